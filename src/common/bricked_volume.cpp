@@ -0,0 +1,177 @@
+#include "bricked_volume.h"
+
+#include <QtConcurrent>
+
+#include <numeric>
+
+namespace VDS {
+namespace {
+// spreads the lower 21 bits of value to every third bit
+std::uint64_t spreadBits(std::uint64_t value) {
+    value &= 0x1fffff;
+    value = (value | value << 32) & 0x1f00000000ffff;
+    value = (value | value << 16) & 0x1f0000ff0000ff;
+    value = (value | value << 8) & 0x100f00f00f00f00f;
+    value = (value | value << 4) & 0x10c30c30c30c30c3;
+    value = (value | value << 2) & 0x1249249249249249;
+    return value;
+}
+
+std::uint64_t getMortonCode(const std::size_t x, const std::size_t y, const std::size_t z) {
+    return spreadBits(x) | spreadBits(y) << 1 | spreadBits(z) << 2;
+}
+
+std::vector<std::size_t> getBrickIndices(const BrickedVolume& volume) {
+    std::vector<std::size_t> bricks(volume.getTotalBrickCount());
+    std::iota(bricks.begin(), bricks.end(), 0);
+    return bricks;
+}
+} // namespace
+
+BrickedVolume::BrickedVolume()
+    : m_size{0, 0, 0}, m_spacing{1.0f, 1.0f, 1.0f}, m_voxelType{VoxelType::UInt16},
+      m_valueRange{getVoxelTypeRange<uint16_t>()}, m_brickCount{0, 0, 0},
+      m_data{std::make_shared<VoxelBuffer>()} {}
+
+BrickedVolume::BrickedVolume(const std::array<std::size_t, 3>& size,
+                             const std::array<float, 3>& spacing, const VoxelType voxelType)
+    : m_size{size}, m_spacing{spacing}, m_voxelType{voxelType},
+      m_valueRange{dispatchVoxelType(voxelType,
+                                     [](auto tag) { return getVoxelTypeRange<decltype(tag)>(); })} {
+    initializeBricks();
+    m_data = std::make_shared<VoxelBuffer>(m_brickIndices.size() * brickVoxelCount *
+                                           VDS::getBytesPerVoxel(voxelType));
+}
+
+BrickedVolume::BrickedVolume(const Volume& volume)
+    : BrickedVolume(volume.getSize(), volume.getSpacing(), volume.getVoxelType()) {
+    m_valueRange = volume.getValueRange();
+    if (volume.isEmpty()) {
+        return;
+    }
+
+    dispatchVoxelType(m_voxelType, [&](auto tag) {
+        using T = decltype(tag);
+        T* voxels = reinterpret_cast<T*>(m_data->data());
+        std::vector<std::size_t> bricks = getBrickIndices(*this);
+        QtConcurrent::blockingMap(bricks, [&](const std::size_t brick) {
+            const VolumeRegion region = getBrickRegion(brick);
+            T* brickVoxels = voxels + brick * brickVoxelCount;
+            for (std::size_t z = 0; z < region.size[2]; z++) {
+                for (std::size_t y = 0; y < region.size[1]; y++) {
+                    const T* row =
+                        volume.getRow<T>(region.offset[1] + y, region.offset[2] + z) +
+                        region.offset[0];
+                    std::copy(row, row + region.size[0],
+                              brickVoxels + (z * brickSize + y) * brickSize);
+                }
+            }
+        });
+    });
+}
+
+Volume BrickedVolume::toVolume() const {
+    Volume volume(m_size, m_spacing, m_voxelType);
+    volume.setValueRange(m_valueRange);
+    if (isEmpty()) {
+        return volume;
+    }
+
+    dispatchVoxelType(m_voxelType, [&](auto tag) {
+        using T = decltype(tag);
+        // the new volume is not shared, so the bricks can write their disjoint rows in parallel
+        T* data = volume.getData<T>();
+        std::vector<std::size_t> bricks = getBrickIndices(*this);
+        QtConcurrent::blockingMap(bricks, [&](const std::size_t brick) {
+            const VolumeRegion region = getBrickRegion(brick);
+            const T* brickVoxels = getBrick<T>(brick);
+            for (std::size_t z = 0; z < region.size[2]; z++) {
+                for (std::size_t y = 0; y < region.size[1]; y++) {
+                    const T* row = brickVoxels + (z * brickSize + y) * brickSize;
+                    std::copy(row, row + region.size[0],
+                              data + ((region.offset[2] + z) * m_size[1] + region.offset[1] + y) *
+                                             m_size[0] +
+                                  region.offset[0]);
+                }
+            }
+        });
+    });
+    return volume;
+}
+
+const std::array<std::size_t, 3>& BrickedVolume::getSize() const {
+    return m_size;
+}
+const std::array<float, 3>& BrickedVolume::getSpacing() const {
+    return m_spacing;
+}
+VoxelType BrickedVolume::getVoxelType() const {
+    return m_voxelType;
+}
+const ValueRange& BrickedVolume::getValueRange() const {
+    return m_valueRange;
+}
+void BrickedVolume::setValueRange(const ValueRange& range) {
+    m_valueRange = range;
+}
+bool BrickedVolume::isEmpty() const {
+    return m_brickIndices.empty();
+}
+const std::array<std::size_t, 3>& BrickedVolume::getBrickCount() const {
+    return m_brickCount;
+}
+std::size_t BrickedVolume::getTotalBrickCount() const {
+    return m_brickIndices.size();
+}
+std::size_t BrickedVolume::getBrickIndex(std::size_t brickX, std::size_t brickY,
+                                         std::size_t brickZ) const {
+    return m_brickIndices[(brickZ * m_brickCount[1] + brickY) * m_brickCount[0] + brickX];
+}
+VolumeRegion BrickedVolume::getBrickRegion(const std::size_t brickIndex) const {
+    const std::size_t position = m_brickPositions[brickIndex];
+    const std::array<std::size_t, 3> brick = {position % m_brickCount[0],
+                                              position / m_brickCount[0] % m_brickCount[1],
+                                              position / m_brickCount[0] / m_brickCount[1]};
+    VolumeRegion region;
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        region.offset[axis] = brick[axis] * brickSize;
+        region.size[axis] = std::min(brickSize, m_size[axis] - region.offset[axis]);
+    }
+    return region;
+}
+
+void BrickedVolume::initializeBricks() {
+    m_brickCount = {0, 0, 0};
+    if (m_size[0] > 0 && m_size[1] > 0 && m_size[2] > 0) {
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            m_brickCount[axis] = (m_size[axis] + brickSize - 1) / brickSize;
+        }
+    }
+
+    // The brick grid is rarely a power of two in every direction, so the Morton codes have gaps.
+    // Sorting the bricks by their code keeps the order but packs them densely.
+    std::vector<std::uint64_t> codes(m_brickCount[0] * m_brickCount[1] * m_brickCount[2]);
+    for (std::size_t z = 0; z < m_brickCount[2]; z++) {
+        for (std::size_t y = 0; y < m_brickCount[1]; y++) {
+            for (std::size_t x = 0; x < m_brickCount[0]; x++) {
+                codes[(z * m_brickCount[1] + y) * m_brickCount[0] + x] = getMortonCode(x, y, z);
+            }
+        }
+    }
+    m_brickPositions.resize(codes.size());
+    std::iota(m_brickPositions.begin(), m_brickPositions.end(), 0);
+    std::sort(m_brickPositions.begin(), m_brickPositions.end(),
+              [&](const std::size_t a, const std::size_t b) { return codes[a] < codes[b]; });
+
+    m_brickIndices.resize(codes.size());
+    for (std::size_t index = 0; index < m_brickPositions.size(); index++) {
+        m_brickIndices[m_brickPositions[index]] = index;
+    }
+}
+
+void BrickedVolume::detach() {
+    if (m_data && m_data.use_count() > 1) {
+        m_data = std::make_shared<VoxelBuffer>(*m_data);
+    }
+}
+} // namespace VDS
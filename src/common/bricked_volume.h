@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "volume.h"
+
+namespace VDS {
+// Volume data in bricks of brickSize^3 voxels for kernels working on 3D neighbourhoods. In the
+// linear layout of Volume the neighbours of a voxel along Z are a whole slice apart, so a stencil
+// streams through several slices at once and thrashes the caches and the TLB. Within a brick the
+// voxels are linear with X being the fastest axis, so a brick fits into the L1 cache, and the
+// bricks are stored in Morton order of their brick coordinates, so neighbouring bricks are mostly
+// close in memory as well.
+//
+// Volumes get converted from and to the linear layout at the boundaries, e.g. before a filter
+// runs on an imported volume and before the result gets uploaded or exported. Bricks at the upper
+// borders are padded to the full brick size, the padding is zero and never read by the accessors.
+// Copies share their voxel data like copies of Volume do.
+class BrickedVolume {
+public:
+    static constexpr std::size_t brickShift = 4;
+    static constexpr std::size_t brickSize = std::size_t{1} << brickShift;
+    static constexpr std::size_t brickVoxelCount = brickSize * brickSize * brickSize;
+
+    BrickedVolume();
+    // zero-initialized
+    BrickedVolume(const std::array<std::size_t, 3>& size, const std::array<float, 3>& spacing,
+                  const VoxelType voxelType);
+    // converts volume into the bricked layout, the bricks are filled in parallel
+    explicit BrickedVolume(const Volume& volume);
+
+    // converts back into the linear layout of Volume
+    Volume toVolume() const;
+
+    const std::array<std::size_t, 3>& getSize() const;
+    const std::array<float, 3>& getSpacing() const;
+    VoxelType getVoxelType() const;
+    const ValueRange& getValueRange() const;
+    void setValueRange(const ValueRange& range);
+    bool isEmpty() const;
+
+    // Bricks per axis. Bricks are addressed by their index in storage order, which runs from 0 to
+    // getTotalBrickCount() - 1, so kernels can process them in parallel by index.
+    const std::array<std::size_t, 3>& getBrickCount() const;
+    std::size_t getTotalBrickCount() const;
+    // index of the brick containing voxel (brickX * brickSize, brickY * brickSize, ...)
+    std::size_t getBrickIndex(std::size_t brickX, std::size_t brickY, std::size_t brickZ) const;
+    // voxels of the volume covered by a brick, smaller than a brick at the upper borders
+    VolumeRegion getBrickRegion(const std::size_t brickIndex) const;
+
+    // brickVoxelCount voxels, linear within the brick with X being the fastest axis
+    template <typename T>
+    const T* getBrick(const std::size_t brickIndex) const {
+        assert(VoxelTypeOf<T>::value == m_voxelType);
+        return reinterpret_cast<const T*>(m_data->data()) + brickIndex * brickVoxelCount;
+    }
+    template <typename T>
+    T* getBrick(const std::size_t brickIndex) {
+        assert(VoxelTypeOf<T>::value == m_voxelType);
+        detach();
+        return reinterpret_cast<T*>(m_data->data()) + brickIndex * brickVoxelCount;
+    }
+
+    template <typename T>
+    T getVoxel(const std::size_t x, const std::size_t y, const std::size_t z) const {
+        assert(VoxelTypeOf<T>::value == m_voxelType);
+        return reinterpret_cast<const T*>(m_data->data())[getVoxelOffset(x, y, z)];
+    }
+    template <typename T>
+    void setVoxel(const std::size_t x, const std::size_t y, const std::size_t z, const T value) {
+        assert(VoxelTypeOf<T>::value == m_voxelType);
+        detach();
+        reinterpret_cast<T*>(m_data->data())[getVoxelOffset(x, y, z)] = value;
+    }
+
+    // calls function(region, brick) for every brick in storage order, see getBrickRegion and
+    // getBrick
+    template <typename T, typename Function>
+    void forEachBrick(Function&& function) const {
+        for (std::size_t brick = 0; brick < getTotalBrickCount(); brick++) {
+            function(getBrickRegion(brick), getBrick<T>(brick));
+        }
+    }
+
+    // Copies the voxels of the box starting at offset into block, linear with X being the fastest
+    // axis. The box may reach beyond the volume, voxels outside of it repeat the nearest border
+    // voxel. Reading a brick together with the halo of a stencil this way gives kernels a small
+    // dense block they can process without any border checks.
+    template <typename T>
+    void readBlock(const std::array<std::ptrdiff_t, 3>& offset,
+                   const std::array<std::size_t, 3>& size, T* block) const {
+        assert(VoxelTypeOf<T>::value == m_voxelType);
+        if (isEmpty()) {
+            return;
+        }
+
+        const T* voxels = reinterpret_cast<const T*>(m_data->data());
+        const auto clampCoordinate = [&](const std::ptrdiff_t coordinate, const std::size_t axis) {
+            return static_cast<std::size_t>(std::clamp<std::ptrdiff_t>(
+                coordinate, 0, static_cast<std::ptrdiff_t>(m_size[axis]) - 1));
+        };
+
+        // every row of the block consists of voxels left of the volume, voxels within it and
+        // voxels right of it
+        const std::ptrdiff_t sizeX = static_cast<std::ptrdiff_t>(m_size[0]);
+        const std::ptrdiff_t innerBegin = std::clamp<std::ptrdiff_t>(offset[0], 0, sizeX);
+        const std::ptrdiff_t innerEnd = std::clamp<std::ptrdiff_t>(
+            offset[0] + static_cast<std::ptrdiff_t>(size[0]), innerBegin, sizeX);
+        const std::size_t leftCount = static_cast<std::size_t>(
+            std::clamp<std::ptrdiff_t>(-offset[0], 0, static_cast<std::ptrdiff_t>(size[0])));
+        const std::size_t rightBegin = leftCount + static_cast<std::size_t>(innerEnd - innerBegin);
+
+        for (std::size_t z = 0; z < size[2]; z++) {
+            const std::size_t sourceZ =
+                clampCoordinate(offset[2] + static_cast<std::ptrdiff_t>(z), 2);
+            for (std::size_t y = 0; y < size[1]; y++) {
+                const std::size_t sourceY =
+                    clampCoordinate(offset[1] + static_cast<std::ptrdiff_t>(y), 1);
+                T* row = block + (z * size[1] + y) * size[0];
+
+                // the row of a brick is contiguous, so the inner part is copied brick by brick
+                T* target = row + leftCount;
+                for (std::size_t x = static_cast<std::size_t>(innerBegin);
+                     x < static_cast<std::size_t>(innerEnd);) {
+                    const std::size_t count = std::min(brickSize - (x & brickMask),
+                                                       static_cast<std::size_t>(innerEnd) - x);
+                    std::memcpy(target, voxels + getVoxelOffset(x, sourceY, sourceZ),
+                                count * sizeof(T));
+                    target += count;
+                    x += count;
+                }
+
+                std::fill(row, row + leftCount, voxels[getVoxelOffset(0, sourceY, sourceZ)]);
+                std::fill(row + rightBegin, row + size[0],
+                          voxels[getVoxelOffset(m_size[0] - 1, sourceY, sourceZ)]);
+            }
+        }
+    }
+
+private:
+    static constexpr std::size_t brickMask = brickSize - 1;
+
+    // position of voxel (x, y, z) within the voxel data
+    std::size_t getVoxelOffset(const std::size_t x, const std::size_t y,
+                               const std::size_t z) const {
+        const std::size_t brick =
+            m_brickIndices[((z >> brickShift) * m_brickCount[1] + (y >> brickShift)) *
+                               m_brickCount[0] +
+                           (x >> brickShift)];
+        return (brick << (3 * brickShift)) +
+               ((((z & brickMask) << brickShift) | (y & brickMask)) << brickShift) +
+               (x & brickMask);
+    }
+
+    // computes the brick count and the storage order of the bricks for m_size
+    void initializeBricks();
+    // gives this volume its own copy of shared voxel data
+    void detach();
+
+    std::array<std::size_t, 3> m_size;
+    std::array<float, 3> m_spacing;
+    VoxelType m_voxelType;
+    ValueRange m_valueRange;
+    std::array<std::size_t, 3> m_brickCount;
+    // storage index of every brick, indexed linearly by brick position with X being the fastest
+    std::vector<std::size_t> m_brickIndices;
+    // linear brick position of every storage index, the inverse of m_brickIndices
+    std::vector<std::size_t> m_brickPositions;
+    // never modified while shared
+    std::shared_ptr<VoxelBuffer> m_data;
+};
+} // namespace VDS
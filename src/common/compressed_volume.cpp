@@ -0,0 +1,318 @@
+#include "compressed_volume.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <numeric>
+#include <type_traits>
+
+namespace VDS {
+namespace {
+// see VdsVolumeIO, level 1 compresses several times faster than higher levels at almost the same
+// ratio once the bricks are preconditioned
+constexpr int compressionLevel = 1;
+
+// unsigned integer of the voxel size, deltas wrap around, so they are lossless for every type
+template <typename T>
+using VoxelBits = std::conditional_t<
+    sizeof(T) == 1, uint8_t, std::conditional_t<sizeof(T) == 2, uint16_t, uint32_t>>;
+
+// Replaces every voxel with the difference to its predecessor and stores byte i of all deltas in
+// plane i. Smooth regions produce small deltas, so the planes of the high bytes are mostly zero
+// and compress to almost nothing.
+template <typename T>
+void shuffleDeltas(const T* voxels, const std::size_t count, uint8_t* planes) {
+    using Bits = VoxelBits<T>;
+    Bits previous = 0;
+    for (std::size_t index = 0; index < count; index++) {
+        Bits bits;
+        std::memcpy(&bits, voxels + index, sizeof(T));
+        const Bits delta = static_cast<Bits>(bits - previous);
+        previous = bits;
+        for (std::size_t byte = 0; byte < sizeof(T); byte++) {
+            planes[byte * count + index] = static_cast<uint8_t>(delta >> (8 * byte));
+        }
+    }
+}
+
+// inverse of shuffleDeltas
+template <typename T>
+void unshuffleDeltas(const uint8_t* planes, const std::size_t count, T* voxels) {
+    using Bits = VoxelBits<T>;
+    Bits previous = 0;
+    for (std::size_t index = 0; index < count; index++) {
+        Bits delta = 0;
+        for (std::size_t byte = 0; byte < sizeof(T); byte++) {
+            delta |= static_cast<Bits>(static_cast<Bits>(planes[byte * count + index])
+                                       << (8 * byte));
+        }
+        previous = static_cast<Bits>(previous + delta);
+        std::memcpy(voxels + index, &previous, sizeof(T));
+    }
+}
+} // namespace
+
+CompressedVolume::CompressedVolume(const std::array<std::size_t, 3>& size,
+                                   const std::array<float, 3>& spacing, const VoxelType voxelType,
+                                   const std::size_t cacheSizeInBytes)
+    : m_size{size}, m_spacing{spacing}, m_voxelType{voxelType},
+      m_valueRange{dispatchVoxelType(voxelType,
+                                     [](auto tag) { return getVoxelTypeRange<decltype(tag)>(); })},
+      m_brickCount{VolumeBrickRanges::computeBrickCount(size)},
+      m_cacheSizeInBytes{cacheSizeInBytes}, m_cachedSizeInBytes{0} {
+    m_bricks.resize(m_brickCount[0] * m_brickCount[1] * m_brickCount[2]);
+    m_brickRanges.resize(m_bricks.size());
+}
+
+CompressedVolume::CompressedVolume(const Volume& volume, const std::size_t cacheSizeInBytes)
+    : CompressedVolume(volume.getSize(), volume.getSpacing(), volume.getVoxelType(),
+                       cacheSizeInBytes) {
+    m_valueRange = volume.getValueRange();
+
+    std::vector<std::size_t> bricks(m_bricks.size());
+    std::iota(bricks.begin(), bricks.end(), 0);
+    QtConcurrent::blockingMap(bricks, [&](const std::size_t brick) {
+        compressBrick(volume, getBrickRegion(brick), brick);
+    });
+}
+
+const std::array<std::size_t, 3>& CompressedVolume::getSize() const {
+    return m_size;
+}
+const std::array<float, 3>& CompressedVolume::getSpacing() const {
+    return m_spacing;
+}
+VoxelType CompressedVolume::getVoxelType() const {
+    return m_voxelType;
+}
+const ValueRange& CompressedVolume::getValueRange() const {
+    return m_valueRange;
+}
+void CompressedVolume::setValueRange(const ValueRange& range) {
+    m_valueRange = range;
+}
+std::size_t CompressedVolume::getVoxelCount() const {
+    return m_size[0] * m_size[1] * m_size[2];
+}
+std::size_t CompressedVolume::getSizeInBytes() const {
+    return getVoxelCount() * getBytesPerVoxel(m_voxelType);
+}
+std::size_t CompressedVolume::getCompressedSizeInBytes() const {
+    std::size_t size = 0;
+    for (const QByteArray& brick : m_bricks) {
+        size += static_cast<std::size_t>(brick.size());
+    }
+    return size;
+}
+bool CompressedVolume::isEmpty() const {
+    return m_bricks.empty();
+}
+
+bool CompressedVolume::insertSlab(const Volume& slab, const std::size_t firstSlice) {
+    if (firstSlice % brickSize != 0 || firstSlice >= m_size[2] ||
+        slab.getVoxelType() != m_voxelType || slab.getSizeX() != m_size[0] ||
+        slab.getSizeY() != m_size[1] ||
+        slab.getSizeZ() != std::min(brickSize, m_size[2] - firstSlice)) {
+        return false;
+    }
+
+    const std::size_t brickZ = firstSlice / brickSize;
+    std::vector<std::size_t> bricks(m_brickCount[0] * m_brickCount[1]);
+    std::iota(bricks.begin(), bricks.end(), brickZ * bricks.size());
+    QtConcurrent::blockingMap(bricks, [&](const std::size_t brick) {
+        VolumeRegion sourceRegion = getBrickRegion(brick);
+        sourceRegion.offset[2] -= firstSlice;
+        compressBrick(slab, sourceRegion, brick);
+    });
+    return true;
+}
+
+bool CompressedVolume::readSlab(const std::size_t firstSlice, const std::size_t sliceCount,
+                                Volume& slab) const {
+    if (sliceCount == 0 || firstSlice + sliceCount > m_size[2]) {
+        return false;
+    }
+
+    const std::array<std::size_t, 3> slabSize = {m_size[0], m_size[1], sliceCount};
+    if (slab.getSize() != slabSize || slab.getVoxelType() != m_voxelType) {
+        slab = Volume(slabSize, m_spacing, m_voxelType);
+    }
+    slab.setValueRange(m_valueRange);
+
+    // the slab is not shared anymore, so the bricks can copy their disjoint rows in parallel
+    uint8_t* slabData = static_cast<uint8_t*>(slab.getRawData());
+    std::vector<std::size_t> bricks;
+    for (std::size_t z = firstSlice / brickSize; z <= (firstSlice + sliceCount - 1) / brickSize;
+         z++) {
+        for (std::size_t brick = z * m_brickCount[0] * m_brickCount[1];
+             brick < (z + 1) * m_brickCount[0] * m_brickCount[1]; brick++) {
+            bricks.push_back(brick);
+        }
+    }
+
+    std::atomic<bool> success{true};
+    QtConcurrent::blockingMap(bricks, [&](const std::size_t brick) {
+        const Volume brickData = decompressBrick(brick);
+        if (brickData.isEmpty()) {
+            success = false;
+            return;
+        }
+
+        const VolumeRegion region = getBrickRegion(brick);
+        const std::size_t bytesPerVoxel = getBytesPerVoxel(m_voxelType);
+        const std::size_t begin = std::max(region.offset[2], firstSlice);
+        const std::size_t end = std::min(region.getEnd()[2], firstSlice + sliceCount);
+        for (std::size_t z = begin; z < end; z++) {
+            for (std::size_t y = 0; y < region.size[1]; y++) {
+                const uint8_t* source =
+                    static_cast<const uint8_t*>(brickData.getRawData()) +
+                    ((z - region.offset[2]) * region.size[1] + y) * region.size[0] * bytesPerVoxel;
+                uint8_t* destination = slabData + (((z - firstSlice) * m_size[1] +
+                                                    region.offset[1] + y) *
+                                                       m_size[0] +
+                                                   region.offset[0]) *
+                                                      bytesPerVoxel;
+                std::memcpy(destination, source, region.size[0] * bytesPerVoxel);
+            }
+        }
+    });
+    return success;
+}
+
+std::size_t CompressedVolume::getSlabSliceCount(const std::size_t maximumSlabSizeInBytes) const {
+    const std::size_t layerBytes =
+        std::max<std::size_t>(m_size[0] * m_size[1] * brickSize * getBytesPerVoxel(m_voxelType), 1);
+    return std::max<std::size_t>(maximumSlabSizeInBytes / layerBytes, 1) * brickSize;
+}
+
+Volume CompressedVolume::extractRegion(const VolumeRegion& region) const {
+    const VolumeRegion clampedRegion = region.clamped(m_size);
+    Volume result(clampedRegion.size, m_spacing, m_voxelType);
+    result.setValueRange(m_valueRange);
+    if (clampedRegion.isEmpty()) {
+        return result;
+    }
+
+    const auto end = clampedRegion.getEnd();
+    for (std::size_t z = clampedRegion.offset[2] / brickSize; z <= (end[2] - 1) / brickSize; z++) {
+        for (std::size_t y = clampedRegion.offset[1] / brickSize; y <= (end[1] - 1) / brickSize;
+             y++) {
+            for (std::size_t x = clampedRegion.offset[0] / brickSize;
+                 x <= (end[0] - 1) / brickSize; x++) {
+                // part of the region within the brick, relative to the brick
+                const Volume brick = getBrick(x, y, z);
+                const std::array<std::size_t, 3> brickOffset = {x * brickSize, y * brickSize,
+                                                                z * brickSize};
+                VolumeRegion part;
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    const std::size_t begin =
+                        std::max(clampedRegion.offset[axis], brickOffset[axis]);
+                    part.offset[axis] = begin - brickOffset[axis];
+                    part.size[axis] =
+                        std::min(end[axis], brickOffset[axis] + brick.getSize()[axis]) - begin;
+                }
+
+                VolumeRegion target = part;
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    target.offset[axis] += brickOffset[axis] - clampedRegion.offset[axis];
+                }
+                result.insertRegion(brick.extractRegion(part), target);
+            }
+        }
+    }
+    return result;
+}
+
+VolumeBrickRanges CompressedVolume::getBrickRanges() const {
+    return VolumeBrickRanges(m_brickCount, m_brickRanges);
+}
+
+Volume CompressedVolume::getBrick(const std::size_t x, const std::size_t y,
+                                  const std::size_t z) const {
+    const std::size_t brick = (z * m_brickCount[1] + y) * m_brickCount[0] + x;
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        const auto it = m_cachedBrickPositions.find(brick);
+        if (it != m_cachedBrickPositions.end()) {
+            m_cachedBricks.splice(m_cachedBricks.begin(), m_cachedBricks, it->second);
+            return it->second->second;
+        }
+    }
+
+    // decompress without holding the lock, two threads missing the same brick both decompress it
+    Volume brickData = decompressBrick(brick);
+
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    if (m_cachedBrickPositions.find(brick) == m_cachedBrickPositions.end()) {
+        m_cachedBricks.emplace_front(brick, brickData);
+        m_cachedBrickPositions[brick] = m_cachedBricks.begin();
+        m_cachedSizeInBytes += brickData.getSizeInBytes();
+
+        // the brick just inserted stays, even if it is larger than the cache
+        while (m_cachedSizeInBytes > m_cacheSizeInBytes && m_cachedBricks.size() > 1) {
+            m_cachedSizeInBytes -= m_cachedBricks.back().second.getSizeInBytes();
+            m_cachedBrickPositions.erase(m_cachedBricks.back().first);
+            m_cachedBricks.pop_back();
+        }
+    }
+    return brickData;
+}
+
+Volume CompressedVolume::decompressBrick(const std::size_t brick) const {
+    const VolumeRegion region = getBrickRegion(brick);
+    if (m_bricks[brick].isEmpty()) {
+        return Volume();
+    }
+
+    const QByteArray planes =
+        qUncompress(reinterpret_cast<const uchar*>(m_bricks[brick].constData()),
+                    m_bricks[brick].size());
+    Volume brickData(region.size, m_spacing, m_voxelType);
+    if (static_cast<std::size_t>(planes.size()) != brickData.getSizeInBytes()) {
+        return Volume();
+    }
+
+    brickData.setValueRange(m_valueRange);
+    dispatchVoxelType(m_voxelType, [&](auto tag) {
+        using T = decltype(tag);
+        unshuffleDeltas(reinterpret_cast<const uint8_t*>(planes.constData()),
+                        brickData.getVoxelCount(), brickData.getData<T>());
+    });
+    return brickData;
+}
+
+void CompressedVolume::compressBrick(const Volume& source, const VolumeRegion& sourceRegion,
+                                     const std::size_t brick) {
+    dispatchVoxelType(m_voxelType, [&](auto tag) {
+        using T = decltype(tag);
+        std::vector<T> voxels;
+        voxels.reserve(sourceRegion.getVoxelCount());
+        source.forEachRegionRow<T>(sourceRegion, [&](const T* row, const std::size_t count) {
+            voxels.insert(voxels.end(), row, row + count);
+        });
+
+        const auto [minimum, maximum] = std::minmax_element(voxels.begin(), voxels.end());
+        m_brickRanges[brick] = ValueRange{static_cast<float>(*minimum),
+                                          static_cast<float>(*maximum)};
+
+        std::vector<uint8_t> planes(voxels.size() * sizeof(T));
+        shuffleDeltas(voxels.data(), voxels.size(), planes.data());
+        m_bricks[brick] = qCompress(planes.data(), static_cast<qsizetype>(planes.size()),
+                                    compressionLevel);
+    });
+}
+
+VolumeRegion CompressedVolume::getBrickRegion(const std::size_t brick) const {
+    const std::array<std::size_t, 3> position = {brick % m_brickCount[0],
+                                                 brick / m_brickCount[0] % m_brickCount[1],
+                                                 brick / m_brickCount[0] / m_brickCount[1]};
+    VolumeRegion region;
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        region.offset[axis] = position[axis] * brickSize;
+        region.size[axis] = std::min(brickSize, m_size[axis] - region.offset[axis]);
+    }
+    return region;
+}
+} // namespace VDS
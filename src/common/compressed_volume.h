@@ -0,0 +1,110 @@
+#pragma once
+
+#include <QByteArray>
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "volume.h"
+#include "volume_brick_ranges.h"
+
+namespace VDS {
+// Volume data held in RAM as independently compressed bricks, so volumes several times larger
+// than the available memory can be loaded as long as they compress well, which CT volumes with a
+// lot of air or smooth tissue do. Every brick is preconditioned with a delta along X and a byte
+// shuffle, which groups the mostly constant high bytes of the deltas, before it gets compressed
+// losslessly.
+//
+// Random access through getVoxel and extractRegion is served by a small LRU cache of
+// decompressed bricks. Sequential consumers like texture upload, histogram and export stream the
+// volume with readSlab instead, which decompresses the bricks of a slab in parallel without
+// evicting the bricks in the cache.
+//
+// All const functions are thread safe. Slabs are inserted while building the volume, before it
+// gets shared with readers.
+class CompressedVolume {
+public:
+    // same bricks as VolumeBrickRanges, so the ranges are collected while compressing
+    static constexpr std::size_t brickSize = VolumeBrickRanges::brickSize;
+    static constexpr std::size_t defaultCacheSizeInBytes = std::size_t{256} << 20;
+
+    // all bricks are empty until their slab gets inserted
+    CompressedVolume(const std::array<std::size_t, 3>& size, const std::array<float, 3>& spacing,
+                     const VoxelType voxelType,
+                     const std::size_t cacheSizeInBytes = defaultCacheSizeInBytes);
+    // compresses all bricks of volume in parallel
+    explicit CompressedVolume(const Volume& volume,
+                              const std::size_t cacheSizeInBytes = defaultCacheSizeInBytes);
+    CompressedVolume(const CompressedVolume&) = delete;
+    CompressedVolume& operator=(const CompressedVolume&) = delete;
+
+    const std::array<std::size_t, 3>& getSize() const;
+    const std::array<float, 3>& getSpacing() const;
+    VoxelType getVoxelType() const;
+    // see Volume::getValueRange
+    const ValueRange& getValueRange() const;
+    void setValueRange(const ValueRange& range);
+
+    std::size_t getVoxelCount() const;
+    // size of the decompressed voxels
+    std::size_t getSizeInBytes() const;
+    std::size_t getCompressedSizeInBytes() const;
+    bool isEmpty() const;
+
+    // Compresses slab as the slices starting at firstSlice, which has to be a multiple of
+    // brickSize. slab has to have the size of the volume along X and Y, brickSize slices and the
+    // voxel type of the volume. The last slab has fewer slices if the volume size along Z is not a
+    // multiple of brickSize. Not thread safe.
+    bool insertSlab(const Volume& slab, const std::size_t firstSlice);
+
+    // Replaces slab with the sliceCount slices starting at firstSlice, like
+    // RawVolumeIO::RawSliceReader::readSlab. The slab keeps its memory if it already has the same
+    // size.
+    bool readSlab(const std::size_t firstSlice, const std::size_t sliceCount, Volume& slab) const;
+    // Number of slices per slab, a multiple of brickSize, so a slab takes at most
+    // maximumSlabSizeInBytes unless a single brick layer is larger. Slabs aligned to the bricks
+    // decompress every brick only once.
+    std::size_t getSlabSliceCount(const std::size_t maximumSlabSizeInBytes) const;
+    // copy of the voxels within region, see Volume::extractRegion
+    Volume extractRegion(const VolumeRegion& region) const;
+
+    template <typename T>
+    T getVoxel(const std::size_t x, const std::size_t y, const std::size_t z) const {
+        const Volume brick = getBrick(x / brickSize, y / brickSize, z / brickSize);
+        return brick.getRow<T>(y % brickSize, z % brickSize)[x % brickSize];
+    }
+
+    // minimum and maximum per brick, collected while compressing
+    VolumeBrickRanges getBrickRanges() const;
+
+private:
+    // decompressed brick from the cache, decompressed and cached first if missing
+    Volume getBrick(const std::size_t x, const std::size_t y, const std::size_t z) const;
+    Volume decompressBrick(const std::size_t brick) const;
+    void compressBrick(const Volume& source, const VolumeRegion& sourceRegion,
+                       const std::size_t brick);
+    // voxels of the volume covered by brick, smaller than a brick at the upper borders
+    VolumeRegion getBrickRegion(const std::size_t brick) const;
+
+    std::array<std::size_t, 3> m_size;
+    std::array<float, 3> m_spacing;
+    VoxelType m_voxelType;
+    ValueRange m_valueRange;
+    std::array<std::size_t, 3> m_brickCount;
+    // in X, Y, Z order
+    std::vector<QByteArray> m_bricks;
+    std::vector<ValueRange> m_brickRanges;
+
+    // least recently used brick last
+    std::size_t m_cacheSizeInBytes;
+    mutable std::mutex m_cacheMutex;
+    mutable std::list<std::pair<std::size_t, Volume>> m_cachedBricks;
+    mutable std::unordered_map<std::size_t, std::list<std::pair<std::size_t, Volume>>::iterator>
+        m_cachedBrickPositions;
+    mutable std::size_t m_cachedSizeInBytes;
+};
+} // namespace VDS
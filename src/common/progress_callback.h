@@ -0,0 +1,9 @@
+#pragma once
+
+#include <functional>
+
+namespace VDS {
+// Called by long running operations with their progress in [0, 1]. The operation stops and fails
+// as soon as the callback returns false, which is how background jobs get canceled.
+using ProgressCallback = std::function<bool(float progress)>;
+} // namespace VDS
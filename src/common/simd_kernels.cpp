@@ -0,0 +1,501 @@
+#include "simd_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VDS_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC accepts intrinsics of every instruction set, GCC and Clang need them enabled per function
+#if defined(__GNUC__) || defined(__clang__)
+#define VDS_SIMD_TARGET(instructionSets) __attribute__((target(instructionSets)))
+#else
+#define VDS_SIMD_TARGET(instructionSets)
+#endif
+
+namespace VDS::Kernels::Simd {
+namespace {
+// scalar fallbacks, also used for the remainders of the vectorized loops
+void swapBytesScalar(uint8_t* data, const std::size_t count, const std::size_t bytesPerValue) {
+    for (std::size_t index = 0; index < count; index++) {
+        uint8_t* value = data + index * bytesPerValue;
+        for (std::size_t byte = 0; byte < bytesPerValue / 2; byte++) {
+            const uint8_t swapped = value[byte];
+            value[byte] = value[bytesPerValue - 1 - byte];
+            value[bytesPerValue - 1 - byte] = swapped;
+        }
+    }
+}
+
+void widen8To16Scalar(const uint8_t* source, uint16_t* destination, const std::size_t count) {
+    for (std::size_t index = 0; index < count; index++) {
+        destination[index] = static_cast<uint16_t>(source[index] * 257);
+    }
+}
+
+// round(value / 257) == (value * 65281 / 65536 + 128) / 256 for all 16 bit values, which only
+// needs 16 bit lanes
+uint8_t narrowValue(const uint16_t value) {
+    return static_cast<uint8_t>((((static_cast<uint32_t>(value) * 65281) >> 16) + 128) >> 8);
+}
+
+void narrow16To8Scalar(const uint16_t* source, uint8_t* destination, const std::size_t count) {
+    for (std::size_t index = 0; index < count; index++) {
+        destination[index] = narrowValue(source[index]);
+    }
+}
+
+// fails for infinity and NaN
+bool isFinite(const float value) {
+    return std::abs(value) <= std::numeric_limits<float>::max();
+}
+
+void replaceNonFiniteScalar(float* data, const std::size_t count, float& minimum,
+                            float& maximum) {
+    for (std::size_t index = 0; index < count; index++) {
+        const float value = isFinite(data[index]) ? data[index] : 0.0f;
+        data[index] = value;
+        minimum = std::min(minimum, value);
+        maximum = std::max(maximum, value);
+    }
+}
+
+template <typename T>
+void applySortingNetworkScalar(T* wires, const uint8_t* comparators,
+                               const std::size_t comparatorCount) {
+    for (std::size_t index = 0; index < comparatorCount; index++) {
+        T* first = wires + comparators[2 * index] * sortingNetworkLaneCount;
+        T* second = wires + comparators[2 * index + 1] * sortingNetworkLaneCount;
+        for (std::size_t lane = 0; lane < sortingNetworkLaneCount; lane++) {
+            const T minimum = std::min(first[lane], second[lane]);
+            second[lane] = std::max(first[lane], second[lane]);
+            first[lane] = minimum;
+        }
+    }
+}
+
+#ifdef VDS_SIMD_X86
+// Byte order of a 64 byte block for each value size. pshufb works within 16 byte lanes, so the
+// narrower instruction sets use the beginning of the same table.
+struct ShuffleMask {
+    alignas(64) int8_t bytes[64];
+};
+
+ShuffleMask createShuffleMask(const std::size_t bytesPerValue) {
+    ShuffleMask mask;
+    for (std::size_t index = 0; index < sizeof(mask.bytes); index++) {
+        const std::size_t laneByte = index % 16;
+        const std::size_t valueStart = laneByte - laneByte % bytesPerValue;
+        mask.bytes[index] =
+            static_cast<int8_t>(valueStart + bytesPerValue - 1 - (laneByte - valueStart));
+    }
+    return mask;
+}
+
+const int8_t* getShuffleMask(const std::size_t bytesPerValue) {
+    static const ShuffleMask masks[3] = {createShuffleMask(2), createShuffleMask(4),
+                                         createShuffleMask(8)};
+    return masks[bytesPerValue == 2 ? 0 : bytesPerValue == 4 ? 1 : 2].bytes;
+}
+
+VDS_SIMD_TARGET("ssse3")
+void swapBytesSSSE3(uint8_t* data, const std::size_t bytes, const std::size_t bytesPerValue) {
+    const __m128i mask =
+        _mm_load_si128(reinterpret_cast<const __m128i*>(getShuffleMask(bytesPerValue)));
+    std::size_t offset = 0;
+    for (; offset + 16 <= bytes; offset += 16) {
+        __m128i* block = reinterpret_cast<__m128i*>(data + offset);
+        _mm_storeu_si128(block, _mm_shuffle_epi8(_mm_loadu_si128(block), mask));
+    }
+    swapBytesScalar(data + offset, (bytes - offset) / bytesPerValue, bytesPerValue);
+}
+
+VDS_SIMD_TARGET("avx2")
+void swapBytesAVX2(uint8_t* data, const std::size_t bytes, const std::size_t bytesPerValue) {
+    const __m256i mask =
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(getShuffleMask(bytesPerValue)));
+    std::size_t offset = 0;
+    for (; offset + 32 <= bytes; offset += 32) {
+        __m256i* block = reinterpret_cast<__m256i*>(data + offset);
+        _mm256_storeu_si256(block, _mm256_shuffle_epi8(_mm256_loadu_si256(block), mask));
+    }
+    swapBytesScalar(data + offset, (bytes - offset) / bytesPerValue, bytesPerValue);
+}
+
+VDS_SIMD_TARGET("avx512f,avx512bw")
+void swapBytesAVX512(uint8_t* data, const std::size_t bytes, const std::size_t bytesPerValue) {
+    const __m512i mask = _mm512_load_si512(getShuffleMask(bytesPerValue));
+    std::size_t offset = 0;
+    for (; offset + 64 <= bytes; offset += 64) {
+        void* block = data + offset;
+        _mm512_storeu_si512(block, _mm512_shuffle_epi8(_mm512_loadu_si512(block), mask));
+    }
+    swapBytesScalar(data + offset, (bytes - offset) / bytesPerValue, bytesPerValue);
+}
+
+VDS_SIMD_TARGET("ssse3")
+void widen8To16SSSE3(const uint8_t* source, uint16_t* destination, const std::size_t count) {
+    std::size_t index = 0;
+    for (; index + 16 <= count; index += 16) {
+        const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index));
+        // interleaving a byte with itself gives value * 257
+        __m128i* output = reinterpret_cast<__m128i*>(destination + index);
+        _mm_storeu_si128(output, _mm_unpacklo_epi8(values, values));
+        _mm_storeu_si128(output + 1, _mm_unpackhi_epi8(values, values));
+    }
+    widen8To16Scalar(source + index, destination + index, count - index);
+}
+
+VDS_SIMD_TARGET("avx2")
+void widen8To16AVX2(const uint8_t* source, uint16_t* destination, const std::size_t count) {
+    std::size_t index = 0;
+    for (; index + 32 <= count; index += 32) {
+        const __m256i values =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + index));
+        // unpack works per 128 bit lane, so the lanes are put in order first
+        const __m256i ordered = _mm256_permute4x64_epi64(values, 0xD8);
+        __m256i* output = reinterpret_cast<__m256i*>(destination + index);
+        _mm256_storeu_si256(output, _mm256_unpacklo_epi8(ordered, ordered));
+        _mm256_storeu_si256(output + 1, _mm256_unpackhi_epi8(ordered, ordered));
+    }
+    widen8To16Scalar(source + index, destination + index, count - index);
+}
+
+VDS_SIMD_TARGET("ssse3")
+void narrow16To8SSSE3(const uint16_t* source, uint8_t* destination, const std::size_t count) {
+    const __m128i factor = _mm_set1_epi16(static_cast<short>(65281));
+    const __m128i rounding = _mm_set1_epi16(128);
+    std::size_t index = 0;
+    for (; index + 16 <= count; index += 16) {
+        const __m128i* input = reinterpret_cast<const __m128i*>(source + index);
+        const __m128i low = _mm_srli_epi16(
+            _mm_add_epi16(_mm_mulhi_epu16(_mm_loadu_si128(input), factor), rounding), 8);
+        const __m128i high = _mm_srli_epi16(
+            _mm_add_epi16(_mm_mulhi_epu16(_mm_loadu_si128(input + 1), factor), rounding), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + index),
+                         _mm_packus_epi16(low, high));
+    }
+    narrow16To8Scalar(source + index, destination + index, count - index);
+}
+
+VDS_SIMD_TARGET("avx2")
+void narrow16To8AVX2(const uint16_t* source, uint8_t* destination, const std::size_t count) {
+    const __m256i factor = _mm256_set1_epi16(static_cast<short>(65281));
+    const __m256i rounding = _mm256_set1_epi16(128);
+    std::size_t index = 0;
+    for (; index + 32 <= count; index += 32) {
+        const __m256i* input = reinterpret_cast<const __m256i*>(source + index);
+        const __m256i low = _mm256_srli_epi16(
+            _mm256_add_epi16(_mm256_mulhi_epu16(_mm256_loadu_si256(input), factor), rounding), 8);
+        const __m256i high = _mm256_srli_epi16(
+            _mm256_add_epi16(_mm256_mulhi_epu16(_mm256_loadu_si256(input + 1), factor), rounding),
+            8);
+        // pack works per 128 bit lane, so the lanes are put back in order afterwards
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + index), packed);
+    }
+    narrow16To8Scalar(source + index, destination + index, count - index);
+}
+
+// the sign bit cleared gives the absolute value, which is only at most the largest float if finite
+VDS_SIMD_TARGET("ssse3")
+void replaceNonFiniteSSSE3(float* data, const std::size_t count, float& minimum,
+                           float& maximum) {
+    const __m128 absoluteMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 largest = _mm_set1_ps(std::numeric_limits<float>::max());
+    __m128 minimums = _mm_set1_ps(minimum);
+    __m128 maximums = _mm_set1_ps(maximum);
+    std::size_t index = 0;
+    for (; index + 4 <= count; index += 4) {
+        const __m128 values = _mm_loadu_ps(data + index);
+        const __m128 finite = _mm_cmple_ps(_mm_and_ps(values, absoluteMask), largest);
+        const __m128 replaced = _mm_and_ps(values, finite);
+        _mm_storeu_ps(data + index, replaced);
+        minimums = _mm_min_ps(minimums, replaced);
+        maximums = _mm_max_ps(maximums, replaced);
+    }
+
+    alignas(16) float lanes[2][4];
+    _mm_store_ps(lanes[0], minimums);
+    _mm_store_ps(lanes[1], maximums);
+    minimum = *std::min_element(lanes[0], lanes[0] + 4);
+    maximum = *std::max_element(lanes[1], lanes[1] + 4);
+    replaceNonFiniteScalar(data + index, count - index, minimum, maximum);
+}
+
+VDS_SIMD_TARGET("avx2")
+void replaceNonFiniteAVX2(float* data, const std::size_t count, float& minimum, float& maximum) {
+    const __m256 absoluteMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const __m256 largest = _mm256_set1_ps(std::numeric_limits<float>::max());
+    __m256 minimums = _mm256_set1_ps(minimum);
+    __m256 maximums = _mm256_set1_ps(maximum);
+    std::size_t index = 0;
+    for (; index + 8 <= count; index += 8) {
+        const __m256 values = _mm256_loadu_ps(data + index);
+        const __m256 finite =
+            _mm256_cmp_ps(_mm256_and_ps(values, absoluteMask), largest, _CMP_LE_OQ);
+        const __m256 replaced = _mm256_and_ps(values, finite);
+        _mm256_storeu_ps(data + index, replaced);
+        minimums = _mm256_min_ps(minimums, replaced);
+        maximums = _mm256_max_ps(maximums, replaced);
+    }
+
+    alignas(32) float lanes[2][8];
+    _mm256_store_ps(lanes[0], minimums);
+    _mm256_store_ps(lanes[1], maximums);
+    minimum = *std::min_element(lanes[0], lanes[0] + 8);
+    maximum = *std::max_element(lanes[1], lanes[1] + 8);
+    replaceNonFiniteScalar(data + index, count - index, minimum, maximum);
+}
+
+// 16 lanes of 16 bit are a single AVX2 or two SSE registers, 16 floats two AVX2 or four SSE
+// registers
+VDS_SIMD_TARGET("ssse3")
+void applySortingNetworkSSSE3(int16_t* wires, const uint8_t* comparators,
+                              const std::size_t comparatorCount) {
+    for (std::size_t index = 0; index < comparatorCount; index++) {
+        __m128i* first =
+            reinterpret_cast<__m128i*>(wires + comparators[2 * index] * sortingNetworkLaneCount);
+        __m128i* second = reinterpret_cast<__m128i*>(wires + comparators[2 * index + 1] *
+                                                                 sortingNetworkLaneCount);
+        for (std::size_t part = 0; part < 2; part++) {
+            const __m128i a = _mm_loadu_si128(first + part);
+            const __m128i b = _mm_loadu_si128(second + part);
+            _mm_storeu_si128(first + part, _mm_min_epi16(a, b));
+            _mm_storeu_si128(second + part, _mm_max_epi16(a, b));
+        }
+    }
+}
+
+VDS_SIMD_TARGET("avx2")
+void applySortingNetworkAVX2(int16_t* wires, const uint8_t* comparators,
+                             const std::size_t comparatorCount) {
+    for (std::size_t index = 0; index < comparatorCount; index++) {
+        __m256i* first =
+            reinterpret_cast<__m256i*>(wires + comparators[2 * index] * sortingNetworkLaneCount);
+        __m256i* second = reinterpret_cast<__m256i*>(wires + comparators[2 * index + 1] *
+                                                                 sortingNetworkLaneCount);
+        const __m256i a = _mm256_loadu_si256(first);
+        const __m256i b = _mm256_loadu_si256(second);
+        _mm256_storeu_si256(first, _mm256_min_epi16(a, b));
+        _mm256_storeu_si256(second, _mm256_max_epi16(a, b));
+    }
+}
+
+VDS_SIMD_TARGET("ssse3")
+void applySortingNetworkSSSE3(float* wires, const uint8_t* comparators,
+                              const std::size_t comparatorCount) {
+    for (std::size_t index = 0; index < comparatorCount; index++) {
+        float* first = wires + comparators[2 * index] * sortingNetworkLaneCount;
+        float* second = wires + comparators[2 * index + 1] * sortingNetworkLaneCount;
+        for (std::size_t lane = 0; lane < sortingNetworkLaneCount; lane += 4) {
+            const __m128 a = _mm_loadu_ps(first + lane);
+            const __m128 b = _mm_loadu_ps(second + lane);
+            _mm_storeu_ps(first + lane, _mm_min_ps(a, b));
+            _mm_storeu_ps(second + lane, _mm_max_ps(a, b));
+        }
+    }
+}
+
+VDS_SIMD_TARGET("avx2")
+void applySortingNetworkAVX2(float* wires, const uint8_t* comparators,
+                             const std::size_t comparatorCount) {
+    for (std::size_t index = 0; index < comparatorCount; index++) {
+        float* first = wires + comparators[2 * index] * sortingNetworkLaneCount;
+        float* second = wires + comparators[2 * index + 1] * sortingNetworkLaneCount;
+        for (std::size_t lane = 0; lane < sortingNetworkLaneCount; lane += 8) {
+            const __m256 a = _mm256_loadu_ps(first + lane);
+            const __m256 b = _mm256_loadu_ps(second + lane);
+            _mm256_storeu_ps(first + lane, _mm256_min_ps(a, b));
+            _mm256_storeu_ps(second + lane, _mm256_max_ps(a, b));
+        }
+    }
+}
+
+InstructionSet detectInstructionSet() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int registers[4];
+    __cpuid(registers, 0);
+    const int maximumLeaf = registers[0];
+    __cpuid(registers, 1);
+    const bool ssse3 = (registers[2] & (1 << 9)) != 0;
+    const bool osxsave = (registers[2] & (1 << 27)) != 0;
+    bool avx2 = false;
+    bool avx512 = false;
+    if (maximumLeaf >= 7 && osxsave) {
+        // the operating system has to save the wide registers on context switches
+        const unsigned long long enabledStates = _xgetbv(0);
+        __cpuidex(registers, 7, 0);
+        avx2 = (registers[1] & (1 << 5)) != 0 && (enabledStates & 0x6) == 0x6;
+        avx512 = (registers[1] & (1 << 16)) != 0 && (registers[1] & (1 << 30)) != 0 &&
+                 (enabledStates & 0xE6) == 0xE6;
+    }
+#else
+    __builtin_cpu_init();
+    const bool ssse3 = __builtin_cpu_supports("ssse3");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+    const bool avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+    if (avx512) {
+        return InstructionSet::AVX512;
+    }
+    if (avx2) {
+        return InstructionSet::AVX2;
+    }
+    if (ssse3) {
+        return InstructionSet::SSSE3;
+    }
+    return InstructionSet::Scalar;
+}
+#else
+InstructionSet detectInstructionSet() {
+    return InstructionSet::Scalar;
+}
+#endif
+} // namespace
+
+InstructionSet getInstructionSet() {
+    static const InstructionSet instructionSet = detectInstructionSet();
+    return instructionSet;
+}
+
+const char* getInstructionSetName(const InstructionSet instructionSet) {
+    switch (instructionSet) {
+    case InstructionSet::AVX512:
+        return "AVX-512";
+    case InstructionSet::AVX2:
+        return "AVX2";
+    case InstructionSet::SSSE3:
+        return "SSSE3";
+    case InstructionSet::Scalar:
+    default:
+        return "Scalar";
+    }
+}
+
+void swapBytes(void* data, const std::size_t count, const std::size_t bytesPerValue) {
+    if (bytesPerValue != 2 && bytesPerValue != 4 && bytesPerValue != 8) {
+        return;
+    }
+
+    uint8_t* bytes = static_cast<uint8_t*>(data);
+#ifdef VDS_SIMD_X86
+    switch (getInstructionSet()) {
+    case InstructionSet::AVX512:
+        swapBytesAVX512(bytes, count * bytesPerValue, bytesPerValue);
+        return;
+    case InstructionSet::AVX2:
+        swapBytesAVX2(bytes, count * bytesPerValue, bytesPerValue);
+        return;
+    case InstructionSet::SSSE3:
+        swapBytesSSSE3(bytes, count * bytesPerValue, bytesPerValue);
+        return;
+    case InstructionSet::Scalar:
+    default:
+        break;
+    }
+#endif
+    swapBytesScalar(bytes, count, bytesPerValue);
+}
+
+void widen8To16(const uint8_t* source, uint16_t* destination, const std::size_t count) {
+#ifdef VDS_SIMD_X86
+    switch (getInstructionSet()) {
+    case InstructionSet::AVX512:
+    case InstructionSet::AVX2:
+        widen8To16AVX2(source, destination, count);
+        return;
+    case InstructionSet::SSSE3:
+        widen8To16SSSE3(source, destination, count);
+        return;
+    case InstructionSet::Scalar:
+    default:
+        break;
+    }
+#endif
+    widen8To16Scalar(source, destination, count);
+}
+
+void narrow16To8(const uint16_t* source, uint8_t* destination, const std::size_t count) {
+#ifdef VDS_SIMD_X86
+    switch (getInstructionSet()) {
+    case InstructionSet::AVX512:
+    case InstructionSet::AVX2:
+        narrow16To8AVX2(source, destination, count);
+        return;
+    case InstructionSet::SSSE3:
+        narrow16To8SSSE3(source, destination, count);
+        return;
+    case InstructionSet::Scalar:
+    default:
+        break;
+    }
+#endif
+    narrow16To8Scalar(source, destination, count);
+}
+
+void replaceNonFinite(float* data, const std::size_t count, float& minimum, float& maximum) {
+    minimum = std::numeric_limits<float>::max();
+    maximum = std::numeric_limits<float>::lowest();
+#ifdef VDS_SIMD_X86
+    switch (getInstructionSet()) {
+    case InstructionSet::AVX512:
+    case InstructionSet::AVX2:
+        replaceNonFiniteAVX2(data, count, minimum, maximum);
+        return;
+    case InstructionSet::SSSE3:
+        replaceNonFiniteSSSE3(data, count, minimum, maximum);
+        return;
+    case InstructionSet::Scalar:
+    default:
+        break;
+    }
+#endif
+    replaceNonFiniteScalar(data, count, minimum, maximum);
+}
+
+void applySortingNetwork(int16_t* wires, const uint8_t* comparators,
+                         const std::size_t comparatorCount) {
+#ifdef VDS_SIMD_X86
+    switch (getInstructionSet()) {
+    case InstructionSet::AVX512:
+    case InstructionSet::AVX2:
+        applySortingNetworkAVX2(wires, comparators, comparatorCount);
+        return;
+    case InstructionSet::SSSE3:
+        applySortingNetworkSSSE3(wires, comparators, comparatorCount);
+        return;
+    case InstructionSet::Scalar:
+    default:
+        break;
+    }
+#endif
+    applySortingNetworkScalar(wires, comparators, comparatorCount);
+}
+
+void applySortingNetwork(float* wires, const uint8_t* comparators,
+                         const std::size_t comparatorCount) {
+#ifdef VDS_SIMD_X86
+    switch (getInstructionSet()) {
+    case InstructionSet::AVX512:
+    case InstructionSet::AVX2:
+        applySortingNetworkAVX2(wires, comparators, comparatorCount);
+        return;
+    case InstructionSet::SSSE3:
+        applySortingNetworkSSSE3(wires, comparators, comparatorCount);
+        return;
+    case InstructionSet::Scalar:
+    default:
+        break;
+    }
+#endif
+    applySortingNetworkScalar(wires, comparators, comparatorCount);
+}
+} // namespace VDS::Kernels::Simd
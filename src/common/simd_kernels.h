@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Vectorized versions of the bandwidth bound kernels. The widest instruction set supported by the
+// CPU is detected once at runtime, all functions fall back to scalar code on other CPUs.
+namespace VDS::Kernels::Simd {
+enum class InstructionSet { Scalar, SSSE3, AVX2, AVX512 };
+
+InstructionSet getInstructionSet();
+const char* getInstructionSetName(const InstructionSet instructionSet);
+
+// reverses the byte order of count values of bytesPerValue bytes each (2, 4 or 8)
+void swapBytes(void* data, const std::size_t count, const std::size_t bytesPerValue);
+
+// Full range bit depth conversions, identical to the results of VoxelConverter without window:
+// 8 to 16 bit multiplies by 257, 16 to 8 bit rounds value / 257.
+void widen8To16(const uint8_t* source, uint16_t* destination, const std::size_t count);
+void narrow16To8(const uint16_t* source, uint8_t* destination, const std::size_t count);
+
+// Replaces the values that are not finite, infinity and NaN, by 0. minimum and maximum are set to
+// the range of the resulting values, the lowest and highest float if count is 0.
+void replaceNonFinite(float* data, const std::size_t count, float& minimum, float& maximum);
+
+// Runs a sorting network over 16 lanes at once. wires holds 16 values per wire, wire after wire,
+// comparators holds comparatorCount pairs of wire indices. Each comparator leaves the minimum of
+// both wires on its first and the maximum on its second wire, lane by lane.
+constexpr std::size_t sortingNetworkLaneCount = 16;
+void applySortingNetwork(int16_t* wires, const uint8_t* comparators,
+                         const std::size_t comparatorCount);
+void applySortingNetwork(float* wires, const uint8_t* comparators,
+                         const std::size_t comparatorCount);
+} // namespace VDS::Kernels::Simd
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace VDS {
+// Indexed triangle mesh, vertices shared by several triangles are stored once. Positions are in
+// the units of the volume spacing with the center of the first voxel at the origin, normals have
+// unit length and point outwards. Triangles are counter-clockwise seen from outside.
+struct TriangleMesh {
+    std::vector<std::array<float, 3>> positions;
+    std::vector<std::array<float, 3>> normals;
+    // three vertex indices per triangle
+    std::vector<std::uint32_t> indices;
+
+    bool isEmpty() const {
+        return indices.empty();
+    }
+
+    std::size_t getTriangleCount() const {
+        return indices.size() / 3;
+    }
+};
+} // namespace VDS
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QVector3D>
+#include <array>
 #include <VDTK/common/CommonDataTypes.h>
 
 namespace VDS::Helper {
@@ -21,4 +22,22 @@ inline const QVector3D VolumeSizetoQVector3D(const VDTK::VolumeSize size) {
 inline const QVector3D VolumeSpacingToQVector3D(const VDTK::VolumeSpacing spacing) {
     return QVector3D(spacing.getX(), spacing.getY(), spacing.getZ());
 }
+
+inline const VDTK::VolumeSize ArrayToVolumeSize(const std::array<std::size_t, 3>& size) {
+    return VDTK::VolumeSize(static_cast<uint32_t>(size[0]), static_cast<uint32_t>(size[1]),
+                            static_cast<uint32_t>(size[2]));
+}
+
+inline const VDTK::VolumeSpacing ArrayToVolumeSpacing(const std::array<float, 3>& spacing) {
+    return VDTK::VolumeSpacing(spacing[0], spacing[1], spacing[2]);
+}
+
+inline const std::array<std::size_t, 3> QVector3DToArraySize(const QVector3D size) {
+    return {static_cast<std::size_t>(size.x()), static_cast<std::size_t>(size.y()),
+            static_cast<std::size_t>(size.z())};
+}
+
+inline const std::array<float, 3> QVector3DToArraySpacing(const QVector3D spacing) {
+    return {spacing.x(), spacing.y(), spacing.z()};
+}
 } // namespace VDS::Helper
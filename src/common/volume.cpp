@@ -0,0 +1,162 @@
+#include "volume.h"
+
+#include <atomic>
+#include <cstring>
+
+namespace VDS {
+namespace {
+// more dirty regions get collapsed into their bounding box
+constexpr std::size_t maximumDirtyRegionCount = 16;
+
+// process-wide, copies made by worker threads on behalf of a path count as well
+std::atomic<std::size_t> deepCopyCount{0};
+} // namespace
+
+Volume::Volume()
+    : m_size{0, 0, 0}, m_spacing{1.0f, 1.0f, 1.0f}, m_voxelType{VoxelType::UInt16},
+      m_valueRange{getVoxelTypeRange<uint16_t>()},
+      m_data{std::make_shared<VoxelBuffer>()} {}
+
+Volume::Volume(const std::array<std::size_t, 3>& size, const std::array<float, 3>& spacing,
+               const VoxelType voxelType)
+    : m_size{size}, m_spacing{spacing}, m_voxelType{voxelType},
+      m_valueRange{dispatchVoxelType(voxelType,
+                                     [](auto tag) { return getVoxelTypeRange<decltype(tag)>(); })},
+      m_data{std::make_shared<VoxelBuffer>(size[0] * size[1] * size[2] *
+                                           VDS::getBytesPerVoxel(voxelType))} {}
+
+const std::array<std::size_t, 3>& Volume::getSize() const {
+    return m_size;
+}
+std::size_t Volume::getSizeX() const {
+    return m_size[0];
+}
+std::size_t Volume::getSizeY() const {
+    return m_size[1];
+}
+std::size_t Volume::getSizeZ() const {
+    return m_size[2];
+}
+const std::array<float, 3>& Volume::getSpacing() const {
+    return m_spacing;
+}
+void Volume::setSpacing(const std::array<float, 3>& spacing) {
+    m_spacing = spacing;
+}
+VoxelType Volume::getVoxelType() const {
+    return m_voxelType;
+}
+const ValueRange& Volume::getValueRange() const {
+    return m_valueRange;
+}
+void Volume::setValueRange(const ValueRange& range) {
+    m_valueRange = range;
+}
+std::size_t Volume::getVoxelCount() const {
+    return m_size[0] * m_size[1] * m_size[2];
+}
+std::size_t Volume::getSizeInBytes() const {
+    return m_data ? m_data->size() : 0;
+}
+bool Volume::isEmpty() const {
+    return getSizeInBytes() == 0;
+}
+void* Volume::getRawData() {
+    detach();
+    return m_data ? m_data->data() : nullptr;
+}
+const void* Volume::getRawData() const {
+    return m_data ? m_data->data() : nullptr;
+}
+bool Volume::isShared() const {
+    return m_data && m_data.use_count() > 1;
+}
+std::size_t Volume::getDeepCopyCount() {
+    return deepCopyCount;
+}
+Volume Volume::extractRegion(const VolumeRegion& region) const {
+    const VolumeRegion clampedRegion = region.clamped(m_size);
+    Volume result(clampedRegion.size, m_spacing, m_voxelType);
+    result.setValueRange(m_valueRange);
+
+    const std::size_t bytesPerVoxel = VDS::getBytesPerVoxel(m_voxelType);
+    const std::size_t rowBytes = clampedRegion.size[0] * bytesPerVoxel;
+    for (std::size_t z = 0; z < clampedRegion.size[2]; z++) {
+        for (std::size_t y = 0; y < clampedRegion.size[1]; y++) {
+            const std::size_t sourceIndex =
+                ((clampedRegion.offset[2] + z) * m_size[1] + clampedRegion.offset[1] + y) *
+                    m_size[0] +
+                clampedRegion.offset[0];
+            const std::size_t destinationIndex = (z * clampedRegion.size[1] + y) *
+                                                 clampedRegion.size[0];
+            std::memcpy(result.m_data->data() + destinationIndex * bytesPerVoxel,
+                        m_data->data() + sourceIndex * bytesPerVoxel, rowBytes);
+        }
+    }
+    return result;
+}
+void Volume::insertRegion(const Volume& regionData, const VolumeRegion& region) {
+    const VolumeRegion clampedRegion = region.clamped(m_size);
+    if (clampedRegion.isEmpty() || regionData.m_voxelType != m_voxelType ||
+        regionData.m_size != region.size || clampedRegion.size != region.size) {
+        return;
+    }
+
+    detach();
+    const std::size_t bytesPerVoxel = VDS::getBytesPerVoxel(m_voxelType);
+    const std::size_t rowBytes = region.size[0] * bytesPerVoxel;
+    for (std::size_t z = 0; z < region.size[2]; z++) {
+        for (std::size_t y = 0; y < region.size[1]; y++) {
+            const std::size_t sourceIndex = (z * region.size[1] + y) * region.size[0];
+            const std::size_t destinationIndex =
+                ((region.offset[2] + z) * m_size[1] + region.offset[1] + y) * m_size[0] +
+                region.offset[0];
+            std::memcpy(m_data->data() + destinationIndex * bytesPerVoxel,
+                        regionData.m_data->data() + sourceIndex * bytesPerVoxel, rowBytes);
+        }
+    }
+}
+void Volume::markDirty(const VolumeRegion& region) {
+    VolumeRegion dirtyRegion = region.clamped(m_size);
+    if (dirtyRegion.isEmpty()) {
+        return;
+    }
+
+    // merge with all touching regions until the new region is disjoint from the remaining ones
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (auto it = m_dirtyRegions.begin(); it != m_dirtyRegions.end(); ++it) {
+            if (it->touches(dirtyRegion)) {
+                dirtyRegion = dirtyRegion.merged(*it);
+                m_dirtyRegions.erase(it);
+                merged = true;
+                break;
+            }
+        }
+    }
+    m_dirtyRegions.push_back(dirtyRegion);
+
+    if (m_dirtyRegions.size() > maximumDirtyRegionCount) {
+        VolumeRegion boundingRegion;
+        for (const VolumeRegion& dirty : m_dirtyRegions) {
+            boundingRegion = boundingRegion.merged(dirty);
+        }
+        m_dirtyRegions = {boundingRegion};
+    }
+}
+const std::vector<VolumeRegion>& Volume::getDirtyRegions() const {
+    return m_dirtyRegions;
+}
+void Volume::clearDirtyRegions() {
+    m_dirtyRegions.clear();
+}
+void Volume::detach() {
+    // Only the owner of this volume can copy it, so no other thread can start sharing the data
+    // between the check and the copy.
+    if (isShared()) {
+        m_data = std::make_shared<VoxelBuffer>(*m_data);
+        deepCopyCount++;
+    }
+}
+} // namespace VDS
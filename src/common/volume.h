@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "volume_region.h"
+#include "voxel_buffer.h"
+#include "voxel_type.h"
+
+namespace VDS {
+// In-memory volume data in its native voxel type. Voxels are stored linear with X being the
+// fastest and Z the slowest axis, see BrickedVolume for a layout suited to 3D neighbourhoods.
+//
+// Copies share their voxel data, so a copy is a cheap snapshot that background tasks can read
+// while the original keeps changing. The mutable accessors copy the voxels first if they are
+// shared with another volume. Writing through a pointer obtained before copying the volume
+// changes the copy as well, and volumes that may be shared have to be detached by calling one of
+// the mutable accessors before several threads write into them.
+class Volume {
+public:
+    Volume();
+    Volume(const std::array<std::size_t, 3>& size, const std::array<float, 3>& spacing,
+           const VoxelType voxelType);
+
+    const std::array<std::size_t, 3>& getSize() const;
+    std::size_t getSizeX() const;
+    std::size_t getSizeY() const;
+    std::size_t getSizeZ() const;
+
+    const std::array<float, 3>& getSpacing() const;
+    void setSpacing(const std::array<float, 3>& spacing);
+
+    VoxelType getVoxelType() const;
+
+    // Voxel values mapped to [0, 1] for windowing, rendering and histograms. Defaults to the range
+    // of the voxel type. Floating point volumes should set the range of their data.
+    const ValueRange& getValueRange() const;
+    void setValueRange(const ValueRange& range);
+
+    std::size_t getVoxelCount() const;
+    std::size_t getSizeInBytes() const;
+    bool isEmpty() const;
+
+    void* getRawData();
+    const void* getRawData() const;
+
+    // true if the voxel data is shared with a copy of this volume
+    bool isShared() const;
+    // Number of times any thread copied the voxel data of a shared volume. Allows asserting that a
+    // path like import and upload hands the voxels on without ever copying them, including the
+    // worker threads it fans out to.
+    static std::size_t getDeepCopyCount();
+
+    // Copy of the voxels within region as a volume of the region size
+    Volume extractRegion(const VolumeRegion& region) const;
+    // Copies regionData, which needs the size of region and the voxel type of this volume, into
+    // region. Inserting disjoint regions from several threads at once is safe if the volume is
+    // not shared.
+    void insertRegion(const Volume& regionData, const VolumeRegion& region);
+
+    // Regions modified in place since the last clearDirtyRegions call. Touching regions get merged,
+    // so the list stays short and consumers like the GPU texture and the histogram only need to
+    // process the voxels that actually changed.
+    void markDirty(const VolumeRegion& region);
+    const std::vector<VolumeRegion>& getDirtyRegions() const;
+    void clearDirtyRegions();
+
+    // The non-const accessors detach a shared volume first, which deep copies its voxels and
+    // invalidates pointers obtained from it before. Code handing pointers to several threads
+    // has to detach once up front, e.g. by calling getData, and only compute pointers from there.
+    template <typename T>
+    T* getData() {
+        assert(VoxelTypeOf<T>::value == m_voxelType);
+        return reinterpret_cast<T*>(getRawData());
+    }
+    template <typename T>
+    const T* getData() const {
+        assert(VoxelTypeOf<T>::value == m_voxelType);
+        return reinterpret_cast<const T*>(getRawData());
+    }
+
+    // pointer to the first voxel of the row at (y, z)
+    template <typename T>
+    T* getRow(const std::size_t y, const std::size_t z) {
+        return getData<T>() + (z * m_size[1] + y) * m_size[0];
+    }
+    template <typename T>
+    const T* getRow(const std::size_t y, const std::size_t z) const {
+        return getData<T>() + (z * m_size[1] + y) * m_size[0];
+    }
+
+    // calls function(row, count) for every row of voxels of region that lies within the volume
+    template <typename T, typename Function>
+    void forEachRegionRow(const VolumeRegion& region, Function&& function) const {
+        const VolumeRegion clampedRegion = region.clamped(m_size);
+        if (clampedRegion.isEmpty()) {
+            return;
+        }
+
+        const auto end = clampedRegion.getEnd();
+        for (std::size_t z = clampedRegion.offset[2]; z < end[2]; z++) {
+            for (std::size_t y = clampedRegion.offset[1]; y < end[1]; y++) {
+                function(getRow<T>(y, z) + clampedRegion.offset[0], clampedRegion.size[0]);
+            }
+        }
+    }
+
+private:
+    // gives this volume its own copy of shared voxel data
+    void detach();
+
+    std::array<std::size_t, 3> m_size;
+    std::array<float, 3> m_spacing;
+    VoxelType m_voxelType;
+    ValueRange m_valueRange;
+    // never modified while shared, null for moved-from volumes
+    std::shared_ptr<VoxelBuffer> m_data;
+    std::vector<VolumeRegion> m_dirtyRegions;
+};
+} // namespace VDS
@@ -0,0 +1,90 @@
+#include "volume_brick_ranges.h"
+
+#include <algorithm>
+
+namespace VDS {
+VolumeBrickRanges::VolumeBrickRanges() : m_brickCount{0, 0, 0}, m_brickRanges{} {}
+
+VolumeBrickRanges::VolumeBrickRanges(const Volume& volume)
+    : m_brickCount{computeBrickCount(volume.getSize())} {
+    m_brickRanges.resize(m_brickCount[0] * m_brickCount[1] * m_brickCount[2]);
+
+    update(volume, VolumeRegion{{0, 0, 0}, volume.getSize()});
+}
+
+VolumeBrickRanges::VolumeBrickRanges(const std::array<std::size_t, 3>& brickCount,
+                                     std::vector<ValueRange> brickRanges)
+    : m_brickCount{brickCount}, m_brickRanges{std::move(brickRanges)} {}
+
+std::array<std::size_t, 3>
+VolumeBrickRanges::computeBrickCount(const std::array<std::size_t, 3>& size) {
+    return {(size[0] + brickSize - 1) / brickSize, (size[1] + brickSize - 1) / brickSize,
+            (size[2] + brickSize - 1) / brickSize};
+}
+
+void VolumeBrickRanges::update(const Volume& volume, const VolumeRegion& region) {
+    const VolumeRegion clampedRegion = region.clamped(volume.getSize());
+    if (clampedRegion.isEmpty() || m_brickRanges.empty()) {
+        return;
+    }
+
+    const auto end = clampedRegion.getEnd();
+    for (std::size_t z = clampedRegion.offset[2] / brickSize; z <= (end[2] - 1) / brickSize; z++) {
+        for (std::size_t y = clampedRegion.offset[1] / brickSize; y <= (end[1] - 1) / brickSize;
+             y++) {
+            for (std::size_t x = clampedRegion.offset[0] / brickSize;
+                 x <= (end[0] - 1) / brickSize; x++) {
+                updateBrick(volume, x, y, z);
+            }
+        }
+    }
+}
+
+const std::array<std::size_t, 3>& VolumeBrickRanges::getBrickCount() const {
+    return m_brickCount;
+}
+
+const std::vector<ValueRange>& VolumeBrickRanges::getBrickRanges() const {
+    return m_brickRanges;
+}
+
+const ValueRange& VolumeBrickRanges::getBrickRange(std::size_t x, std::size_t y,
+                                                   std::size_t z) const {
+    return m_brickRanges[(z * m_brickCount[1] + y) * m_brickCount[0] + x];
+}
+
+ValueRange VolumeBrickRanges::getRange() const {
+    if (m_brickRanges.empty()) {
+        return ValueRange{};
+    }
+
+    ValueRange range = m_brickRanges.front();
+    for (const ValueRange& brickRange : m_brickRanges) {
+        range.minimum = std::min(range.minimum, brickRange.minimum);
+        range.maximum = std::max(range.maximum, brickRange.maximum);
+    }
+    return range;
+}
+
+void VolumeBrickRanges::updateBrick(const Volume& volume, std::size_t x, std::size_t y,
+                                    std::size_t z) {
+    const VolumeRegion brick{{x * brickSize, y * brickSize, z * brickSize},
+                             {brickSize, brickSize, brickSize}};
+
+    ValueRange& brickRange = m_brickRanges[(z * m_brickCount[1] + y) * m_brickCount[0] + x];
+    dispatchVoxelType(volume.getVoxelType(), [&](auto tag) {
+        using T = decltype(tag);
+        bool first = true;
+        volume.forEachRegionRow<T>(brick, [&](const T* row, std::size_t count) {
+            const auto [minimum, maximum] = std::minmax_element(row, row + count);
+            if (first) {
+                brickRange = ValueRange{static_cast<float>(*minimum), static_cast<float>(*maximum)};
+                first = false;
+            } else {
+                brickRange.minimum = std::min(brickRange.minimum, static_cast<float>(*minimum));
+                brickRange.maximum = std::max(brickRange.maximum, static_cast<float>(*maximum));
+            }
+        });
+    });
+}
+} // namespace VDS
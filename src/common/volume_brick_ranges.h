@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "volume.h"
+
+namespace VDS {
+// Minimum and maximum voxel value per brick of brickSize^3 voxels. Updating a region only rescans
+// the bricks it touches, so in-place edits do not need another pass over the whole volume.
+class VolumeBrickRanges {
+public:
+    static constexpr std::size_t brickSize = 32;
+
+    VolumeBrickRanges();
+    explicit VolumeBrickRanges(const Volume& volume);
+    // brick ranges computed earlier, e.g. stored in a file
+    VolumeBrickRanges(const std::array<std::size_t, 3>& brickCount,
+                      std::vector<ValueRange> brickRanges);
+
+    static std::array<std::size_t, 3> computeBrickCount(const std::array<std::size_t, 3>& size);
+
+    void update(const Volume& volume, const VolumeRegion& region);
+
+    const std::array<std::size_t, 3>& getBrickCount() const;
+    const std::vector<ValueRange>& getBrickRanges() const;
+    const ValueRange& getBrickRange(std::size_t x, std::size_t y, std::size_t z) const;
+
+    // minimum and maximum over all bricks
+    ValueRange getRange() const;
+
+private:
+    void updateBrick(const Volume& volume, std::size_t x, std::size_t y, std::size_t z);
+
+    std::array<std::size_t, 3> m_brickCount;
+    std::vector<ValueRange> m_brickRanges;
+};
+} // namespace VDS
@@ -0,0 +1,75 @@
+#include "volume_cache.h"
+
+#include <algorithm>
+
+namespace VDS {
+VolumeCache::VolumeCache(std::size_t budgetInBytes)
+    : m_budgetInBytes{budgetInBytes}, m_sizeInBytes{0} {}
+
+bool VolumeCache::take(const std::string& key, CachedVolume& entry) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return takeEntry(key, entry);
+}
+
+void VolumeCache::insert(const std::string& key, CachedVolume&& entry) {
+    // the outdated entry of the same key is released after unlocking
+    CachedVolume outdatedEntry;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    takeEntry(key, outdatedEntry);
+
+    if (entry.volume.isEmpty() || entry.volume.getSizeInBytes() > m_budgetInBytes) {
+        return;
+    }
+
+    m_sizeInBytes += entry.volume.getSizeInBytes();
+    m_entries.emplace_front(key, std::move(entry));
+    evict();
+}
+
+void VolumeCache::setBudget(std::size_t budgetInBytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budgetInBytes = budgetInBytes;
+    evict();
+}
+
+std::size_t VolumeCache::getBudget() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_budgetInBytes;
+}
+
+std::size_t VolumeCache::getSizeInBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_sizeInBytes;
+}
+
+std::size_t VolumeCache::getEntryCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+void VolumeCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_sizeInBytes = 0;
+}
+
+bool VolumeCache::takeEntry(const std::string& key, CachedVolume& entry) {
+    const auto it = std::find_if(m_entries.begin(), m_entries.end(),
+                                 [&key](const auto& cached) { return cached.first == key; });
+    if (it == m_entries.end()) {
+        return false;
+    }
+
+    m_sizeInBytes -= it->second.volume.getSizeInBytes();
+    entry = std::move(it->second);
+    m_entries.erase(it);
+    return true;
+}
+
+void VolumeCache::evict() {
+    while (m_sizeInBytes > m_budgetInBytes && !m_entries.empty()) {
+        m_sizeInBytes -= m_entries.back().second.volume.getSizeInBytes();
+        m_entries.pop_back();
+    }
+}
+} // namespace VDS
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+
+#include "volume.h"
+#include "volume_brick_ranges.h"
+#include "volume_histogram.h"
+
+namespace VDS {
+// Decoded volume together with the data derived from it, so a cached volume can be shown again
+// without another pass over its voxels
+struct CachedVolume {
+    Volume volume;
+    VolumeHistogram histogram;
+    VolumeBrickRanges brickRanges;
+};
+
+// Least recently used cache of decoded volumes within a RAM budget. Entries are moved in and out of
+// the cache, so switching between cached volumes never copies voxel data. All functions can be
+// called from any thread, imports look up their file on a worker while the UI thread caches the
+// volume it replaces.
+class VolumeCache {
+public:
+    static constexpr std::size_t defaultBudgetInBytes = std::size_t{4} << 30;
+
+    explicit VolumeCache(std::size_t budgetInBytes = defaultBudgetInBytes);
+
+    // Moves the entry of key out of the cache. Returns false if there is no such entry.
+    bool take(const std::string& key, CachedVolume& entry);
+    // Adds the entry as most recently used and evicts the least recently used entries until the
+    // cache fits into the budget again. Entries larger than the whole budget are not cached.
+    void insert(const std::string& key, CachedVolume&& entry);
+
+    void setBudget(std::size_t budgetInBytes);
+    std::size_t getBudget() const;
+    std::size_t getSizeInBytes() const;
+    std::size_t getEntryCount() const;
+    void clear();
+
+private:
+    // both expect m_mutex to be locked
+    bool takeEntry(const std::string& key, CachedVolume& entry);
+    void evict();
+
+    mutable std::mutex m_mutex;
+    // most recently used entry first
+    std::list<std::pair<std::string, CachedVolume>> m_entries;
+    std::size_t m_budgetInBytes;
+    std::size_t m_sizeInBytes;
+};
+} // namespace VDS
@@ -0,0 +1,148 @@
+#include "volume_histogram.h"
+#include "volume_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VDS {
+namespace {
+// slab size when streaming a compressed volume, the same RawVolumeIO streams files with
+constexpr std::size_t maximumSlabSizeInBytes = std::size_t{64} << 20;
+} // namespace
+
+VolumeHistogram::VolumeHistogram()
+    : m_voxelType{VoxelType::UInt16}, m_bins{std::make_shared<std::vector<uint64_t>>()} {}
+
+VolumeHistogram::VolumeHistogram(const Volume& volume)
+    : m_voxelType{volume.getVoxelType()}, m_valueRange{volume.getValueRange()},
+      m_bins{std::make_shared<std::vector<uint64_t>>()} {
+    dispatchVoxelType(m_voxelType, [&](auto tag) {
+        using T = decltype(tag);
+        m_bins->assign(Kernels::getValueCount<T>(), 0);
+        Kernels::accumulateHistogram(volume.getData<T>(), volume.getVoxelCount(), m_valueRange,
+                                     *m_bins);
+    });
+}
+
+VolumeHistogram::VolumeHistogram(const CompressedVolume& volume)
+    : m_voxelType{volume.getVoxelType()}, m_valueRange{volume.getValueRange()},
+      m_bins{std::make_shared<std::vector<uint64_t>>()} {
+    dispatchVoxelType(m_voxelType, [&](auto tag) {
+        using T = decltype(tag);
+        m_bins->assign(Kernels::getValueCount<T>(), 0);
+    });
+
+    const std::size_t sizeZ = volume.getSize()[2];
+    const std::size_t slabSliceCount = volume.getSlabSliceCount(maximumSlabSizeInBytes);
+    Volume slab;
+    for (std::size_t firstSlice = 0; firstSlice < sizeZ; firstSlice += slabSliceCount) {
+        if (!volume.readSlab(firstSlice, std::min(slabSliceCount, sizeZ - firstSlice), slab)) {
+            m_bins->assign(m_bins->size(), 0);
+            return;
+        }
+        dispatchVoxelType(m_voxelType, [&](auto tag) {
+            using T = decltype(tag);
+            Kernels::accumulateHistogram(slab.getData<T>(), slab.getVoxelCount(), m_valueRange,
+                                         *m_bins);
+        });
+    }
+}
+
+VolumeHistogram::VolumeHistogram(const VoxelType voxelType, const ValueRange& valueRange,
+                                 std::vector<uint64_t> bins)
+    : m_voxelType{voxelType}, m_valueRange{valueRange},
+      m_bins{std::make_shared<std::vector<uint64_t>>(std::move(bins))} {}
+
+VoxelType VolumeHistogram::getVoxelType() const {
+    return m_voxelType;
+}
+
+const ValueRange& VolumeHistogram::getValueRange() const {
+    return m_valueRange;
+}
+
+const std::vector<uint64_t>& VolumeHistogram::getBins() const {
+    static const std::vector<uint64_t> noBins;
+    return m_bins ? *m_bins : noBins;
+}
+
+void VolumeHistogram::removeRegion(const Volume& volume, const VolumeRegion& region) {
+    if (volume.getVoxelType() != m_voxelType || getBins().empty()) {
+        return;
+    }
+
+    std::vector<uint64_t>& bins = getMutableBins();
+    dispatchVoxelType(m_voxelType, [&](auto tag) {
+        using T = decltype(tag);
+        volume.forEachRegionRow<T>(region, [&](const T* row, std::size_t count) {
+            Kernels::removeFromHistogram(row, count, m_valueRange, bins);
+        });
+    });
+}
+
+void VolumeHistogram::addRegion(const Volume& volume, const VolumeRegion& region) {
+    if (volume.getVoxelType() != m_voxelType || getBins().empty()) {
+        return;
+    }
+
+    std::vector<uint64_t>& bins = getMutableBins();
+    dispatchVoxelType(m_voxelType, [&](auto tag) {
+        using T = decltype(tag);
+        volume.forEachRegionRow<T>(region, [&](const T* row, std::size_t count) {
+            Kernels::accumulateHistogram(row, count, m_valueRange, bins);
+        });
+    });
+}
+
+DisplayHistogram VolumeHistogram::getDisplayHistogram(bool ignoreBorders) const {
+    return scaleToDisplayRange(getBins(), ignoreBorders);
+}
+
+DisplayHistogram VolumeHistogram::getDisplayHistogram(const ValueWindowSettings& window,
+                                                      bool ignoreBorders) const {
+    const std::vector<uint64_t>& bins = getBins();
+    std::vector<uint64_t> windowedBins(bins.size(), 0);
+    if (bins.size() < 2) {
+        return scaleToDisplayRange(std::move(windowedBins), ignoreBorders);
+    }
+
+    // bins are evenly distributed over the normalized value range
+    const float lastBin = static_cast<float>(bins.size() - 1);
+    for (std::size_t bin = 0; bin < bins.size(); bin++) {
+        const float windowed = Kernels::applyWindow(static_cast<float>(bin) / lastBin, window);
+        windowedBins[static_cast<std::size_t>(std::lround(windowed * lastBin))] += bins[bin];
+    }
+
+    return scaleToDisplayRange(std::move(windowedBins), ignoreBorders);
+}
+
+DisplayHistogram VolumeHistogram::scaleToDisplayRange(std::vector<uint64_t> bins,
+                                                      bool ignoreBorders) {
+    if (bins.empty()) {
+        return std::make_shared<const std::vector<uint16_t>>(UINT16_MAX + 1, 0);
+    }
+
+    if (ignoreBorders) {
+        bins.front() = 0;
+        bins.back() = 0;
+    }
+
+    const uint64_t maximum = std::max<uint64_t>(*std::max_element(bins.begin(), bins.end()), 1);
+
+    std::vector<uint16_t> histogram(bins.size());
+    std::transform(bins.begin(), bins.end(), histogram.begin(), [maximum](uint64_t count) {
+        return static_cast<uint16_t>(count * UINT16_MAX / maximum);
+    });
+
+    return std::make_shared<const std::vector<uint16_t>>(std::move(histogram));
+}
+
+std::vector<uint64_t>& VolumeHistogram::getMutableBins() {
+    if (!m_bins) {
+        m_bins = std::make_shared<std::vector<uint64_t>>();
+    } else if (m_bins.use_count() > 1) {
+        m_bins = std::make_shared<std::vector<uint64_t>>(*m_bins);
+    }
+    return *m_bins;
+}
+} // namespace VDS
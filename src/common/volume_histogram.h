@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "compressed_volume.h"
+#include "renderer/shader/shader_settings.h"
+#include "volume.h"
+
+namespace VDS {
+// Bin counts scaled to the uint16_t range as expected by HistogramViewGL. Shared read-only between
+// the job computing it and the view, so passing it through queued signals copies no bins.
+using DisplayHistogram = std::shared_ptr<const std::vector<uint16_t>>;
+
+// Voxel value histogram with one bin per representable value of the voxel type (256 bins for 8
+// bit, 65536 bins for 16 bit volumes). Floating point volumes are binned into 65536 bins over
+// their value range. Windowed histograms are derived from the raw bins, so changing the value
+// window does not require another pass over the volume. Copies share their bins until one of
+// them gets updated, so background jobs can hold a snapshot cheaply.
+class VolumeHistogram {
+public:
+    VolumeHistogram();
+    explicit VolumeHistogram(const Volume& volume);
+    // streams the volume slab by slab, so it never gets decompressed as a whole
+    explicit VolumeHistogram(const CompressedVolume& volume);
+    // histogram computed earlier, e.g. stored in a file
+    VolumeHistogram(const VoxelType voxelType, const ValueRange& valueRange,
+                    std::vector<uint64_t> bins);
+
+    VoxelType getVoxelType() const;
+    const ValueRange& getValueRange() const;
+    const std::vector<uint64_t>& getBins() const;
+
+    // Incremental updates for in-place edits: remove the voxels of a region before modifying them
+    // and add them again afterwards. Costs are proportional to the region size. Voxels of floating
+    // point volumes outside the histogram value range are counted in the border bins.
+    void removeRegion(const Volume& volume, const VolumeRegion& region);
+    void addRegion(const Volume& volume, const VolumeRegion& region);
+
+    // ignoreBorders removes the first and last bin before scaling, since they are crowded by
+    // linear windowing.
+    DisplayHistogram getDisplayHistogram(bool ignoreBorders) const;
+    DisplayHistogram getDisplayHistogram(const ValueWindowSettings& window,
+                                         bool ignoreBorders) const;
+
+private:
+    static DisplayHistogram scaleToDisplayRange(std::vector<uint64_t> bins, bool ignoreBorders);
+
+    // copies the bins first if they are shared with another histogram
+    std::vector<uint64_t>& getMutableBins();
+
+    VoxelType m_voxelType;
+    ValueRange m_valueRange;
+    // never modified while shared, null for moved-from histograms
+    std::shared_ptr<std::vector<uint64_t>> m_bins;
+};
+} // namespace VDS
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "renderer/shader/shader_settings.h"
+#include "simd_kernels.h"
+#include "voxel_type.h"
+
+// Per voxel kernels templated over the voxel type, so volumes never get widened to another type.
+namespace VDS::Kernels {
+// CPU version of the GLSL window functions in shader_code_constants.h. Input and output are
+// normalized to [0, 1], so the same window can be applied to every voxel type.
+inline float applyWindow(const float value, const ValueWindowSettings& window) {
+    const float shiftedValue = value + window.valueWindowOffset;
+
+    switch (window.method) {
+    case WindowingMethod::Sigmoid: {
+        const float result =
+            1.0f / (1.0f + std::exp(-4.0f * ((shiftedValue - window.valueWindowCenter) /
+                                              window.valueWindowWidth)));
+        return std::clamp(result, 0.0f, 1.0f);
+    }
+    case WindowingMethod::LinearExact:
+    case WindowingMethod::Linear:
+    default: {
+        // the default linear window shifts center and width by half a 16 bit step
+        const float step = window.method == WindowingMethod::Linear ? 1.0f / UINT16_MAX : 0.0f;
+        const float center = window.valueWindowCenter - step * 0.5f;
+        const float width = window.valueWindowWidth - step;
+
+        const float lowerBorder = center - width * 0.5f;
+        const float upperBorder = center + width * 0.5f;
+
+        if (shiftedValue <= lowerBorder) {
+            return 0.0f;
+        }
+        if (shiftedValue > upperBorder) {
+            return 1.0f;
+        }
+        return std::clamp((shiftedValue - center) / width + 0.5f, 0.0f, 1.0f);
+    }
+    }
+}
+
+template <typename T>
+float normalizeVoxel(const T value, const ValueRange& range) {
+    return (static_cast<float>(value) - range.minimum) / (range.maximum - range.minimum);
+}
+
+template <typename T>
+T denormalizeVoxel(const float value, const ValueRange& range) {
+    const float clamped = std::clamp(value, 0.0f, 1.0f);
+    const float denormalized = range.minimum + clamped * (range.maximum - range.minimum);
+    if constexpr (std::is_integral_v<T>) {
+        return static_cast<T>(std::lround(denormalized));
+    } else {
+        return static_cast<T>(denormalized);
+    }
+}
+
+// Number of distinct values of an integer voxel type. Histograms of floating point volumes use as
+// many bins as 16 bit volumes.
+template <typename T>
+constexpr std::size_t getValueCount() {
+    if constexpr (std::is_integral_v<T> && sizeof(T) == 1) {
+        return 256;
+    } else {
+        return 65536;
+    }
+}
+
+// position of an integer value within all representable values of its type
+template <typename T>
+std::size_t getValueIndex(const T value) {
+    static_assert(std::is_integral_v<T>);
+    return static_cast<std::size_t>(static_cast<int32_t>(value) - std::numeric_limits<T>::lowest());
+}
+
+template <typename T>
+std::size_t getHistogramBin(const T value, const ValueRange& range) {
+    if constexpr (std::is_integral_v<T>) {
+        return getValueIndex(value);
+    } else {
+        const float bin = normalizeVoxel(value, range) * (getValueCount<T>() - 1);
+        return static_cast<std::size_t>(
+            std::lround(std::clamp(bin, 0.0f, static_cast<float>(getValueCount<T>() - 1))));
+    }
+}
+
+// bins has to contain getValueCount<T>() entries
+template <typename T>
+void accumulateHistogram(const T* data, const std::size_t count, const ValueRange& range,
+                         std::vector<uint64_t>& bins) {
+    for (std::size_t index = 0; index < count; index++) {
+        bins[getHistogramBin(data[index], range)]++;
+    }
+}
+
+// inverse of accumulateHistogram, used to remove voxels before they get modified
+template <typename T>
+void removeFromHistogram(const T* data, const std::size_t count, const ValueRange& range,
+                         std::vector<uint64_t>& bins) {
+    for (std::size_t index = 0; index < count; index++) {
+        bins[getHistogramBin(data[index], range)]--;
+    }
+}
+
+template <typename T>
+ValueRange computeValueRange(const T* data, const std::size_t count) {
+    if (count == 0) {
+        return getVoxelTypeRange<T>();
+    }
+
+    const auto [minimum, maximum] = std::minmax_element(data, data + count);
+    ValueRange range{static_cast<float>(*minimum), static_cast<float>(*maximum)};
+    // avoid a division by zero for constant volumes
+    if (range.maximum <= range.minimum) {
+        range.maximum = range.minimum + 1.0f;
+    }
+    return range;
+}
+
+template <typename T>
+void swapEndianness(T* data, const std::size_t count) {
+    if constexpr (sizeof(T) > 1) {
+        Simd::swapBytes(data, count, sizeof(T));
+    }
+}
+
+// Maps voxels from the value range of the source to the full range of Destination and optionally
+// applies a value window on the way. Integer sources are converted through a lookup table with one
+// entry per representable value.
+template <typename Source, typename Destination>
+class VoxelConverter {
+public:
+    VoxelConverter(const ValueRange& sourceRange, const ValueWindowSettings& window)
+        : m_sourceRange{sourceRange}, m_destinationRange{getVoxelTypeRange<Destination>()},
+          m_window{window} {
+        const ValueRange fullRange = getVoxelTypeRange<Source>();
+        m_fullRangeWithoutWindow = !window.enabled && sourceRange.minimum == fullRange.minimum &&
+                                   sourceRange.maximum == fullRange.maximum;
+
+        if constexpr (std::is_integral_v<Source>) {
+            m_lookupTable.resize(getValueCount<Source>());
+            for (std::size_t index = 0; index < m_lookupTable.size(); index++) {
+                const Source value = static_cast<Source>(
+                    static_cast<int32_t>(index) + std::numeric_limits<Source>::lowest());
+                m_lookupTable[index] = convertVoxel(value);
+            }
+        }
+    }
+
+    void convert(const Source* source, Destination* destination, const std::size_t count) const {
+        if constexpr (std::is_same_v<Source, Destination>) {
+            if (!m_window.enabled) {
+                std::copy(source, source + count, destination);
+                return;
+            }
+        }
+        // plain bit depth changes are vectorized instead of going through the lookup table
+        if constexpr (std::is_same_v<Source, uint8_t> && std::is_same_v<Destination, uint16_t>) {
+            if (m_fullRangeWithoutWindow) {
+                Simd::widen8To16(source, destination, count);
+                return;
+            }
+        }
+        if constexpr (std::is_same_v<Source, uint16_t> && std::is_same_v<Destination, uint8_t>) {
+            if (m_fullRangeWithoutWindow) {
+                Simd::narrow16To8(source, destination, count);
+                return;
+            }
+        }
+
+        for (std::size_t index = 0; index < count; index++) {
+            if constexpr (std::is_integral_v<Source>) {
+                destination[index] = m_lookupTable[getValueIndex(source[index])];
+            } else {
+                destination[index] = convertVoxel(source[index]);
+            }
+        }
+    }
+
+private:
+    Destination convertVoxel(const Source value) const {
+        float normalized = normalizeVoxel(value, m_sourceRange);
+        if (m_window.enabled) {
+            normalized = applyWindow(normalized, m_window);
+        }
+        return denormalizeVoxel<Destination>(normalized, m_destinationRange);
+    }
+
+    ValueRange m_sourceRange;
+    ValueRange m_destinationRange;
+    ValueWindowSettings m_window;
+    bool m_fullRangeWithoutWindow;
+    std::vector<Destination> m_lookupTable;
+};
+} // namespace VDS::Kernels
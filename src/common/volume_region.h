@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+namespace VDS {
+// Axis aligned box of voxels within a volume, given by its first voxel and its size per axis
+struct VolumeRegion {
+    std::array<std::size_t, 3> offset = {0, 0, 0};
+    std::array<std::size_t, 3> size = {0, 0, 0};
+
+    bool isEmpty() const {
+        return size[0] == 0 || size[1] == 0 || size[2] == 0;
+    }
+
+    std::size_t getVoxelCount() const {
+        return size[0] * size[1] * size[2];
+    }
+
+    // first voxel behind the region per axis
+    std::array<std::size_t, 3> getEnd() const {
+        return {offset[0] + size[0], offset[1] + size[1], offset[2] + size[2]};
+    }
+
+    // True if both regions overlap or share part of a face, i.e. they overlap along two axes and
+    // overlap or are adjacent along the third. Regions meeting only at an edge or a corner do not
+    // touch, their bounding box could be far larger than both of them.
+    bool touches(const VolumeRegion& other) const {
+        const auto end = getEnd();
+        const auto otherEnd = other.getEnd();
+        std::size_t overlappingAxisCount = 0;
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            if (offset[axis] > otherEnd[axis] || other.offset[axis] > end[axis]) {
+                return false;
+            }
+            if (offset[axis] < otherEnd[axis] && other.offset[axis] < end[axis]) {
+                overlappingAxisCount++;
+            }
+        }
+        return overlappingAxisCount >= 2;
+    }
+
+    // smallest region containing both regions
+    VolumeRegion merged(const VolumeRegion& other) const {
+        if (isEmpty()) {
+            return other;
+        }
+        if (other.isEmpty()) {
+            return *this;
+        }
+
+        const auto end = getEnd();
+        const auto otherEnd = other.getEnd();
+        VolumeRegion result;
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            result.offset[axis] = std::min(offset[axis], other.offset[axis]);
+            result.size[axis] = std::max(end[axis], otherEnd[axis]) - result.offset[axis];
+        }
+        return result;
+    }
+
+    // part of the region that lies within a volume of the given size
+    VolumeRegion clamped(const std::array<std::size_t, 3>& volumeSize) const {
+        VolumeRegion result;
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            result.offset[axis] = std::min(offset[axis], volumeSize[axis]);
+            result.size[axis] = std::min(size[axis], volumeSize[axis] - result.offset[axis]);
+        }
+        return result;
+    }
+};
+} // namespace VDS
@@ -0,0 +1,161 @@
+#include "voxel_buffer.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <numeric>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace VDS {
+namespace {
+// smallest page size of the supported systems, every page gets touched once
+constexpr std::size_t pageSize = 4096;
+
+std::atomic<bool> pageMappingEnabled{true};
+
+// calls function(offset, size) for the huge page sized chunks of a buffer in parallel
+template <typename Function>
+void forEachChunk(const std::size_t size, Function&& function) {
+    std::vector<std::size_t> chunks((size + VoxelBuffer::hugePageSize - 1) /
+                                    VoxelBuffer::hugePageSize);
+    std::iota(chunks.begin(), chunks.end(), 0);
+    QtConcurrent::blockingMap(chunks, [&](const std::size_t chunk) {
+        const std::size_t offset = chunk * VoxelBuffer::hugePageSize;
+        function(offset, std::min(VoxelBuffer::hugePageSize, size - offset));
+    });
+}
+} // namespace
+
+VoxelBuffer::VoxelBuffer(const std::size_t size) : m_data{nullptr}, m_size{size}, m_mappedSize{0} {
+    allocate();
+
+    if (m_mappedSize > 0) {
+        // the system maps a zeroed page on the first write, so writing zeros only decides which
+        // thread, and thereby which NUMA node, the page belongs to
+        forEachChunk(m_size, [this](const std::size_t offset, const std::size_t size) {
+            for (std::size_t page = 0; page < size; page += pageSize) {
+                m_data[offset + page] = 0;
+            }
+        });
+    } else if (m_size > 0) {
+        std::memset(m_data, 0, m_size);
+    }
+}
+
+VoxelBuffer::VoxelBuffer(const VoxelBuffer& other)
+    : m_data{nullptr}, m_size{other.m_size}, m_mappedSize{0} {
+    allocate();
+
+    if (m_mappedSize > 0) {
+        forEachChunk(m_size, [&](const std::size_t offset, const std::size_t size) {
+            std::memcpy(m_data + offset, other.m_data + offset, size);
+        });
+    } else if (m_size > 0) {
+        std::memcpy(m_data, other.m_data, m_size);
+    }
+}
+
+VoxelBuffer::~VoxelBuffer() {
+    release();
+}
+
+uint8_t* VoxelBuffer::data() {
+    return m_data;
+}
+
+const uint8_t* VoxelBuffer::data() const {
+    return m_data;
+}
+
+std::size_t VoxelBuffer::size() const {
+    return m_size;
+}
+
+bool VoxelBuffer::empty() const {
+    return m_size == 0;
+}
+
+void VoxelBuffer::setPageMappingEnabled(const bool enabled) {
+    pageMappingEnabled = enabled;
+}
+
+bool VoxelBuffer::isPageMappingEnabled() {
+    return pageMappingEnabled;
+}
+
+void VoxelBuffer::allocate() {
+    if (m_size == 0) {
+        return;
+    }
+
+    if (pageMappingEnabled && m_size >= hugePageSize) {
+        // whole huge pages, so the end of the buffer can be backed by a huge page as well
+        const std::size_t mappedSize = (m_size + hugePageSize - 1) / hugePageSize * hugePageSize;
+#ifdef _WIN32
+        // large pages on Windows need a privilege most users do not have, so only the zeroed pages
+        // and the parallel first touch apply there
+        void* memory = VirtualAlloc(nullptr, mappedSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (memory != nullptr) {
+            m_data = static_cast<uint8_t*>(memory);
+            m_mappedSize = mappedSize;
+            return;
+        }
+#else
+        // one huge page more than needed, so the start can be aligned to a huge page
+        void* memory = mmap(nullptr, mappedSize + hugePageSize, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory != MAP_FAILED) {
+            const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(memory);
+            const std::uintptr_t alignedAddress =
+                (address + hugePageSize - 1) / hugePageSize * hugePageSize;
+            const std::size_t head = alignedAddress - address;
+            if (head > 0) {
+                munmap(memory, head);
+            }
+            if (hugePageSize - head > 0) {
+                munmap(reinterpret_cast<void*>(alignedAddress + mappedSize), hugePageSize - head);
+            }
+
+            m_data = reinterpret_cast<uint8_t*>(alignedAddress);
+            m_mappedSize = mappedSize;
+#ifdef MADV_HUGEPAGE
+            // only a hint, without transparent huge pages the buffer uses regular pages
+            madvise(m_data, m_mappedSize, MADV_HUGEPAGE);
+#endif
+            return;
+        }
+#endif
+    }
+
+    m_data = static_cast<uint8_t*>(::operator new(m_size, std::align_val_t{cacheLineSize}));
+}
+
+void VoxelBuffer::release() {
+    if (m_data == nullptr) {
+        return;
+    }
+
+    if (m_mappedSize > 0) {
+#ifdef _WIN32
+        VirtualFree(m_data, 0, MEM_RELEASE);
+#else
+        munmap(m_data, m_mappedSize);
+#endif
+    } else {
+        ::operator delete(m_data, std::align_val_t{cacheLineSize});
+    }
+    m_data = nullptr;
+}
+} // namespace VDS
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace VDS {
+// Zero-initialized memory for voxel data. Large buffers are mapped directly from the operating
+// system aligned to huge pages and marked for transparent huge pages, which reduces TLB misses when
+// striding along Y and Z. The pages come zeroed from the system, so they are not cleared again,
+// and they are first touched in parallel, which spreads them across the NUMA nodes of the threads
+// processing the volume afterwards. Small buffers are allocated from the heap with cache line
+// alignment.
+class VoxelBuffer {
+public:
+    static constexpr std::size_t cacheLineSize = 64;
+    static constexpr std::size_t hugePageSize = std::size_t{2} << 20;
+
+    explicit VoxelBuffer(const std::size_t size = 0);
+    // copies in parallel, the pages of the copy are first touched by the copying threads
+    VoxelBuffer(const VoxelBuffer& other);
+    VoxelBuffer& operator=(const VoxelBuffer&) = delete;
+    ~VoxelBuffer();
+
+    uint8_t* data();
+    const uint8_t* data() const;
+    std::size_t size() const;
+    bool empty() const;
+
+    // Large buffers fall back to the heap if disabled, e.g. to compare the performance of both.
+    // Only affects buffers allocated afterwards. Disabled at startup by VDS_HEAP_VOXELS=1.
+    static void setPageMappingEnabled(const bool enabled);
+    static bool isPageMappingEnabled();
+
+private:
+    // allocates without initializing heap memory, mapped pages are zero anyway
+    void allocate();
+    void release();
+
+    uint8_t* m_data;
+    std::size_t m_size;
+    // size of the mapping, 0 for heap memory
+    std::size_t m_mappedSize;
+};
+} // namespace VDS
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+namespace VDS {
+// Storage type of a single voxel. Volumes keep their native type in RAM and on the GPU instead of
+// being widened to 16 bit.
+enum class VoxelType { UInt8, UInt16, Int16, Float32 };
+
+template <typename T>
+struct VoxelTypeOf;
+
+template <>
+struct VoxelTypeOf<uint8_t> {
+    static constexpr VoxelType value = VoxelType::UInt8;
+};
+
+template <>
+struct VoxelTypeOf<uint16_t> {
+    static constexpr VoxelType value = VoxelType::UInt16;
+};
+
+template <>
+struct VoxelTypeOf<int16_t> {
+    static constexpr VoxelType value = VoxelType::Int16;
+};
+
+template <>
+struct VoxelTypeOf<float> {
+    static constexpr VoxelType value = VoxelType::Float32;
+};
+
+// Range of voxel values that gets mapped to [0, 1] for windowing, rendering and histograms
+struct ValueRange {
+    float minimum = 0.0f;
+    float maximum = 1.0f;
+};
+
+inline std::size_t getBytesPerVoxel(const VoxelType type) {
+    switch (type) {
+    case VoxelType::UInt8:
+        return sizeof(uint8_t);
+    case VoxelType::Int16:
+        return sizeof(int16_t);
+    case VoxelType::Float32:
+        return sizeof(float);
+    case VoxelType::UInt16:
+    default:
+        return sizeof(uint16_t);
+    }
+}
+
+inline uint8_t getBitsPerVoxel(const VoxelType type) {
+    return static_cast<uint8_t>(getBytesPerVoxel(type) * 8);
+}
+
+// unsigned integer type with the given bit depth
+inline VoxelType getVoxelTypeFromBitsPerVoxel(const uint8_t bitsPerVoxel) {
+    return bitsPerVoxel == 8 ? VoxelType::UInt8 : VoxelType::UInt16;
+}
+
+// names used in the recent files list
+inline std::string getVoxelTypeName(const VoxelType type) {
+    switch (type) {
+    case VoxelType::UInt8:
+        return "uint8";
+    case VoxelType::Int16:
+        return "int16";
+    case VoxelType::Float32:
+        return "float32";
+    case VoxelType::UInt16:
+    default:
+        return "uint16";
+    }
+}
+
+inline VoxelType getVoxelTypeFromName(const std::string& name) {
+    if (name == "uint8") {
+        return VoxelType::UInt8;
+    }
+    if (name == "int16") {
+        return VoxelType::Int16;
+    }
+    if (name == "float32") {
+        return VoxelType::Float32;
+    }
+    return VoxelType::UInt16;
+}
+
+// Calls function with a default constructed value of the C++ type that matches the voxel type, so
+// templated kernels can be instantiated for every supported type:
+//     dispatchVoxelType(type, [&](auto tag) { using T = decltype(tag); ... });
+template <typename Function>
+decltype(auto) dispatchVoxelType(const VoxelType type, Function&& function) {
+    switch (type) {
+    case VoxelType::UInt8:
+        return function(uint8_t{});
+    case VoxelType::Int16:
+        return function(int16_t{});
+    case VoxelType::Float32:
+        return function(float{});
+    case VoxelType::UInt16:
+    default:
+        return function(uint16_t{});
+    }
+}
+
+// Integer types map their full value range to [0, 1]. Floating point volumes use the value range of
+// their data instead, see Volume::getValueRange.
+template <typename T>
+constexpr ValueRange getVoxelTypeRange() {
+    if constexpr (std::is_integral_v<T>) {
+        return ValueRange{static_cast<float>(std::numeric_limits<T>::lowest()),
+                          static_cast<float>(std::numeric_limits<T>::max())};
+    } else {
+        return ValueRange{0.0f, 1.0f};
+    }
+}
+} // namespace VDS
@@ -0,0 +1,152 @@
+#include "derived_data_cache.h"
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFile>
+
+#include <algorithm>
+#include <vector>
+
+namespace VDS::DerivedDataCache {
+namespace {
+constexpr quint32 fileMagic = 0x56445344; // "VDSD"
+constexpr quint32 fileVersion = 1;
+constexpr int compressionLevel = 1;
+
+std::filesystem::path getEntryPath(const std::string& key) {
+    const QByteArray hash =
+        QCryptographicHash::hash(QByteArray::fromStdString(key), QCryptographicHash::Sha1);
+    return getCacheDirectory() / (hash.toHex().toStdString() + ".vdsd");
+}
+
+void removeOldestEntries() {
+    std::error_code error;
+    std::vector<std::filesystem::directory_entry> entries;
+    for (const auto& entry : std::filesystem::directory_iterator(getCacheDirectory(), error)) {
+        if (entry.path().extension() == ".vdsd") {
+            entries.push_back(entry);
+        }
+    }
+    if (entries.size() <= maximumEntryCount) {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        std::error_code error;
+        return a.last_write_time(error) < b.last_write_time(error);
+    });
+    for (std::size_t index = 0; index < entries.size() - maximumEntryCount; index++) {
+        std::filesystem::remove(entries[index].path(), error);
+    }
+}
+} // namespace
+
+std::filesystem::path getCacheDirectory() {
+    // next to the recent files list
+    return std::filesystem::path("derivedDataCache");
+}
+
+bool loadDerivedData(const std::string& key, const Volume& volume, VolumeHistogram& histogram,
+                     VolumeBrickRanges& brickRanges) {
+    QFile file(QString::fromStdString(getEntryPath(key).string()));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const QByteArray data = qUncompress(file.readAll());
+    QDataStream stream(data);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    QByteArray storedKey;
+    stream >> magic >> version >> storedKey;
+    // the file name is only a hash of the key
+    if (magic != fileMagic || version != fileVersion || storedKey.toStdString() != key) {
+        return false;
+    }
+
+    quint32 voxelType = 0;
+    std::array<quint64, 3> size{};
+    ValueRange valueRange;
+    stream >> voxelType >> size[0] >> size[1] >> size[2];
+    stream >> valueRange.minimum >> valueRange.maximum;
+    if (static_cast<VoxelType>(voxelType) != volume.getVoxelType() ||
+        size[0] != volume.getSizeX() || size[1] != volume.getSizeY() ||
+        size[2] != volume.getSizeZ() || valueRange.minimum != volume.getValueRange().minimum ||
+        valueRange.maximum != volume.getValueRange().maximum) {
+        return false;
+    }
+
+    quint64 binCount = 0;
+    stream >> binCount;
+    std::vector<uint64_t> bins(binCount);
+    for (uint64_t& bin : bins) {
+        quint64 value = 0;
+        stream >> value;
+        bin = value;
+    }
+
+    std::array<quint64, 3> brickCount{};
+    stream >> brickCount[0] >> brickCount[1] >> brickCount[2];
+    const std::array<std::size_t, 3> expectedBrickCount =
+        VolumeBrickRanges::computeBrickCount(volume.getSize());
+    if (brickCount[0] != expectedBrickCount[0] || brickCount[1] != expectedBrickCount[1] ||
+        brickCount[2] != expectedBrickCount[2]) {
+        return false;
+    }
+    std::vector<ValueRange> ranges(brickCount[0] * brickCount[1] * brickCount[2]);
+    for (ValueRange& range : ranges) {
+        stream >> range.minimum >> range.maximum;
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    histogram = VolumeHistogram(volume.getVoxelType(), volume.getValueRange(), std::move(bins));
+    brickRanges = VolumeBrickRanges(expectedBrickCount, std::move(ranges));
+    return true;
+}
+
+bool storeDerivedData(const std::string& key, const Volume& volume,
+                      const VolumeHistogram& histogram, const VolumeBrickRanges& brickRanges) {
+    std::error_code error;
+    std::filesystem::create_directories(getCacheDirectory(), error);
+
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    stream << fileMagic << fileVersion << QByteArray::fromStdString(key);
+    stream << static_cast<quint32>(volume.getVoxelType());
+    for (const std::size_t size : volume.getSize()) {
+        stream << static_cast<quint64>(size);
+    }
+    stream << volume.getValueRange().minimum << volume.getValueRange().maximum;
+
+    stream << static_cast<quint64>(histogram.getBins().size());
+    for (const uint64_t bin : histogram.getBins()) {
+        stream << static_cast<quint64>(bin);
+    }
+
+    for (const std::size_t count : brickRanges.getBrickCount()) {
+        stream << static_cast<quint64>(count);
+    }
+    for (const ValueRange& range : brickRanges.getBrickRanges()) {
+        stream << range.minimum << range.maximum;
+    }
+
+    // most histogram bins are empty
+    QFile file(QString::fromStdString(getEntryPath(key).string()));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        file.write(qCompress(data, compressionLevel)) < 0) {
+        return false;
+    }
+    file.close();
+
+    removeOldestEntries();
+    return true;
+}
+} // namespace VDS::DerivedDataCache
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include "common/volume.h"
+#include "common/volume_brick_ranges.h"
+#include "common/volume_histogram.h"
+
+// Sidecar files holding the data derived from an imported volume, so reopening a file skips the
+// pass over its voxels. Entries are identified by ImportItem::getCacheKey(), which changes with the
+// import parameters and whenever the file gets modified.
+namespace VDS::DerivedDataCache {
+constexpr std::size_t maximumEntryCount = 256;
+
+std::filesystem::path getCacheDirectory();
+
+// Returns false if there is no entry for key or it does not match the voxel type, size and value
+// range of volume.
+bool loadDerivedData(const std::string& key, const Volume& volume, VolumeHistogram& histogram,
+                     VolumeBrickRanges& brickRanges);
+// Removes the least recently written entries once there are more than maximumEntryCount.
+bool storeDerivedData(const std::string& key, const Volume& volume,
+                      const VolumeHistogram& histogram, const VolumeBrickRanges& brickRanges);
+} // namespace VDS::DerivedDataCache
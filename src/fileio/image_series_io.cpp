@@ -0,0 +1,204 @@
+#include "image_series_io.h"
+
+#include "common/volume_kernels.h"
+
+#include <QImage>
+#include <QImageReader>
+#include <QString>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <numeric>
+
+namespace VDS::ImageSeriesIO {
+namespace {
+// upper bound of the slabs read by out-of-core exports
+constexpr std::size_t maximumSlabSizeInBytes = std::size_t{64} << 20;
+
+// Writes the slices of slab, which start at slice firstSlice of a volume with sliceCount slices.
+// The value range of slab has to be the one of the whole volume.
+template <typename T>
+bool exportBitmapSeriesTyped(const std::filesystem::path& directoryPath, const Volume& slab,
+                             const ValueWindowSettings& window, const std::size_t firstSlice,
+                             const std::size_t sliceCount, const ProgressCallback& progress) {
+    const Kernels::VoxelConverter<T, uint8_t> converter(slab.getValueRange(), window);
+
+    const std::size_t sizeX = slab.getSizeX();
+    const std::size_t sizeY = slab.getSizeY();
+    const std::size_t sizeZ = slab.getSizeZ();
+    const int digits = static_cast<int>(QString::number(sliceCount).size());
+
+    QImage image(static_cast<int>(sizeX), static_cast<int>(sizeY), QImage::Format_Grayscale8);
+
+    for (std::size_t z = 0; z < sizeZ; z++) {
+        for (std::size_t y = 0; y < sizeY; y++) {
+            // QImage rows are padded to 4 bytes, so every row has to be converted separately
+            converter.convert(slab.getRow<T>(y, z), image.scanLine(static_cast<int>(y)), sizeX);
+        }
+
+        const QString fileName = QString("slice_%1.bmp")
+                                     .arg(static_cast<qulonglong>(firstSlice + z), digits, 10,
+                                          QChar('0'));
+        const std::filesystem::path filePath = directoryPath / fileName.toStdString();
+        if (!image.save(QString::fromStdString(filePath.string()), "BMP")) {
+            return false;
+        }
+
+        if (progress && !progress(static_cast<float>(firstSlice + z + 1) / sliceCount)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename T>
+bool importBitmapSlice(const std::filesystem::path& filePath, const QImage::Format format,
+                       const std::size_t z, Volume& volume) {
+    QImage image;
+    if (!image.load(QString::fromStdString(filePath.string())) ||
+        static_cast<std::size_t>(image.width()) != volume.getSizeX() ||
+        static_cast<std::size_t>(image.height()) != volume.getSizeY()) {
+        return false;
+    }
+    if (image.format() != format) {
+        image.convertTo(format);
+    }
+
+    // QImage rows are padded to 4 bytes, so every row has to be copied separately
+    for (std::size_t y = 0; y < volume.getSizeY(); y++) {
+        std::memcpy(volume.getRow<T>(y, z), image.constScanLine(static_cast<int>(y)),
+                    volume.getSizeX() * sizeof(T));
+    }
+    return true;
+}
+} // namespace
+
+bool exportBitmapSeries(const std::filesystem::path& directoryPath, const Volume& volume,
+                        const ValueWindowSettings& window, const ProgressCallback& progress) {
+    std::error_code error;
+    if (volume.isEmpty() || !std::filesystem::is_directory(directoryPath, error)) {
+        return false;
+    }
+
+    return dispatchVoxelType(volume.getVoxelType(), [&](auto tag) {
+        using T = decltype(tag);
+        return exportBitmapSeriesTyped<T>(directoryPath, volume, window, 0, volume.getSizeZ(),
+                                          progress);
+    });
+}
+
+bool exportBitmapSeries(const std::filesystem::path& directoryPath,
+                        RawVolumeIO::RawSliceReader& reader, const ValueWindowSettings& window,
+                        const ProgressCallback& progress) {
+    std::error_code error;
+    ValueRange valueRange;
+    if (!reader.isOpen() || !std::filesystem::is_directory(directoryPath, error) ||
+        !reader.computeValueRange(valueRange)) {
+        return false;
+    }
+
+    const std::size_t sliceCount = reader.getSize()[2];
+    const std::size_t slabSliceCount = reader.getSlabSliceCount(maximumSlabSizeInBytes);
+    Volume slab;
+    for (std::size_t firstSlice = 0; firstSlice < sliceCount; firstSlice += slabSliceCount) {
+        if (!reader.readSlab(firstSlice, std::min(slabSliceCount, sliceCount - firstSlice),
+                             slab)) {
+            return false;
+        }
+        slab.setValueRange(valueRange);
+
+        const bool success = dispatchVoxelType(slab.getVoxelType(), [&](auto tag) {
+            using T = decltype(tag);
+            return exportBitmapSeriesTyped<T>(directoryPath, slab, window, firstSlice,
+                                              sliceCount, progress);
+        });
+        if (!success) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::filesystem::path> findBitmapSlices(const std::filesystem::path& directoryPath) {
+    const QList<QByteArray> formats = QImageReader::supportedImageFormats();
+
+    std::vector<std::filesystem::path> slicePaths;
+    std::error_code error;
+    for (const auto& directoryEntry : std::filesystem::directory_iterator(directoryPath, error)) {
+        // skip subdirectories and other files
+        const QByteArray extension =
+            QByteArray::fromStdString(directoryEntry.path().extension().string()).mid(1).toLower();
+        if (directoryEntry.is_regular_file() && formats.contains(extension)) {
+            slicePaths.push_back(directoryEntry.path());
+        }
+    }
+    std::sort(slicePaths.begin(), slicePaths.end());
+
+    return slicePaths;
+}
+
+bool readBitmapSliceInfo(const std::filesystem::path& filePath, std::size_t& width,
+                         std::size_t& height, VoxelType& voxelType) {
+    const QImageReader reader(QString::fromStdString(filePath.string()));
+    const QSize size = reader.size();
+    if (!size.isValid() || size.isEmpty()) {
+        return false;
+    }
+
+    const QImage::Format format = reader.imageFormat();
+    const bool sixteenBit =
+        format == QImage::Format_Grayscale16 || format == QImage::Format_RGBX64 ||
+        format == QImage::Format_RGBA64 || format == QImage::Format_RGBA64_Premultiplied;
+
+    width = static_cast<std::size_t>(size.width());
+    height = static_cast<std::size_t>(size.height());
+    voxelType = sixteenBit ? VoxelType::UInt16 : VoxelType::UInt8;
+    return true;
+}
+
+bool importBitmapSlices(const std::filesystem::path& directoryPath,
+                        const std::array<float, 3>& spacing, Volume& volume) {
+    const std::vector<std::filesystem::path> slicePaths = findBitmapSlices(directoryPath);
+    if (slicePaths.empty()) {
+        return false;
+    }
+
+    std::size_t width = 0;
+    std::size_t height = 0;
+    VoxelType voxelType = VoxelType::UInt8;
+    if (!readBitmapSliceInfo(slicePaths.front(), width, height, voxelType)) {
+        return false;
+    }
+    const QImage::Format format = voxelType == VoxelType::UInt16 ? QImage::Format_Grayscale16
+                                                                 : QImage::Format_Grayscale8;
+
+    Volume importedVolume({width, height, slicePaths.size()}, spacing, voxelType);
+
+    // every slice is decoded on the thread pool straight into its own Z position
+    std::vector<std::size_t> sliceIndices(slicePaths.size());
+    std::iota(sliceIndices.begin(), sliceIndices.end(), 0);
+    std::atomic<bool> success{true};
+    QtConcurrent::blockingMap(sliceIndices, [&](const std::size_t& z) {
+        if (!success) {
+            return;
+        }
+        const bool sliceImported = dispatchVoxelType(voxelType, [&](auto tag) {
+            using T = decltype(tag);
+            return importBitmapSlice<T>(slicePaths[z], format, z, importedVolume);
+        });
+        if (!sliceImported) {
+            success = false;
+        }
+    });
+
+    if (!success) {
+        return false;
+    }
+
+    volume = std::move(importedVolume);
+    return true;
+}
+} // namespace VDS::ImageSeriesIO
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <vector>
+
+#include "common/progress_callback.h"
+#include "common/volume.h"
+#include "fileio/raw_volume_io.h"
+#include "renderer/shader/shader_settings.h"
+
+namespace VDS::ImageSeriesIO {
+// Writes one 8 bit monochrome bitmap per XY slice into directoryPath. The value window is applied
+// before the voxels are reduced to 8 bit. progress is called per written slice.
+bool exportBitmapSeries(const std::filesystem::path& directoryPath, const Volume& volume,
+                        const ValueWindowSettings& window,
+                        const ProgressCallback& progress = ProgressCallback());
+// Out-of-core variant for raw files larger than RAM, the file is read slab by slab
+bool exportBitmapSeries(const std::filesystem::path& directoryPath,
+                        RawVolumeIO::RawSliceReader& reader, const ValueWindowSettings& window,
+                        const ProgressCallback& progress = ProgressCallback());
+
+// image files in directoryPath with a format Qt can read, sorted alphabetically
+std::vector<std::filesystem::path> findBitmapSlices(const std::filesystem::path& directoryPath);
+
+// Reads width, height and resulting voxel type of an image slice from its header without decoding
+// it. 16 bit grayscale and 16 bit per channel images give 16 bit voxels, all others 8 bit.
+bool readBitmapSliceInfo(const std::filesystem::path& filePath, std::size_t& width,
+                         std::size_t& height, VoxelType& voxelType);
+
+// Imports one image per XY slice in alphabetical order. Size and voxel type are taken from the
+// first slice, all slices are converted to grayscale. Slices are decoded in parallel directly into
+// their Z position of the volume.
+bool importBitmapSlices(const std::filesystem::path& directoryPath,
+                        const std::array<float, 3>& spacing, Volume& volume);
+} // namespace VDS::ImageSeriesIO
@@ -14,7 +14,7 @@ DialogImportBinarySlices::DialogImportBinarySlices(QWidget* parent) : QDialog(pa
     setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint);
 
     setupSectionPathToFile();
-    setupSectionBitsPerVoxel();
+    setupSectionVoxelType();
     setupSectionEndianess();
     setupAxis();
     setupSectionSize();
@@ -24,7 +24,7 @@ DialogImportBinarySlices::DialogImportBinarySlices(QWidget* parent) : QDialog(pa
 
     m_vLayoutDialog = new QVBoxLayout(this);
     m_vLayoutDialog->addWidget(m_groupPathToDirectory);
-    m_vLayoutDialog->addWidget(m_groupBitsPerVoxel);
+    m_vLayoutDialog->addWidget(m_groupVoxelType);
     m_vLayoutDialog->addWidget(m_groupEndianess);
     m_vLayoutDialog->addWidget(m_groupAxis);
     m_vLayoutDialog->addWidget(m_groupSize);
@@ -46,16 +46,20 @@ const ImportItemBinarySlices DialogImportBinarySlices::getImportItem() const {
     const QVector3D spacing(m_textSpacingX->text().toFloat(), m_textSpacingY->text().toFloat(),
                             m_textSpacingZ->text().toFloat());
 
-    uint32_t bitsPerVoxel = 0;
-    switch (m_comboBoxBitsPerVoxelOptions->currentIndex()) {
+    VoxelType voxelType = VoxelType::UInt16;
+    switch (m_comboBoxVoxelTypeOptions->currentIndex()) {
     case 0:
-        bitsPerVoxel = 8;
+        voxelType = VoxelType::UInt8;
         break;
-    case 1:
-        bitsPerVoxel = 16;
+    case 2:
+        voxelType = VoxelType::Int16;
         break;
+    case 3:
+        voxelType = VoxelType::Float32;
+        break;
+    case 1:
     default:
-        bitsPerVoxel = 0;
+        voxelType = VoxelType::UInt16;
         break;
     }
 
@@ -84,7 +88,7 @@ const ImportItemBinarySlices DialogImportBinarySlices::getImportItem() const {
         break;
     }
 
-    return ImportItemBinarySlices(path, bitsPerVoxel, representedInLittleEndian, axis, size, spacing);
+    return ImportItemBinarySlices(path, voxelType, representedInLittleEndian, axis, size, spacing);
 }
 void DialogImportBinarySlices::onOKButtonClicked() {
     if (checkCurrentInput()) {
@@ -180,19 +184,20 @@ void DialogImportBinarySlices::setupSectionPathToFile() {
     connect(m_buttonPathToDirectory, &QPushButton::clicked, this, &DialogImportBinarySlices::selectDirectory);
 }
 
-void DialogImportBinarySlices::setupSectionBitsPerVoxel() {
-    m_labelBitsPerVoxel = new QLabel;
-    m_labelBitsPerVoxel->setText(QString("Bits per voxel:"));
+void DialogImportBinarySlices::setupSectionVoxelType() {
+    m_labelVoxelType = new QLabel;
+    m_labelVoxelType->setText(QString("Voxel type:"));
 
-    m_comboBoxBitsPerVoxelOptions = new QComboBox;
-    m_comboBoxBitsPerVoxelOptions->addItems({"8", "16"});
+    m_comboBoxVoxelTypeOptions = new QComboBox;
+    m_comboBoxVoxelTypeOptions->addItems(
+        {"8 bit unsigned", "16 bit unsigned", "16 bit signed", "32 bit float"});
 
-    m_hLayoutBitsPerVoxel = new QHBoxLayout;
-    m_hLayoutBitsPerVoxel->addWidget(m_labelBitsPerVoxel);
-    m_hLayoutBitsPerVoxel->addWidget(m_comboBoxBitsPerVoxelOptions);
+    m_hLayoutVoxelType = new QHBoxLayout;
+    m_hLayoutVoxelType->addWidget(m_labelVoxelType);
+    m_hLayoutVoxelType->addWidget(m_comboBoxVoxelTypeOptions);
 
-    m_groupBitsPerVoxel = new QGroupBox;
-    m_groupBitsPerVoxel->setLayout(m_hLayoutBitsPerVoxel);
+    m_groupVoxelType = new QGroupBox;
+    m_groupVoxelType->setLayout(m_hLayoutVoxelType);
 }
 
 void DialogImportBinarySlices::setupSectionEndianess() {
@@ -33,7 +33,7 @@ private:
     bool checkIsBigEndian();
 
     void setupSectionPathToFile();
-    void setupSectionBitsPerVoxel();
+    void setupSectionVoxelType();
     void setupSectionEndianess();
     void setupSectionSize();
     void setupSectionSpacing();
@@ -54,11 +54,11 @@ private:
     QLineEdit* m_textPathToDirectory;
     QPushButton* m_buttonPathToDirectory;
 
-    // Bits per voxel
-    QGroupBox* m_groupBitsPerVoxel;
-    QHBoxLayout* m_hLayoutBitsPerVoxel;
-    QLabel* m_labelBitsPerVoxel;
-    QComboBox* m_comboBoxBitsPerVoxelOptions;
+    // Voxel type
+    QGroupBox* m_groupVoxelType;
+    QHBoxLayout* m_hLayoutVoxelType;
+    QLabel* m_labelVoxelType;
+    QComboBox* m_comboBoxVoxelTypeOptions;
 
     // Endianess
     QGroupBox* m_groupEndianess;
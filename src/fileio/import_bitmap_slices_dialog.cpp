@@ -0,0 +1,207 @@
+#include <QFileDialog>
+#include <QMessageBox>
+#include "import_bitmap_slices_dialog.h"
+#include "image_series_io.h"
+
+namespace VDS {
+
+DialogImportBitmapSlices::DialogImportBitmapSlices(QWidget* parent) : QDialog(parent) {
+    setWindowTitle(QString("Import Bitmap Slices"));
+
+    // disable the context help button
+    setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint);
+
+    setupSectionPathToDirectory();
+    setupSectionSpacing();
+    setupImportOrderPreview();
+    setupSectionOKAndCancel();
+
+    m_vLayoutDialog = new QVBoxLayout(this);
+    m_vLayoutDialog->addWidget(m_groupPathToDirectory);
+    m_vLayoutDialog->addWidget(m_groupSpacing);
+    m_vLayoutDialog->addWidget(m_groupFileImportPreview);
+    m_vLayoutDialog->addWidget(m_groupOKAndCancel);
+
+    setLayout(m_vLayoutDialog);
+    setMinimumSize(200, 200);
+
+    m_numberOfSlices = 0;
+}
+
+const ImportItemBitmapSlices DialogImportBitmapSlices::getImportItem() const {
+    const std::filesystem::path path =
+        std::filesystem::path(m_textPathToDirectory->text().toStdString());
+    const QVector3D spacing(m_textSpacingX->text().toFloat(), m_textSpacingY->text().toFloat(),
+                            m_textSpacingZ->text().toFloat());
+
+    return ImportItemBitmapSlices(path, spacing);
+}
+void DialogImportBitmapSlices::onOKButtonClicked() {
+    if (checkCurrentInput()) {
+        this->accept();
+    } else {
+        QMessageBox msgBox(QMessageBox::Warning, "Incomplete Bitmap Slices Import!",
+                           "Some required fields are empty or the directory contains no images!");
+        msgBox.exec();
+    }
+}
+void DialogImportBitmapSlices::onCancelButtonClicked() {
+    this->reject();
+}
+
+bool DialogImportBitmapSlices::checkCurrentInput() {
+    if (m_textPathToDirectory->text().isEmpty() || m_numberOfSlices == 0) {
+        return false;
+    }
+    if (m_textSpacingX->text().isEmpty() || m_textSpacingY->text().isEmpty() ||
+        m_textSpacingZ->text().isEmpty()) {
+        return false;
+    }
+    return true;
+}
+void DialogImportBitmapSlices::setupSectionPathToDirectory() {
+    m_labelPathToDirectory = new QLabel;
+    m_labelPathToDirectory->setText(QString("Path to Bitmap Slices directory:"));
+
+    m_textPathToDirectory = new QLineEdit;
+    m_textPathToDirectory->setReadOnly(true);
+    m_textPathToDirectory->setMinimumWidth(350);
+    m_textPathToDirectory->setPlaceholderText(QString("Select a directory"));
+
+    m_buttonPathToDirectory = new QPushButton;
+    m_buttonPathToDirectory->setText(QString("Open"));
+
+    m_hLayoutPathToDirectory = new QHBoxLayout;
+    m_hLayoutPathToDirectory->addWidget(m_textPathToDirectory);
+    m_hLayoutPathToDirectory->addWidget(m_buttonPathToDirectory);
+
+    m_vLayoutPathToDirectory = new QVBoxLayout;
+    m_vLayoutPathToDirectory->addStretch();
+    m_vLayoutPathToDirectory->addWidget(m_labelPathToDirectory);
+    m_vLayoutPathToDirectory->addLayout(m_hLayoutPathToDirectory);
+    m_vLayoutPathToDirectory->addStretch();
+
+    m_groupPathToDirectory = new QGroupBox;
+    m_groupPathToDirectory->setLayout(m_vLayoutPathToDirectory);
+
+    connect(m_buttonPathToDirectory, &QPushButton::clicked, this,
+            &DialogImportBitmapSlices::selectDirectory);
+}
+
+void DialogImportBitmapSlices::setupSectionSpacing() {
+    m_labelSpacing = new QLabel;
+    m_labelSpacing->setText(QString("Spacing in cm:"));
+
+    m_validatorSpacing = new QRegularExpressionValidator(
+        QRegularExpression("[-+]?[0-9]*\\.?[0-9]+([eE][-+]?[0-9]+)?"));
+
+    m_textSpacingX = new QLineEdit;
+    m_textSpacingX->setPlaceholderText(QString("X-Dimension"));
+    m_textSpacingX->setValidator(m_validatorSpacing);
+
+    m_textSpacingY = new QLineEdit;
+    m_textSpacingY->setPlaceholderText(QString("Y-Dimension"));
+    m_textSpacingY->setValidator(m_validatorSpacing);
+
+    m_textSpacingZ = new QLineEdit;
+    m_textSpacingZ->setPlaceholderText(QString("Z-Dimension"));
+    m_textSpacingZ->setValidator(m_validatorSpacing);
+
+    m_hLayoutSpacing = new QHBoxLayout;
+    m_hLayoutSpacing->addWidget(m_textSpacingX);
+    m_hLayoutSpacing->addWidget(m_textSpacingY);
+    m_hLayoutSpacing->addWidget(m_textSpacingZ);
+
+    m_vLayoutSpacing = new QVBoxLayout;
+    m_vLayoutSpacing->addStretch();
+    m_vLayoutSpacing->addWidget(m_labelSpacing);
+    m_vLayoutSpacing->addLayout(m_hLayoutSpacing);
+    m_vLayoutSpacing->addStretch();
+
+    m_groupSpacing = new QGroupBox;
+    m_groupSpacing->setLayout(m_vLayoutSpacing);
+}
+
+void DialogImportBitmapSlices::setupSectionOKAndCancel() {
+    m_buttonOK = new QPushButton;
+    m_buttonOK->setText(QString("OK"));
+
+    m_buttonCancel = new QPushButton;
+    m_buttonCancel->setText(QString("Cancel"));
+
+    m_hLayoutOKAndCancel = new QHBoxLayout;
+    m_hLayoutOKAndCancel->addWidget(m_buttonOK);
+    m_hLayoutOKAndCancel->addWidget(m_buttonCancel);
+
+    m_groupOKAndCancel = new QGroupBox;
+    m_groupOKAndCancel->setLayout(m_hLayoutOKAndCancel);
+
+    connect(m_buttonOK, &QPushButton::clicked, this, &DialogImportBitmapSlices::onOKButtonClicked);
+    connect(m_buttonCancel, &QPushButton::clicked, this,
+            &DialogImportBitmapSlices::onCancelButtonClicked);
+}
+
+void DialogImportBitmapSlices::setupImportOrderPreview() {
+    m_labelFileImportPreview = new QLabel;
+    m_labelFileImportPreview->setText(QString("File Import Order Preview:"));
+
+    m_labelSliceFormat = new QLabel;
+
+    m_textFileImportPreview = new QTextEdit;
+    m_textFileImportPreview->setPlaceholderText(
+        QString("Images are imported by alphabetical order."));
+    m_textFileImportPreview->setReadOnly(true);
+
+    m_vLayoutFileImportPreview = new QVBoxLayout;
+    m_vLayoutFileImportPreview->addWidget(m_labelFileImportPreview);
+    m_vLayoutFileImportPreview->addWidget(m_labelSliceFormat);
+    m_vLayoutFileImportPreview->addWidget(m_textFileImportPreview);
+
+    m_groupFileImportPreview = new QGroupBox;
+    m_groupFileImportPreview->setLayout(m_vLayoutFileImportPreview);
+}
+
+void DialogImportBitmapSlices::previewImportOrder() {
+    const std::vector<std::filesystem::path> slicePaths =
+        ImageSeriesIO::findBitmapSlices(m_textPathToDirectory->text().toStdString());
+    m_numberOfSlices = slicePaths.size();
+
+    QString fileList = "Images are imported by alphabetical order:\n\n";
+    for (const std::filesystem::path& path : slicePaths) {
+        fileList.append(QString::fromStdString(path.filename().string() + "\n"));
+    }
+    m_textFileImportPreview->setText(fileList);
+
+    if (slicePaths.empty()) {
+        m_labelSliceFormat->setText(QString("No images found"));
+        return;
+    }
+
+    // all slices need the size of the first one
+    std::size_t width = 0;
+    std::size_t height = 0;
+    VoxelType voxelType = VoxelType::UInt8;
+    if (!ImageSeriesIO::readBitmapSliceInfo(slicePaths.front(), width, height, voxelType)) {
+        m_labelSliceFormat->setText(QString("Unreadable image"));
+        m_numberOfSlices = 0;
+        return;
+    }
+    m_labelSliceFormat->setText(QString("%1 x %2 x %3 voxels, %4 bit")
+                                    .arg(width)
+                                    .arg(height)
+                                    .arg(m_numberOfSlices)
+                                    .arg(getBitsPerVoxel(voxelType)));
+}
+
+void DialogImportBitmapSlices::selectDirectory() {
+    const QString path = QFileDialog::getExistingDirectory(
+        nullptr, tr("Open Directory"), QDir::homePath(), QFileDialog::ShowDirsOnly);
+    if (path.isEmpty()) {
+        // Open file dialog got cancelled by user. Do not overwrite current text in case user open
+        // file dialog a second time accidentally
+        return;
+    }
+    m_textPathToDirectory->setText(path);
+    previewImportOrder();
+}
+} // namespace VDS
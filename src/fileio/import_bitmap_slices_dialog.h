@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QDialog>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QTextEdit>
+#include <QVBoxLayout>
+
+#include "import_item.h"
+
+namespace VDS {
+
+class DialogImportBitmapSlices : public QDialog {
+    Q_OBJECT
+
+public:
+    DialogImportBitmapSlices(QWidget* parent = 0);
+
+    const ImportItemBitmapSlices getImportItem() const;
+
+public slots:
+    void selectDirectory();
+    void onOKButtonClicked();
+    void onCancelButtonClicked();
+
+private:
+    bool checkCurrentInput();
+
+    void setupSectionPathToDirectory();
+    void setupSectionSpacing();
+    void setupImportOrderPreview();
+    void setupSectionOKAndCancel();
+
+    void previewImportOrder();
+
+    // Dialog Window
+    QVBoxLayout* m_vLayoutDialog;
+
+    // Path to directory
+    QGroupBox* m_groupPathToDirectory;
+    QHBoxLayout* m_hLayoutPathToDirectory;
+    QVBoxLayout* m_vLayoutPathToDirectory;
+    QLabel* m_labelPathToDirectory;
+    QLineEdit* m_textPathToDirectory;
+    QPushButton* m_buttonPathToDirectory;
+
+    // Spacing
+    QGroupBox* m_groupSpacing;
+    QHBoxLayout* m_hLayoutSpacing;
+    QVBoxLayout* m_vLayoutSpacing;
+    QLabel* m_labelSpacing;
+    QLineEdit* m_textSpacingX;
+    QLineEdit* m_textSpacingY;
+    QLineEdit* m_textSpacingZ;
+    QRegularExpressionValidator* m_validatorSpacing;
+
+    // File Import Order Preview
+    QGroupBox* m_groupFileImportPreview;
+    QVBoxLayout* m_vLayoutFileImportPreview;
+    QLabel* m_labelFileImportPreview;
+    QLabel* m_labelSliceFormat;
+    QTextEdit* m_textFileImportPreview;
+
+    // OK and Cancel
+    QGroupBox* m_groupOKAndCancel;
+    QHBoxLayout* m_hLayoutOKAndCancel;
+    QPushButton* m_buttonOK;
+    QPushButton* m_buttonCancel;
+
+    std::size_t m_numberOfSlices;
+};
+} // namespace VDS
@@ -1,21 +1,37 @@
 #include "import_item.h"
 
+#include <QJsonDocument>
+
 namespace VDS {
 const std::filesystem::path ImportItem::getFilePath() const {
     return m_path;
 }
 
+const std::string ImportItem::getCacheKey() const {
+    // a modified file gets a new key, so outdated cache entries are never used
+    std::error_code error;
+    const auto modificationTime = std::filesystem::last_write_time(m_path, error);
+    const auto fileSize = std::filesystem::is_regular_file(m_path, error)
+                              ? std::filesystem::file_size(m_path, error)
+                              : std::uintmax_t{0};
+
+    const QByteArray parameters = QJsonDocument(serialize()).toJson(QJsonDocument::Compact);
+    return parameters.toStdString() + "@" +
+           std::to_string(modificationTime.time_since_epoch().count()) + ":" +
+           std::to_string(fileSize);
+}
+
 ImportItem::ImportItem(const std::filesystem::path& path) : m_path{path} {}
 
-ImportItemRaw::ImportItemRaw(const std::filesystem::path& filePath, const uint8_t bitsPerVoxel,
+ImportItemRaw::ImportItemRaw(const std::filesystem::path& filePath, const VoxelType voxelType,
                              const bool little_endian, const QVector3D& size,
                              const QVector3D& spacing)
-    : ImportItem(filePath), m_bitsPerVoxel(bitsPerVoxel), m_littleEndian(little_endian),
-      m_size(size), m_spacing(spacing) {}
+    : ImportItem(filePath), m_voxelType(voxelType), m_littleEndian(little_endian),
+      m_size(size), m_spacing(spacing), m_regionOffset{}, m_regionSize{}, m_stride{1, 1, 1} {}
 
 ImportItemRaw::ImportItemRaw()
-    : m_bitsPerVoxel{}, m_littleEndian{}, m_size{}, m_spacing{}, ImportItem{
-                                                                     std::filesystem::path{}} {}
+    : m_voxelType{VoxelType::UInt16}, m_littleEndian{}, m_size{}, m_spacing{}, m_regionOffset{},
+      m_regionSize{}, m_stride{1, 1, 1}, ImportItem{std::filesystem::path{}} {}
 
 const QString ImportItemRaw::getFileName() const {
     return QString::fromStdString(m_path.filename().string());
@@ -26,12 +42,33 @@ const QVector3D ImportItemRaw::getSize() const {
 const QVector3D ImportItemRaw::getSpacing() const {
     return m_spacing;
 }
+VoxelType ImportItemRaw::getVoxelType() const {
+    return m_voxelType;
+}
 uint8_t ImportItemRaw::getBitsPerVoxel() const {
-    return m_bitsPerVoxel;
+    return VDS::getBitsPerVoxel(m_voxelType);
 }
 bool ImportItemRaw::representedInLittleEndian() const {
     return m_littleEndian;
 }
+void ImportItemRaw::setRegionOfInterest(const QVector3D& offset, const QVector3D& size,
+                                        const QVector3D& stride) {
+    m_regionOffset = offset;
+    m_regionSize = size;
+    m_stride = stride;
+}
+const QVector3D ImportItemRaw::getRegionOffset() const {
+    return m_regionOffset;
+}
+const QVector3D ImportItemRaw::getRegionSize() const {
+    return m_regionSize;
+}
+const QVector3D ImportItemRaw::getStride() const {
+    return m_stride;
+}
+bool ImportItemRaw::hasRegionOfInterest() const {
+    return !m_regionOffset.isNull() || !m_regionSize.isNull() || m_stride != QVector3D(1, 1, 1);
+}
 const QJsonObject ImportItemRaw::serialize() const {
     // QJsonObject supports just a few data types
     QJsonObject jsonSize;
@@ -46,11 +83,35 @@ const QJsonObject ImportItemRaw::serialize() const {
 
     QJsonObject json;
     json["path"] = QString(m_path.string().c_str());
-    json["bitPerVoxel"] = m_bitsPerVoxel;
+    json["bitPerVoxel"] = getBitsPerVoxel();
+    json["voxelType"] = QString::fromStdString(getVoxelTypeName(m_voxelType));
     json["littleEndian"] = m_littleEndian;
     json["size"] = jsonSize;
     json["spacing"] = jsonSpacing;
 
+    if (hasRegionOfInterest()) {
+        QJsonObject jsonRegionOffset;
+        jsonRegionOffset["x"] = static_cast<int>(m_regionOffset.x());
+        jsonRegionOffset["y"] = static_cast<int>(m_regionOffset.y());
+        jsonRegionOffset["z"] = static_cast<int>(m_regionOffset.z());
+
+        QJsonObject jsonRegionSize;
+        jsonRegionSize["x"] = static_cast<int>(m_regionSize.x());
+        jsonRegionSize["y"] = static_cast<int>(m_regionSize.y());
+        jsonRegionSize["z"] = static_cast<int>(m_regionSize.z());
+
+        QJsonObject jsonStride;
+        jsonStride["x"] = static_cast<int>(m_stride.x());
+        jsonStride["y"] = static_cast<int>(m_stride.y());
+        jsonStride["z"] = static_cast<int>(m_stride.z());
+
+        QJsonObject jsonRegion;
+        jsonRegion["offset"] = jsonRegionOffset;
+        jsonRegion["size"] = jsonRegionSize;
+        jsonRegion["stride"] = jsonStride;
+        json["regionOfInterest"] = jsonRegion;
+    }
+
     return json;
 }
 void ImportItemRaw::deserialize(const QJsonObject& json) {
@@ -66,14 +127,38 @@ void ImportItemRaw::deserialize(const QJsonObject& json) {
 
     m_path = std::filesystem::path(json["path"].toString().toStdString());
 
-    m_bitsPerVoxel = static_cast<uint8_t>(json["bitPerVoxel"].toInt());
+    // lists written before regions of interest were supported import the whole volume
+    const QJsonObject jsonRegion = json["regionOfInterest"].toObject();
+    const QJsonObject jsonRegionOffset = jsonRegion["offset"].toObject();
+    m_regionOffset.setX(static_cast<float>(jsonRegionOffset["x"].toInt()));
+    m_regionOffset.setY(static_cast<float>(jsonRegionOffset["y"].toInt()));
+    m_regionOffset.setZ(static_cast<float>(jsonRegionOffset["z"].toInt()));
+
+    const QJsonObject jsonRegionSize = jsonRegion["size"].toObject();
+    m_regionSize.setX(static_cast<float>(jsonRegionSize["x"].toInt()));
+    m_regionSize.setY(static_cast<float>(jsonRegionSize["y"].toInt()));
+    m_regionSize.setZ(static_cast<float>(jsonRegionSize["z"].toInt()));
+
+    const QJsonObject jsonStride = jsonRegion["stride"].toObject();
+    m_stride.setX(static_cast<float>(jsonStride["x"].toInt(1)));
+    m_stride.setY(static_cast<float>(jsonStride["y"].toInt(1)));
+    m_stride.setZ(static_cast<float>(jsonStride["z"].toInt(1)));
+
+    // lists written before signed and floating point voxels were supported only contain the bit
+    // depth of unsigned voxels
+    if (json.contains("voxelType")) {
+        m_voxelType = getVoxelTypeFromName(json["voxelType"].toString().toStdString());
+    } else {
+        m_voxelType =
+            getVoxelTypeFromBitsPerVoxel(static_cast<uint8_t>(json["bitPerVoxel"].toInt()));
+    }
     m_littleEndian = static_cast<uint8_t>(json["littleEndian"].toBool());
 }
 ImportItemBinarySlices::ImportItemBinarySlices(const std::filesystem::path& directoryPath,
-                                               const uint8_t bitsPerVoxel, const bool little_endian,
+                                               const VoxelType voxelType, const bool little_endian,
                                                const VDTK::VolumeAxis axis,
                                                const QVector3D& size, const QVector3D& spacing)
-    : ImportItemRaw(directoryPath, bitsPerVoxel, little_endian, size, spacing), m_axis(axis) {}
+    : ImportItemRaw(directoryPath, voxelType, little_endian, size, spacing), m_axis(axis) {}
 
 ImportItemBinarySlices::ImportItemBinarySlices() : ImportItemRaw() {}
 
@@ -90,4 +175,53 @@ void ImportItemBinarySlices::deserialize(const QJsonObject& json) {
     ImportItemRaw::deserialize(json);
     m_axis = static_cast<VDTK::VolumeAxis>(json["axis"].toInt());
 }
+
+ImportItemBitmapSlices::ImportItemBitmapSlices(const std::filesystem::path& directoryPath,
+                                               const QVector3D& spacing)
+    : ImportItem(directoryPath), m_spacing(spacing) {}
+
+ImportItemBitmapSlices::ImportItemBitmapSlices()
+    : ImportItem(std::filesystem::path{}), m_spacing{} {}
+
+const QString ImportItemBitmapSlices::getFileName() const {
+    return QString::fromStdString(m_path.filename().string());
+}
+const QVector3D ImportItemBitmapSlices::getSpacing() const {
+    return m_spacing;
+}
+const QJsonObject ImportItemBitmapSlices::serialize() const {
+    QJsonObject jsonSpacing;
+    jsonSpacing["x"] = static_cast<double>(m_spacing.x());
+    jsonSpacing["y"] = static_cast<double>(m_spacing.y());
+    jsonSpacing["z"] = static_cast<double>(m_spacing.z());
+
+    QJsonObject json;
+    json["path"] = QString(m_path.string().c_str());
+    json["spacing"] = jsonSpacing;
+    return json;
+}
+void ImportItemBitmapSlices::deserialize(const QJsonObject& json) {
+    QJsonObject jsonSpacing = json["spacing"].toObject();
+    m_spacing.setX(static_cast<float>(jsonSpacing["x"].toDouble()));
+    m_spacing.setY(static_cast<float>(jsonSpacing["y"].toDouble()));
+    m_spacing.setZ(static_cast<float>(jsonSpacing["z"].toDouble()));
+
+    m_path = std::filesystem::path(json["path"].toString().toStdString());
+}
+
+ImportItemVds::ImportItemVds(const std::filesystem::path& filePath) : ImportItem(filePath) {}
+
+ImportItemVds::ImportItemVds() : ImportItem(std::filesystem::path{}) {}
+
+const QString ImportItemVds::getFileName() const {
+    return QString::fromStdString(m_path.filename().string());
+}
+const QJsonObject ImportItemVds::serialize() const {
+    QJsonObject json;
+    json["path"] = QString(m_path.string().c_str());
+    return json;
+}
+void ImportItemVds::deserialize(const QJsonObject& json) {
+    m_path = std::filesystem::path(json["path"].toString().toStdString());
+}
 } // namespace VDS
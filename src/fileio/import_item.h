@@ -1,12 +1,15 @@
 #pragma once
 
 #include <filesystem>
+#include <string>
 #include <QJsonObject>
 #include <QString>
 #include <QVector3D>
 
 #include <VDTK/common/CommonDataTypes.h>
 
+#include "common/voxel_type.h"
+
 namespace VDS {
 // Interface class for processing different kind of import item for the "last opened" section in
 // import menu section
@@ -19,6 +22,9 @@ public:
     virtual const QJsonObject serialize() const = 0;
     virtual void deserialize(const QJsonObject& json) = 0;
     const std::filesystem::path getFilePath() const;
+    // Import parameters, modification time and size of the file. Identifies the decoded volume in
+    // the volume cache and its derived data in the sidecar cache on disk.
+    const std::string getCacheKey() const;
 
 protected:
     ImportItem(const std::filesystem::path& path);
@@ -28,7 +34,7 @@ protected:
 
 class ImportItemRaw : public ImportItem {
 public:
-    ImportItemRaw(const std::filesystem::path& filePath, const uint8_t bitsPerVoxel,
+    ImportItemRaw(const std::filesystem::path& filePath, const VoxelType voxelType,
                   const bool little_endian, const QVector3D& size, const QVector3D& spacing);
     ImportItemRaw();
     ~ImportItemRaw() = default;
@@ -36,22 +42,35 @@ public:
     const QString getFileName() const override;
     const QVector3D getSize() const;
     const QVector3D getSpacing() const;
+    VoxelType getVoxelType() const;
     uint8_t getBitsPerVoxel() const;
     bool representedInLittleEndian() const;
 
+    // Optional region of interest in voxels of the file and a stride per axis for decimated
+    // imports. A region size of 0 extends the region to the end of that axis.
+    void setRegionOfInterest(const QVector3D& offset, const QVector3D& size,
+                             const QVector3D& stride);
+    const QVector3D getRegionOffset() const;
+    const QVector3D getRegionSize() const;
+    const QVector3D getStride() const;
+    bool hasRegionOfInterest() const;
+
     const QJsonObject serialize() const;
     void deserialize(const QJsonObject& json);
 
 protected:
-    uint8_t m_bitsPerVoxel;
+    VoxelType m_voxelType;
     bool m_littleEndian;
     QVector3D m_size;
     QVector3D m_spacing;
+    QVector3D m_regionOffset;
+    QVector3D m_regionSize;
+    QVector3D m_stride;
 };
 
 class ImportItemBinarySlices : public ImportItemRaw {
 public:
-    ImportItemBinarySlices(const std::filesystem::path& directoryPath, const uint8_t bitsPerVoxel,
+    ImportItemBinarySlices(const std::filesystem::path& directoryPath, const VoxelType voxelType,
                            const bool little_endian,
                            const VDTK::VolumeAxis axis, const QVector3D& size,
                            const QVector3D& spacing);
@@ -67,4 +86,34 @@ protected:
     VDTK::VolumeAxis m_axis;
 };
 
+// Size and bit depth of image slices are read from the images, only the spacing is required
+class ImportItemBitmapSlices : public ImportItem {
+public:
+    ImportItemBitmapSlices(const std::filesystem::path& directoryPath, const QVector3D& spacing);
+    ImportItemBitmapSlices();
+    ~ImportItemBitmapSlices() = default;
+
+    const QString getFileName() const override;
+    const QVector3D getSpacing() const;
+
+    const QJsonObject serialize() const override;
+    void deserialize(const QJsonObject& json) override;
+
+protected:
+    QVector3D m_spacing;
+};
+
+// Native container files store all import parameters themselves
+class ImportItemVds : public ImportItem {
+public:
+    ImportItemVds(const std::filesystem::path& filePath);
+    ImportItemVds();
+    ~ImportItemVds() = default;
+
+    const QString getFileName() const override;
+
+    const QJsonObject serialize() const override;
+    void deserialize(const QJsonObject& json) override;
+};
+
 } // namespace VDS
\ No newline at end of file
@@ -22,7 +22,8 @@ void ImportItemListEntry::deserialize(const QJsonObject& json) {
     const ImportType type = static_cast<ImportType>(json["type"].toInt());
 
     switch (type) {
-    case VDS::ImportType::RAW3D: {
+    case VDS::ImportType::RAW3D:
+    case VDS::ImportType::RAW4D: {
         ImportItemRaw* importItem = new ImportItemRaw();
         importItem->deserialize(item);
         delete m_item;
@@ -36,9 +37,18 @@ void ImportItemListEntry::deserialize(const QJsonObject& json) {
         m_item = importItem;
         break;
     }
+    case VDS::ImportType::VDS: {
+        ImportItemVds* importItem = new ImportItemVds();
+        importItem->deserialize(item);
+        delete m_item;
+        m_item = importItem;
+        break;
+    }
     case VDS::ImportType::BitmapSlices: {
-        Q_UNIMPLEMENTED();
-        return;
+        ImportItemBitmapSlices* importItem = new ImportItemBitmapSlices();
+        importItem->deserialize(item);
+        delete m_item;
+        m_item = importItem;
         break;
     }
     default: {
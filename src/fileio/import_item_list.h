@@ -7,7 +7,7 @@
 #include <QList>
 
 namespace VDS {
-enum class ImportType { RAW3D, BinarySlices, BitmapSlices };
+enum class ImportType { RAW3D, BinarySlices, BitmapSlices, RAW4D, VDS };
 
 class ImportItemListEntry {
 public:
@@ -3,6 +3,7 @@
 #include <QMessageBox>
 #include "import_raw_3D_dialog.h"
 
+#include <algorithm>
 #include <limits>
 
 namespace VDS {
@@ -14,18 +15,20 @@ DialogImportRAW3D::DialogImportRAW3D(QWidget* parent) : QDialog(parent) {
     setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint);
 
     setupSectionPathToFile();
-    setupSectionBitsPerVoxel();
+    setupSectionVoxelType();
     setupSectionEndianess();
     setupSectionSize();
     setupSectionSpacing();
+    setupSectionRegionOfInterest();
     setupSectionOKAndCancel();
 
     m_vLayoutDialog = new QVBoxLayout(this);
     m_vLayoutDialog->addWidget(m_groupPathToFile);
-    m_vLayoutDialog->addWidget(m_groupBitsPerVoxel);
+    m_vLayoutDialog->addWidget(m_groupVoxelType);
     m_vLayoutDialog->addWidget(m_groupEndianess);
     m_vLayoutDialog->addWidget(m_groupSize);
     m_vLayoutDialog->addWidget(m_groupSpacing);
+    m_vLayoutDialog->addWidget(m_groupRegionOfInterest);
     m_vLayoutDialog->addWidget(m_groupOKAndCancel);
 
     setLayout(m_vLayoutDialog);
@@ -40,16 +43,20 @@ const ImportItemRaw DialogImportRAW3D::getImportItem() const {
     const QVector3D spacing(m_textSpacingX->text().toFloat(), m_textSpacingY->text().toFloat(),
                             m_textSpacingZ->text().toFloat());
 
-    uint32_t bitsPerVoxel = 0;
-    switch (m_comboBoxBitsPerVoxelOptions->currentIndex()) {
+    VoxelType voxelType = VoxelType::UInt16;
+    switch (m_comboBoxVoxelTypeOptions->currentIndex()) {
     case 0:
-        bitsPerVoxel = 8;
+        voxelType = VoxelType::UInt8;
         break;
-    case 1:
-        bitsPerVoxel = 16;
+    case 2:
+        voxelType = VoxelType::Int16;
+        break;
+    case 3:
+        voxelType = VoxelType::Float32;
         break;
+    case 1:
     default:
-        bitsPerVoxel = 0;
+        voxelType = VoxelType::UInt16;
         break;
     }
 
@@ -64,7 +71,25 @@ const ImportItemRaw DialogImportRAW3D::getImportItem() const {
         break;
     }
 
-    return ImportItemRaw(path, bitsPerVoxel, representedInLittleEndian, size, spacing);
+    // empty fields import the whole volume
+    const QVector3D regionOffset(m_textRegionOffsetX->text().toFloat(),
+                                 m_textRegionOffsetY->text().toFloat(),
+                                 m_textRegionOffsetZ->text().toFloat());
+    const QVector3D regionSize(m_textRegionSizeX->text().toFloat(),
+                               m_textRegionSizeY->text().toFloat(),
+                               m_textRegionSizeZ->text().toFloat());
+    const QVector3D stride(std::max(m_textStrideX->text().toFloat(), 1.0f),
+                           std::max(m_textStrideY->text().toFloat(), 1.0f),
+                           std::max(m_textStrideZ->text().toFloat(), 1.0f));
+
+    ImportItemRaw item(path, voxelType, representedInLittleEndian, size, spacing);
+    if (m_groupRegionOfInterest->isVisible()) {
+        item.setRegionOfInterest(regionOffset, regionSize, stride);
+    }
+    return item;
+}
+void DialogImportRAW3D::setRegionOfInterestVisible(bool visible) {
+    m_groupRegionOfInterest->setVisible(visible);
 }
 void DialogImportRAW3D::onOKButtonClicked() {
     if (checkCurrentInput()) {
@@ -128,19 +153,20 @@ void DialogImportRAW3D::setupSectionPathToFile() {
     connect(m_buttonPathToFile, &QPushButton::clicked, this, &DialogImportRAW3D::selectFile);
 }
 
-void DialogImportRAW3D::setupSectionBitsPerVoxel() {
-    m_labelBitsPerVoxel = new QLabel;
-    m_labelBitsPerVoxel->setText(QString("Bits per voxel:"));
+void DialogImportRAW3D::setupSectionVoxelType() {
+    m_labelVoxelType = new QLabel;
+    m_labelVoxelType->setText(QString("Voxel type:"));
 
-    m_comboBoxBitsPerVoxelOptions = new QComboBox;
-    m_comboBoxBitsPerVoxelOptions->addItems({"8", "16"});
+    m_comboBoxVoxelTypeOptions = new QComboBox;
+    m_comboBoxVoxelTypeOptions->addItems(
+        {"8 bit unsigned", "16 bit unsigned", "16 bit signed", "32 bit float"});
 
-    m_hLayoutBitsPerVoxel = new QHBoxLayout;
-    m_hLayoutBitsPerVoxel->addWidget(m_labelBitsPerVoxel);
-    m_hLayoutBitsPerVoxel->addWidget(m_comboBoxBitsPerVoxelOptions);
+    m_hLayoutVoxelType = new QHBoxLayout;
+    m_hLayoutVoxelType->addWidget(m_labelVoxelType);
+    m_hLayoutVoxelType->addWidget(m_comboBoxVoxelTypeOptions);
 
-    m_groupBitsPerVoxel = new QGroupBox;
-    m_groupBitsPerVoxel->setLayout(m_hLayoutBitsPerVoxel);
+    m_groupVoxelType = new QGroupBox;
+    m_groupVoxelType->setLayout(m_hLayoutVoxelType);
 }
 
 void DialogImportRAW3D::setupSectionEndianess() {
@@ -231,6 +257,83 @@ void DialogImportRAW3D::setupSectionSpacing() {
     m_groupSpacing->setLayout(m_vLayoutSpacing);
 }
 
+void DialogImportRAW3D::setupSectionRegionOfInterest() {
+    m_validatorStride = new QIntValidator(1, std::numeric_limits<int>::max(), this);
+
+    m_labelRegionOffset = new QLabel;
+    m_labelRegionOffset->setText(QString("Region of interest offset in pixel (optional):"));
+
+    m_textRegionOffsetX = new QLineEdit;
+    m_textRegionOffsetX->setPlaceholderText(QString("0"));
+    m_textRegionOffsetX->setValidator(m_validatorSize);
+
+    m_textRegionOffsetY = new QLineEdit;
+    m_textRegionOffsetY->setPlaceholderText(QString("0"));
+    m_textRegionOffsetY->setValidator(m_validatorSize);
+
+    m_textRegionOffsetZ = new QLineEdit;
+    m_textRegionOffsetZ->setPlaceholderText(QString("0"));
+    m_textRegionOffsetZ->setValidator(m_validatorSize);
+
+    m_hLayoutRegionOffset = new QHBoxLayout;
+    m_hLayoutRegionOffset->addWidget(m_textRegionOffsetX);
+    m_hLayoutRegionOffset->addWidget(m_textRegionOffsetY);
+    m_hLayoutRegionOffset->addWidget(m_textRegionOffsetZ);
+
+    m_labelRegionSize = new QLabel;
+    m_labelRegionSize->setText(QString("Region of interest size in pixel (optional):"));
+
+    m_textRegionSizeX = new QLineEdit;
+    m_textRegionSizeX->setPlaceholderText(QString("Up to end"));
+    m_textRegionSizeX->setValidator(m_validatorSize);
+
+    m_textRegionSizeY = new QLineEdit;
+    m_textRegionSizeY->setPlaceholderText(QString("Up to end"));
+    m_textRegionSizeY->setValidator(m_validatorSize);
+
+    m_textRegionSizeZ = new QLineEdit;
+    m_textRegionSizeZ->setPlaceholderText(QString("Up to end"));
+    m_textRegionSizeZ->setValidator(m_validatorSize);
+
+    m_hLayoutRegionSize = new QHBoxLayout;
+    m_hLayoutRegionSize->addWidget(m_textRegionSizeX);
+    m_hLayoutRegionSize->addWidget(m_textRegionSizeY);
+    m_hLayoutRegionSize->addWidget(m_textRegionSizeZ);
+
+    m_labelStride = new QLabel;
+    m_labelStride->setText(QString("Import every n-th pixel (optional):"));
+
+    m_textStrideX = new QLineEdit;
+    m_textStrideX->setPlaceholderText(QString("1"));
+    m_textStrideX->setValidator(m_validatorStride);
+
+    m_textStrideY = new QLineEdit;
+    m_textStrideY->setPlaceholderText(QString("1"));
+    m_textStrideY->setValidator(m_validatorStride);
+
+    m_textStrideZ = new QLineEdit;
+    m_textStrideZ->setPlaceholderText(QString("1"));
+    m_textStrideZ->setValidator(m_validatorStride);
+
+    m_hLayoutStride = new QHBoxLayout;
+    m_hLayoutStride->addWidget(m_textStrideX);
+    m_hLayoutStride->addWidget(m_textStrideY);
+    m_hLayoutStride->addWidget(m_textStrideZ);
+
+    m_vLayoutRegionOfInterest = new QVBoxLayout;
+    m_vLayoutRegionOfInterest->addStretch();
+    m_vLayoutRegionOfInterest->addWidget(m_labelRegionOffset);
+    m_vLayoutRegionOfInterest->addLayout(m_hLayoutRegionOffset);
+    m_vLayoutRegionOfInterest->addWidget(m_labelRegionSize);
+    m_vLayoutRegionOfInterest->addLayout(m_hLayoutRegionSize);
+    m_vLayoutRegionOfInterest->addWidget(m_labelStride);
+    m_vLayoutRegionOfInterest->addLayout(m_hLayoutStride);
+    m_vLayoutRegionOfInterest->addStretch();
+
+    m_groupRegionOfInterest = new QGroupBox;
+    m_groupRegionOfInterest->setLayout(m_vLayoutRegionOfInterest);
+}
+
 void DialogImportRAW3D::setupSectionOKAndCancel() {
     m_buttonOK = new QPushButton;
     m_buttonOK->setText(QString("OK"));
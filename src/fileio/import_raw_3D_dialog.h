@@ -21,6 +21,9 @@ public:
 
     const ImportItemRaw getImportItem() const;
 
+    // the region of interest is only supported for single volumes
+    void setRegionOfInterestVisible(bool visible);
+
 public slots:
     void selectFile();
     void onOKButtonClicked();
@@ -31,10 +34,11 @@ private:
     bool checkIsBigEndian();
 
     void setupSectionPathToFile();
-    void setupSectionBitsPerVoxel();
+    void setupSectionVoxelType();
     void setupSectionEndianess();
     void setupSectionSize();
     void setupSectionSpacing();
+    void setupSectionRegionOfInterest();
     void setupSectionOKAndCancel();
 
     // Dialog Window
@@ -48,11 +52,11 @@ private:
     QLineEdit* m_textPathToFile;
     QPushButton* m_buttonPathToFile;
 
-    // Bits per voxel
-    QGroupBox* m_groupBitsPerVoxel;
-    QHBoxLayout* m_hLayoutBitsPerVoxel;
-    QLabel* m_labelBitsPerVoxel;
-    QComboBox* m_comboBoxBitsPerVoxelOptions;
+    // Voxel type
+    QGroupBox* m_groupVoxelType;
+    QHBoxLayout* m_hLayoutVoxelType;
+    QLabel* m_labelVoxelType;
+    QComboBox* m_comboBoxVoxelTypeOptions;
 
     // Endianess
     QGroupBox* m_groupEndianess;
@@ -80,6 +84,26 @@ private:
     QLineEdit* m_textSpacingZ;
     QRegularExpressionValidator* m_validatorSpacing;
 
+    // Region of interest
+    QGroupBox* m_groupRegionOfInterest;
+    QVBoxLayout* m_vLayoutRegionOfInterest;
+    QLabel* m_labelRegionOffset;
+    QHBoxLayout* m_hLayoutRegionOffset;
+    QLineEdit* m_textRegionOffsetX;
+    QLineEdit* m_textRegionOffsetY;
+    QLineEdit* m_textRegionOffsetZ;
+    QLabel* m_labelRegionSize;
+    QHBoxLayout* m_hLayoutRegionSize;
+    QLineEdit* m_textRegionSizeX;
+    QLineEdit* m_textRegionSizeY;
+    QLineEdit* m_textRegionSizeZ;
+    QLabel* m_labelStride;
+    QHBoxLayout* m_hLayoutStride;
+    QLineEdit* m_textStrideX;
+    QLineEdit* m_textStrideY;
+    QLineEdit* m_textStrideZ;
+    QIntValidator* m_validatorStride;
+
     // OK and Cancel
     QGroupBox* m_groupOKAndCancel;
     QHBoxLayout* m_hLayoutOKAndCancel;
@@ -0,0 +1,130 @@
+#include "mesh_io.h"
+
+#include "common/volume_kernels.h"
+#include "raw_volume_io.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace VDS::MeshIO {
+namespace {
+// triangles converted and written at once
+constexpr std::size_t trianglesPerChunk = 65536;
+
+template <typename T>
+void appendValue(std::vector<char>& buffer, T value) {
+    if (RawVolumeIO::isSystemBigEndian()) {
+        Kernels::swapEndianness(&value, 1);
+    }
+    const std::size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(T));
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+std::array<float, 3> getFaceNormal(const std::array<float, 3>& first,
+                                   const std::array<float, 3>& second,
+                                   const std::array<float, 3>& third) {
+    const std::array<float, 3> u = {second[0] - first[0], second[1] - first[1],
+                                    second[2] - first[2]};
+    const std::array<float, 3> v = {third[0] - first[0], third[1] - first[1],
+                                    third[2] - first[2]};
+    std::array<float, 3> normal = {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2],
+                                   u[0] * v[1] - u[1] * v[0]};
+    const float length =
+        std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+    for (float& component : normal) {
+        component = length > 0.0f ? component / length : 0.0f;
+    }
+    return normal;
+}
+} // namespace
+
+bool exportStlFile(const std::filesystem::path& filePath, const TriangleMesh& mesh) {
+    std::ofstream file(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::vector<char> buffer;
+    // 80 byte header, which must not start with "solid" as ASCII STL files do
+    const std::string header = "Binary STL exported by Volume-Data-Suite";
+    buffer.assign(80, '\0');
+    std::copy(header.begin(), header.end(), buffer.begin());
+    appendValue<std::uint32_t>(buffer, static_cast<std::uint32_t>(mesh.getTriangleCount()));
+
+    for (std::size_t first = 0; first < mesh.getTriangleCount(); first += trianglesPerChunk) {
+        const std::size_t end = std::min(first + trianglesPerChunk, mesh.getTriangleCount());
+        for (std::size_t triangle = first; triangle < end; triangle++) {
+            const std::array<float, 3>& a = mesh.positions[mesh.indices[triangle * 3]];
+            const std::array<float, 3>& b = mesh.positions[mesh.indices[triangle * 3 + 1]];
+            const std::array<float, 3>& c = mesh.positions[mesh.indices[triangle * 3 + 2]];
+            for (const std::array<float, 3>& vector : {getFaceNormal(a, b, c), a, b, c}) {
+                for (const float component : vector) {
+                    appendValue<float>(buffer, component);
+                }
+            }
+            // attribute byte count, unused
+            appendValue<std::uint16_t>(buffer, 0);
+        }
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+    return file.good();
+}
+
+bool exportPlyFile(const std::filesystem::path& filePath, const TriangleMesh& mesh) {
+    std::ofstream file(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << "ply\n"
+         << "format binary_little_endian 1.0\n"
+         << "comment exported by Volume-Data-Suite\n"
+         << "element vertex " << mesh.positions.size() << "\n"
+         << "property float x\n"
+         << "property float y\n"
+         << "property float z\n"
+         << "property float nx\n"
+         << "property float ny\n"
+         << "property float nz\n"
+         << "element face " << mesh.getTriangleCount() << "\n"
+         << "property list uchar uint vertex_indices\n"
+         << "end_header\n";
+
+    std::vector<char> buffer;
+    for (std::size_t first = 0; first < mesh.positions.size(); first += trianglesPerChunk) {
+        const std::size_t end = std::min(first + trianglesPerChunk, mesh.positions.size());
+        for (std::size_t vertex = first; vertex < end; vertex++) {
+            for (const float component : mesh.positions[vertex]) {
+                appendValue<float>(buffer, component);
+            }
+            for (const float component : mesh.normals[vertex]) {
+                appendValue<float>(buffer, component);
+            }
+        }
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+    for (std::size_t first = 0; first < mesh.getTriangleCount(); first += trianglesPerChunk) {
+        const std::size_t end = std::min(first + trianglesPerChunk, mesh.getTriangleCount());
+        for (std::size_t triangle = first; triangle < end; triangle++) {
+            appendValue<std::uint8_t>(buffer, 3);
+            for (std::size_t corner = 0; corner < 3; corner++) {
+                appendValue<std::uint32_t>(buffer, mesh.indices[triangle * 3 + corner]);
+            }
+        }
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+    return file.good();
+}
+} // namespace VDS::MeshIO
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <filesystem>
+
+#include "common/triangle_mesh.h"
+
+// Writes triangle meshes for CAD and 3D printing tools, both formats as binary little endian
+namespace VDS::MeshIO {
+// STL has no shared vertices, every triangle stores its three positions and its face normal
+bool exportStlFile(const std::filesystem::path& filePath, const TriangleMesh& mesh);
+// PLY keeps the indexed vertices together with their normals
+bool exportPlyFile(const std::filesystem::path& filePath, const TriangleMesh& mesh);
+} // namespace VDS::MeshIO
@@ -0,0 +1,859 @@
+#include "raw_volume_io.h"
+
+#include "common/volume_kernels.h"
+#include "tools/volume_reorientation.h"
+
+#include <QDebug>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace VDS::RawVolumeIO {
+namespace {
+// number of voxels converted per block during export
+constexpr std::size_t exportBlockSize = 1 << 20;
+// brick slabs are combined into chunks of at least this size, so small volumes are not read in
+// tiny pieces
+constexpr std::size_t minimumChunkSizeInBytes = std::size_t{8} << 20;
+// rows of a region import that are at most this far apart are read together, since skipping a
+// few KiB costs more as a separate request than reading them
+constexpr std::size_t maximumReadGapInBytes = std::size_t{16} << 10;
+// upper bound of a single read of a region import
+constexpr std::size_t maximumReadSizeInBytes = std::size_t{8} << 20;
+// upper bound of the slabs held in memory by binary slice imports and out-of-core processing
+constexpr std::size_t maximumSlabSizeInBytes = std::size_t{64} << 20;
+
+// Read only file that reads at given byte offsets without a shared file position, so several
+// threads can read from it at once
+class PositionedFile {
+public:
+    explicit PositionedFile(const std::filesystem::path& filePath) {
+#ifdef _WIN32
+        m_handle = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                               OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+#else
+        m_descriptor = ::open(filePath.c_str(), O_RDONLY);
+#endif
+    }
+    ~PositionedFile() {
+#ifdef _WIN32
+        if (isOpen()) {
+            CloseHandle(m_handle);
+        }
+#else
+        if (isOpen()) {
+            ::close(m_descriptor);
+        }
+#endif
+    }
+    PositionedFile(const PositionedFile&) = delete;
+    PositionedFile& operator=(const PositionedFile&) = delete;
+
+    bool isOpen() const {
+#ifdef _WIN32
+        return m_handle != INVALID_HANDLE_VALUE;
+#else
+        return m_descriptor >= 0;
+#endif
+    }
+
+    bool read(void* destination, std::size_t bytes, std::uintmax_t byteOffset) const {
+        char* target = reinterpret_cast<char*>(destination);
+        while (bytes > 0) {
+#ifdef _WIN32
+            OVERLAPPED overlapped{};
+            overlapped.Offset = static_cast<DWORD>(byteOffset & 0xFFFFFFFF);
+            overlapped.OffsetHigh = static_cast<DWORD>(byteOffset >> 32);
+            const DWORD requested = static_cast<DWORD>(std::min<std::size_t>(bytes, 1 << 30));
+            DWORD bytesRead = 0;
+            if (!ReadFile(m_handle, target, requested, &bytesRead, &overlapped) ||
+                bytesRead == 0) {
+                return false;
+            }
+#else
+            const ssize_t bytesRead =
+                ::pread(m_descriptor, target, bytes, static_cast<off_t>(byteOffset));
+            if (bytesRead < 0 && errno == EINTR) {
+                continue;
+            }
+            if (bytesRead <= 0) {
+                return false;
+            }
+#endif
+            target += bytesRead;
+            bytes -= static_cast<std::size_t>(bytesRead);
+            byteOffset += static_cast<std::uintmax_t>(bytesRead);
+        }
+        return true;
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE m_handle;
+#else
+    int m_descriptor;
+#endif
+};
+
+bool readFile(const std::filesystem::path& filePath, void* destination, std::size_t bytes) {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(filePath, error) ||
+        std::filesystem::file_size(filePath, error) < bytes) {
+        return false;
+    }
+
+    std::ifstream file(filePath, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file.read(reinterpret_cast<char*>(destination), static_cast<std::streamsize>(bytes));
+    return static_cast<std::size_t>(file.gcount()) == bytes;
+}
+
+void logThroughput(const char* operation, const std::size_t bytes,
+                   const std::chrono::steady_clock::time_point start) {
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    qInfo("%s %.1f MB in %.1f ms (%.2f GB/s, %s kernels)", operation,
+          static_cast<double>(bytes) / 1e6, seconds * 1e3,
+          static_cast<double>(bytes) / 1e9 / std::max(seconds, 1e-9),
+          Kernels::Simd::getInstructionSetName(Kernels::Simd::getInstructionSet()));
+}
+
+// converts the imported voxels to the system endianness and determines the value range of
+// floating point volumes
+void finishImport(Volume& volume, const bool littleEndian) {
+    dispatchVoxelType(volume.getVoxelType(), [&](auto tag) {
+        using T = decltype(tag);
+        if (littleEndian == isSystemBigEndian()) {
+            Kernels::swapEndianness(volume.getData<T>(), volume.getVoxelCount());
+        }
+        if constexpr (std::is_floating_point_v<T>) {
+            volume.setValueRange(
+                Kernels::computeValueRange(volume.getData<T>(), volume.getVoxelCount()));
+        }
+    });
+}
+
+// Reads the voxels in chunks of whole brick slabs directly into volume. While the next chunk gets
+// read, the previous one is converted to the system endianness and folded into histogram, brick
+// ranges and value range in parallel, so every voxel is only touched once while it is in cache.
+// Each task owns its histogram bins and brick rows, so no synchronization is needed.
+template <typename T>
+bool streamRawFile(std::ifstream& file, Volume& volume, const bool swapBytes,
+                   VolumeHistogram* histogram, VolumeBrickRanges* brickRanges) {
+    constexpr std::size_t brickSize = VolumeBrickRanges::brickSize;
+    const std::size_t sizeX = volume.getSizeX();
+    const std::size_t sizeY = volume.getSizeY();
+    const std::size_t sizeZ = volume.getSizeZ();
+    const std::array<std::size_t, 3> brickCount =
+        VolumeBrickRanges::computeBrickCount(volume.getSize());
+
+    const std::size_t slabSizeInBytes = sizeX * sizeY * brickSize * sizeof(T);
+    const std::size_t chunkSliceCount =
+        std::max<std::size_t>(minimumChunkSizeInBytes / slabSizeInBytes, 1) * brickSize;
+
+    // brick ranges are needed for the value range of floating point volumes as well
+    const bool computeRanges = brickRanges != nullptr || std::is_floating_point_v<T>;
+    const bool computeHistogram = histogram != nullptr && std::is_integral_v<T>;
+    std::vector<ValueRange> ranges(computeRanges ? brickCount[0] * brickCount[1] * brickCount[2]
+                                                 : 0);
+
+    std::vector<std::size_t> tasks(
+        static_cast<std::size_t>(std::max(QThread::idealThreadCount(), 1)));
+    std::iota(tasks.begin(), tasks.end(), 0);
+    std::vector<std::vector<uint64_t>> taskBins(
+        computeHistogram ? tasks.size() : 0,
+        std::vector<uint64_t>(Kernels::getValueCount<T>(), 0));
+
+    const auto readChunk = [&](const std::size_t firstSlice) {
+        const std::size_t bytes =
+            std::min(chunkSliceCount, sizeZ - firstSlice) * sizeX * sizeY * sizeof(T);
+        file.read(reinterpret_cast<char*>(volume.getRow<T>(0, firstSlice)),
+                  static_cast<std::streamsize>(bytes));
+        return static_cast<std::size_t>(file.gcount()) == bytes;
+    };
+
+    const auto processBrickRow = [&](const std::size_t task, const std::size_t brickY,
+                                     const std::size_t brickZ) {
+        ValueRange* rowRanges =
+            computeRanges ? &ranges[(brickZ * brickCount[1] + brickY) * brickCount[0]] : nullptr;
+        const std::size_t endY = std::min((brickY + 1) * brickSize, sizeY);
+        const std::size_t endZ = std::min((brickZ + 1) * brickSize, sizeZ);
+
+        for (std::size_t z = brickZ * brickSize; z < endZ; z++) {
+            for (std::size_t y = brickY * brickSize; y < endY; y++) {
+                T* row = volume.getRow<T>(y, z);
+                if (swapBytes) {
+                    Kernels::swapEndianness(row, sizeX);
+                }
+                if (computeHistogram) {
+                    Kernels::accumulateHistogram(row, sizeX, volume.getValueRange(),
+                                                 taskBins[task]);
+                }
+                if (!computeRanges) {
+                    continue;
+                }
+
+                const bool firstRow = z == brickZ * brickSize && y == brickY * brickSize;
+                for (std::size_t brickX = 0; brickX < brickCount[0]; brickX++) {
+                    const T* segment = row + brickX * brickSize;
+                    const std::size_t count = std::min(brickSize, sizeX - brickX * brickSize);
+                    const auto [minimum, maximum] = std::minmax_element(segment, segment + count);
+                    ValueRange& range = rowRanges[brickX];
+                    if (firstRow) {
+                        range = ValueRange{static_cast<float>(*minimum),
+                                           static_cast<float>(*maximum)};
+                    } else {
+                        range.minimum = std::min(range.minimum, static_cast<float>(*minimum));
+                        range.maximum = std::max(range.maximum, static_cast<float>(*maximum));
+                    }
+                }
+            }
+        }
+    };
+
+    const auto processChunk = [&](const std::size_t firstSlice) {
+        // chunks start at a brick slab, so no brick row is shared between chunks
+        const std::size_t firstBrickZ = firstSlice / brickSize;
+        const std::size_t brickRowCount =
+            ((std::min(firstSlice + chunkSliceCount, sizeZ) - 1) / brickSize - firstBrickZ + 1) *
+            brickCount[1];
+
+        QtConcurrent::blockingMap(tasks, [&](const std::size_t& task) {
+            const std::size_t begin = brickRowCount * task / tasks.size();
+            const std::size_t end = brickRowCount * (task + 1) / tasks.size();
+            for (std::size_t brickRow = begin; brickRow < end; brickRow++) {
+                processBrickRow(task, brickRow % brickCount[1],
+                                firstBrickZ + brickRow / brickCount[1]);
+            }
+        });
+    };
+
+    if (!readChunk(0)) {
+        return false;
+    }
+    for (std::size_t firstSlice = 0; firstSlice < sizeZ; firstSlice += chunkSliceCount) {
+        // double buffering within the volume: the next chunk is read while this one is processed
+        const std::size_t nextSlice = firstSlice + chunkSliceCount;
+        QFuture<bool> nextRead;
+        if (nextSlice < sizeZ) {
+            nextRead =
+                QtConcurrent::run([&readChunk, nextSlice]() { return readChunk(nextSlice); });
+        }
+
+        if (swapBytes || computeHistogram || computeRanges) {
+            processChunk(firstSlice);
+        }
+
+        if (nextSlice < sizeZ && !nextRead.result()) {
+            return false;
+        }
+    }
+
+    if constexpr (std::is_floating_point_v<T>) {
+        ValueRange valueRange = VolumeBrickRanges(brickCount, ranges).getRange();
+        // avoid a division by zero for constant volumes
+        if (valueRange.maximum <= valueRange.minimum) {
+            valueRange.maximum = valueRange.minimum + 1.0f;
+        }
+        volume.setValueRange(valueRange);
+    }
+
+    if (histogram != nullptr) {
+        if constexpr (std::is_integral_v<T>) {
+            std::vector<uint64_t> bins(Kernels::getValueCount<T>(), 0);
+            for (const std::vector<uint64_t>& partialBins : taskBins) {
+                std::transform(bins.begin(), bins.end(), partialBins.begin(), bins.begin(),
+                               std::plus<uint64_t>());
+            }
+            *histogram = VolumeHistogram(volume.getVoxelType(), volume.getValueRange(),
+                                         std::move(bins));
+        } else {
+            // floating point bins depend on the value range, which is only known now
+            *histogram = VolumeHistogram(volume);
+        }
+    }
+    if (brickRanges != nullptr) {
+        *brickRanges = VolumeBrickRanges(brickCount, std::move(ranges));
+    }
+
+    return true;
+}
+
+bool importRawVolume(const std::filesystem::path& filePath, const std::uintmax_t byteOffset,
+                     const VoxelType voxelType, const bool littleEndian,
+                     const std::array<std::size_t, 3>& size, const std::array<float, 3>& spacing,
+                     Volume& volume, VolumeHistogram* histogram,
+                     VolumeBrickRanges* brickRanges) {
+    if (size[0] == 0 || size[1] == 0 || size[2] == 0) {
+        return false;
+    }
+
+    Volume importedVolume(size, spacing, voxelType);
+
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(filePath, error) ||
+        std::filesystem::file_size(filePath, error) <
+            byteOffset + importedVolume.getSizeInBytes()) {
+        return false;
+    }
+
+    std::ifstream file(filePath, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    if (byteOffset > 0) {
+        file.seekg(static_cast<std::streamoff>(byteOffset));
+        if (!file.good()) {
+            return false;
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool swapBytes = littleEndian == isSystemBigEndian();
+    const bool success = dispatchVoxelType(voxelType, [&](auto tag) {
+        using T = decltype(tag);
+        return streamRawFile<T>(file, importedVolume, swapBytes, histogram, brickRanges);
+    });
+    if (!success) {
+        return false;
+    }
+    logThroughput("Imported", importedVolume.getSizeInBytes(), start);
+
+    volume = std::move(importedVolume);
+    return true;
+}
+
+// Reads one output slice of a region import. Rows needed by the slice are grouped into reads of
+// neighbouring rows, every stride-th voxel of a row is then copied out of the read buffer.
+template <typename T>
+bool readRegionSlice(const PositionedFile& file, const std::array<std::size_t, 3>& fileSize,
+                     const VolumeRegion& region, const std::array<std::size_t, 3>& stride,
+                     const std::size_t z, Volume& volume, std::vector<char>& buffer) {
+    const std::size_t sizeX = volume.getSizeX();
+    const std::size_t sizeY = volume.getSizeY();
+    const std::size_t sourceZ = region.offset[2] + z * stride[2];
+    const std::size_t rowBytes = ((sizeX - 1) * stride[0] + 1) * sizeof(T);
+
+    const auto getRowOffset = [&](std::size_t y) {
+        const std::uintmax_t sourceY = region.offset[1] + y * stride[1];
+        return ((static_cast<std::uintmax_t>(sourceZ) * fileSize[1] + sourceY) * fileSize[0] +
+                region.offset[0]) *
+               sizeof(T);
+    };
+
+    std::size_t firstRow = 0;
+    while (firstRow < sizeY) {
+        const std::uintmax_t readOffset = getRowOffset(firstRow);
+        std::size_t endRow = firstRow + 1;
+        while (endRow < sizeY) {
+            const std::uintmax_t gap = getRowOffset(endRow) - (getRowOffset(endRow - 1) + rowBytes);
+            if (gap > maximumReadGapInBytes ||
+                getRowOffset(endRow) + rowBytes - readOffset > maximumReadSizeInBytes) {
+                break;
+            }
+            endRow++;
+        }
+
+        const std::size_t readBytes =
+            static_cast<std::size_t>(getRowOffset(endRow - 1) + rowBytes - readOffset);
+        buffer.resize(readBytes);
+        if (!file.read(buffer.data(), readBytes, readOffset)) {
+            return false;
+        }
+
+        for (std::size_t y = firstRow; y < endRow; y++) {
+            const char* source = buffer.data() + (getRowOffset(y) - readOffset);
+            T* destination = volume.getRow<T>(y, z);
+            if (stride[0] == 1) {
+                std::memcpy(destination, source, sizeX * sizeof(T));
+            } else {
+                for (std::size_t x = 0; x < sizeX; x++) {
+                    std::memcpy(destination + x, source + x * stride[0] * sizeof(T), sizeof(T));
+                }
+            }
+        }
+        firstRow = endRow;
+    }
+    return true;
+}
+
+template <typename Source, typename Destination>
+bool exportRawFileTyped(std::ofstream& file, const Volume& volume, const bool swapBytes,
+                        const ValueWindowSettings& window, const ProgressCallback& progress) {
+    const Source* source = volume.getData<Source>();
+    const std::size_t voxelCount = volume.getVoxelCount();
+
+    const Kernels::VoxelConverter<Source, Destination> converter(volume.getValueRange(), window);
+    std::vector<Destination> converted(std::min(exportBlockSize, voxelCount));
+
+    for (std::size_t offset = 0; offset < voxelCount; offset += exportBlockSize) {
+        const std::size_t count = std::min(exportBlockSize, voxelCount - offset);
+
+        converter.convert(source + offset, converted.data(), count);
+
+        if (swapBytes) {
+            Kernels::swapEndianness(converted.data(), count);
+        }
+
+        file.write(reinterpret_cast<const char*>(converted.data()),
+                   static_cast<std::streamsize>(count * sizeof(Destination)));
+        if (!file.good()) {
+            return false;
+        }
+
+        if (progress && !progress(static_cast<float>(offset + count) / voxelCount)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+} // namespace
+
+bool importRawFile(const std::filesystem::path& filePath, const VoxelType voxelType,
+                   const bool littleEndian, const std::array<std::size_t, 3>& size,
+                   const std::array<float, 3>& spacing, CachedVolume& contents) {
+    return importRawVolume(filePath, 0, voxelType, littleEndian, size, spacing, contents.volume,
+                           &contents.histogram, &contents.brickRanges);
+}
+
+bool importRawFileCompressed(const std::filesystem::path& filePath, const VoxelType voxelType,
+                             const bool littleEndian, const std::array<std::size_t, 3>& size,
+                             const std::array<float, 3>& spacing,
+                             std::shared_ptr<CompressedVolume>& volume,
+                             const ProgressCallback& progress) {
+    RawSliceReader reader(filePath, voxelType, littleEndian, size, spacing);
+    if (!reader.isOpen()) {
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto compressedVolume = std::make_shared<CompressedVolume>(size, spacing, voxelType);
+    Volume slab;
+    for (std::size_t firstSlice = 0; firstSlice < size[2];
+         firstSlice += CompressedVolume::brickSize) {
+        const std::size_t sliceCount = std::min(CompressedVolume::brickSize, size[2] - firstSlice);
+        if (!reader.readSlab(firstSlice, sliceCount, slab) ||
+            !compressedVolume->insertSlab(slab, firstSlice)) {
+            return false;
+        }
+        if (progress && !progress(static_cast<float>(firstSlice + sliceCount) / size[2])) {
+            return false;
+        }
+    }
+
+    // the brick ranges are collected while compressing, so floating point volumes need no
+    // separate pass over the file for their value range
+    if (voxelType == VoxelType::Float32) {
+        compressedVolume->setValueRange(compressedVolume->getBrickRanges().getRange());
+    }
+
+    const std::size_t sizeInBytes = compressedVolume->getSizeInBytes();
+    logThroughput("Imported", sizeInBytes, start);
+    const std::size_t compressedSizeInBytes = compressedVolume->getCompressedSizeInBytes();
+    qInfo("Compressed to %.1f MB (%.2fx)", static_cast<double>(compressedSizeInBytes) / 1e6,
+          static_cast<double>(sizeInBytes) / std::max<double>(compressedSizeInBytes, 1));
+
+    volume = std::move(compressedVolume);
+    return true;
+}
+
+bool importRawFrame(const std::filesystem::path& filePath, const std::uintmax_t byteOffset,
+                    const VoxelType voxelType, const bool littleEndian,
+                    const std::array<std::size_t, 3>& size, const std::array<float, 3>& spacing,
+                    Volume& volume) {
+    return importRawVolume(filePath, byteOffset, voxelType, littleEndian, size, spacing, volume,
+                           nullptr, nullptr);
+}
+
+bool importRawRegion(const std::filesystem::path& filePath, const VoxelType voxelType,
+                     const bool littleEndian, const std::array<std::size_t, 3>& size,
+                     const std::array<float, 3>& spacing, const VolumeRegion& region,
+                     const std::array<std::size_t, 3>& stride, Volume& volume) {
+    const auto end = region.getEnd();
+    std::array<std::size_t, 3> importedSize{};
+    std::array<float, 3> importedSpacing{};
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        if (region.size[axis] == 0 || stride[axis] == 0 || end[axis] > size[axis]) {
+            return false;
+        }
+        importedSize[axis] = (region.size[axis] + stride[axis] - 1) / stride[axis];
+        importedSpacing[axis] = spacing[axis] * static_cast<float>(stride[axis]);
+    }
+
+    Volume importedVolume(importedSize, importedSpacing, voxelType);
+
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(filePath, error) ||
+        std::filesystem::file_size(filePath, error) <
+            size[0] * size[1] * size[2] * getBytesPerVoxel(voxelType)) {
+        return false;
+    }
+
+    const PositionedFile file(filePath);
+    if (!file.isOpen()) {
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::size_t> slices(importedSize[2]);
+    std::iota(slices.begin(), slices.end(), 0);
+    std::atomic<bool> success{true};
+    dispatchVoxelType(voxelType, [&](auto tag) {
+        using T = decltype(tag);
+        QtConcurrent::blockingMap(slices, [&](const std::size_t z) {
+            std::vector<char> buffer;
+            if (success &&
+                !readRegionSlice<T>(file, size, region, stride, z, importedVolume, buffer)) {
+                success = false;
+            }
+        });
+    });
+    if (!success) {
+        return false;
+    }
+    logThroughput("Imported region", importedVolume.getSizeInBytes(), start);
+
+    finishImport(importedVolume, littleEndian);
+
+    volume = std::move(importedVolume);
+    return true;
+}
+
+bool importBinarySlices(const std::filesystem::path& directoryPath, const VoxelType voxelType,
+                        const bool littleEndian, const VDTK::VolumeAxis axis,
+                        const std::array<std::size_t, 3>& size,
+                        const std::array<float, 3>& spacing, Volume& volume) {
+    if (size[0] == 0 || size[1] == 0 || size[2] == 0) {
+        return false;
+    }
+
+    std::error_code error;
+    if (!std::filesystem::is_directory(directoryPath, error)) {
+        return false;
+    }
+
+    std::vector<std::filesystem::path> slicePaths;
+    for (const auto& directoryEntry : std::filesystem::directory_iterator(directoryPath, error)) {
+        // skip subdirectories
+        if (directoryEntry.is_regular_file()) {
+            slicePaths.push_back(directoryEntry.path());
+        }
+    }
+    std::sort(slicePaths.begin(), slicePaths.end());
+
+    // slice width and height in voxels and the axis the slices are stacked along
+    std::size_t sliceWidth = 0;
+    std::size_t sliceHeight = 0;
+    std::size_t sliceCount = 0;
+    switch (axis) {
+    case VDTK::VolumeAxis::YZAxis:
+        sliceWidth = size[1];
+        sliceHeight = size[2];
+        sliceCount = size[0];
+        break;
+    case VDTK::VolumeAxis::XZAxis:
+        sliceWidth = size[0];
+        sliceHeight = size[2];
+        sliceCount = size[1];
+        break;
+    case VDTK::VolumeAxis::XYAxis:
+    default:
+        sliceWidth = size[0];
+        sliceHeight = size[1];
+        sliceCount = size[2];
+        break;
+    }
+
+    if (slicePaths.size() != sliceCount) {
+        return false;
+    }
+
+    // slices as stored in the files are stacked along Z and reoriented onto the volume axes
+    const std::array<std::size_t, 3> stackSize = {sliceWidth, sliceHeight, sliceCount};
+    Reorientation reorientation;
+    switch (axis) {
+    case VDTK::VolumeAxis::YZAxis:
+        reorientation.axes = {2, 0, 1};
+        break;
+    case VDTK::VolumeAxis::XZAxis:
+        reorientation.axes = {0, 2, 1};
+        break;
+    case VDTK::VolumeAxis::XYAxis:
+    default:
+        break;
+    }
+
+    Volume importedVolume(size, spacing, voxelType);
+
+    // Slices along Z are read straight into the volume. Other stacks are read in slabs into a
+    // bounded buffer and transposed into the volume from there.
+    const bool reorient = !reorientation.isIdentity();
+    const std::size_t sliceBytes = sliceWidth * sliceHeight * getBytesPerVoxel(voxelType);
+    const std::size_t slabSliceCount =
+        reorient ? std::clamp<std::size_t>(maximumSlabSizeInBytes / sliceBytes, 1, sliceCount)
+                 : sliceCount;
+    std::vector<uint8_t> slab(reorient ? slabSliceCount * sliceBytes : 0);
+
+    for (std::size_t firstSlice = 0; firstSlice < sliceCount; firstSlice += slabSliceCount) {
+        const std::size_t slabSlices = std::min(slabSliceCount, sliceCount - firstSlice);
+        uint8_t* slabData = reorient ? slab.data()
+                                     : reinterpret_cast<uint8_t*>(importedVolume.getRawData()) +
+                                           firstSlice * sliceBytes;
+
+        std::vector<std::size_t> slices(slabSlices);
+        std::iota(slices.begin(), slices.end(), 0);
+        std::atomic<bool> success{true};
+        QtConcurrent::blockingMap(slices, [&](const std::size_t slice) {
+            if (success && !readFile(slicePaths[firstSlice + slice],
+                                     slabData + slice * sliceBytes, sliceBytes)) {
+                success = false;
+            }
+        });
+        if (!success) {
+            return false;
+        }
+
+        if (reorient) {
+            reorientSlab(slabData, stackSize, firstSlice, slabSlices, reorientation,
+                         importedVolume);
+        }
+    }
+
+    finishImport(importedVolume, littleEndian);
+
+    volume = std::move(importedVolume);
+    return true;
+}
+
+bool exportRawFile(const std::filesystem::path& filePath, const Volume& volume,
+                   const VoxelType outputType, const bool littleEndian,
+                   const ValueWindowSettings& window, const ProgressCallback& progress) {
+    if (volume.isEmpty()) {
+        return false;
+    }
+
+    RawSliceWriter writer(filePath, outputType, littleEndian);
+    if (!writer.isOpen()) {
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool success = writer.writeSlab(volume, window, progress);
+    if (success) {
+        logThroughput("Exported", volume.getSizeInBytes(), start);
+    }
+    return success;
+}
+
+bool exportRawFile(const std::filesystem::path& filePath, const CompressedVolume& volume,
+                   const VoxelType outputType, const bool littleEndian,
+                   const ValueWindowSettings& window, const ProgressCallback& progress) {
+    if (volume.isEmpty()) {
+        return false;
+    }
+
+    RawSliceWriter writer(filePath, outputType, littleEndian);
+    if (!writer.isOpen()) {
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::size_t sizeZ = volume.getSize()[2];
+    const std::size_t slabSliceCount = volume.getSlabSliceCount(maximumSlabSizeInBytes);
+    Volume slab;
+    for (std::size_t firstSlice = 0; firstSlice < sizeZ; firstSlice += slabSliceCount) {
+        if (!volume.readSlab(firstSlice, std::min(slabSliceCount, sizeZ - firstSlice), slab) ||
+            !writer.writeSlab(slab, window)) {
+            return false;
+        }
+
+        const std::size_t sliceEnd = std::min(firstSlice + slabSliceCount, sizeZ);
+        if (progress && !progress(static_cast<float>(sliceEnd) / sizeZ)) {
+            return false;
+        }
+    }
+    logThroughput("Exported", volume.getSizeInBytes(), start);
+    return true;
+}
+
+bool isSystemBigEndian() {
+    union {
+        uint32_t i;
+        char c[4];
+    } bint = {0x01020304};
+
+    return bint.c[0] == 1;
+}
+
+RawSliceReader::RawSliceReader(const std::filesystem::path& filePath, const VoxelType voxelType,
+                               const bool littleEndian, const std::array<std::size_t, 3>& size,
+                               const std::array<float, 3>& spacing)
+    : m_file(filePath, std::ios::in | std::ios::binary), m_voxelType(voxelType),
+      m_littleEndian(littleEndian), m_size(size), m_spacing(spacing), m_open(false) {
+    std::error_code error;
+    m_open = m_file.is_open() && size[0] > 0 && size[1] > 0 && size[2] > 0 &&
+             std::filesystem::file_size(filePath, error) >=
+                 size[0] * size[1] * size[2] * getBytesPerVoxel(voxelType);
+}
+
+bool RawSliceReader::isOpen() const {
+    return m_open;
+}
+
+VoxelType RawSliceReader::getVoxelType() const {
+    return m_voxelType;
+}
+
+const std::array<std::size_t, 3>& RawSliceReader::getSize() const {
+    return m_size;
+}
+
+const std::array<float, 3>& RawSliceReader::getSpacing() const {
+    return m_spacing;
+}
+
+bool RawSliceReader::readSlab(const std::size_t firstSlice, const std::size_t sliceCount,
+                              Volume& slab) {
+    if (!m_open || sliceCount == 0 || firstSlice + sliceCount > m_size[2]) {
+        return false;
+    }
+
+    const std::array<std::size_t, 3> slabSize = {m_size[0], m_size[1], sliceCount};
+    if (slab.getSize() != slabSize || slab.getVoxelType() != m_voxelType) {
+        slab = Volume(slabSize, m_spacing, m_voxelType);
+    }
+
+    const std::size_t sliceBytes = m_size[0] * m_size[1] * getBytesPerVoxel(m_voxelType);
+    m_file.seekg(static_cast<std::streamoff>(firstSlice * sliceBytes));
+    m_file.read(reinterpret_cast<char*>(slab.getRawData()),
+                static_cast<std::streamsize>(slab.getSizeInBytes()));
+    if (static_cast<std::size_t>(m_file.gcount()) != slab.getSizeInBytes()) {
+        m_file.clear();
+        return false;
+    }
+
+    if (m_littleEndian == isSystemBigEndian()) {
+        dispatchVoxelType(m_voxelType, [&](auto tag) {
+            using T = decltype(tag);
+            Kernels::swapEndianness(slab.getData<T>(), slab.getVoxelCount());
+        });
+    }
+    return true;
+}
+
+bool RawSliceReader::computeValueRange(ValueRange& range) {
+    if (!m_open) {
+        return false;
+    }
+
+    if (m_voxelType != VoxelType::Float32) {
+        range = dispatchVoxelType(m_voxelType, [](auto tag) {
+            using T = decltype(tag);
+            return getVoxelTypeRange<T>();
+        });
+        return true;
+    }
+
+    const std::size_t slabSliceCount = getSlabSliceCount(maximumSlabSizeInBytes);
+    Volume slab;
+    bool first = true;
+    for (std::size_t firstSlice = 0; firstSlice < m_size[2]; firstSlice += slabSliceCount) {
+        if (!readSlab(firstSlice, std::min(slabSliceCount, m_size[2] - firstSlice), slab)) {
+            return false;
+        }
+        const ValueRange slabRange =
+            Kernels::computeValueRange(slab.getData<float>(), slab.getVoxelCount());
+        range.minimum = first ? slabRange.minimum : std::min(range.minimum, slabRange.minimum);
+        range.maximum = first ? slabRange.maximum : std::max(range.maximum, slabRange.maximum);
+        first = false;
+    }
+    return true;
+}
+
+std::size_t RawSliceReader::getSlabSliceCount(const std::size_t maximumSlabSizeInBytes) const {
+    const std::size_t sliceBytes =
+        std::max<std::size_t>(m_size[0] * m_size[1] * getBytesPerVoxel(m_voxelType), 1);
+    return std::clamp<std::size_t>(maximumSlabSizeInBytes / sliceBytes, 1,
+                                   std::max<std::size_t>(m_size[2], 1));
+}
+
+RawSliceWriter::RawSliceWriter(const std::filesystem::path& filePath, const VoxelType outputType,
+                               const bool littleEndian)
+    : m_file(filePath, std::ios::out | std::ios::binary | std::ios::trunc),
+      m_outputType(outputType), m_swapBytes(littleEndian == isSystemBigEndian()) {}
+
+bool RawSliceWriter::isOpen() const {
+    return m_file.is_open();
+}
+
+bool RawSliceWriter::writeSlab(const Volume& slab, const ValueWindowSettings& window,
+                               const ProgressCallback& progress) {
+    return dispatchVoxelType(slab.getVoxelType(), [&](auto sourceTag) {
+        using Source = decltype(sourceTag);
+        return dispatchVoxelType(m_outputType, [&](auto destinationTag) {
+            using Destination = decltype(destinationTag);
+            return exportRawFileTyped<Source, Destination>(m_file, slab, m_swapBytes, window,
+                                                           progress);
+        });
+    });
+}
+
+bool convertRawFile(const std::filesystem::path& sourcePath, const VoxelType voxelType,
+                    const bool littleEndian, const std::array<std::size_t, 3>& size,
+                    const std::filesystem::path& destinationPath, const VoxelType outputType,
+                    const bool outputLittleEndian, const ValueWindowSettings& window,
+                    const ProgressCallback& progress) {
+    RawSliceReader reader(sourcePath, voxelType, littleEndian, size, {1.0f, 1.0f, 1.0f});
+    ValueRange valueRange;
+    if (!reader.isOpen() || !reader.computeValueRange(valueRange)) {
+        return false;
+    }
+
+    RawSliceWriter writer(destinationPath, outputType, outputLittleEndian);
+    if (!writer.isOpen()) {
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::size_t slabSliceCount = reader.getSlabSliceCount(maximumSlabSizeInBytes);
+    Volume slab;
+    for (std::size_t firstSlice = 0; firstSlice < size[2]; firstSlice += slabSliceCount) {
+        if (!reader.readSlab(firstSlice, std::min(slabSliceCount, size[2] - firstSlice), slab)) {
+            return false;
+        }
+        slab.setValueRange(valueRange);
+        if (!writer.writeSlab(slab, window)) {
+            return false;
+        }
+
+        const std::size_t sliceEnd = std::min(firstSlice + slabSliceCount, size[2]);
+        if (progress && !progress(static_cast<float>(sliceEnd) / size[2])) {
+            return false;
+        }
+    }
+    logThroughput("Converted", size[0] * size[1] * size[2] * getBytesPerVoxel(voxelType), start);
+    return true;
+}
+} // namespace VDS::RawVolumeIO
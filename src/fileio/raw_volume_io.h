@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+#include <VDTK/common/CommonDataTypes.h>
+
+#include "common/compressed_volume.h"
+#include "common/progress_callback.h"
+#include "common/volume.h"
+#include "common/volume_cache.h"
+#include "common/volume_region.h"
+#include "renderer/shader/shader_settings.h"
+
+// Reads and writes uncompressed volume data in its native voxel type
+namespace VDS::RawVolumeIO {
+// Streams the file into the volume in a single pass. Endianness conversion, histogram, brick
+// ranges and the value range are computed on chunks already read while the next chunk is read.
+bool importRawFile(const std::filesystem::path& filePath, const VoxelType voxelType,
+                   const bool littleEndian, const std::array<std::size_t, 3>& size,
+                   const std::array<float, 3>& spacing, CachedVolume& contents);
+
+// Streams the file into a volume compressed brick by brick, so only one brick layer of the
+// decompressed volume is held in memory at a time. progress is called per brick layer.
+bool importRawFileCompressed(const std::filesystem::path& filePath, const VoxelType voxelType,
+                             const bool littleEndian, const std::array<std::size_t, 3>& size,
+                             const std::array<float, 3>& spacing,
+                             std::shared_ptr<CompressedVolume>& volume,
+                             const ProgressCallback& progress = ProgressCallback());
+
+// Imports a single volume starting at byteOffset, e.g. one frame of a multi-frame raw file
+bool importRawFrame(const std::filesystem::path& filePath, const std::uintmax_t byteOffset,
+                    const VoxelType voxelType, const bool littleEndian,
+                    const std::array<std::size_t, 3>& size, const std::array<float, 3>& spacing,
+                    Volume& volume);
+
+// Imports only region of a volume of the given size, taking every stride-th voxel per axis. Only
+// the byte ranges of the needed rows are read with positioned reads, rows close to each other are
+// combined into one read. The spacing of the result is multiplied by stride.
+bool importRawRegion(const std::filesystem::path& filePath, const VoxelType voxelType,
+                     const bool littleEndian, const std::array<std::size_t, 3>& size,
+                     const std::array<float, 3>& spacing, const VolumeRegion& region,
+                     const std::array<std::size_t, 3>& stride, Volume& volume);
+
+// Imports one file per slice. Files are imported in alphabetical order.
+bool importBinarySlices(const std::filesystem::path& directoryPath, const VoxelType voxelType,
+                        const bool littleEndian, const VDTK::VolumeAxis axis,
+                        const std::array<std::size_t, 3>& size,
+                        const std::array<float, 3>& spacing, Volume& volume);
+
+// Converts the value range of the volume to the full range of outputType on the fly and optionally
+// applies a value window. No full copy of the volume is created.
+bool exportRawFile(const std::filesystem::path& filePath, const Volume& volume,
+                   const VoxelType outputType, const bool littleEndian,
+                   const ValueWindowSettings& window,
+                   const ProgressCallback& progress = ProgressCallback());
+// decompresses and converts the volume slab by slab
+bool exportRawFile(const std::filesystem::path& filePath, const CompressedVolume& volume,
+                   const VoxelType outputType, const bool littleEndian,
+                   const ValueWindowSettings& window,
+                   const ProgressCallback& progress = ProgressCallback());
+
+bool isSystemBigEndian();
+
+// Reads slabs of XY slices of a raw volume file on demand and converts them to the system
+// endianness, so volumes larger than RAM can be processed slab by slab. Not thread safe.
+class RawSliceReader {
+public:
+    RawSliceReader(const std::filesystem::path& filePath, const VoxelType voxelType,
+                   const bool littleEndian, const std::array<std::size_t, 3>& size,
+                   const std::array<float, 3>& spacing);
+
+    // false if the file could not be opened or is smaller than the volume
+    bool isOpen() const;
+    VoxelType getVoxelType() const;
+    const std::array<std::size_t, 3>& getSize() const;
+    const std::array<float, 3>& getSpacing() const;
+
+    // Replaces slab with the sliceCount slices starting at firstSlice. The slab keeps its memory if
+    // it already has the same size.
+    bool readSlab(const std::size_t firstSlice, const std::size_t sliceCount, Volume& slab);
+    // value range of the whole file for floating point volumes, computed slab by slab
+    bool computeValueRange(ValueRange& range);
+
+    // number of slices per slab, so a slab takes at most maximumSlabSizeInBytes unless a single
+    // slice is larger
+    std::size_t getSlabSliceCount(const std::size_t maximumSlabSizeInBytes) const;
+
+private:
+    std::ifstream m_file;
+    VoxelType m_voxelType;
+    bool m_littleEndian;
+    std::array<std::size_t, 3> m_size;
+    std::array<float, 3> m_spacing;
+    bool m_open;
+};
+
+// Appends slabs of XY slices to a raw volume file, converted to the given voxel type and
+// endianness block by block. Used together with RawSliceReader for out-of-core processing.
+class RawSliceWriter {
+public:
+    RawSliceWriter(const std::filesystem::path& filePath, const VoxelType outputType,
+                   const bool littleEndian);
+
+    bool isOpen() const;
+    // The value range of slab is mapped to the full range of the output type, so slabs of the
+    // same volume need the value range of the whole volume. progress is called per converted block.
+    bool writeSlab(const Volume& slab, const ValueWindowSettings& window,
+                   const ProgressCallback& progress = ProgressCallback());
+
+private:
+    std::ofstream m_file;
+    VoxelType m_outputType;
+    bool m_swapBytes;
+};
+
+// Converts a raw volume file of any size to another voxel type and endianness and optionally
+// applies a value window. Only one slab of the volume is held in memory at a time.
+bool convertRawFile(const std::filesystem::path& sourcePath, const VoxelType voxelType,
+                    const bool littleEndian, const std::array<std::size_t, 3>& size,
+                    const std::filesystem::path& destinationPath, const VoxelType outputType,
+                    const bool outputLittleEndian, const ValueWindowSettings& window,
+                    const ProgressCallback& progress = ProgressCallback());
+} // namespace VDS::RawVolumeIO
@@ -0,0 +1,75 @@
+#include "time_series_io.h"
+
+#include "raw_volume_io.h"
+
+#include <algorithm>
+
+namespace VDS::TimeSeriesIO {
+std::size_t TimeSeries::getTimestepCount() const {
+    return frames.size();
+}
+
+std::size_t TimeSeries::getFrameSizeInBytes() const {
+    return size[0] * size[1] * size[2] * getBytesPerVoxel(voxelType);
+}
+
+bool openTimeSeries(const std::filesystem::path& filePath, const VoxelType voxelType,
+                    const bool littleEndian, const std::array<std::size_t, 3>& size,
+                    const std::array<float, 3>& spacing, TimeSeries& series) {
+    TimeSeries openedSeries;
+    openedSeries.voxelType = voxelType;
+    openedSeries.littleEndian = littleEndian;
+    openedSeries.size = size;
+    openedSeries.spacing = spacing;
+
+    const std::uintmax_t frameSize = openedSeries.getFrameSizeInBytes();
+    if (frameSize == 0) {
+        return false;
+    }
+
+    std::error_code error;
+    const std::uintmax_t fileSize = std::filesystem::file_size(filePath, error);
+    if (error || fileSize < frameSize) {
+        return false;
+    }
+
+    if (fileSize / frameSize > 1) {
+        // multi-frame raw file, trailing bytes of an incomplete frame are ignored
+        for (std::uintmax_t frame = 0; frame < fileSize / frameSize; frame++) {
+            openedSeries.frames.push_back(TimeSeriesFrame{filePath, frame * frameSize});
+        }
+    } else {
+        std::vector<std::filesystem::path> framePaths;
+        for (const auto& directoryEntry :
+             std::filesystem::directory_iterator(filePath.parent_path(), error)) {
+            if (directoryEntry.is_regular_file() &&
+                directoryEntry.path().extension() == filePath.extension() &&
+                directoryEntry.file_size(error) == fileSize) {
+                framePaths.push_back(directoryEntry.path());
+            }
+        }
+        std::sort(framePaths.begin(), framePaths.end());
+
+        for (const auto& framePath : framePaths) {
+            openedSeries.frames.push_back(TimeSeriesFrame{framePath, 0});
+        }
+    }
+
+    if (openedSeries.frames.empty()) {
+        return false;
+    }
+
+    series = std::move(openedSeries);
+    return true;
+}
+
+bool loadTimestep(const TimeSeries& series, std::size_t timestep, Volume& volume) {
+    if (timestep >= series.frames.size()) {
+        return false;
+    }
+
+    const TimeSeriesFrame& frame = series.frames[timestep];
+    return RawVolumeIO::importRawFrame(frame.filePath, frame.byteOffset, series.voxelType,
+                                       series.littleEndian, series.size, series.spacing, volume);
+}
+} // namespace VDS::TimeSeriesIO
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "common/volume.h"
+
+// Time series of raw volumes with the same geometry, e.g. dynamic CT or 4D flow acquisitions
+namespace VDS::TimeSeriesIO {
+// location of a single timestep within the raw files of a time series
+struct TimeSeriesFrame {
+    std::filesystem::path filePath;
+    std::uintmax_t byteOffset = 0;
+};
+
+struct TimeSeries {
+    std::vector<TimeSeriesFrame> frames;
+    VoxelType voxelType = VoxelType::UInt16;
+    bool littleEndian = true;
+    std::array<std::size_t, 3> size = {0, 0, 0};
+    std::array<float, 3> spacing = {1.0f, 1.0f, 1.0f};
+
+    std::size_t getTimestepCount() const;
+    std::size_t getFrameSizeInBytes() const;
+};
+
+// A raw file that holds several volumes of the given size back to back is opened as a multi-frame
+// raw file. Otherwise every file with the same extension and size within the directory of filePath
+// is one timestep, in alphabetical order.
+bool openTimeSeries(const std::filesystem::path& filePath, const VoxelType voxelType,
+                    const bool littleEndian, const std::array<std::size_t, 3>& size,
+                    const std::array<float, 3>& spacing, TimeSeries& series);
+
+bool loadTimestep(const TimeSeries& series, std::size_t timestep, Volume& volume);
+} // namespace VDS::TimeSeriesIO
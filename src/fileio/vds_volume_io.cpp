@@ -0,0 +1,411 @@
+#include "vds_volume_io.h"
+
+#include "common/volume_kernels.h"
+#include "raw_volume_io.h"
+#include "tools/volume_resampler.h"
+
+#include <QByteArray>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+namespace VDS::VdsVolumeIO {
+namespace {
+constexpr char fileMagic[4] = {'V', 'D', 'S', 'V'};
+constexpr uint32_t fileVersion = 1;
+// zlib level 1 decompresses about as fast as higher levels but compresses several times faster
+constexpr int compressionLevel = 1;
+// levels of detail are generated until the longest axis gets shorter than this
+constexpr std::size_t minimumLevelOfDetailSize = 64;
+// coarsest level of detail used as preview should still have this many voxels along its
+// longest axis
+constexpr std::size_t minimumPreviewSize = 128;
+
+// location of a compressed block within the file
+struct BlockEntry {
+    uint64_t offset = 0;
+    uint64_t compressedSize = 0;
+};
+
+struct LevelOfDetail {
+    std::array<std::size_t, 3> size;
+    std::array<float, 3> spacing;
+    BlockEntry block;
+};
+
+// all values are stored in little endian
+template <typename T>
+void writeValue(std::ofstream& file, T value) {
+    if (RawVolumeIO::isSystemBigEndian()) {
+        Kernels::swapEndianness(&value, 1);
+    }
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::ifstream& file, T& value) {
+    file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (RawVolumeIO::isSystemBigEndian()) {
+        Kernels::swapEndianness(&value, 1);
+    }
+    return file.good();
+}
+
+void writeBlockEntry(std::ofstream& file, const BlockEntry& block) {
+    writeValue<uint64_t>(file, block.offset);
+    writeValue<uint64_t>(file, block.compressedSize);
+}
+
+bool readBlockEntry(std::ifstream& file, BlockEntry& block) {
+    return readValue(file, block.offset) && readValue(file, block.compressedSize);
+}
+
+QByteArray compressVolume(const Volume& volume) {
+    if (!RawVolumeIO::isSystemBigEndian()) {
+        return qCompress(reinterpret_cast<const uchar*>(volume.getRawData()),
+                         static_cast<qsizetype>(volume.getSizeInBytes()), compressionLevel);
+    }
+
+    Volume littleEndianVolume = volume;
+    dispatchVoxelType(volume.getVoxelType(), [&](auto tag) {
+        using T = decltype(tag);
+        Kernels::swapEndianness(littleEndianVolume.getData<T>(),
+                                littleEndianVolume.getVoxelCount());
+    });
+    return qCompress(reinterpret_cast<const uchar*>(littleEndianVolume.getRawData()),
+                     static_cast<qsizetype>(littleEndianVolume.getSizeInBytes()),
+                     compressionLevel);
+}
+
+bool decompressVolume(const char* data, const std::size_t compressedSize, Volume& volume) {
+    const QByteArray decompressed =
+        qUncompress(reinterpret_cast<const uchar*>(data), static_cast<qsizetype>(compressedSize));
+    if (static_cast<std::size_t>(decompressed.size()) != volume.getSizeInBytes()) {
+        return false;
+    }
+
+    std::memcpy(volume.getRawData(), decompressed.constData(), volume.getSizeInBytes());
+    if (RawVolumeIO::isSystemBigEndian()) {
+        dispatchVoxelType(volume.getVoxelType(), [&](auto tag) {
+            using T = decltype(tag);
+            Kernels::swapEndianness(volume.getData<T>(), volume.getVoxelCount());
+        });
+    }
+    return true;
+}
+
+// bricks in X, Y, Z order, bricks at the upper borders are smaller
+std::vector<VolumeRegion> computeBricks(const std::array<std::size_t, 3>& size) {
+    const std::size_t brickSize = VolumeBrickRanges::brickSize;
+    const std::array<std::size_t, 3> brickCount = VolumeBrickRanges::computeBrickCount(size);
+
+    std::vector<VolumeRegion> bricks;
+    bricks.reserve(brickCount[0] * brickCount[1] * brickCount[2]);
+    for (std::size_t z = 0; z < brickCount[2]; z++) {
+        for (std::size_t y = 0; y < brickCount[1]; y++) {
+            for (std::size_t x = 0; x < brickCount[0]; x++) {
+                const VolumeRegion brick{{x * brickSize, y * brickSize, z * brickSize},
+                                         {brickSize, brickSize, brickSize}};
+                bricks.push_back(brick.clamped(size));
+            }
+        }
+    }
+    return bricks;
+}
+
+std::vector<Volume> computeLevelsOfDetail(const Volume& volume) {
+    std::vector<Volume> levels;
+    const Volume* previous = &volume;
+    while (std::max({previous->getSizeX(), previous->getSizeY(), previous->getSizeZ()}) / 2 >=
+           minimumLevelOfDetailSize) {
+        const std::array<std::size_t, 3> size = {
+            std::max<std::size_t>(previous->getSizeX() / 2, 1),
+            std::max<std::size_t>(previous->getSizeY() / 2, 1),
+            std::max<std::size_t>(previous->getSizeZ() / 2, 1)};
+        levels.push_back(resampleVolume(*previous, size, InterpolationMethod::Linear));
+        previous = &levels.back();
+    }
+    return levels;
+}
+} // namespace
+
+bool exportVdsFile(const std::filesystem::path& filePath, const Volume& volume,
+                   const VolumeHistogram& histogram, const VolumeBrickRanges& brickRanges,
+                   const bool levelsOfDetail) {
+    if (volume.isEmpty()) {
+        return false;
+    }
+
+    std::ofstream file(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // compress all bricks before writing, since their compressed sizes go into the header
+    const std::vector<VolumeRegion> bricks = computeBricks(volume.getSize());
+    const std::vector<QByteArray> compressedBricks = QtConcurrent::blockingMapped<
+        std::vector<QByteArray>>(bricks, [&volume](const VolumeRegion& brick) {
+        return compressVolume(volume.extractRegion(brick));
+    });
+
+    std::vector<Volume> levels;
+    if (levelsOfDetail) {
+        levels = computeLevelsOfDetail(volume);
+    }
+
+    file.write(fileMagic, sizeof(fileMagic));
+    writeValue<uint32_t>(file, fileVersion);
+    writeValue<uint32_t>(file, static_cast<uint32_t>(volume.getVoxelType()));
+    for (const std::size_t size : volume.getSize()) {
+        writeValue<uint64_t>(file, size);
+    }
+    for (const float spacing : volume.getSpacing()) {
+        writeValue<float>(file, spacing);
+    }
+    writeValue<float>(file, volume.getValueRange().minimum);
+    writeValue<float>(file, volume.getValueRange().maximum);
+    writeValue<uint32_t>(file, static_cast<uint32_t>(VolumeBrickRanges::brickSize));
+
+    // derived data, only stored if it belongs to the volume
+    const bool validHistogram = histogram.getVoxelType() == volume.getVoxelType() &&
+                                !histogram.getBins().empty();
+    const std::vector<uint64_t> noBins;
+    const std::vector<uint64_t>& bins = validHistogram ? histogram.getBins() : noBins;
+    writeValue<uint64_t>(file, bins.size());
+    for (const uint64_t bin : bins) {
+        writeValue<uint64_t>(file, bin);
+    }
+
+    const bool validBrickRanges = brickRanges.getBrickRanges().size() == bricks.size();
+    writeValue<uint64_t>(file, validBrickRanges ? bricks.size() : 0);
+    if (validBrickRanges) {
+        for (const ValueRange& range : brickRanges.getBrickRanges()) {
+            writeValue<float>(file, range.minimum);
+            writeValue<float>(file, range.maximum);
+        }
+    }
+
+    // block tables are written once the offsets are known
+    writeValue<uint32_t>(file, static_cast<uint32_t>(levels.size()));
+    for (const Volume& level : levels) {
+        for (const std::size_t size : level.getSize()) {
+            writeValue<uint64_t>(file, size);
+        }
+        for (const float spacing : level.getSpacing()) {
+            writeValue<float>(file, spacing);
+        }
+    }
+    const std::streamoff levelTablePosition = file.tellp();
+    for (std::size_t level = 0; level < levels.size(); level++) {
+        writeBlockEntry(file, BlockEntry{});
+    }
+    writeValue<uint64_t>(file, bricks.size());
+    const std::streamoff brickTablePosition = file.tellp();
+    for (std::size_t brick = 0; brick < bricks.size(); brick++) {
+        writeBlockEntry(file, BlockEntry{});
+    }
+
+    std::vector<BlockEntry> brickBlocks(bricks.size());
+    for (std::size_t brick = 0; brick < bricks.size(); brick++) {
+        brickBlocks[brick] = BlockEntry{static_cast<uint64_t>(file.tellp()),
+                                        static_cast<uint64_t>(compressedBricks[brick].size())};
+        file.write(compressedBricks[brick].constData(), compressedBricks[brick].size());
+    }
+
+    std::vector<BlockEntry> levelBlocks(levels.size());
+    for (std::size_t level = 0; level < levels.size(); level++) {
+        const QByteArray compressedLevel = compressVolume(levels[level]);
+        levelBlocks[level] = BlockEntry{static_cast<uint64_t>(file.tellp()),
+                                        static_cast<uint64_t>(compressedLevel.size())};
+        file.write(compressedLevel.constData(), compressedLevel.size());
+    }
+
+    file.seekp(levelTablePosition);
+    for (const BlockEntry& block : levelBlocks) {
+        writeBlockEntry(file, block);
+    }
+    file.seekp(brickTablePosition);
+    for (const BlockEntry& block : brickBlocks) {
+        writeBlockEntry(file, block);
+    }
+
+    return file.good();
+}
+
+bool importVdsFile(const std::filesystem::path& filePath, CachedVolume& contents,
+                   const std::function<void(const Volume&)>& preview) {
+    std::ifstream file(filePath, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    char magic[sizeof(fileMagic)];
+    uint32_t version = 0;
+    file.read(magic, sizeof(magic));
+    if (!file.good() || std::memcmp(magic, fileMagic, sizeof(fileMagic)) != 0 ||
+        !readValue(file, version) || version != fileVersion) {
+        return false;
+    }
+
+    uint32_t voxelTypeValue = 0;
+    std::array<uint64_t, 3> size = {0, 0, 0};
+    std::array<float, 3> spacing = {1.0f, 1.0f, 1.0f};
+    ValueRange valueRange;
+    uint32_t brickSize = 0;
+    if (!readValue(file, voxelTypeValue) || !readValue(file, size[0]) ||
+        !readValue(file, size[1]) || !readValue(file, size[2]) || !readValue(file, spacing[0]) ||
+        !readValue(file, spacing[1]) || !readValue(file, spacing[2]) ||
+        !readValue(file, valueRange.minimum) || !readValue(file, valueRange.maximum) ||
+        !readValue(file, brickSize)) {
+        return false;
+    }
+    if (voxelTypeValue > static_cast<uint32_t>(VoxelType::Float32) ||
+        brickSize != VolumeBrickRanges::brickSize || size[0] == 0 || size[1] == 0 ||
+        size[2] == 0) {
+        return false;
+    }
+    const VoxelType voxelType = static_cast<VoxelType>(voxelTypeValue);
+    const std::array<std::size_t, 3> volumeSize = {static_cast<std::size_t>(size[0]),
+                                                   static_cast<std::size_t>(size[1]),
+                                                   static_cast<std::size_t>(size[2])};
+
+    uint64_t binCount = 0;
+    if (!readValue(file, binCount)) {
+        return false;
+    }
+    std::vector<uint64_t> bins(static_cast<std::size_t>(binCount));
+    for (uint64_t& bin : bins) {
+        if (!readValue(file, bin)) {
+            return false;
+        }
+    }
+
+    uint64_t brickRangeCount = 0;
+    if (!readValue(file, brickRangeCount)) {
+        return false;
+    }
+    std::vector<ValueRange> brickRanges(static_cast<std::size_t>(brickRangeCount));
+    for (ValueRange& range : brickRanges) {
+        if (!readValue(file, range.minimum) || !readValue(file, range.maximum)) {
+            return false;
+        }
+    }
+
+    uint32_t levelCount = 0;
+    if (!readValue(file, levelCount)) {
+        return false;
+    }
+    std::vector<LevelOfDetail> levels(levelCount);
+    for (LevelOfDetail& level : levels) {
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            uint64_t levelSize = 0;
+            if (!readValue(file, levelSize)) {
+                return false;
+            }
+            level.size[axis] = static_cast<std::size_t>(levelSize);
+        }
+        if (!readValue(file, level.spacing[0]) || !readValue(file, level.spacing[1]) ||
+            !readValue(file, level.spacing[2])) {
+            return false;
+        }
+    }
+    for (LevelOfDetail& level : levels) {
+        if (!readBlockEntry(file, level.block)) {
+            return false;
+        }
+    }
+
+    const std::vector<VolumeRegion> bricks = computeBricks(volumeSize);
+    uint64_t brickCount = 0;
+    if (!readValue(file, brickCount) || brickCount != bricks.size()) {
+        return false;
+    }
+    std::vector<BlockEntry> brickBlocks(bricks.size());
+    for (BlockEntry& block : brickBlocks) {
+        if (!readBlockEntry(file, block)) {
+            return false;
+        }
+    }
+
+    // the coarsest level of detail that is still large enough gives a quick preview
+    if (preview && !levels.empty()) {
+        auto previewLevel = levels.begin();
+        for (auto it = levels.begin(); it != levels.end(); ++it) {
+            if (std::max({it->size[0], it->size[1], it->size[2]}) >= minimumPreviewSize) {
+                previewLevel = it;
+            }
+        }
+
+        std::vector<char> compressedLevel(
+            static_cast<std::size_t>(previewLevel->block.compressedSize));
+        file.seekg(static_cast<std::streamoff>(previewLevel->block.offset));
+        file.read(compressedLevel.data(), static_cast<std::streamsize>(compressedLevel.size()));
+
+        Volume previewVolume(previewLevel->size, previewLevel->spacing, voxelType);
+        previewVolume.setValueRange(valueRange);
+        if (file.good() &&
+            decompressVolume(compressedLevel.data(), compressedLevel.size(), previewVolume)) {
+            preview(previewVolume);
+        }
+    }
+
+    // read all compressed bricks at once, they are stored back to back
+    uint64_t dataBegin = brickBlocks.front().offset;
+    uint64_t dataEnd = dataBegin;
+    for (const BlockEntry& block : brickBlocks) {
+        dataBegin = std::min(dataBegin, block.offset);
+        dataEnd = std::max(dataEnd, block.offset + block.compressedSize);
+    }
+    std::vector<char> compressedData(static_cast<std::size_t>(dataEnd - dataBegin));
+    file.seekg(static_cast<std::streamoff>(dataBegin));
+    file.read(compressedData.data(), static_cast<std::streamsize>(compressedData.size()));
+    if (!file.good()) {
+        return false;
+    }
+
+    Volume volume(volumeSize, {spacing[0], spacing[1], spacing[2]}, voxelType);
+    volume.setValueRange(valueRange);
+
+    std::vector<std::size_t> brickIndices(bricks.size());
+    std::iota(brickIndices.begin(), brickIndices.end(), std::size_t{0});
+    std::atomic<bool> success{true};
+    QtConcurrent::blockingMap(brickIndices, [&](const std::size_t brick) {
+        Volume brickData(bricks[brick].size, volume.getSpacing(), voxelType);
+        const BlockEntry& block = brickBlocks[brick];
+        if (!decompressVolume(compressedData.data() + (block.offset - dataBegin),
+                              static_cast<std::size_t>(block.compressedSize), brickData)) {
+            success = false;
+            return;
+        }
+        volume.insertRegion(brickData, bricks[brick]);
+    });
+    if (!success) {
+        return false;
+    }
+
+    // derived data stored with the volume, recomputed if it is missing
+    CachedVolume importedContents;
+    if (bins.size() == dispatchVoxelType(voxelType, [](auto tag) {
+            return Kernels::getValueCount<decltype(tag)>();
+        })) {
+        importedContents.histogram = VolumeHistogram(voxelType, valueRange, std::move(bins));
+    } else {
+        importedContents.histogram = VolumeHistogram(volume);
+    }
+    if (brickRanges.size() == bricks.size()) {
+        importedContents.brickRanges = VolumeBrickRanges(
+            VolumeBrickRanges::computeBrickCount(volumeSize), std::move(brickRanges));
+    } else {
+        importedContents.brickRanges = VolumeBrickRanges(volume);
+    }
+    importedContents.volume = std::move(volume);
+
+    contents = std::move(importedContents);
+    return true;
+}
+} // namespace VDS::VdsVolumeIO
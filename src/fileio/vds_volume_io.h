@@ -0,0 +1,22 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+
+#include "common/volume_cache.h"
+
+// Native container format (.vds). Volumes are stored in bricks of VolumeBrickRanges::brickSize
+// voxels per axis, each compressed on its own. The header holds size, spacing, value range,
+// histogram and brick min/max grid, so none of them needs to be recomputed on import. An optional
+// pyramid of downsampled levels of detail allows showing a preview before all bricks are in.
+namespace VDS::VdsVolumeIO {
+// histogram and brickRanges are only stored if they belong to volume
+bool exportVdsFile(const std::filesystem::path& filePath, const Volume& volume,
+                   const VolumeHistogram& histogram, const VolumeBrickRanges& brickRanges,
+                   const bool levelsOfDetail);
+
+// Bricks are decompressed in parallel. If the file contains levels of detail, preview is called
+// with a downsampled volume of the same extent before the bricks get decompressed.
+bool importVdsFile(const std::filesystem::path& filePath, CachedVolume& contents,
+                   const std::function<void(const Volume&)>& preview);
+} // namespace VDS::VdsVolumeIO
@@ -1,8 +1,11 @@
 #include "main_window.h"
 
+#include "common/voxel_buffer.h"
+
 #include <QSurfaceFormat>
 #include <QThread>
 #include <QFile>
+#include <QtGlobal>
 #include <QtWidgets/QApplication>
 
 int main(int argc, char* argv[]) {
@@ -28,6 +31,13 @@ int main(int argc, char* argv[]) {
 
     QThread::currentThread()->setObjectName("Main Thread");
 
+    // VDS_HEAP_VOXELS=1 allocates large voxel buffers from the heap instead of mapping huge pages,
+    // e.g. to compare the performance of both
+    if (qEnvironmentVariableIntValue("VDS_HEAP_VOXELS") != 0) {
+        VDS::VoxelBuffer::setPageMappingEnabled(false);
+        qInfo("Voxel buffers are allocated from the heap");
+    }
+
     VDS::MainWindow window;
     window.show();
 
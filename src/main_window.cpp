@@ -1,32 +1,96 @@
 #include "main_window.h"
 
 #include "fileio/import_binary_slices_dialog.h"
+#include "fileio/import_bitmap_slices_dialog.h"
 #include "fileio/import_raw_3D_dialog.h"
 #include "fileio/export_raw_3D_dialog.h"
 #include "fileio/export_image_series_dialog.h"
+#include "fileio/derived_data_cache.h"
+#include "fileio/image_series_io.h"
+#include "fileio/mesh_io.h"
+#include "fileio/raw_volume_io.h"
+#include "fileio/time_series_io.h"
+#include "fileio/vds_volume_io.h"
+#include "tools/connected_components.h"
+#include "tools/isosurface.h"
 #include "tools/resize_volume_data.h"
+#include "tools/volume_resampler.h"
+#include "tools/voxel_expression_dialog.h"
 
 #include "common/vdtk_helper_functions.h"
 
+#include <QActionGroup>
 #include <QCheckBox>
 #include <QComboBox>
 #include <QDialog>
 #include <QDebug>
 #include <QDoubleSpinBox>
 #include <QFile>
+#include <QFileDialog>
 #include <QGroupBox>
+#include <QInputDialog>
 #include <QJsonDocument>
 #include <QMessageBox>
-#include <QtConcurrent>
-#include <QFuture>
+#include <QStatusBar>
+#include <QThread>
+
+#include <algorithm>
+#include <cassert>
 
 namespace VDS {
+namespace {
+// the interpolation method combo box of the resize dialog lists the methods in this order
+InterpolationMethod getInterpolationMethod(int index) {
+    switch (index) {
+    case 4:
+        return InterpolationMethod::Lanczos;
+    case 3:
+        return InterpolationMethod::Area;
+    case 2:
+        return InterpolationMethod::Cubic;
+    case 1:
+        return InterpolationMethod::Linear;
+    case 0:
+    default:
+        return InterpolationMethod::NearestNeighbor;
+    }
+}
+
+// edits of up to this many voxels run on the UI thread, larger ones as a job
+constexpr std::size_t inlineEditVoxelCount = std::size_t{1} << 21;
+
+// Blocks UI actions while a job runs. The block is lifted when the job returns, throws or gets
+// canceled, so no path through the job can leave actions disabled for good.
+class ScopedUIPermissions {
+public:
+    ScopedUIPermissions(MainWindow* window, const int read, const int write)
+        : m_window{window}, m_read{read}, m_write{write} {
+        emit(m_window->updateUIPermissions(m_read, m_write));
+    }
+    ~ScopedUIPermissions() {
+        emit(m_window->updateUIPermissions(-m_read, -m_write));
+    }
+
+    ScopedUIPermissions(const ScopedUIPermissions&) = delete;
+    ScopedUIPermissions& operator=(const ScopedUIPermissions&) = delete;
+
+private:
+    MainWindow* m_window;
+    int m_read;
+    int m_write;
+};
+} // namespace
+
 MainWindow::MainWindow(QWidget* parent)
-    : QMainWindow(parent) {
+    : QMainWindow(parent), m_volumeVersion{0} {
     // Register meta types so concurrent threads can pass these in signals
-    qRegisterMetaType<std::vector<uint16_t>>("std::vector<uint16_t>");
+    qRegisterMetaType<VDS::DisplayHistogram>("VDS::DisplayHistogram");
     qRegisterMetaType<std::array<std::size_t, 3>>("std::array<std::size_t, 3>");
     qRegisterMetaType<std::array<float, 3>>("std::array<float, 3>");
+    qRegisterMetaType<VDS::Volume>("VDS::Volume");
+    qRegisterMetaType<std::shared_ptr<const VDS::CompressedVolume>>(
+        "std::shared_ptr<const VDS::CompressedVolume>");
+    qRegisterMetaType<VDS::VolumeRegion>("VDS::VolumeRegion");
 
     ui.setupUi(this);
 
@@ -35,6 +99,7 @@ MainWindow::MainWindow(QWidget* parent)
     setupViewMenu();
     setupFileMenu();
     setupToolsMenu();
+    setupPlaybackMenu();
     setupRendererView();
     setupShaderEditor();
 
@@ -138,6 +203,11 @@ MainWindow::MainWindow(QWidget* parent)
     // connect volume data update
     connect(this, &MainWindow::updateVolumeView, ui.volumeViewWidget,
             &VolumeViewGL::updateVolumeData);
+    connect(this, &MainWindow::updateCompressedVolumeView, ui.volumeViewWidget,
+            &VolumeViewGL::updateCompressedVolumeData);
+    connect(this, &MainWindow::updateVolumeViewRegion, ui.volumeViewWidget,
+            &VolumeViewGL::updateVolumeRegion);
+    connect(this, &MainWindow::updateMeshView, ui.volumeViewWidget, &VolumeViewGL::updateMesh);
 
     // connect histogram update
     connect(ui.groupBoxApplyWindow, &QGroupBox::toggled, this, &MainWindow::computeHistogram);
@@ -158,6 +228,19 @@ MainWindow::MainWindow(QWidget* parent)
     // connect UI permisson updates
     connect(this, &MainWindow::updateUIPermissions, this, &MainWindow::setUIPermissions);
 
+    // background jobs show their progress in the status bar and can be canceled from there
+    m_labelJobStatus = new QLabel();
+    m_buttonCancelJobs = new QPushButton(QString("Cancel"));
+    m_buttonCancelJobs->setVisible(false);
+    statusBar()->addWidget(m_labelJobStatus);
+    statusBar()->addWidget(m_buttonCancelJobs);
+    connect(&m_jobScheduler, &JobScheduler::statusChanged, this, [this](const QString& status) {
+        m_labelJobStatus->setText(status);
+        m_buttonCancelJobs->setVisible(!status.isEmpty());
+    });
+    connect(m_buttonCancelJobs, &QAbstractButton::clicked, &m_jobScheduler,
+            &JobScheduler::cancelAll);
+
     // connect bounding box settings
     connect(ui.checkBoxRenderBoundingBox, &QCheckBox::stateChanged, ui.volumeViewWidget,
             &VolumeViewGL::setBoundingBoxRenderStatus);
@@ -169,6 +252,36 @@ MainWindow::MainWindow(QWidget* parent)
     connect(this, &MainWindow::showErrorImportRaw, this, &MainWindow::errorRawImport);
     connect(this, &MainWindow::showErrorImportBinarySlices, this,
             &MainWindow::errorBinarySlicesImport);
+    connect(this, &MainWindow::showErrorImportBitmapSlices, this,
+            &MainWindow::errorBitmapSlicesImport);
+    connect(this, &MainWindow::showErrorExportVds, this, &MainWindow::errorVdsExport);
+    connect(this, &MainWindow::showErrorImportVds, this, &MainWindow::errorVdsImport);
+    connect(this, &MainWindow::showErrorOutOfCoreProcessing, this,
+            &MainWindow::errorOutOfCoreProcessing);
+    connect(this, &MainWindow::showErrorExportMesh, this, &MainWindow::errorMeshExport);
+    connect(this, &MainWindow::showErrorExportStatistics, this,
+            &MainWindow::errorStatisticsExport);
+    connect(&m_jobScheduler, &JobScheduler::jobFailed, this, &MainWindow::errorJobFailed);
+
+    // connect time series playback, textures are uploaded while the signals are processed
+    connect(&m_timeSeriesPlayer, &TimeSeriesPlayer::setupTimestepTextures, ui.volumeViewWidget,
+            &VolumeViewGL::setupTimestepTextures, Qt::DirectConnection);
+    connect(&m_timeSeriesPlayer, &TimeSeriesPlayer::uploadTimestep, ui.volumeViewWidget,
+            &VolumeViewGL::uploadTimestep, Qt::DirectConnection);
+    connect(&m_timeSeriesPlayer, &TimeSeriesPlayer::showTimestep, ui.volumeViewWidget,
+            &VolumeViewGL::showTimestep, Qt::DirectConnection);
+    connect(&m_timeSeriesPlayer, &TimeSeriesPlayer::showTimestep, this,
+            &MainWindow::updateSliceRendererTexture);
+    connect(&m_timeSeriesPlayer, &TimeSeriesPlayer::playbackStatistics, this,
+            &MainWindow::updateTimeSeriesStatus);
+    connect(&m_timeSeriesPlayer, &TimeSeriesPlayer::playbackStateChanged, this,
+            &MainWindow::adoptCurrentTimestep);
+    connect(&m_timeSeriesPlayer, &TimeSeriesPlayer::playbackStateChanged, m_actionPlayPause,
+            &QAction::setChecked);
+    connect(&m_timeSeriesPlayer, &TimeSeriesPlayer::loadingFailed, this,
+            &MainWindow::errorRawImport);
+    connect(&m_timeSeriesPlayer, &TimeSeriesPlayer::loadingFailed, &m_timeSeriesPlayer,
+            &TimeSeriesPlayer::pause);
 
     // connect recent files
     connect(this, &MainWindow::updateRecentFiles, this, &MainWindow::refreshRecentFileList);
@@ -190,23 +303,38 @@ MainWindow::MainWindow(QWidget* parent)
     // Disable all exports until a file is loaded
     m_actionExportRAW3D->setEnabled(false);
     m_actionExportBitmapSeries->setEnabled(false);
+    m_actionExportVDS->setEnabled(false);
     m_actionResizeVolumeData->setEnabled(false);
+    m_menuReorientVolumeData->setEnabled(false);
+    m_menuFilterVolumeData->setEnabled(false);
+    m_menuOperationGraph->setEnabled(false);
+    m_actionConnectedComponents->setEnabled(false);
+    m_menuIsosurface->setEnabled(false);
+    m_actionExportIsosurfaceSTL->setEnabled(false);
+    m_actionExportIsosurfacePLY->setEnabled(false);
 }
 
 void MainWindow::setUIPermissions(int read, int write) {
     readBlockCount += read;
     writeBlockCount += write;
 
+    // compressed volumes are only streamed by the raw export, the other tools need all voxels
+    const bool decompressed = !m_compressedVolume;
+
     switch (readBlockCount) {
     case 0:
         // enable read only UI elements
         m_actionExportRAW3D->setEnabled(true);
-        m_actionExportBitmapSeries->setEnabled(true);
+        m_actionExportBitmapSeries->setEnabled(decompressed);
+        m_actionExportVDS->setEnabled(decompressed);
+        m_menuIsosurface->setEnabled(decompressed);
         break;
     default:
         // disable read only UI elements
         m_actionExportRAW3D->setEnabled(false);
         m_actionExportBitmapSeries->setEnabled(false);
+        m_actionExportVDS->setEnabled(false);
+        m_menuIsosurface->setEnabled(false);
         break;
     }
 
@@ -214,17 +342,37 @@ void MainWindow::setUIPermissions(int read, int write) {
     case 0:
         // enable write access UI elements
         m_actionImportRAW3D->setEnabled(true);
+        m_actionImportRAW3DCompressed->setEnabled(true);
         m_actionImportBinarySlices->setEnabled(true);
+        m_actionImportBitmapSlices->setEnabled(true);
+        m_actionImportRAW4D->setEnabled(true);
+        m_actionImportVDS->setEnabled(true);
         m_menuRecentFiles->setEnabled(true);
-        m_actionResizeVolumeData->setEnabled(true);
+        m_actionResizeVolumeData->setEnabled(decompressed);
+        m_menuReorientVolumeData->setEnabled(decompressed);
+        m_menuFilterVolumeData->setEnabled(decompressed);
+        m_menuOperationGraph->setEnabled(decompressed);
+        m_actionVoxelExpression->setEnabled(decompressed);
+        m_actionConnectedComponents->setEnabled(decompressed);
+        m_menuOutOfCore->setEnabled(true);
         ui.groupBoxApplyWindow->setEnabled(true);
         break;
     default:
         // disable write access UI elements
         m_actionImportRAW3D->setEnabled(false);
+        m_actionImportRAW3DCompressed->setEnabled(false);
         m_actionImportBinarySlices->setEnabled(false);
+        m_actionImportBitmapSlices->setEnabled(false);
+        m_actionImportRAW4D->setEnabled(false);
+        m_actionImportVDS->setEnabled(false);
         m_menuRecentFiles->setEnabled(false);
         m_actionResizeVolumeData->setEnabled(false);
+        m_menuReorientVolumeData->setEnabled(false);
+        m_menuFilterVolumeData->setEnabled(false);
+        m_menuOperationGraph->setEnabled(false);
+        m_actionVoxelExpression->setEnabled(false);
+        m_actionConnectedComponents->setEnabled(false);
+        m_menuOutOfCore->setEnabled(false);
         ui.groupBoxApplyWindow->setEnabled(false);
         break;
     }
@@ -247,6 +395,24 @@ void MainWindow::openImportRawDialog() {
     emit(updateUIPermissions(-1, -1));
 }
 
+void MainWindow::openImportRawCompressedDialog() {
+    emit(updateUIPermissions(1, 1));
+    DialogImportRAW3D dialog;
+    dialog.setWindowTitle(QString("Import RAW 3D Compressed"));
+    dialog.setRegionOfInterestVisible(false);
+    dialog.show();
+
+    if (dialog.exec() != QDialog::Accepted) {
+        // Raw Import got canceled by user
+        emit(updateUIPermissions(-1, -1));
+        return;
+    }
+
+    const ImportItemRaw item3D = dialog.getImportItem();
+    importRAW3DCompressed(item3D);
+    emit(updateUIPermissions(-1, -1));
+}
+
 void MainWindow::openImportBinarySlicesDialog() {
     emit(updateUIPermissions(1, 1));
     DialogImportBinarySlices dialog;
@@ -263,6 +429,55 @@ void MainWindow::openImportBinarySlicesDialog() {
     emit(updateUIPermissions(-1, -1));
 }
 
+void MainWindow::openImportBitmapSlicesDialog() {
+    emit(updateUIPermissions(1, 1));
+    DialogImportBitmapSlices dialog;
+    dialog.show();
+
+    if (dialog.exec() != QDialog::Accepted) {
+        // Bitmap Import got canceled by user
+        emit(updateUIPermissions(-1, -1));
+        return;
+    }
+
+    const ImportItemBitmapSlices item3D = dialog.getImportItem();
+    importBitmapSlices(item3D);
+    emit(updateUIPermissions(-1, -1));
+}
+
+void MainWindow::openImportRaw4DDialog() {
+    emit(updateUIPermissions(1, 1));
+    DialogImportRAW3D dialog;
+    dialog.setWindowTitle(QString("Import RAW 4D Time Series"));
+    dialog.setRegionOfInterestVisible(false);
+    dialog.show();
+
+    if (dialog.exec() != QDialog::Accepted) {
+        // Raw Import got canceled by user
+        emit(updateUIPermissions(-1, -1));
+        return;
+    }
+
+    const ImportItemRaw item4D = dialog.getImportItem();
+    importRAW4D(item4D);
+    emit(updateUIPermissions(-1, -1));
+}
+
+void MainWindow::openImportVdsDialog() {
+    emit(updateUIPermissions(1, 1));
+    const QString path =
+        QFileDialog::getOpenFileName(this, QString("Import VDS"), QString(), "VDS (*.vds)");
+
+    if (path.isEmpty()) {
+        // VDS Import got canceled by user
+        emit(updateUIPermissions(-1, -1));
+        return;
+    }
+
+    importVDS(ImportItemVds(std::filesystem::path(path.toStdString())));
+    emit(updateUIPermissions(-1, -1));
+}
+
 void MainWindow::saveRecentFilesList() {
     QFile saveFile(QStringLiteral("recentlyOpened.json"));
 
@@ -273,6 +488,11 @@ void MainWindow::saveRecentFilesList() {
 
     saveFile.write(m_importList.serialize().toJson());
 }
+void MainWindow::addRecentFile(const ImportItem* item, ImportType type) {
+    m_importList.addImportItem(new ImportItemListEntry(item, type));
+    saveRecentFilesList();
+    emit(updateRecentFiles());
+}
 void MainWindow::loadRecentFilesList() {
     m_importList.clear();
 
@@ -293,60 +513,195 @@ void MainWindow::loadRecentFilesList() {
     m_importList.deserialize(loadDoc);
 }
 void MainWindow::importRAW3D(const ImportItemRaw& item3D) {
-    QFuture<void> future = QtConcurrent::run([=]() {
-        QThread::currentThread()->setObjectName("Import Raw Thread");
-        emit(updateUIPermissions(1, 1));
+    closeTimeSeries();
 
-        const VDTK::VolumeSize size = Helper::QVector3DToVolumeSize(item3D.getSize());
-        const VDTK::VolumeSpacing spacing = Helper::QVector3DToVolumeSpacing(item3D.getSpacing());
+    m_jobScheduler.submit("Importing RAW", JobPriority::Import, [=](JobContext&) {
+        QThread::currentThread()->setObjectName("Import Raw Thread");
+        const ScopedUIPermissions permissions(this, 1, 1);
+
+        const std::array<std::size_t, 3> size = Helper::QVector3DToArraySize(item3D.getSize());
+        const std::array<float, 3> spacing = Helper::QVector3DToArraySpacing(item3D.getSpacing());
+
+        const bool success = switchVolume(
+            item3D.getCacheKey(),
+            [&](CachedVolume& entry) {
+                if (!item3D.hasRegionOfInterest()) {
+                    return RawVolumeIO::importRawFile(item3D.getFilePath(), item3D.getVoxelType(),
+                                                      item3D.representedInLittleEndian(), size,
+                                                      spacing, entry);
+                }
+
+                // only the voxels within the region are read, histogram and brick ranges are
+                // computed for the smaller volume
+                VolumeRegion region;
+                region.offset = Helper::QVector3DToArraySize(item3D.getRegionOffset());
+                region.size = Helper::QVector3DToArraySize(item3D.getRegionSize());
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    if (region.size[axis] == 0 && region.offset[axis] < size[axis]) {
+                        region.size[axis] = size[axis] - region.offset[axis];
+                    }
+                }
+                return RawVolumeIO::importRawRegion(
+                    item3D.getFilePath(), item3D.getVoxelType(), item3D.representedInLittleEndian(),
+                    size, spacing, region, Helper::QVector3DToArraySize(item3D.getStride()),
+                    entry.volume);
+            },
+            [this, item3D]() { addRecentFile(new ImportItemRaw(item3D), ImportType::RAW3D); });
+        if (!success) {
+            emit(showErrorImportRaw());
+        }
 
-        if (m_vdh.importRawFile(item3D.getFilePath(), item3D.getBitsPerVoxel(), size, spacing)) {
-            if (item3D.representedInLittleEndian() == checkIsBigEndian()) {
-                m_vdh.convertEndianness();
+        return;
+    });
+}
+void MainWindow::importRAW3DCompressed(const ImportItemRaw& item3D) {
+    closeTimeSeries();
+
+    m_jobScheduler.submit(
+        "Importing RAW compressed", JobPriority::Import, [=](JobContext& context) {
+            QThread::currentThread()->setObjectName("Import Raw Compressed Thread");
+            const ScopedUIPermissions permissions(this, 1, 1);
+
+            const std::array<std::size_t, 3> size =
+                Helper::QVector3DToArraySize(item3D.getSize());
+            const std::array<float, 3> spacing =
+                Helper::QVector3DToArraySpacing(item3D.getSpacing());
+
+            // The histogram streams through the compressed bricks, the brick ranges are collected
+            // while compressing. The file is not added to the recent files, which would import it
+            // uncompressed.
+            std::shared_ptr<CompressedVolume> volume;
+            if (RawVolumeIO::importRawFileCompressed(
+                    item3D.getFilePath(), item3D.getVoxelType(),
+                    item3D.representedInLittleEndian(), size, spacing, volume,
+                    context.getProgressCallback())) {
+                VolumeHistogram histogram(*volume);
+                VolumeBrickRanges brickRanges = volume->getBrickRanges();
+                switchToCompressedVolume(std::move(volume), std::move(histogram),
+                                         std::move(brickRanges));
+            } else if (!context.isCanceled()) {
+                emit(showErrorImportRaw());
             }
 
-            updateVolumeData();
+            return;
+        });
+}
 
-            // add to recent files
-            const ImportItem* item = &item3D;
-            ImportItemListEntry* entry = new ImportItemListEntry(item, ImportType::RAW3D);
-            m_importList.addImportItem(entry);
-            saveRecentFilesList();
-            emit(updateRecentFiles());
-        } else {
-            emit(showErrorImportRaw());
+void MainWindow::importBinarySlices(const ImportItemBinarySlices& item3D) {
+    closeTimeSeries();
+
+    m_jobScheduler.submit("Importing binary slices", JobPriority::Import, [=](JobContext&) {
+        QThread::currentThread()->setObjectName("Import Raw Thread");
+        const ScopedUIPermissions permissions(this, 1, 1);
+
+        const std::array<std::size_t, 3> size = Helper::QVector3DToArraySize(item3D.getSize());
+        const std::array<float, 3> spacing = Helper::QVector3DToArraySpacing(item3D.getSpacing());
+
+        const bool success = switchVolume(
+            item3D.getCacheKey(),
+            [&](CachedVolume& entry) {
+                return RawVolumeIO::importBinarySlices(
+                    item3D.getFilePath(), item3D.getVoxelType(), item3D.representedInLittleEndian(),
+                    item3D.getAxis(), size, spacing, entry.volume);
+            },
+            [this, item3D]() {
+                addRecentFile(new ImportItemBinarySlices(item3D), ImportType::BinarySlices);
+            });
+        if (!success) {
+            emit(showErrorImportBinarySlices());
         }
-        emit(updateUIPermissions(-1, -1));
 
         return;
     });
 }
-void MainWindow::importBinarySlices(const ImportItemBinarySlices& item3D) {
-    QFuture<void> future = QtConcurrent::run([=]() {
-        QThread::currentThread()->setObjectName("Import Raw Thread");
-        emit(updateUIPermissions(1, 1));
 
-        const VDTK::VolumeSize size = Helper::QVector3DToVolumeSize(item3D.getSize());
-        const VDTK::VolumeSpacing spacing = Helper::QVector3DToVolumeSpacing(item3D.getSpacing());
+void MainWindow::importBitmapSlices(const ImportItemBitmapSlices& item3D) {
+    closeTimeSeries();
 
-        if (m_vdh.importBinarySlices(item3D.getFilePath(), item3D.getBitsPerVoxel(), item3D.getAxis(), size,
-                                     spacing)) {
-            if (item3D.representedInLittleEndian() == checkIsBigEndian()) {
-                m_vdh.convertEndianness();
-            }
+    m_jobScheduler.submit("Importing bitmap slices", JobPriority::Import, [=](JobContext&) {
+        QThread::currentThread()->setObjectName("Import Bitmap Slices Thread");
+        const ScopedUIPermissions permissions(this, 1, 1);
 
-            updateVolumeData();
+        const std::array<float, 3> spacing = Helper::QVector3DToArraySpacing(item3D.getSpacing());
 
-            // add to recent files
-            const ImportItem* item = &item3D;
-            ImportItemListEntry* entry = new ImportItemListEntry(item, ImportType::BinarySlices);
-            m_importList.addImportItem(entry);
-            saveRecentFilesList();
-            emit(updateRecentFiles());
-        } else {
-            emit(showErrorImportBinarySlices());
+        const bool success = switchVolume(
+            item3D.getCacheKey(),
+            [&](CachedVolume& entry) {
+                return ImageSeriesIO::importBitmapSlices(item3D.getFilePath(), spacing,
+                                                         entry.volume);
+            },
+            [this, item3D]() {
+                addRecentFile(new ImportItemBitmapSlices(item3D), ImportType::BitmapSlices);
+            });
+        if (!success) {
+            emit(showErrorImportBitmapSlices());
+        }
+
+        return;
+    });
+}
+
+void MainWindow::importRAW4D(const ImportItemRaw& item4D) {
+    closeTimeSeries();
+
+    m_jobScheduler.submit("Importing time series", JobPriority::Import, [=](JobContext&) {
+        QThread::currentThread()->setObjectName("Import Raw Time Series Thread");
+        const ScopedUIPermissions permissions(this, 1, 1);
+
+        const std::array<std::size_t, 3> size = Helper::QVector3DToArraySize(item4D.getSize());
+        const std::array<float, 3> spacing = Helper::QVector3DToArraySpacing(item4D.getSpacing());
+
+        // timesteps are buffered by the player and not kept in the volume cache
+        TimeSeriesIO::TimeSeries series;
+        const bool success =
+            TimeSeriesIO::openTimeSeries(item4D.getFilePath(), item4D.getVoxelType(),
+                                         item4D.representedInLittleEndian(), size, spacing,
+                                         series) &&
+            switchVolume(
+                std::string(),
+                [&](CachedVolume& entry) {
+                    return TimeSeriesIO::loadTimestep(series, 0, entry.volume);
+                },
+                [this, series, item4D]() {
+                    // the first timestep has set up geometry, histogram and value range of the
+                    // series, the player uploads textures and has to run on the UI thread
+                    m_timeSeriesPlayer.open(series, m_volume);
+                    m_menuPlayback->setEnabled(true);
+
+                    addRecentFile(new ImportItemRaw(item4D), ImportType::RAW4D);
+                });
+        if (!success) {
+            emit(showErrorImportRaw());
+        }
+
+        return;
+    });
+}
+
+void MainWindow::importVDS(const ImportItemVds& item) {
+    closeTimeSeries();
+
+    m_jobScheduler.submit("Importing VDS", JobPriority::Import, [=](JobContext&) {
+        QThread::currentThread()->setObjectName("Import VDS Thread");
+        const ScopedUIPermissions permissions(this, 1, 1);
+
+        // the stored histogram and brick ranges are used as they are, while the bricks get
+        // decompressed a downsampled level of detail is already shown
+        const bool success = switchVolume(
+            item.getCacheKey(),
+            [&](CachedVolume& entry) {
+                return VdsVolumeIO::importVdsFile(
+                    item.getFilePath(), entry,
+                    [this](const Volume& preview) { emit(updateVolumeView(preview)); });
+            },
+            [this, item]() { addRecentFile(new ImportItemVds(item), ImportType::VDS); });
+        if (!success) {
+            // the views may already show a preview of the failed import, bring back the current
+            // volume
+            QMetaObject::invokeMethod(
+                this, [this]() { updateVolumeViews(); }, Qt::QueuedConnection);
+            emit(showErrorImportVds());
         }
-        emit(updateUIPermissions(-1, -1));
 
         return;
     });
@@ -362,15 +717,28 @@ void MainWindow::importRecentFile(std::size_t index) {
         importRAW3D(*importItem);
         break;
     }
+    case VDS::ImportType::RAW4D: {
+        const ImportItemRaw* const importItem =
+            reinterpret_cast<const ImportItemRaw*>(entry->getItem());
+        importRAW4D(*importItem);
+        break;
+    }
     case VDS::ImportType::BinarySlices: {
         const ImportItemBinarySlices* const importItem =
             reinterpret_cast<const ImportItemBinarySlices*>(entry->getItem());
         importBinarySlices(*importItem);
         break;
     }
+    case VDS::ImportType::VDS: {
+        const ImportItemVds* const importItem =
+            reinterpret_cast<const ImportItemVds*>(entry->getItem());
+        importVDS(*importItem);
+        break;
+    }
     case VDS::ImportType::BitmapSlices: {
-        Q_UNIMPLEMENTED();
-        return;
+        const ImportItemBitmapSlices* const importItem =
+            reinterpret_cast<const ImportItemBitmapSlices*>(entry->getItem());
+        importBitmapSlices(*importItem);
         break;
     }
     default: {
@@ -384,11 +752,10 @@ void MainWindow::importRecentFile(std::size_t index) {
 void MainWindow::openExportRawDialog() {
     emit(updateUIPermissions(1, 1));
 
-    const QVector3D size(m_vdh.getVolumeData().getSize().getX(), m_vdh.getVolumeData().getSize().getY(),
-                   m_vdh.getVolumeData().getSize().getZ());
-    const QVector3D spacing(m_vdh.getVolumeData().getSpacing().getX(),
-                      m_vdh.getVolumeData().getSpacing().getY(),
-                      m_vdh.getVolumeData().getSpacing().getZ());
+    const std::array<std::size_t, 3> volumeSize = getVolumeSize();
+    const std::array<float, 3> volumeSpacing = getVolumeSpacing();
+    const QVector3D size(volumeSize[0], volumeSize[1], volumeSize[2]);
+    const QVector3D spacing(volumeSpacing[0], volumeSpacing[1], volumeSpacing[2]);
 
     const int32_t windowWidth = ui.spinBoxApplyWindowValueWindowWidth->value();
     const int32_t windowCenter = ui.spinBoxApplyWindowValueWindowCenter->value();
@@ -412,30 +779,29 @@ void MainWindow::openExportRawDialog() {
 }
 
 void MainWindow::exportRAW3D(const ExportItemRaw& item) {
-    QFuture<void> future = QtConcurrent::run([=]() {
-        QThread::currentThread()->setObjectName("Export Raw Thread");
-        emit(updateUIPermissions(0, 1));
-        auto vdhCopy = m_vdh;
-        emit(updateUIPermissions(0, -1));
-
-        const bool convertEndianness = item.representedInLittleEndian() != checkIsBigEndian();
-
-        if (item.applyValueWindow()) {
-            const int32_t windowWidth = ui.spinBoxApplyWindowValueWindowWidth->value();
-            const int32_t windowCenter = ui.spinBoxApplyWindowValueWindowCenter->value();
-            const int32_t windowOffset = ui.spinBoxApplyWindowValueWindowOffset->value();
-            const VDTK::WindowingFunction function =
-                VDTK::WindowingFunction(ui.comboBoxApplyWindowFunction->currentIndex());
-            vdhCopy.applyWindow(function, windowCenter, windowWidth, windowOffset);
-        }
-
-        if (convertEndianness) {
-            vdhCopy.convertEndianness();
-        }
+    // the export writes a snapshot, so the volume can be modified or replaced meanwhile
+    const Volume volume = m_volume;
+    const std::shared_ptr<const CompressedVolume> compressedVolume = m_compressedVolume;
+    ValueWindowSettings window = getValueWindowSettings();
+    window.enabled = item.applyValueWindow();
 
-        bool success = vdhCopy.exportRawFile(item.getPath(), item.getBitsPerVoxel());
+    m_jobScheduler.submit("Exporting RAW", JobPriority::Export, [=](JobContext& context) {
+        QThread::currentThread()->setObjectName("Export Raw Thread");
 
-        if (!success) {
+        // window, bit depth and endianness are converted block by block while writing, so no
+        // copy of the volume data is needed, compressed volumes get decompressed slab by slab
+        const VoxelType outputType = getVoxelTypeFromBitsPerVoxel(item.getBitsPerVoxel());
+        const bool success =
+            compressedVolume
+                ? RawVolumeIO::exportRawFile(item.getPath(), *compressedVolume, outputType,
+                                             item.representedInLittleEndian(), window,
+                                             context.getProgressCallback())
+                : RawVolumeIO::exportRawFile(item.getPath(), volume, outputType,
+                                             item.representedInLittleEndian(), window,
+                                             context.getProgressCallback());
+
+        // a canceled export leaves a partial file, but is no error
+        if (!success && !context.isCanceled()) {
             emit(showErrorExportRaw());
         }
 
@@ -446,12 +812,9 @@ void MainWindow::exportRAW3D(const ExportItemRaw& item) {
 void MainWindow::openExportImageSeriesDialog() {
     emit(updateUIPermissions(1, 1));
 
-    const QVector3D size(m_vdh.getVolumeData().getSize().getX(),
-                         m_vdh.getVolumeData().getSize().getY(),
-                         m_vdh.getVolumeData().getSize().getZ());
-    const QVector3D spacing(m_vdh.getVolumeData().getSpacing().getX(),
-                            m_vdh.getVolumeData().getSpacing().getY(),
-                            m_vdh.getVolumeData().getSpacing().getZ());
+    const QVector3D size(m_volume.getSizeX(), m_volume.getSizeY(), m_volume.getSizeZ());
+    const QVector3D spacing(m_volume.getSpacing()[0], m_volume.getSpacing()[1],
+                            m_volume.getSpacing()[2]);
 
     const int32_t windowWidth = ui.spinBoxApplyWindowValueWindowWidth->value();
     const int32_t windowCenter = ui.spinBoxApplyWindowValueWindowCenter->value();
@@ -475,41 +838,64 @@ void MainWindow::openExportImageSeriesDialog() {
 }
 
 void MainWindow::exportImageSeries(const ExportItemImageSeries& item) {
-    QFuture<void> future = QtConcurrent::run([=]() {
+    // the export writes a snapshot, so the volume can be modified or replaced meanwhile
+    const Volume volume = m_volume;
+    ValueWindowSettings window = getValueWindowSettings();
+    window.enabled = item.applyValueWindow();
+
+    m_jobScheduler.submit("Exporting image series", JobPriority::Export, [=](JobContext& context) {
         QThread::currentThread()->setObjectName("Export Images Series Thread");
-        emit(updateUIPermissions(0, 1));
-        auto vdhCopy = m_vdh;
-
-        if (item.applyValueWindow()) {
-            const int32_t windowWidth = ui.spinBoxApplyWindowValueWindowWidth->value();
-            const int32_t windowCenter = ui.spinBoxApplyWindowValueWindowCenter->value();
-            const int32_t windowOffset = ui.spinBoxApplyWindowValueWindowOffset->value();
-            const VDTK::WindowingFunction function =
-                VDTK::WindowingFunction(ui.comboBoxApplyWindowFunction->currentIndex());
-            vdhCopy.applyWindow(function, windowCenter, windowWidth, windowOffset);
-        }
 
-        bool success = vdhCopy.exportToBitmapMonochrom(item.getPath());
+        const bool success = ImageSeriesIO::exportBitmapSeries(item.getPath(), volume, window,
+                                                               context.getProgressCallback());
 
-        if (!success) {
+        if (!success && !context.isCanceled()) {
             emit(showErrorExportImagesSeries());
         }
+    });
+}
+
+void MainWindow::openExportVdsDialog() {
+    emit(updateUIPermissions(1, 1));
+    const QString path =
+        QFileDialog::getSaveFileName(this, QString("Export VDS"), QString(), "VDS (*.vds)");
+
+    if (path.isEmpty()) {
+        // VDS Export got canceled by user
+        emit(updateUIPermissions(-1, -1));
+        return;
+    }
+
+    exportVDS(std::filesystem::path(path.toStdString()));
+    emit(updateUIPermissions(-1, -1));
+}
+
+void MainWindow::exportVDS(const std::filesystem::path& path) {
+    // the export writes a snapshot, so the volume can be modified or replaced meanwhile
+    const CachedVolume snapshot{m_volume, m_histogram, m_brickRanges};
+
+    m_jobScheduler.submit("Exporting VDS", JobPriority::Export, [=](JobContext&) {
+        QThread::currentThread()->setObjectName("Export VDS Thread");
+
+        // histogram and brick ranges are stored as well, so the next import skips computing them
+        const bool success = VdsVolumeIO::exportVdsFile(path, snapshot.volume, snapshot.histogram,
+                                                        snapshot.brickRanges, true);
 
-        emit(updateUIPermissions(0, -1));
+        if (!success) {
+            emit(showErrorExportVds());
+        }
     });
 }
 
 void MainWindow::openVolumeDataResizeDialog() {
     emit(updateUIPermissions(1, 1));
 
-    const QVector3D size(m_vdh.getVolumeSize().getX(),
-                         m_vdh.getVolumeSize().getY(),
-                         m_vdh.getVolumeSize().getZ());
-    const QVector3D spacing(m_vdh.getVolumeSpacing().getX(),
-                            m_vdh.getVolumeSpacing().getY(),
-                            m_vdh.getVolumeSpacing().getZ());
+    const QVector3D size(m_volume.getSizeX(), m_volume.getSizeY(), m_volume.getSizeZ());
+    const QVector3D spacing(m_volume.getSpacing()[0], m_volume.getSpacing()[1],
+                            m_volume.getSpacing()[2]);
 
-    DialogResizeVolumeData dialog(size, spacing, ui.volumeViewWidget->getTextureSizeMaximum());
+    DialogResizeVolumeData dialog(size, spacing, getBytesPerVoxel(m_volume.getVoxelType()),
+                                  ui.volumeViewWidget->getTextureSizeMaximum());
     connect(&dialog, &DialogResizeVolumeData::requestVRAMinfoUpdate, ui.volumeViewWidget,
             &VolumeViewGL::recieveVRAMinfoUpdateRequest);
     connect(ui.volumeViewWidget, &VolumeViewGL::sendVRAMinfoUpdate, &dialog,
@@ -545,66 +931,759 @@ void MainWindow::updateThresholdFromSlider(int threshold) {
 }
 
 void MainWindow::resizeVolumeData(QVector3D newSize, int interpolationMethod) {
-    QFuture<void> future = QtConcurrent::run([=]() {
+    // the timesteps keep their original size
+    closeTimeSeries();
+
+    // the resized volume is computed from a snapshot and published as a new version, exports of
+    // the current version are not blocked meanwhile
+    const Volume volume = m_volume;
+    const std::uint64_t version = m_volumeVersion;
+
+    m_jobScheduler.submit("Resizing volume", JobPriority::Import, [=](JobContext& context) {
         QThread::currentThread()->setObjectName("Resize Volume Data Thread");
-        emit(updateUIPermissions(1, 1));
+        const ScopedUIPermissions permissions(this, 0, 1);
+
+        const InterpolationMethod method = getInterpolationMethod(interpolationMethod);
+        const std::array<std::size_t, 3> size = Helper::QVector3DToArraySize(newSize);
+
+        CachedVolume resized;
+        resized.volume = resampleVolume(volume, size, method, context.getProgressCallback());
+        if (!context.isCanceled()) {
+            resized.histogram = VolumeHistogram(resized.volume);
+            resized.brickRanges = VolumeBrickRanges(resized.volume);
+            publishVolumeVersion(std::move(resized), version);
+        }
+
+        return;
+    });
+}
+
+void MainWindow::reorientVolumeData(const Reorientation& reorientation) {
+    // the timesteps keep their original orientation
+    closeTimeSeries();
+
+    const Volume volume = m_volume;
+    const std::uint64_t version = m_volumeVersion;
+
+    m_jobScheduler.submit("Reorienting volume", JobPriority::Import, [=](JobContext& context) {
+        QThread::currentThread()->setObjectName("Reorient Volume Data Thread");
+        const ScopedUIPermissions permissions(this, 0, 1);
+
+        CachedVolume reoriented;
+        reoriented.volume = reorientVolume(volume, reorientation, context.getProgressCallback());
+        if (context.isCanceled() || reoriented.volume.isEmpty()) {
+            return;
+        }
+        reoriented.histogram = VolumeHistogram(reoriented.volume);
+        reoriented.brickRanges = VolumeBrickRanges(reoriented.volume);
+        publishVolumeVersion(std::move(reoriented), version);
+
+        return;
+    });
+}
+
+void MainWindow::openVolumeFilterDialog(FilterType type) {
+    emit(updateUIPermissions(1, 1));
+
+    bool accepted = true;
+    float parameter = 0.0f;
+    switch (type) {
+    case FilterType::Gaussian:
+        parameter = static_cast<float>(QInputDialog::getDouble(
+            this, QString("Gaussian Smoothing"), QString("Standard deviation in voxels:"), 1.0,
+            0.1, 16.0, 2, &accepted));
+        break;
+    case FilterType::Box:
+        parameter = static_cast<float>(QInputDialog::getInt(
+            this, QString("Box Filter"), QString("Radius in voxels:"), 1, 1, 32, 1, &accepted));
+        break;
+    case FilterType::Median:
+        break;
+    }
+
+    if (accepted) {
+        filterVolumeData(type, parameter);
+    }
 
-        VDTK::ScaleMode scaleMode;
-        switch (interpolationMethod) {
-        case 2:
-            scaleMode = VDTK::ScaleMode::Cubic;
+    emit(updateUIPermissions(-1, -1));
+}
+
+void MainWindow::filterVolumeData(FilterType type, float parameter) {
+    // the timesteps keep their original voxels
+    closeTimeSeries();
+
+    const Volume volume = m_volume;
+    const std::uint64_t version = m_volumeVersion;
+
+    m_jobScheduler.submit("Filtering volume", JobPriority::Import, [=](JobContext& context) {
+        QThread::currentThread()->setObjectName("Filter Volume Data Thread");
+        const ScopedUIPermissions permissions(this, 0, 1);
+
+        CachedVolume result;
+        switch (type) {
+        case FilterType::Gaussian:
+            result.volume = gaussianFilterVolume(volume, parameter, context.getProgressCallback());
             break;
-        case 1:
-            scaleMode = VDTK::ScaleMode::Linear;
+        case FilterType::Box:
+            result.volume = boxFilterVolume(volume, static_cast<std::size_t>(parameter),
+                                            context.getProgressCallback());
             break;
-        case 0:
-        default:
-            scaleMode = VDTK::ScaleMode::NearestNeighbor;
+        case FilterType::Median:
+            result.volume = medianFilterVolume(volume, context.getProgressCallback());
             break;
         }
+        if (!context.isCanceled()) {
+            result.histogram = VolumeHistogram(result.volume);
+            result.brickRanges = VolumeBrickRanges(result.volume);
+            publishVolumeVersion(std::move(result), version);
+        }
 
-        VDTK::VolumeSize size(newSize.x(), newSize.y(), newSize.z());
+        return;
+    });
+}
+
+void MainWindow::openVoxelExpressionDialog() {
+    emit(updateUIPermissions(1, 1));
 
-        m_vdh.scaleToSize(scaleMode, size);
+    DialogVoxelExpression dialog(QString(getVoxelTypeName(m_volume.getVoxelType())));
+    connect(&dialog, &DialogVoxelExpression::requestPreview, this,
+            &MainWindow::previewVoxelExpression);
 
-        updateVolumeData();
+    const bool accepted = dialog.exec() == QDialog::Accepted;
+
+    // the preview only changed the texture, it gets the current voxels back
+    for (const VolumeRegion& region : m_voxelExpressionPreviewRegions) {
+        emit(updateVolumeViewRegion(m_volume.extractRegion(region), region));
+    }
+    m_voxelExpressionPreviewRegions.clear();
+    updateSliceRendererTexture();
 
+    if (accepted) {
+        applyVoxelExpression(dialog.getExpression(), dialog.getRegion(m_volume.getSize()));
+    }
+
+    emit(updateUIPermissions(-1, -1));
+}
+
+void MainWindow::previewVoxelExpression(const VoxelExpression& expression) {
+    const std::array<std::size_t, 3>& size = m_volume.getSize();
+    const std::array<int, 3> positions = {m_sliderSliceRendererX->value(),
+                                          m_sliderSliceRendererY->value(),
+                                          m_sliderSliceRendererZ->value()};
+
+    // The slice views sample the texture between the voxels position - 1 and position, so both
+    // get previewed. Only these slices are evaluated and uploaded, the volume stays unchanged.
+    m_voxelExpressionPreviewRegions.clear();
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        VolumeRegion region;
+        region.size = size;
+        region.offset[axis] = static_cast<std::size_t>(std::max(positions[axis] - 1, 0));
+        region.size[axis] = 2;
+        region = region.clamped(size);
+        if (region.isEmpty()) {
+            continue;
+        }
+
+        emit(updateVolumeViewRegion(expression.apply(m_volume.extractRegion(region)), region));
+        m_voxelExpressionPreviewRegions.push_back(region);
+    }
+
+    updateSliceRendererTexture();
+}
+
+void MainWindow::applyVoxelExpression(const VoxelExpression& expression,
+                                      const VolumeRegion& region) {
+    if (region.isEmpty()) {
+        return;
+    }
+
+    // the timesteps keep their original voxels
+    closeTimeSeries();
+
+    // Small regions are evaluated on the UI thread, only their voxels get uploaded and recounted
+    // in the histogram and the edit takes effect right away
+    if (region.getVoxelCount() <= inlineEditVoxelCount) {
+        editVolumeRegion(region, [&](Volume& volume) {
+            volume.insertRegion(expression.apply(volume.extractRegion(region)), region);
+        });
+        return;
+    }
+
+    const Volume volume = m_volume;
+    const std::uint64_t version = m_volumeVersion;
+
+    if (region.getVoxelCount() < volume.getVoxelCount()) {
+        const VolumeHistogram histogram = m_histogram;
+        const VolumeBrickRanges brickRanges = m_brickRanges;
+
+        m_jobScheduler.submit("Voxel expression", JobPriority::Import, [=](JobContext& context) {
+            QThread::currentThread()->setObjectName("Voxel Expression Thread");
+            const ScopedUIPermissions permissions(this, 0, 1);
+
+            const Volume regionResult =
+                expression.apply(volume.extractRegion(region), context.getProgressCallback());
+            if (context.isCanceled()) {
+                return;
+            }
+
+            // the derived data outside of the region stays valid
+            CachedVolume result{volume, histogram, brickRanges};
+            result.histogram.removeRegion(result.volume, region);
+            result.volume.insertRegion(regionResult, region);
+            result.histogram.addRegion(result.volume, region);
+            result.brickRanges.update(result.volume, region);
+
+            // floating point values beyond the value range change the mapping of all voxels
+            const ValueRange& currentRange = result.volume.getValueRange();
+            const ValueRange range = result.brickRanges.getRange();
+            if (result.volume.getVoxelType() == VoxelType::Float32 &&
+                (range.minimum < currentRange.minimum || range.maximum > currentRange.maximum)) {
+                result.volume.setValueRange(
+                    ValueRange{std::min(range.minimum, currentRange.minimum),
+                               std::max(range.maximum, currentRange.maximum)});
+                result.histogram = VolumeHistogram(result.volume);
+            }
+            publishVolumeVersion(std::move(result), version);
+        });
+        return;
+    }
+
+    m_jobScheduler.submit("Voxel expression", JobPriority::Import, [=](JobContext& context) {
+        QThread::currentThread()->setObjectName("Voxel Expression Thread");
+        const ScopedUIPermissions permissions(this, 0, 1);
+
+        CachedVolume result;
+        result.volume = expression.apply(volume, context.getProgressCallback());
+        if (!context.isCanceled()) {
+            result.histogram = VolumeHistogram(result.volume);
+            result.brickRanges = VolumeBrickRanges(result.volume);
+            publishVolumeVersion(std::move(result), version);
+        }
+
+        return;
+    });
+}
+
+void MainWindow::openConnectedComponentsDialog() {
+    const QString path = QFileDialog::getSaveFileName(this, QString("Save Component Statistics"),
+                                                      QString(), "CSV (*.csv)");
+    if (path.isEmpty()) {
+        return;
+    }
+
+    labelConnectedComponents(std::filesystem::path(path.toStdString()));
+}
+
+void MainWindow::labelConnectedComponents(const std::filesystem::path& statisticsPath) {
+    // the same voxels the isosurface encloses at this threshold
+    const ValueRange& range = m_volume.getValueRange();
+    const float isovalue =
+        range.minimum +
+        static_cast<float>(ui.doubleSpinBoxThreshold->value()) * (range.maximum - range.minimum);
+
+    // the timesteps keep their original voxels
+    closeTimeSeries();
+
+    const Volume volume = m_volume;
+    const std::uint64_t version = m_volumeVersion;
+
+    m_jobScheduler.submit("Connected components", JobPriority::Import, [=](JobContext& context) {
+        QThread::currentThread()->setObjectName("Connected Components Thread");
+        const ScopedUIPermissions permissions(this, 0, 1);
+
+        ConnectedComponents components =
+            VDS::labelConnectedComponents(volume, isovalue, context.getProgressCallback());
+        // too many runs of voxels for 32 bit indices or too many components for exact float
+        // labels leave the labels empty
+        if (!context.isCanceled() && !components.labels.isEmpty()) {
+            if (!exportComponentStatistics(statisticsPath, components, volume.getSpacing())) {
+                emit(showErrorExportStatistics());
+            }
+
+            CachedVolume result;
+            result.volume = std::move(components.labels);
+            result.histogram = VolumeHistogram(result.volume);
+            result.brickRanges = VolumeBrickRanges(result.volume);
+            publishVolumeVersion(std::move(result), version);
+        }
+
+        return;
+    });
+}
+
+void MainWindow::openIsosurfaceDialog() {
+    bool accepted = false;
+    const int decimationCellSize = QInputDialog::getInt(
+        this, QString("Extract Isosurface"),
+        QString("Merge vertices within cells of n voxels (1 = no decimation):"), 1, 1, 16, 1,
+        &accepted);
+
+    if (accepted) {
+        computeIsosurface(static_cast<std::size_t>(decimationCellSize));
+    }
+}
+
+void MainWindow::computeIsosurface(std::size_t decimationCellSize) {
+    // the threshold is normalized to the value range like the ray casting samples
+    const ValueRange& range = m_volume.getValueRange();
+    const float isovalue =
+        range.minimum +
+        static_cast<float>(ui.doubleSpinBoxThreshold->value()) * (range.maximum - range.minimum);
+
+    const Volume volume = m_volume;
+    const VolumeBrickRanges brickRanges = m_brickRanges;
+    const std::uint64_t version = m_volumeVersion;
+
+    m_jobScheduler.submit("Isosurface", JobPriority::Interactive, [=](JobContext& context) {
+        QThread::currentThread()->setObjectName("Isosurface Thread");
+
+        TriangleMesh mesh =
+            extractIsosurface(volume, brickRanges, isovalue, context.getProgressCallback());
+        if (context.isCanceled()) {
+            return;
+        }
+        if (decimationCellSize > 1) {
+            const std::array<float, 3>& spacing = volume.getSpacing();
+            const float cellSize = static_cast<float>(decimationCellSize);
+            mesh = decimateMesh(mesh, {spacing[0] * cellSize, spacing[1] * cellSize,
+                                       spacing[2] * cellSize});
+        }
+
+        auto result = std::make_shared<const TriangleMesh>(std::move(mesh));
+        QMetaObject::invokeMethod(
+            this,
+            [this, result, version]() {
+                // the mesh belongs to a volume that got replaced meanwhile
+                if (version == m_volumeVersion) {
+                    setIsosurface(result);
+                }
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::openExportIsosurfaceDialog(bool stl) {
+    const QString path = stl ? QFileDialog::getSaveFileName(this, QString("Export STL"),
+                                                            QString(), "STL (*.stl)")
+                             : QFileDialog::getSaveFileName(this, QString("Export PLY"),
+                                                            QString(), "PLY (*.ply)");
+    if (path.isEmpty() || !m_isosurface) {
+        return;
+    }
+
+    const std::shared_ptr<const TriangleMesh> mesh = m_isosurface;
+    const std::filesystem::path filePath(path.toStdString());
+    m_jobScheduler.submit("Exporting mesh", JobPriority::Export, [=](JobContext&) {
+        QThread::currentThread()->setObjectName("Export Mesh Thread");
+
+        const bool success = stl ? MeshIO::exportStlFile(filePath, *mesh)
+                                 : MeshIO::exportPlyFile(filePath, *mesh);
+        if (!success) {
+            emit(showErrorExportMesh());
+        }
+    });
+}
+
+void MainWindow::refreshOperationGraphMenu() {
+    // clear only deletes the actions, the submenus are children of the menu
+    qDeleteAll(m_menuOperationGraph->findChildren<QMenu*>(QString(), Qt::FindDirectChildrenOnly));
+    m_menuOperationGraph->clear();
+
+    QAction* actionQueueResize = m_menuOperationGraph->addAction(QString("Queue Resize"));
+    connect(actionQueueResize, &QAction::triggered, this,
+            &MainWindow::openOperationGraphResizeDialog);
+
+    QMenu* menuQueueReorientation = m_menuOperationGraph->addMenu(QString("Queue Reorientation"));
+    addReorientationActions(menuQueueReorientation, [this](const Reorientation& reorientation) {
+        m_operationGraph.append(Operation::reorient(reorientation));
+    });
+
+    QAction* actionQueueWindow =
+        m_menuOperationGraph->addAction(QString("Queue Current Value Window"));
+    connect(actionQueueWindow, &QAction::triggered, this, [this]() {
+        m_operationGraph.append(Operation::valueWindow(getValueWindowSettings()));
+    });
+
+    QMenu* menuQueueConversion = m_menuOperationGraph->addMenu(QString("Queue Conversion"));
+    for (const VoxelType voxelType :
+         {VoxelType::UInt8, VoxelType::UInt16, VoxelType::Int16, VoxelType::Float32}) {
+        QAction* actionConvert = menuQueueConversion->addAction(
+            QString("Convert to %1").arg(QString::fromStdString(getVoxelTypeName(voxelType))));
+        connect(actionConvert, &QAction::triggered, this, [this, voxelType]() {
+            m_operationGraph.append(Operation::convertVoxelType(voxelType));
+        });
+    }
+
+    // the queued operations in order, each one can be moved up or removed
+    m_menuOperationGraph->addSeparator();
+    const std::vector<Operation>& operations = m_operationGraph.getOperations();
+    for (std::size_t index = 0; index < operations.size(); index++) {
+        QMenu* menuOperation = m_menuOperationGraph->addMenu(
+            QString("%1. %2").arg(index + 1).arg(
+                QString::fromStdString(operations[index].getDescription())));
+        QAction* actionMoveUp = menuOperation->addAction(QString("Move Up"));
+        actionMoveUp->setEnabled(index > 0);
+        connect(actionMoveUp, &QAction::triggered, this,
+                [this, index]() { m_operationGraph.moveUp(index); });
+        QAction* actionRemove = menuOperation->addAction(QString("Remove"));
+        connect(actionRemove, &QAction::triggered, this,
+                [this, index]() { m_operationGraph.remove(index); });
+    }
+    QAction* actionPasses = m_menuOperationGraph->addAction(
+        m_operationGraph.isEmpty()
+            ? QString("No Operations Queued")
+            : QString("%1 Passes over the Volume").arg(m_operationGraph.getStageCount()));
+    actionPasses->setEnabled(false);
+
+    m_menuOperationGraph->addSeparator();
+    QAction* actionExecute = m_menuOperationGraph->addAction(QString("Apply to Volume"));
+    connect(actionExecute, &QAction::triggered, this, &MainWindow::executeOperationGraph);
+    QAction* actionExportLittleEndian =
+        m_menuOperationGraph->addAction(QString("Export RAW 3D (Little Endian)"));
+    connect(actionExportLittleEndian, &QAction::triggered, this,
+            [this]() { exportOperationGraph(true); });
+    QAction* actionExportBigEndian =
+        m_menuOperationGraph->addAction(QString("Export RAW 3D (Big Endian)"));
+    connect(actionExportBigEndian, &QAction::triggered, this,
+            [this]() { exportOperationGraph(false); });
+    QAction* actionClear = m_menuOperationGraph->addAction(QString("Clear"));
+    connect(actionClear, &QAction::triggered, this, [this]() { m_operationGraph.clear(); });
+
+    for (QAction* action : {actionExecute, actionExportLittleEndian, actionExportBigEndian,
+                            actionClear}) {
+        action->setEnabled(!m_operationGraph.isEmpty());
+    }
+}
+
+void MainWindow::openOperationGraphResizeDialog() {
+    // the resize applies to the result of the operations queued before it
+    const VolumeFormat format = m_operationGraph.getOutputFormat(VolumeFormat::of(m_volume));
+    const QVector3D size(format.size[0], format.size[1], format.size[2]);
+    const QVector3D spacing(format.spacing[0], format.spacing[1], format.spacing[2]);
+
+    DialogResizeVolumeData dialog(size, spacing, getBytesPerVoxel(format.voxelType),
+                                  ui.volumeViewWidget->getTextureSizeMaximum());
+    connect(&dialog, &DialogResizeVolumeData::requestVRAMinfoUpdate, ui.volumeViewWidget,
+            &VolumeViewGL::recieveVRAMinfoUpdateRequest);
+    connect(ui.volumeViewWidget, &VolumeViewGL::sendVRAMinfoUpdate, &dialog,
+            &DialogResizeVolumeData::recieveVRAMinfoUpdate);
+    dialog.show();
+
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    m_operationGraph.append(
+        Operation::resize(Helper::QVector3DToArraySize(dialog.getNewSize()),
+                          getInterpolationMethod(dialog.getInterploationMethod())));
+}
+
+void MainWindow::executeOperationGraph() {
+    // the timesteps keep their original format
+    closeTimeSeries();
+
+    // like resizeVolumeData, the result is computed from a snapshot and published as a new
+    // version
+    const Volume volume = m_volume;
+    const std::uint64_t version = m_volumeVersion;
+    const OperationGraph graph = m_operationGraph;
+    m_operationGraph.clear();
+
+    m_jobScheduler.submit(
+        "Applying operation graph", JobPriority::Import, [=](JobContext& context) {
+            QThread::currentThread()->setObjectName("Operation Graph Thread");
+            const ScopedUIPermissions permissions(this, 0, 1);
+
+            CachedVolume result;
+            result.volume = graph.execute(volume, context.getProgressCallback());
+            if (!context.isCanceled() && !result.volume.isEmpty()) {
+                result.histogram = VolumeHistogram(result.volume);
+                result.brickRanges = VolumeBrickRanges(result.volume);
+                publishVolumeVersion(std::move(result), version);
+            }
+
+            return;
+        });
+}
+
+void MainWindow::exportOperationGraph(bool littleEndian) {
+    const QString path = QFileDialog::getSaveFileName(this, QString("Export RAW 3D"), QString(),
+                                                      "RAW (*.raw)");
+    if (path.isEmpty()) {
+        return;
+    }
+
+    const Volume volume = m_volume;
+    const OperationGraph graph = m_operationGraph;
+    const VoxelType outputType = graph.getOutputFormat(VolumeFormat::of(volume)).voxelType;
+
+    m_jobScheduler.submit(
+        "Exporting operation graph", JobPriority::Export, [=](JobContext& context) {
+            QThread::currentThread()->setObjectName("Export Operation Graph Thread");
+
+            // the endianness gets converted while writing each slab, so the whole graph still
+            // traverses the voxels once per stage
+            RawVolumeIO::RawSliceWriter writer(std::filesystem::path(path.toStdString()),
+                                               outputType, littleEndian);
+            const bool success =
+                writer.isOpen() &&
+                graph.execute(
+                    volume,
+                    [&writer](const Volume& slab, std::size_t) {
+                        return writer.writeSlab(slab, ValueWindowSettings{});
+                    },
+                    context.getProgressCallback());
+
+            if (!success && !context.isCanceled()) {
+                emit(showErrorExportRaw());
+            }
+
+            return;
+        });
+}
+
+bool MainWindow::selectOutOfCoreSource(ImportItemRaw& source) {
+    DialogImportRAW3D dialog;
+    dialog.setWindowTitle(QString("Select RAW 3D Source File"));
+    dialog.setRegionOfInterestVisible(false);
+    dialog.show();
+
+    if (dialog.exec() != QDialog::Accepted) {
+        return false;
+    }
+
+    source = dialog.getImportItem();
+    return true;
+}
+
+void MainWindow::openOutOfCoreResizeDialog() {
+    emit(updateUIPermissions(1, 1));
+
+    ImportItemRaw source;
+    if (!selectOutOfCoreSource(source)) {
+        // Out-of-core resize got canceled by user
+        emit(updateUIPermissions(-1, -1));
+        return;
+    }
+
+    DialogResizeVolumeData dialog(source.getSize(), source.getSpacing(),
+                                  getBytesPerVoxel(source.getVoxelType()),
+                                  ui.volumeViewWidget->getTextureSizeMaximum());
+    connect(&dialog, &DialogResizeVolumeData::requestVRAMinfoUpdate, ui.volumeViewWidget,
+            &VolumeViewGL::recieveVRAMinfoUpdateRequest);
+    connect(ui.volumeViewWidget, &VolumeViewGL::sendVRAMinfoUpdate, &dialog,
+            &DialogResizeVolumeData::recieveVRAMinfoUpdate);
+    dialog.show();
+
+    if (dialog.exec() != QDialog::Accepted) {
         emit(updateUIPermissions(-1, -1));
+        return;
+    }
 
+    const QString path = QFileDialog::getSaveFileName(this, QString("Save Resized RAW 3D File"),
+                                                      QString(), "RAW (*.raw)");
+    if (path.isEmpty()) {
+        emit(updateUIPermissions(-1, -1));
         return;
+    }
+
+    resizeRawFileOutOfCore(source, dialog.getNewSize(), dialog.getInterploationMethod(),
+                           std::filesystem::path(path.toStdString()));
+    emit(updateUIPermissions(-1, -1));
+}
+
+void MainWindow::openOutOfCoreConvertDialog() {
+    emit(updateUIPermissions(1, 1));
+
+    ImportItemRaw source;
+    if (!selectOutOfCoreSource(source)) {
+        // Out-of-core conversion got canceled by user
+        emit(updateUIPermissions(-1, -1));
+        return;
+    }
+
+    const int32_t windowWidth = ui.spinBoxApplyWindowValueWindowWidth->value();
+    const int32_t windowCenter = ui.spinBoxApplyWindowValueWindowCenter->value();
+    const int32_t windowOffset = ui.spinBoxApplyWindowValueWindowOffset->value();
+    const QString function = ui.comboBoxApplyWindowFunction->currentText();
+    const ValueWindow valueWindow = ValueWindow(function, windowWidth, windowCenter, windowOffset);
+
+    DialogExportRAW3D dialog(valueWindow, source.getSize(), source.getSpacing());
+    dialog.show();
+
+    if (dialog.exec() != QDialog::Accepted) {
+        emit(updateUIPermissions(-1, -1));
+        return;
+    }
+
+    convertRawFileOutOfCore(source, dialog.getExportItem());
+    emit(updateUIPermissions(-1, -1));
+}
+
+void MainWindow::openOutOfCoreImageSeriesDialog() {
+    emit(updateUIPermissions(1, 1));
+
+    ImportItemRaw source;
+    if (!selectOutOfCoreSource(source)) {
+        // Out-of-core export got canceled by user
+        emit(updateUIPermissions(-1, -1));
+        return;
+    }
+
+    DialogExportImageSeries dialog(source.getSize(), source.getSpacing());
+    dialog.show();
+
+    if (dialog.exec() != QDialog::Accepted) {
+        emit(updateUIPermissions(-1, -1));
+        return;
+    }
+
+    exportImageSeriesOutOfCore(source, dialog.getExportItem());
+    emit(updateUIPermissions(-1, -1));
+}
+
+void MainWindow::resizeRawFileOutOfCore(const ImportItemRaw& source, QVector3D newSize,
+                                        int interpolationMethod,
+                                        const std::filesystem::path& destinationPath) {
+    m_jobScheduler.submit("Resizing RAW file", JobPriority::Export, [=](JobContext& context) {
+        QThread::currentThread()->setObjectName("Out-of-Core Resize Thread");
+        const ScopedUIPermissions permissions(this, 1, 1);
+
+        const bool success = resampleRawFile(
+            source.getFilePath(), source.getVoxelType(), source.representedInLittleEndian(),
+            Helper::QVector3DToArraySize(source.getSize()), destinationPath,
+            Helper::QVector3DToArraySize(newSize), getInterpolationMethod(interpolationMethod),
+            context.getProgressCallback());
+        if (!success && !context.isCanceled()) {
+            emit(showErrorOutOfCoreProcessing());
+        }
     });
 }
 
-void MainWindow::computeHistogram() {
-    QFuture<void> future = QtConcurrent::run(
-        [&]() {
-            QThread::currentThread()->setObjectName("Compute Histogram Thread");
-            emit(updateUIPermissions(0, -1));
+void MainWindow::convertRawFileOutOfCore(const ImportItemRaw& source, const ExportItemRaw& item) {
+    ValueWindowSettings window = getValueWindowSettings();
+    window.enabled = item.applyValueWindow();
+
+    m_jobScheduler.submit("Converting RAW file", JobPriority::Export, [=](JobContext& context) {
+        QThread::currentThread()->setObjectName("Out-of-Core Convert Thread");
+        const ScopedUIPermissions permissions(this, 1, 1);
+
+        const bool success = RawVolumeIO::convertRawFile(
+            source.getFilePath(), source.getVoxelType(), source.representedInLittleEndian(),
+            Helper::QVector3DToArraySize(source.getSize()), item.getPath(),
+            getVoxelTypeFromBitsPerVoxel(item.getBitsPerVoxel()),
+            item.representedInLittleEndian(), window, context.getProgressCallback());
+        if (!success && !context.isCanceled()) {
+            emit(showErrorOutOfCoreProcessing());
+        }
+    });
+}
+
+void MainWindow::exportImageSeriesOutOfCore(const ImportItemRaw& source,
+                                            const ExportItemImageSeries& item) {
+    ValueWindowSettings window = getValueWindowSettings();
+    window.enabled = item.applyValueWindow();
+
+    m_jobScheduler.submit("Exporting image series", JobPriority::Export, [=](JobContext& context) {
+        QThread::currentThread()->setObjectName("Out-of-Core Export Images Series Thread");
+        const ScopedUIPermissions permissions(this, 1, 1);
+
+        RawVolumeIO::RawSliceReader reader(
+            source.getFilePath(), source.getVoxelType(), source.representedInLittleEndian(),
+            Helper::QVector3DToArraySize(source.getSize()),
+            Helper::QVector3DToArraySpacing(source.getSpacing()));
+        if (!ImageSeriesIO::exportBitmapSeries(item.getPath(), reader, window,
+                                               context.getProgressCallback()) &&
+            !context.isCanceled()) {
+            emit(showErrorOutOfCoreProcessing());
+        }
+    });
+}
+
+void MainWindow::updateTimeSeriesStatus(float timestepsPerSecond, std::size_t decodedCount,
+                                        std::size_t uploadedCount, std::size_t ringSize) {
+    m_labelTimeSeriesStatus->setText(
+        QString("Timestep %1/%2 | %3 timesteps/s | RAM buffer %4/%6 | GPU buffer %5/%6")
+            .arg(m_timeSeriesPlayer.getCurrentTimestep() + 1)
+            .arg(m_timeSeriesPlayer.getTimestepCount())
+            .arg(static_cast<double>(timestepsPerSecond), 0, 'f', 1)
+            .arg(decodedCount)
+            .arg(uploadedCount)
+            .arg(ringSize));
+}
 
-            const bool windowingEnabled = ui.groupBoxApplyWindow->isChecked();
+void MainWindow::adoptCurrentTimestep(bool playing) {
+    if (playing || !m_timeSeriesPlayer.isOpen()) {
+        return;
+    }
+
+    // while paused, histogram and exports work on the shown timestep
+    CachedVolume timestep;
+    if (!m_timeSeriesPlayer.getCurrentVolume(timestep.volume)) {
+        return;
+    }
+    const std::uint64_t version = m_volumeVersion;
+
+    // pausing again supersedes a pending adoption
+    const auto adopt = [=](JobContext&) mutable {
+        QThread::currentThread()->setObjectName("Adopt Timestep Thread");
+        const ScopedUIPermissions permissions(this, 0, 1);
+
+        timestep.histogram = VolumeHistogram(timestep.volume);
+        timestep.brickRanges = VolumeBrickRanges(timestep.volume);
+
+        // the timestep is already shown, only the derived data gets replaced
+        QMetaObject::invokeMethod(
+            this,
+            [this, timestep, version]() {
+                if (version != m_volumeVersion) {
+                    return;
+                }
+                m_volume = timestep.volume;
+                m_compressedVolume.reset();
+                m_histogram = timestep.histogram;
+                m_brickRanges = timestep.brickRanges;
+                m_volumeCacheKey.clear();
+                m_volumeVersion++;
+                setIsosurface(nullptr);
+                computeHistogram();
+            },
+            Qt::QueuedConnection);
+    };
+    m_jobScheduler.submit("Adopting timestep", JobPriority::Interactive, adopt, "adoptTimestep");
+}
 
-            bool ignoreBorders = windowingEnabled;
+void MainWindow::computeHistogram() {
+    // The job gets a copy of the settings and a snapshot of the raw bins, so it neither touches
+    // the UI nor the histogram of a volume that may be replaced meanwhile. A newer request
+    // cancels the job, so only the latest window gets shown.
+    const ValueWindowSettings window = getValueWindowSettings();
+    const VolumeHistogram volumeHistogram = m_histogram;
+
+    m_jobScheduler.submit(
+        "Computing histogram", JobPriority::Interactive,
+        [=](JobContext& context) {
+            QThread::currentThread()->setObjectName("Compute Histogram Thread");
 
-            const int32_t windowWidth = ui.spinBoxApplyWindowValueWindowWidth->value();
-            const int32_t windowCenter = ui.spinBoxApplyWindowValueWindowCenter->value();
-            const int32_t windowOffset = ui.spinBoxApplyWindowValueWindowOffset->value();
-            const VDTK::WindowingFunction function =
-                VDTK::WindowingFunction(ui.comboBoxApplyWindowFunction->currentIndex());
+            bool ignoreBorders = window.enabled;
 
-            std::vector<uint16_t> histogram{};
+            // the windowed histogram is remapped from the cached raw bins instead of touching
+            // every voxel again
+            DisplayHistogram histogram;
 
-            if (windowingEnabled) {
-                histogram = m_vdh.getHistogramWidthWindowing(function, windowCenter, windowWidth,
-                                                             windowOffset);
+            if (window.enabled) {
+                histogram = volumeHistogram.getDisplayHistogram(window, ignoreBorders);
             } else {
-                histogram = m_vdh.getHistogram();
+                histogram = volumeHistogram.getDisplayHistogram(ignoreBorders);
             }
 
-            emit(updateHistogram(histogram, ignoreBorders));
-            emit(updateUIPermissions(0, 1));
+            if (!context.isCanceled()) {
+                emit(updateHistogram(histogram, ignoreBorders));
+            }
 
             return;
-        });
+        },
+        "histogram");
 }
 
 void MainWindow::setValueWindowPreset(const QString& preset) {
@@ -687,6 +1766,48 @@ void MainWindow::errorBinarySlicesImport() {
     msgBox.exec();
 }
 
+void MainWindow::errorBitmapSlicesImport() {
+    QMessageBox msgBox(QMessageBox::Warning, "Could not import Bitmap Slices",
+                       "All images need to be readable and of the same size.");
+    msgBox.exec();
+}
+
+void MainWindow::errorVdsExport() {
+    QMessageBox msgBox(QMessageBox::Critical, "Could not export VDS file",
+                       "Could not export VDS file.");
+    msgBox.exec();
+}
+
+void MainWindow::errorMeshExport() {
+    QMessageBox msgBox(QMessageBox::Critical, "Could not export mesh", "Could not export mesh.");
+    msgBox.exec();
+}
+
+void MainWindow::errorJobFailed(const QString& name, const QString& reason) {
+    QMessageBox msgBox(QMessageBox::Critical, name + QString(" failed"),
+                       name + QString(" failed: ") + reason);
+    msgBox.exec();
+}
+
+void MainWindow::errorStatisticsExport() {
+    QMessageBox msgBox(QMessageBox::Critical, "Could not save component statistics",
+                       "Could not write the CSV file, the labels replace the volume anyway.");
+    msgBox.exec();
+}
+
+void MainWindow::errorOutOfCoreProcessing() {
+    QMessageBox msgBox(QMessageBox::Critical, "Could not process RAW 3D file",
+                       "Could not read the source file or write the result. Please check the "
+                       "size and voxel type of the source file.");
+    msgBox.exec();
+}
+
+void MainWindow::errorVdsImport() {
+    QMessageBox msgBox(QMessageBox::Warning, "Could not import VDS file",
+                       "Invalid or corrupt VDS file.");
+    msgBox.exec();
+}
+
 void MainWindow::toggleSliceViewEnabled() {
     if (m_actionToggleSliceView->isChecked()) {
         ui.groupBoxSliceRenderX->setHidden(false);
@@ -779,47 +1900,51 @@ void MainWindow::updateSliceRendererXPosition(int position) {
     m_labelSliceRendererX->setText("X-Axis: " + QString::number(position));
     ui.volumeViewWidget->setSliceYZPosition(
         2.0f -
-        static_cast<float>(position) / static_cast<float>(m_vdh.getVolumeSize().getX()) * 2.0f);
+        static_cast<float>(position) / static_cast<float>(getVolumeSize()[0]) * 2.0f);
 }
 
 void MainWindow::updateSliceRendererYPosition(int position) {
     m_labelSliceRendererY->setText("Y-Axis: " + QString::number(position));
     ui.volumeViewWidget->setSliceXZPosition(
         2.0f -
-        static_cast<float>(position) / static_cast<float>(m_vdh.getVolumeSize().getY()) * 2.0f);
+        static_cast<float>(position) / static_cast<float>(getVolumeSize()[1]) * 2.0f);
 }
 
 void MainWindow::updateSliceRendererZPosition(int position) {
     m_labelSliceRendererZ->setText("Z-Axis: " + QString::number(position));
     ui.volumeViewWidget->setSliceXYPosition(
         2.0f -
-        static_cast<float>(position) / static_cast<float>(m_vdh.getVolumeSize().getZ()) * 2.0f);
+        static_cast<float>(position) / static_cast<float>(getVolumeSize()[2]) * 2.0f);
 }
 
 void MainWindow::updateSliceRenderSliderValueRanges() {
+    const std::array<std::size_t, 3> size = getVolumeSize();
+
     m_sliderSliceRendererX->setMinimum(1);
-    m_sliderSliceRendererX->setMaximum(static_cast<int>(m_vdh.getVolumeSize().getX()));
-    m_sliderSliceRendererX->setValue(static_cast<int>(m_vdh.getVolumeSize().getX()) / 2);
+    m_sliderSliceRendererX->setMaximum(static_cast<int>(size[0]));
+    m_sliderSliceRendererX->setValue(static_cast<int>(size[0]) / 2);
 
     m_sliderSliceRendererY->setMinimum(1);
-    m_sliderSliceRendererY->setMaximum(static_cast<int>(m_vdh.getVolumeSize().getY()));
-    m_sliderSliceRendererY->setValue(static_cast<int>(m_vdh.getVolumeSize().getY()) / 2);
+    m_sliderSliceRendererY->setMaximum(static_cast<int>(size[1]));
+    m_sliderSliceRendererY->setValue(static_cast<int>(size[1]) / 2);
 
     m_sliderSliceRendererZ->setMinimum(1);
-    m_sliderSliceRendererZ->setMaximum(static_cast<int>(m_vdh.getVolumeSize().getZ()));
-    m_sliderSliceRendererZ->setValue(static_cast<int>(m_vdh.getVolumeSize().getZ()) / 2);
+    m_sliderSliceRendererZ->setMaximum(static_cast<int>(size[2]));
+    m_sliderSliceRendererZ->setValue(static_cast<int>(size[2]) / 2);
 }
 
 void MainWindow::updateSliceRendererSizeParameters() {
-    ui.openGLWidgetSliceRenderX->setSize(m_vdh.getVolumeSize());
-    ui.openGLWidgetSliceRenderY->setSize(m_vdh.getVolumeSize());
-    ui.openGLWidgetSliceRenderZ->setSize(m_vdh.getVolumeSize());
+    const std::array<std::size_t, 3> size = getVolumeSize();
+    ui.openGLWidgetSliceRenderX->setSize(Helper::ArrayToVolumeSize(size));
+    ui.openGLWidgetSliceRenderY->setSize(Helper::ArrayToVolumeSize(size));
+    ui.openGLWidgetSliceRenderZ->setSize(Helper::ArrayToVolumeSize(size));
 }
 
 void MainWindow::updateSliceRendererSpacingParameters() {
-    ui.openGLWidgetSliceRenderX->setSpacing(m_vdh.getVolumeSpacing());
-    ui.openGLWidgetSliceRenderY->setSpacing(m_vdh.getVolumeSpacing());
-    ui.openGLWidgetSliceRenderZ->setSpacing(m_vdh.getVolumeSpacing());
+    const std::array<float, 3> spacing = getVolumeSpacing();
+    ui.openGLWidgetSliceRenderX->setSpacing(Helper::ArrayToVolumeSpacing(spacing));
+    ui.openGLWidgetSliceRenderY->setSpacing(Helper::ArrayToVolumeSpacing(spacing));
+    ui.openGLWidgetSliceRenderZ->setSpacing(Helper::ArrayToVolumeSpacing(spacing));
 }
 
 void MainWindow::updateSliceRendererTexture() {
@@ -827,17 +1952,33 @@ void MainWindow::updateSliceRendererTexture() {
     ui.openGLWidgetSliceRenderX->updateTexture(textureHandle);
     ui.openGLWidgetSliceRenderY->updateTexture(textureHandle);
     ui.openGLWidgetSliceRenderZ->updateTexture(textureHandle);
+
+    // the slice views share the texture, so they need the same mapping of its values
+    const ValueRangeMapping mapping =
+        m_compressedVolume
+            ? VolumeData3DTexture::computeValueRangeMapping(m_compressedVolume->getVoxelType(),
+                                                            m_compressedVolume->getValueRange())
+            : VolumeData3DTexture::computeValueRangeMapping(m_volume);
+    ui.openGLWidgetSliceRenderX->updateValueRangeMapping(mapping);
+    ui.openGLWidgetSliceRenderY->updateValueRangeMapping(mapping);
+    ui.openGLWidgetSliceRenderZ->updateValueRangeMapping(mapping);
 }
 
 void MainWindow::updateVolumeData() {
-    const std::array<std::size_t, 3> size = {
-        m_vdh.getVolumeSize().getX(), m_vdh.getVolumeSize().getY(), m_vdh.getVolumeSize().getZ()};
+    m_histogram = VolumeHistogram(m_volume);
+    m_brickRanges = VolumeBrickRanges(m_volume);
 
-    const std::array<float, 3> spacing = {m_vdh.getVolumeSpacing().getX(),
-                                          m_vdh.getVolumeSpacing().getY(),
-                                          m_vdh.getVolumeSpacing().getZ()};
+    updateVolumeViews();
+}
 
-    emit(updateVolumeView(size, spacing, m_vdh.getVolumeData().getRawVolumeData()));
+void MainWindow::updateVolumeViews() {
+    // the whole texture gets replaced, so pending partial updates are obsolete
+    m_volume.clearDirtyRegions();
+    if (m_compressedVolume) {
+        emit(updateCompressedVolumeView(m_compressedVolume));
+    } else {
+        emit(updateVolumeView(m_volume));
+    }
 
     updateSliceRenderSliderValueRanges();
     updateSliceRendererSizeParameters();
@@ -847,6 +1988,180 @@ void MainWindow::updateVolumeData() {
     computeHistogram();
 }
 
+bool MainWindow::switchVolume(const std::string& cacheKey,
+                              const std::function<bool(CachedVolume&)>& import,
+                              std::function<void()> switched) {
+    CachedVolume entry;
+    if (cacheKey.empty() || !m_volumeCache.take(cacheKey, entry)) {
+        // import into a separate volume, so the current one stays valid if the import fails
+        if (!import(entry)) {
+            return false;
+        }
+        // derived data of files opened before is reused from the sidecar cache on disk
+        if (entry.histogram.getBins().empty() &&
+            (cacheKey.empty() ||
+             !DerivedDataCache::loadDerivedData(cacheKey, entry.volume, entry.histogram,
+                                                entry.brickRanges))) {
+            entry.histogram = VolumeHistogram(entry.volume);
+            entry.brickRanges = VolumeBrickRanges(entry.volume);
+            if (!cacheKey.empty()) {
+                DerivedDataCache::storeDerivedData(cacheKey, entry.volume, entry.histogram,
+                                                   entry.brickRanges);
+            }
+        }
+    }
+
+    // the views and the widgets belong to the UI thread
+    QMetaObject::invokeMethod(
+        this,
+        [this, entry = std::move(entry), cacheKey, switched = std::move(switched)]() mutable {
+            // imported voxels are moved into place and shared with the views, never copied
+            [[maybe_unused]] const std::size_t deepCopyCount = Volume::getDeepCopyCount();
+
+            // keep the current volume for switching back to it
+            if (!m_volumeCacheKey.empty()) {
+                m_volumeCache.insert(m_volumeCacheKey, CachedVolume{std::move(m_volume),
+                                                                    std::move(m_histogram),
+                                                                    std::move(m_brickRanges)});
+            }
+
+            m_volume = std::move(entry.volume);
+            m_compressedVolume.reset();
+            m_histogram = std::move(entry.histogram);
+            m_brickRanges = std::move(entry.brickRanges);
+            m_volumeCacheKey = cacheKey;
+            m_volumeVersion++;
+
+            setIsosurface(nullptr);
+            updateVolumeViews();
+            assert(Volume::getDeepCopyCount() == deepCopyCount);
+
+            if (switched) {
+                switched();
+            }
+        },
+        Qt::QueuedConnection);
+    return true;
+}
+
+void MainWindow::switchToCompressedVolume(std::shared_ptr<const CompressedVolume> volume,
+                                          VolumeHistogram histogram,
+                                          VolumeBrickRanges brickRanges) {
+    QMetaObject::invokeMethod(
+        this,
+        [this, volume = std::move(volume), histogram = std::move(histogram),
+         brickRanges = std::move(brickRanges)]() mutable {
+            // keep the current volume for switching back to it
+            if (!m_volumeCacheKey.empty()) {
+                m_volumeCache.insert(m_volumeCacheKey, CachedVolume{std::move(m_volume),
+                                                                    std::move(m_histogram),
+                                                                    std::move(m_brickRanges)});
+            }
+
+            m_volume = Volume();
+            m_compressedVolume = std::move(volume);
+            m_histogram = std::move(histogram);
+            m_brickRanges = std::move(brickRanges);
+            m_volumeCacheKey.clear();
+            m_volumeVersion++;
+
+            setIsosurface(nullptr);
+            updateVolumeViews();
+        },
+        Qt::QueuedConnection);
+}
+
+std::array<std::size_t, 3> MainWindow::getVolumeSize() const {
+    return m_compressedVolume ? m_compressedVolume->getSize() : m_volume.getSize();
+}
+
+std::array<float, 3> MainWindow::getVolumeSpacing() const {
+    return m_compressedVolume ? m_compressedVolume->getSpacing() : m_volume.getSpacing();
+}
+
+void MainWindow::editVolumeRegion(const VolumeRegion& region,
+                                  const std::function<void(Volume&)>& edit) {
+    // remove the old voxel values from the histogram before they get overwritten
+    m_histogram.removeRegion(m_volume, region);
+
+    // snapshots held by background tasks keep the voxels as they were before the edit
+    edit(m_volume);
+    m_volume.markDirty(region);
+    m_volumeCacheKey.clear();
+    m_volumeVersion++;
+
+    m_histogram.addRegion(m_volume, region);
+    m_brickRanges.update(m_volume, region);
+    setIsosurface(nullptr);
+
+    updateDirtyVolumeRegions();
+}
+
+void MainWindow::updateDirtyVolumeRegions() {
+    // floating point volumes are mapped to [0, 1] by their value range, so edits outside of that
+    // range change the mapping of all voxels
+    if (m_volume.getVoxelType() == VoxelType::Float32) {
+        const ValueRange& currentRange = m_volume.getValueRange();
+        const ValueRange range = m_brickRanges.getRange();
+        if (range.minimum < currentRange.minimum || range.maximum > currentRange.maximum) {
+            m_volume.setValueRange(ValueRange{std::min(range.minimum, currentRange.minimum),
+                                              std::max(range.maximum, currentRange.maximum)});
+            updateVolumeData();
+            return;
+        }
+    }
+
+    // only the modified regions get copied and uploaded with glTexSubImage3D
+    for (const VolumeRegion& region : m_volume.getDirtyRegions()) {
+        emit(updateVolumeViewRegion(m_volume.extractRegion(region), region));
+    }
+    m_volume.clearDirtyRegions();
+
+    // the slice views share the texture and only need to be redrawn
+    updateSliceRendererTexture();
+    computeHistogram();
+}
+
+void MainWindow::publishVolumeVersion(CachedVolume&& version, const std::uint64_t baseVersion) {
+    QMetaObject::invokeMethod(
+        this,
+        [this, version = std::move(version), baseVersion]() mutable {
+            // the version is stale if an edit or another writer replaced the volume meanwhile
+            if (baseVersion != m_volumeVersion) {
+                return;
+            }
+
+            m_volume = std::move(version.volume);
+            m_compressedVolume.reset();
+            m_histogram = std::move(version.histogram);
+            m_brickRanges = std::move(version.brickRanges);
+            // keep the current volume for switching back to it, the new version does not match
+            // its file anymore
+            if (!m_volumeCacheKey.empty()) {
+                m_volumeCache.insert(m_volumeCacheKey, CachedVolume{std::move(m_volume),
+                                                                    std::move(m_histogram),
+                                                                    std::move(m_brickRanges)});
+            }
+            m_volumeCacheKey.clear();
+            m_volumeVersion++;
+
+            setIsosurface(nullptr);
+            updateVolumeViews();
+        },
+        Qt::QueuedConnection);
+}
+
+void MainWindow::setIsosurface(std::shared_ptr<const TriangleMesh> mesh) {
+    if (!mesh && !m_isosurface) {
+        return;
+    }
+
+    m_isosurface = std::move(mesh);
+    m_actionExportIsosurfaceSTL->setEnabled(m_isosurface != nullptr);
+    m_actionExportIsosurfacePLY->setEnabled(m_isosurface != nullptr);
+    emit(updateMeshView(m_isosurface));
+}
+
 void MainWindow::setupFileMenu() {
     m_menuFiles = new QMenu(ui.menuBar);
     m_menuFiles->setTitle(QString("File"));
@@ -857,12 +2172,34 @@ void MainWindow::setupFileMenu() {
     m_menuFiles->addAction(m_actionImportRAW3D);
     connect(m_actionImportRAW3D, &QAction::triggered, this, &MainWindow::openImportRawDialog);
 
+    m_actionImportRAW3DCompressed = new QAction(m_menuFiles);
+    m_actionImportRAW3DCompressed->setText(QString("Import RAW 3D Compressed"));
+    m_menuFiles->addAction(m_actionImportRAW3DCompressed);
+    connect(m_actionImportRAW3DCompressed, &QAction::triggered, this,
+            &MainWindow::openImportRawCompressedDialog);
+
     m_actionImportBinarySlices = new QAction(m_menuFiles);
     m_actionImportBinarySlices->setText(QString("Import Binary Slices"));
     m_menuFiles->addAction(m_actionImportBinarySlices);
     connect(m_actionImportBinarySlices, &QAction::triggered, this,
             &MainWindow::openImportBinarySlicesDialog);
 
+    m_actionImportBitmapSlices = new QAction(m_menuFiles);
+    m_actionImportBitmapSlices->setText(QString("Import Bitmap Slices"));
+    m_menuFiles->addAction(m_actionImportBitmapSlices);
+    connect(m_actionImportBitmapSlices, &QAction::triggered, this,
+            &MainWindow::openImportBitmapSlicesDialog);
+
+    m_actionImportRAW4D = new QAction(m_menuFiles);
+    m_actionImportRAW4D->setText(QString("Import RAW 4D Time Series"));
+    m_menuFiles->addAction(m_actionImportRAW4D);
+    connect(m_actionImportRAW4D, &QAction::triggered, this, &MainWindow::openImportRaw4DDialog);
+
+    m_actionImportVDS = new QAction(m_menuFiles);
+    m_actionImportVDS->setText(QString("Import VDS"));
+    m_menuFiles->addAction(m_actionImportVDS);
+    connect(m_actionImportVDS, &QAction::triggered, this, &MainWindow::openImportVdsDialog);
+
     m_menuRecentFiles = new QMenu(m_menuFiles);
     m_menuRecentFiles->setTitle(QString("Recent Files"));
     m_menuFiles->addMenu(m_menuRecentFiles);
@@ -880,6 +2217,11 @@ void MainWindow::setupFileMenu() {
     connect(m_actionExportBitmapSeries, &QAction::triggered, this,
             &MainWindow::openExportImageSeriesDialog);
 
+    m_actionExportVDS = new QAction(m_menuFiles);
+    m_actionExportVDS->setText(QString("Export VDS"));
+    m_menuFiles->addAction(m_actionExportVDS);
+    connect(m_actionExportVDS, &QAction::triggered, this, &MainWindow::openExportVdsDialog);
+
     refreshRecentFileList();
 }
 
@@ -923,6 +2265,160 @@ void MainWindow::setupToolsMenu() {
     m_menuTools->addAction(m_actionResizeVolumeData);
     connect(m_actionResizeVolumeData, &QAction::triggered, this,
             &MainWindow::openVolumeDataResizeDialog);
+
+    m_menuReorientVolumeData = new QMenu(m_menuTools);
+    m_menuReorientVolumeData->setTitle(QString("Reorient Volume Data"));
+    m_menuTools->addMenu(m_menuReorientVolumeData);
+
+    addReorientationActions(m_menuReorientVolumeData, [this](const Reorientation& reorientation) {
+        reorientVolumeData(reorientation);
+    });
+
+    m_menuFilterVolumeData = new QMenu(m_menuTools);
+    m_menuFilterVolumeData->setTitle(QString("Filter Volume Data"));
+    m_menuTools->addMenu(m_menuFilterVolumeData);
+
+    QAction* actionGaussianFilter =
+        m_menuFilterVolumeData->addAction(QString("Gaussian Smoothing"));
+    connect(actionGaussianFilter, &QAction::triggered, this,
+            [this]() { openVolumeFilterDialog(FilterType::Gaussian); });
+    QAction* actionBoxFilter = m_menuFilterVolumeData->addAction(QString("Box Filter"));
+    connect(actionBoxFilter, &QAction::triggered, this,
+            [this]() { openVolumeFilterDialog(FilterType::Box); });
+    QAction* actionMedianFilter = m_menuFilterVolumeData->addAction(QString("Median 3x3x3"));
+    connect(actionMedianFilter, &QAction::triggered, this,
+            [this]() { openVolumeFilterDialog(FilterType::Median); });
+
+    m_actionVoxelExpression = new QAction(m_menuTools);
+    m_actionVoxelExpression->setText(QString("Voxel Expression"));
+    m_menuTools->addAction(m_actionVoxelExpression);
+    connect(m_actionVoxelExpression, &QAction::triggered, this,
+            &MainWindow::openVoxelExpressionDialog);
+
+    m_actionConnectedComponents = new QAction(m_menuTools);
+    m_actionConnectedComponents->setText(QString("Connected Components"));
+    m_menuTools->addAction(m_actionConnectedComponents);
+    connect(m_actionConnectedComponents, &QAction::triggered, this,
+            &MainWindow::openConnectedComponentsDialog);
+
+    m_menuIsosurface = new QMenu(m_menuTools);
+    m_menuIsosurface->setTitle(QString("Isosurface"));
+    m_menuTools->addMenu(m_menuIsosurface);
+
+    QAction* actionExtractIsosurface =
+        m_menuIsosurface->addAction(QString("Extract at Current Threshold"));
+    connect(actionExtractIsosurface, &QAction::triggered, this,
+            &MainWindow::openIsosurfaceDialog);
+    m_actionShowIsosurface = m_menuIsosurface->addAction(QString("Show Isosurface"));
+    m_actionShowIsosurface->setCheckable(true);
+    m_actionShowIsosurface->setChecked(true);
+    connect(m_actionShowIsosurface, &QAction::toggled, ui.volumeViewWidget,
+            &VolumeViewGL::setMeshRenderStatus);
+    m_menuIsosurface->addSeparator();
+    m_actionExportIsosurfaceSTL = m_menuIsosurface->addAction(QString("Export as STL"));
+    connect(m_actionExportIsosurfaceSTL, &QAction::triggered, this,
+            [this]() { openExportIsosurfaceDialog(true); });
+    m_actionExportIsosurfacePLY = m_menuIsosurface->addAction(QString("Export as PLY"));
+    connect(m_actionExportIsosurfacePLY, &QAction::triggered, this,
+            [this]() { openExportIsosurfaceDialog(false); });
+
+    // rebuilt whenever it opens, so it always lists the queued operations
+    m_menuOperationGraph = new QMenu(m_menuTools);
+    m_menuOperationGraph->setTitle(QString("Operation Graph"));
+    m_menuTools->addMenu(m_menuOperationGraph);
+    connect(m_menuOperationGraph, &QMenu::aboutToShow, this,
+            &MainWindow::refreshOperationGraphMenu);
+
+    // works on files instead of the loaded volume, so it is available without a volume
+    m_menuOutOfCore = new QMenu(m_menuTools);
+    m_menuOutOfCore->setTitle(QString("Out-of-Core Processing"));
+    m_menuTools->addMenu(m_menuOutOfCore);
+
+    QAction* actionOutOfCoreResize = m_menuOutOfCore->addAction(QString("Resize RAW 3D File"));
+    connect(actionOutOfCoreResize, &QAction::triggered, this,
+            &MainWindow::openOutOfCoreResizeDialog);
+    QAction* actionOutOfCoreConvert =
+        m_menuOutOfCore->addAction(QString("Convert RAW 3D File"));
+    connect(actionOutOfCoreConvert, &QAction::triggered, this,
+            &MainWindow::openOutOfCoreConvertDialog);
+    QAction* actionOutOfCoreImageSeries =
+        m_menuOutOfCore->addAction(QString("Export RAW 3D File as Image Series"));
+    connect(actionOutOfCoreImageSeries, &QAction::triggered, this,
+            &MainWindow::openOutOfCoreImageSeriesDialog);
+}
+
+void MainWindow::addReorientationActions(
+    QMenu* menu, const std::function<void(const Reorientation&)>& apply) {
+    const std::array<QString, 3> axisNames = {"X", "Y", "Z"};
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        QAction* actionFlip = menu->addAction(QString("Flip %1 Axis").arg(axisNames[axis]));
+        connect(actionFlip, &QAction::triggered, this,
+                [apply, axis]() { apply(Reorientation::flip(axis)); });
+    }
+    menu->addSeparator();
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        const std::size_t nextAxis = (axis + 1) % 3;
+        QAction* actionSwap =
+            menu->addAction(QString("Swap %1 and %2 Axes")
+                                .arg(axisNames[std::min(axis, nextAxis)],
+                                     axisNames[std::max(axis, nextAxis)]));
+        connect(actionSwap, &QAction::triggered, this,
+                [apply, axis, nextAxis]() { apply(Reorientation::swap(axis, nextAxis)); });
+    }
+}
+
+void MainWindow::setupPlaybackMenu() {
+    m_menuPlayback = new QMenu(ui.menuBar);
+    m_menuPlayback->setTitle(QString("Playback"));
+    m_menuPlayback->setEnabled(false);
+    ui.menuBar->addMenu(m_menuPlayback);
+
+    m_actionPlayPause = new QAction(m_menuPlayback);
+    m_actionPlayPause->setText(QString("Play"));
+    m_actionPlayPause->setCheckable(true);
+    m_actionPlayPause->setShortcut(QKeySequence(Qt::Key_Space));
+    m_menuPlayback->addAction(m_actionPlayPause);
+    connect(m_actionPlayPause, &QAction::triggered, &m_timeSeriesPlayer,
+            &TimeSeriesPlayer::togglePlayback);
+
+    m_actionNextTimestep = new QAction(m_menuPlayback);
+    m_actionNextTimestep->setText(QString("Next Timestep"));
+    m_actionNextTimestep->setShortcut(QKeySequence(Qt::Key_Period));
+    m_menuPlayback->addAction(m_actionNextTimestep);
+    connect(m_actionNextTimestep, &QAction::triggered, &m_timeSeriesPlayer,
+            &TimeSeriesPlayer::stepForward);
+
+    m_actionPreviousTimestep = new QAction(m_menuPlayback);
+    m_actionPreviousTimestep->setText(QString("Previous Timestep"));
+    m_actionPreviousTimestep->setShortcut(QKeySequence(Qt::Key_Comma));
+    m_menuPlayback->addAction(m_actionPreviousTimestep);
+    connect(m_actionPreviousTimestep, &QAction::triggered, &m_timeSeriesPlayer,
+            &TimeSeriesPlayer::stepBackward);
+
+    m_menuPlaybackSpeed = new QMenu(m_menuPlayback);
+    m_menuPlaybackSpeed->setTitle(QString("Speed"));
+    m_menuPlayback->addMenu(m_menuPlaybackSpeed);
+    m_actionGroupPlaybackSpeed = new QActionGroup(m_menuPlaybackSpeed);
+    for (const int timestepsPerSecond : {5, 10, 25, 50, 100}) {
+        QAction* action = new QAction(m_menuPlaybackSpeed);
+        action->setText(QString("%1 timesteps/s").arg(timestepsPerSecond));
+        action->setCheckable(true);
+        action->setChecked(timestepsPerSecond == TimeSeriesPlayer::defaultTimestepsPerSecond);
+        m_actionGroupPlaybackSpeed->addAction(action);
+        m_menuPlaybackSpeed->addAction(action);
+        connect(action, &QAction::triggered, this, [this, timestepsPerSecond] {
+            m_timeSeriesPlayer.setTimestepsPerSecond(timestepsPerSecond);
+        });
+    }
+
+    m_labelTimeSeriesStatus = new QLabel();
+    statusBar()->addPermanentWidget(m_labelTimeSeriesStatus);
+}
+
+void MainWindow::closeTimeSeries() {
+    m_timeSeriesPlayer.close();
+    m_menuPlayback->setEnabled(false);
+    m_labelTimeSeriesStatus->clear();
 }
 
 void MainWindow::setupRendererView() {
@@ -1085,13 +2581,18 @@ void MainWindow::refreshRecentFileList() {
     }
 }
 
-bool MainWindow::checkIsBigEndian() {
-    union {
-        uint32_t i;
-        char c[4];
-    } bint = {0x01020304};
-
-    return bint.c[0] == 1;
+ValueWindowSettings MainWindow::getValueWindowSettings() const {
+    ValueWindowSettings window;
+    window.enabled = ui.groupBoxApplyWindow->isChecked();
+    window.method = WindowingMethod(ui.comboBoxApplyWindowFunction->currentIndex());
+    window.valueWindowWidth =
+        static_cast<float>(ui.spinBoxApplyWindowValueWindowWidth->value()) / UINT16_MAX;
+    window.valueWindowCenter =
+        static_cast<float>(ui.spinBoxApplyWindowValueWindowCenter->value()) / UINT16_MAX;
+    window.valueWindowOffset =
+        static_cast<float>(ui.spinBoxApplyWindowValueWindowOffset->value()) / UINT16_MAX;
+
+    return window;
 }
 
 } // namespace VDS
@@ -3,13 +3,29 @@
 #include <QtWidgets/QMainWindow>
 #include <QTextEdit>
 #include <QPushButton>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
 #include "ui_main_window.h"
 
-#include <VDTK/VolumeDataHandler.h>
-
+#include "common/compressed_volume.h"
+#include "common/triangle_mesh.h"
+#include "common/volume.h"
+#include "common/volume_brick_ranges.h"
+#include "common/volume_cache.h"
+#include "common/volume_histogram.h"
 #include "fileio/import_item_list.h"
 #include "fileio/import_item.h"
 #include "fileio/export_item.h"
+#include "renderer/shader/shader_settings.h"
+#include "tools/job_scheduler.h"
+#include "tools/operation_graph.h"
+#include "tools/time_series_player.h"
+#include "tools/volume_filter.h"
+#include "tools/volume_reorientation.h"
+#include "tools/voxel_expression.h"
 #include "widgets/expandable_section_widget.h"
 
 namespace VDS {
@@ -26,12 +42,22 @@ public slots:
 
 
     void openImportRawDialog();
+    void openImportRawCompressedDialog();
     void openImportBinarySlicesDialog();
+    void openImportBitmapSlicesDialog();
+    void openImportRaw4DDialog();
+    void openImportVdsDialog();
     void saveRecentFilesList();
+    // takes ownership of item, UI thread only
+    void addRecentFile(const ImportItem* item, ImportType type);
     void loadRecentFilesList();
     void refreshRecentFileList();
     void importRAW3D(const ImportItemRaw& item3D);
+    void importRAW3DCompressed(const ImportItemRaw& item3D);
     void importBinarySlices(const ImportItemBinarySlices& item3D);
+    void importBitmapSlices(const ImportItemBitmapSlices& item3D);
+    void importRAW4D(const ImportItemRaw& item4D);
+    void importVDS(const ImportItemVds& item);
 
     void importRecentFile(std::size_t index);
 
@@ -39,6 +65,8 @@ public slots:
     void exportRAW3D(const ExportItemRaw& item);
     void openExportImageSeriesDialog();
     void exportImageSeries(const ExportItemImageSeries& item);
+    void openExportVdsDialog();
+    void exportVDS(const std::filesystem::path& path);
 
     void openVolumeDataResizeDialog();
 
@@ -47,6 +75,49 @@ public slots:
     void updateThresholdFromSlider(int threshold);
 
     void resizeVolumeData(QVector3D newSize, int interpolationMethod);
+    void reorientVolumeData(const Reorientation& reorientation);
+    // asks for the kernel size of filters that have one, parameter is sigma or the radius
+    void openVolumeFilterDialog(FilterType type);
+    void filterVolumeData(FilterType type, float parameter);
+
+    // Per-voxel formula over the current volume, previewed on the slices of the slice views.
+    // Expressions restricted to a small region edit the volume in place, see editVolumeRegion,
+    // larger regions run as a job like whole-volume expressions.
+    void openVoxelExpressionDialog();
+    void previewVoxelExpression(const VoxelExpression& expression);
+    void applyVoxelExpression(const VoxelExpression& expression, const VolumeRegion& region);
+
+    // Replaces the volume by the labels of the connected regions at or above the current threshold
+    // and writes their statistics to a CSV file
+    void openConnectedComponentsDialog();
+    void labelConnectedComponents(const std::filesystem::path& statisticsPath);
+
+    // Triangle mesh of the surface the FirstHit ray casting shows at the current threshold. The
+    // volume view renders it instead of ray casting until the volume changes.
+    void openIsosurfaceDialog();
+    void computeIsosurface(std::size_t decimationCellSize);
+    void openExportIsosurfaceDialog(bool stl);
+
+    // Transforms queued in the operation graph run fused in a single job, see OperationGraph
+    void refreshOperationGraphMenu();
+    void openOperationGraphResizeDialog();
+    void executeOperationGraph();
+    void exportOperationGraph(bool littleEndian);
+
+    // Out-of-core processing of raw files larger than RAM, source and result stay on disk
+    void openOutOfCoreResizeDialog();
+    void openOutOfCoreConvertDialog();
+    void openOutOfCoreImageSeriesDialog();
+    void resizeRawFileOutOfCore(const ImportItemRaw& source, QVector3D newSize,
+                                int interpolationMethod,
+                                const std::filesystem::path& destinationPath);
+    void convertRawFileOutOfCore(const ImportItemRaw& source, const ExportItemRaw& item);
+    void exportImageSeriesOutOfCore(const ImportItemRaw& source,
+                                    const ExportItemImageSeries& item);
+
+    void updateTimeSeriesStatus(float timestepsPerSecond, std::size_t decodedCount,
+                                std::size_t uploadedCount, std::size_t ringSize);
+    void adoptCurrentTimestep(bool playing);
 
     void computeHistogram();
 
@@ -61,6 +132,13 @@ public slots:
     void errorImageSeriesExport();
     void errorRawImport();
     void errorBinarySlicesImport();
+    void errorBitmapSlicesImport();
+    void errorVdsExport();
+    void errorVdsImport();
+    void errorOutOfCoreProcessing();
+    void errorMeshExport();
+    void errorStatisticsExport();
+    void errorJobFailed(const QString& name, const QString& reason);
 
     void toggleSliceViewEnabled();
     void toggleControllViewEnabled();
@@ -82,38 +160,90 @@ public slots:
     void updateSliceRendererTexture();
 
 signals:
-    void updateHistogram(const std::vector<uint16_t>& histogram, bool ignoreBorders);
+    void updateHistogram(const VDS::DisplayHistogram& histogram, bool ignoreBorders);
     // -1 = allow it, 0 = unchanged, 1 = do not allow it
     void updateUIPermissions(int read, int write);
     void showErrorExportRaw();
     void showErrorExportImagesSeries();
     void showErrorImportRaw();
     void showErrorImportBinarySlices();
+    void showErrorImportBitmapSlices();
+    void showErrorExportVds();
+    void showErrorImportVds();
+    void showErrorOutOfCoreProcessing();
+    void showErrorExportMesh();
+    void showErrorExportStatistics();
     void updateRecentFiles();
     void updateVertexShaderFromEditor(const QString& vertexShader);
     void updateFragmentShaderFromEditor(const QString& fragmentShader);
-    void updateVolumeView(const std::array<std::size_t, 3> size, const std::array<float, 3> spacing,
-                          const std::vector<uint16_t>& volumeData);
+    void updateVolumeView(const VDS::Volume& volume);
+    void updateCompressedVolumeView(const std::shared_ptr<const VDS::CompressedVolume>& volume);
+    void updateVolumeViewRegion(const VDS::Volume& regionData, const VDS::VolumeRegion& region);
+    void updateMeshView(const std::shared_ptr<const VDS::TriangleMesh>& mesh);
 
 private:
+    // recomputes histogram and brick ranges before updating the views
     void updateVolumeData();
+    void updateVolumeViews();
+    // Makes the volume identified by cacheKey the current one. Cached volumes are moved in
+    // together with their histogram and brick ranges, otherwise import gets called. The previous
+    // volume is moved into the cache. An empty cacheKey bypasses the cache. Histogram and brick
+    // ranges are only computed if import did not provide them. Meant for import jobs: the lookup
+    // and import run on the calling thread, the volume gets swapped in on the UI thread, which
+    // calls switched afterwards. Returns false if import failed.
+    bool switchVolume(const std::string& cacheKey,
+                      const std::function<bool(CachedVolume&)>& import,
+                      std::function<void()> switched = std::function<void()>());
+    // Makes volume the current one on the UI thread, where it stays compressed in RAM. Like
+    // switchVolume the previous volume is moved into the cache and it can be called from any
+    // thread. Tools that need the decompressed voxels are disabled.
+    void switchToCompressedVolume(std::shared_ptr<const CompressedVolume> volume,
+                                  VolumeHistogram histogram, VolumeBrickRanges brickRanges);
+    // size and spacing of the current volume, whether compressed or not
+    std::array<std::size_t, 3> getVolumeSize() const;
+    std::array<float, 3> getVolumeSpacing() const;
+    // Runs edit on m_volume, which must only modify voxels within region. Textures, histogram and
+    // brick ranges are updated for that region only.
+    void editVolumeRegion(const VolumeRegion& region, const std::function<void(Volume&)>& edit);
+    void updateDirtyVolumeRegions();
+    // Makes version the current volume on the UI thread, unless the volume got replaced since
+    // baseVersion, which the new version was computed from. Like switchVolume the previous volume
+    // is moved into the cache, so a derived version like connected component labels does not
+    // lose the file it was computed from. Can be called from any thread.
+    void publishVolumeVersion(CachedVolume&& version, std::uint64_t baseVersion);
+    // Shows mesh in the volume view, an empty pointer returns to ray casting. UI thread only, it
+    // updates the export actions. Called wherever the current volume gets replaced or edited.
+    void setIsosurface(std::shared_ptr<const TriangleMesh> mesh);
     void setupFileMenu();
     void setupViewMenu();
     void setupToolsMenu();
+    // adds the flip and swap actions of the reorient menu, apply gets called with the selection
+    void addReorientationActions(QMenu* menu,
+                                 const std::function<void(const Reorientation&)>& apply);
+    void setupPlaybackMenu();
+    void closeTimeSeries();
     void setupRendererView();
     void setupShaderEditor();
 
-    bool checkIsBigEndian();
+    // asks for the raw file to process out-of-core, false if the user canceled
+    bool selectOutOfCoreSource(ImportItemRaw& source);
+    // value window as currently set in the UI, normalized to [0, 1]
+    ValueWindowSettings getValueWindowSettings() const;
 
     Ui::MainWindowClass ui;
 
     // File Menu
     QMenu* m_menuFiles;
     QAction* m_actionImportRAW3D;
+    QAction* m_actionImportRAW3DCompressed;
     QAction* m_actionImportBinarySlices;
+    QAction* m_actionImportBitmapSlices;
+    QAction* m_actionImportRAW4D;
+    QAction* m_actionImportVDS;
     QMenu* m_menuRecentFiles;
     QAction* m_actionExportRAW3D;
     QAction* m_actionExportBitmapSeries;
+    QAction* m_actionExportVDS;
     ImportItemList m_importList;
 
     // View Menu
@@ -125,6 +255,27 @@ private:
     // Tools Menu
     QMenu* m_menuTools;
     QAction* m_actionResizeVolumeData;
+    QMenu* m_menuReorientVolumeData;
+    QMenu* m_menuFilterVolumeData;
+    QAction* m_actionVoxelExpression;
+    QAction* m_actionConnectedComponents;
+    QMenu* m_menuIsosurface;
+    QAction* m_actionShowIsosurface;
+    QAction* m_actionExportIsosurfaceSTL;
+    QAction* m_actionExportIsosurfacePLY;
+    QMenu* m_menuOperationGraph;
+    QMenu* m_menuOutOfCore;
+
+    // Playback Menu
+    QMenu* m_menuPlayback;
+    QAction* m_actionPlayPause;
+    QAction* m_actionNextTimestep;
+    QAction* m_actionPreviousTimestep;
+    QMenu* m_menuPlaybackSpeed;
+    QActionGroup* m_actionGroupPlaybackSpeed;
+    QLabel* m_labelTimeSeriesStatus;
+    QLabel* m_labelJobStatus;
+    QPushButton* m_buttonCancelJobs;
 
     // Renderer View
     QLabel* m_labelSliceRendererX;
@@ -150,9 +301,31 @@ private:
     QVBoxLayout* m_groupBoxShaderEditorLayout;
 
 
-    VDTK::VolumeDataHandler m_vdh;
+    Volume m_volume;
+    // set instead of m_volume while the current volume is held compressed, m_volume is empty then
+    std::shared_ptr<const CompressedVolume> m_compressedVolume;
+    VolumeHistogram m_histogram;
+    VolumeBrickRanges m_brickRanges;
+    // slices showing a voxel expression preview instead of the volume in the texture
+    std::vector<VolumeRegion> m_voxelExpressionPreviewRegions;
+    // isosurface of the current volume, empty if none was extracted since the volume changed
+    std::shared_ptr<const TriangleMesh> m_isosurface;
+    // transforms queued from the Tools menu, applied to the current volume on execution
+    OperationGraph m_operationGraph;
+    TimeSeriesPlayer m_timeSeriesPlayer;
+    // recently opened volumes, m_volumeCacheKey is empty once the current volume got modified
+    VolumeCache m_volumeCache;
+    std::string m_volumeCacheKey;
+    // Counts the changes of m_volume. Background tasks read a snapshot of the volume, which is a
+    // cheap copy sharing the voxels, and writers publish a new version instead of modifying the
+    // volume the readers hold.
+    std::atomic<std::uint64_t> m_volumeVersion;
 
     std::atomic<int> readBlockCount;
     std::atomic<int> writeBlockCount;
+
+    // all background work runs here, declared last so running jobs finish before the members
+    // they use get destroyed
+    JobScheduler m_jobScheduler;
 };
 } // namespace VDS
@@ -19,8 +19,15 @@ RayCastRenderer::RayCastRenderer(const QMatrix4x4* const projectionMatrix,
                                  const QMatrix4x4* const viewMatrix)
     : m_projectionMatrix(projectionMatrix), m_viewMatrix(viewMatrix),
       m_noiseTexture(9) {
+    m_activeTimestepTexture = 0;
     m_renderBoundingBox = false;
     m_renderSliceBorders = true;
+    m_renderMesh = true;
+
+    m_vao_mesh = 0;
+    m_vbo_mesh = 0;
+    m_ibo_mesh = 0;
+    m_meshIndexCount = 0;
 
     m_sliceXYposition = 1.0f;
     m_sliceXZposition = 1.0f;
@@ -29,7 +36,11 @@ RayCastRenderer::RayCastRenderer(const QMatrix4x4* const projectionMatrix,
 
 RayCastRenderer::~RayCastRenderer() {}
 void RayCastRenderer::render() {
-    renderVolume();
+    if (m_renderMesh && m_meshIndexCount > 0) {
+        renderMesh();
+    } else {
+        renderVolume();
+    }
 
     if (m_renderBoundingBox) {
         setupVertexArray(RenderModes::Borders);
@@ -62,6 +73,9 @@ bool RayCastRenderer::setup() {
     if (!setupShaderProgramBoundingBox()) {
         return false;
     }
+    if (!setupVertexShaderMesh() || !setupFragmentShaderMesh() || !setupShaderProgramMesh()) {
+        return false;
+    }
     if (!generateRaycastShaderProgram()) {
         return false;
     }
@@ -84,7 +98,7 @@ void RayCastRenderer::renderVolume() {
 
     // Bind volume data
     glActiveTexture(GLenum(TextureUnits::VolumeData));
-    glBindTexture(GL_TEXTURE_3D, m_texture.getTextureHandle());
+    glBindTexture(GL_TEXTURE_3D, getTextureHandle());
     // Bind noise texture
     glActiveTexture(GLenum(TextureUnits::JitterNoise));
     glBindTexture(GL_TEXTURE_2D, m_noiseTexture.getTextureHandle());
@@ -104,25 +118,46 @@ void RayCastRenderer::renderVolume() {
     glUseProgram(0);
 }
 void RayCastRenderer::renderMesh() {
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-
-    glUseProgram(m_shaderProgramBoundingBox);
+    // Mesh positions are in voxels times spacing with the first voxel center at the origin. The
+    // cube of the volume box spans [-1, 1] with the voxel centers half a voxel inside.
+    QMatrix4x4 meshToCubeMatrix;
+    const std::array<std::size_t, 3> size = {m_texture.getSizeX(), m_texture.getSizeY(),
+                                             m_texture.getSizeZ()};
+    const std::array<float, 3> spacing = {m_texture.getSpacingX(), m_texture.getSpacingY(),
+                                          m_texture.getSpacingZ()};
+    meshToCubeMatrix.translate(1.0f / static_cast<float>(size[0]) - 1.0f,
+                               1.0f / static_cast<float>(size[1]) - 1.0f,
+                               1.0f / static_cast<float>(size[2]) - 1.0f);
+    meshToCubeMatrix.scale(2.0f / (static_cast<float>(size[0]) * spacing[0]),
+                           2.0f / (static_cast<float>(size[1]) * spacing[1]),
+                           2.0f / (static_cast<float>(size[2]) * spacing[2]));
+
+    const QMatrix4x4 viewModelMatrix = *m_viewMatrix * getModelMatrix() * meshToCubeMatrix;
+    const QMatrix4x4 projectionViewModelMatrix = *m_projectionMatrix * viewModelMatrix;
+    const QMatrix3x3 normalMatrix = viewModelMatrix.normalMatrix();
+
+    // the surface may be open at the volume borders, so its back faces are visible as well
+    glDisable(GL_CULL_FACE);
+
+    glUseProgram(m_shaderProgramMesh);
+
+    glUniformMatrix4fv(glGetUniformLocation(m_shaderProgramMesh, "projectionViewModelMatrix"), 1,
+                       GL_FALSE, projectionViewModelMatrix.data());
+    glUniformMatrix3fv(glGetUniformLocation(m_shaderProgramMesh, "normalMatrix"), 1, GL_FALSE,
+                       normalMatrix.data());
 
     // Bind vertex data
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo_cube_elements);
-    glBindVertexArray(m_vao_cube_vertices);
+    glBindVertexArray(m_vao_mesh);
 
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, m_meshIndexCount, GL_UNSIGNED_INT, 0);
 
     // Unbind vertex data
     glBindVertexArray(0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     // unbind shader programm
     glUseProgram(0);
 
-    // reset ploygon mode
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glEnable(GL_CULL_FACE);
 }
 void RayCastRenderer::renderVolumeBorders() {
     // Always draw lines on top of everything
@@ -269,10 +304,16 @@ void RayCastRenderer::scale(float factor) {
     m_scaleMatrix.scale(factor);
     applyMatrices();
 }
-void RayCastRenderer::updateVolumeData(const std::array<std::size_t, 3> size,
-                                       const std::array<float, 3> spacing,
-                                       const std::vector<uint16_t>& volumeData) {
-    m_texture.update(size, spacing, volumeData);
+void RayCastRenderer::updateVolumeData(const Volume& volume) {
+    m_texture.update(volume);
+    applyVolumeTexture();
+}
+void RayCastRenderer::updateVolumeData(const CompressedVolume& volume) {
+    m_texture.update(volume);
+    applyVolumeTexture();
+}
+void RayCastRenderer::applyVolumeTexture() {
+    updateValueRangeMapping(m_texture.getValueRangeMapping());
 
     // update texture for shader program
     glUseProgram(m_shaderProgramRayCasting);
@@ -290,6 +331,84 @@ void RayCastRenderer::updateVolumeData(const std::array<std::size_t, 3> size,
     // Resize volume box
     scaleVolumeAndNormalizeSize();
 }
+void RayCastRenderer::updateVolumeRegion(const Volume& regionData, const VolumeRegion& region) {
+    m_texture.updateRegion(regionData, region);
+}
+void RayCastRenderer::setupTimestepTextures(std::size_t count) {
+    m_timestepTextures.clear();
+    m_activeTimestepTexture = count;
+
+    const std::array<std::size_t, 3> textureSize = {1, 1, 1};
+    const std::array<float, 3> textureSpacing = {m_texture.getSpacingX(), m_texture.getSpacingY(),
+                                                 m_texture.getSpacingZ()};
+    for (std::size_t textureSlot = 0; textureSlot < count; textureSlot++) {
+        m_timestepTextures.push_back(std::make_unique<VolumeData3DTexture>());
+        m_timestepTextures.back()->setup(textureSize, textureSpacing);
+    }
+}
+void RayCastRenderer::uploadTimestep(const Volume& volume, std::size_t textureSlot) {
+    if (textureSlot < m_timestepTextures.size()) {
+        m_timestepTextures[textureSlot]->update(volume);
+    }
+}
+void RayCastRenderer::showTimestep(std::size_t textureSlot) {
+    if (textureSlot < m_timestepTextures.size()) {
+        m_activeTimestepTexture = textureSlot;
+    }
+}
+void RayCastRenderer::updateMesh(const TriangleMesh& mesh) {
+    if (mesh.isEmpty()) {
+        glDeleteVertexArrays(1, &m_vao_mesh);
+        glDeleteBuffers(1, &m_vbo_mesh);
+        glDeleteBuffers(1, &m_ibo_mesh);
+        m_vao_mesh = 0;
+        m_vbo_mesh = 0;
+        m_ibo_mesh = 0;
+        m_meshIndexCount = 0;
+        return;
+    }
+
+    if (m_vao_mesh == 0) {
+        glGenVertexArrays(1, &m_vao_mesh);
+        glGenBuffers(1, &m_vbo_mesh);
+        glGenBuffers(1, &m_ibo_mesh);
+    }
+
+    // position and normal interleaved per vertex
+    std::vector<GLfloat> vertices(mesh.positions.size() * 6);
+    for (std::size_t vertex = 0; vertex < mesh.positions.size(); vertex++) {
+        std::copy(mesh.positions[vertex].begin(), mesh.positions[vertex].end(),
+                  vertices.begin() + vertex * 6);
+        std::copy(mesh.normals[vertex].begin(), mesh.normals[vertex].end(),
+                  vertices.begin() + vertex * 6 + 3);
+    }
+
+    glBindVertexArray(m_vao_mesh);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo_mesh);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(),
+                 GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo_mesh);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(GLuint),
+                 mesh.indices.data(), GL_STATIC_DRAW);
+
+    // set the vertex attributes pointers
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat),
+                          (void*)(3 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(1);
+
+    // unbind, the element buffer stays bound to the vertex array
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    m_meshIndexCount = static_cast<GLsizei>(mesh.indices.size());
+}
+void RayCastRenderer::setMeshRenderStatus(bool active) {
+    m_renderMesh = active;
+}
 void RayCastRenderer::updateAspectRation(float ratio) {
     m_settings.aspectRationOpenGLWindow = ratio;
 
@@ -380,6 +499,19 @@ void RayCastRenderer::updateValueWindowOffset(float windowOffset) {
     glUseProgram(0);
 }
 
+void RayCastRenderer::updateValueRangeMapping(const ValueRangeMapping& mapping) {
+    m_settings.valueRangeMapping = mapping;
+
+    glUseProgram(m_shaderProgramRayCasting);
+
+    const GLuint scalePosition = glGetUniformLocation(m_shaderProgramRayCasting, "valueRangeScale");
+    glUniform1f(scalePosition, m_settings.valueRangeMapping.scale);
+    const GLuint offsetPosition =
+        glGetUniformLocation(m_shaderProgramRayCasting, "valueRangeOffset");
+    glUniform1f(offsetPosition, m_settings.valueRangeMapping.offset);
+
+    glUseProgram(0);
+}
 void RayCastRenderer::setRayCastMethod(int method) {
     m_settings.method = static_cast<RayCastMethods>(method);
     generateRaycastShaderProgram();
@@ -435,6 +567,9 @@ void RayCastRenderer::setSliceYZPosition(float position) {
     m_sliceYZposition = position;
 }
 GLuint RayCastRenderer::getTextureHandle() const {
+    if (m_activeTimestepTexture < m_timestepTextures.size()) {
+        return m_timestepTextures[m_activeTimestepTexture]->getTextureHandle();
+    }
     return m_texture.getTextureHandle();
 }
 void RayCastRenderer::updateFieldOfView() {
@@ -663,6 +798,7 @@ void RayCastRenderer::updateShaderUniforms() {
     updateValueWindowWidth(m_settings.windowSettings.valueWindowWidth);
     updateValueWindowCenter(m_settings.windowSettings.valueWindowCenter);
     updateValueWindowOffset(m_settings.windowSettings.valueWindowOffset);
+    updateValueRangeMapping(m_settings.valueRangeMapping);
     updateSampleStepLength(m_settings.sampleStepLength);
     updateCameraPosition();
 }
@@ -726,6 +862,72 @@ bool RayCastRenderer::setupShaderProgramBoundingBox() {
     return checkShaderProgramLinkStatus(m_shaderProgramBoundingBox);
 }
 
+bool RayCastRenderer::setupVertexShaderMesh() {
+    const GLchar* const vertexShaderSource =
+        "#version 430 core \n"
+
+        "layout(location = 0) in vec3 inPos; \n"
+        "layout(location = 1) in vec3 inNormal; \n"
+        "uniform mat4 projectionViewModelMatrix; \n"
+        "uniform mat3 normalMatrix; \n"
+        "out vec3 normal; \n"
+
+        "void main() \n"
+        "{ \n"
+        "	gl_Position = projectionViewModelMatrix * vec4(inPos, 1.0f); \n"
+        "	normal = normalMatrix * inNormal; \n"
+        "} \n";
+
+    m_vertexShaderMesh = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(m_vertexShaderMesh, 1, &vertexShaderSource, NULL);
+    glCompileShader(m_vertexShaderMesh);
+
+    bool compileStatus = checkShaderCompileStatus(m_vertexShaderMesh);
+
+    if (!compileStatus) {
+        qDebug() << vertexShaderSource;
+    }
+
+    return compileStatus;
+}
+
+bool RayCastRenderer::setupFragmentShaderMesh() {
+    // headlight shading, front and back faces are lit the same
+    const GLchar* const fragmentShaderSource =
+        "#version 430 core \n"
+
+        "in vec3 normal; \n"
+        "out vec4 FragColor; \n"
+
+        "void main() \n"
+        "{ \n"
+        "	const float diffuse = abs(normalize(normal).z); \n"
+        "	FragColor = vec4(vec3(0.9f, 0.85f, 0.75f) * (0.15f + 0.85f * diffuse), 1.0f); \n"
+        "} \n";
+
+    m_fragmentShaderMesh = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(m_fragmentShaderMesh, 1, &fragmentShaderSource, NULL);
+    glCompileShader(m_fragmentShaderMesh);
+
+    bool compileStatus = checkShaderCompileStatus(m_fragmentShaderMesh);
+
+    if (!compileStatus) {
+        qDebug() << fragmentShaderSource;
+    }
+
+    return compileStatus;
+}
+
+bool RayCastRenderer::setupShaderProgramMesh() {
+    m_shaderProgramMesh = glCreateProgram();
+
+    glAttachShader(m_shaderProgramMesh, m_vertexShaderMesh);
+    glAttachShader(m_shaderProgramMesh, m_fragmentShaderMesh);
+    glLinkProgram(m_shaderProgramMesh);
+
+    return checkShaderProgramLinkStatus(m_shaderProgramMesh);
+}
+
 void RayCastRenderer::setAxisAlignedBoundingBox(const std::array<float, 3>& extent) {
     glUseProgram(m_shaderProgramRayCasting);
 
@@ -7,6 +7,9 @@
 #include <QOpenGLVertexArrayObject>
 
 #include <array>
+#include <memory>
+#include <vector>
+#include "common/triangle_mesh.h"
 #include "shader/shader_generator.h"
 #include "textures/noise_texture_2D.h"
 #include "textures/volume_data_3D_texture.h"
@@ -41,8 +44,22 @@ public:
     void scale(float factor);
     void resetModelMatrix();
 
-    void updateVolumeData(const std::array<std::size_t, 3> size, const std::array<float, 3> spacing,
-                          const std::vector<uint16_t>& volumeData);
+    void updateVolumeData(const Volume& volume);
+    void updateVolumeData(const CompressedVolume& volume);
+    // partial texture update for in-place edits, keeps the model matrix and the volume box
+    void updateVolumeRegion(const Volume& regionData, const VolumeRegion& region);
+
+    // Ring of textures for time series playback, all with the geometry of the current volume data.
+    // Showing a timestep only changes the texture that gets bound, count = 0 releases the ring and
+    // shows the volume data texture again.
+    void setupTimestepTextures(std::size_t count);
+    void uploadTimestep(const Volume& volume, std::size_t textureSlot);
+    void showTimestep(std::size_t textureSlot);
+
+    // Isosurface mesh of the current volume data, positions as in TriangleMesh. While a mesh is
+    // shown it is rendered instead of ray casting the volume. An empty mesh releases the buffers.
+    void updateMesh(const TriangleMesh& mesh);
+    void setMeshRenderStatus(bool active);
 
     // TODO: Dont need a function for that. get the data from projection matrix on projection matrix
     // update
@@ -58,6 +75,7 @@ public:
     void updateValueWindowWidth(float windowWidth);
     void updateValueWindowCenter(float windowCenter);
     void updateValueWindowOffset(float windowOffset);
+    void updateValueRangeMapping(const ValueRangeMapping& mapping);
 
     void setRayCastMethod(int method);
 
@@ -101,12 +119,18 @@ private:
     bool setupFragmentShaderBoundingBox();
     bool setupShaderProgramBoundingBox();
 
+    bool setupVertexShaderMesh();
+    bool setupFragmentShaderMesh();
+    bool setupShaderProgramMesh();
+
     void setAxisAlignedBoundingBox(const std::array<float, 3>& extent);
 
     bool checkShaderCompileStatus(GLuint shader);
     bool checkShaderProgramLinkStatus(GLuint shaderProgram);
 
     void scaleVolumeAndNormalizeSize();
+    // binds the freshly uploaded volume data texture and fits the volume box to it
+    void applyVolumeTexture();
 
     void updateFieldOfView();
     void updateNoise();
@@ -129,6 +153,14 @@ private:
     GLuint m_vertexShaderBoundingBox;
     GLuint m_fragmentShaderBoundingBox;
     GLuint m_shaderProgramBoundingBox;
+    // mesh buffer and shader handles
+    GLuint m_vao_mesh;
+    GLuint m_vbo_mesh;
+    GLuint m_ibo_mesh;
+    GLsizei m_meshIndexCount;
+    GLuint m_vertexShaderMesh;
+    GLuint m_fragmentShaderMesh;
+    GLuint m_shaderProgramMesh;
 
     // Matrices
     const QMatrix4x4* const m_projectionMatrix;
@@ -139,6 +171,8 @@ private:
 
     // stores the volume data
     VolumeData3DTexture m_texture;
+    std::vector<std::unique_ptr<VolumeData3DTexture>> m_timestepTextures;
+    std::size_t m_activeTimestepTexture;
 
     // stores random jitter noise
     NoiseTexture2D m_noiseTexture;
@@ -147,6 +181,7 @@ private:
 
     bool m_renderBoundingBox;
     bool m_renderSliceBorders;
+    bool m_renderMesh;
 
     // slice positions (between 0.0f and 2.0f)
     float m_sliceXYposition;
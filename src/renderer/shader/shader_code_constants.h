@@ -34,6 +34,9 @@ static const std::string fragmentBaseSlice2D = glslVersion.first +
                                                "uniform float valueWindowCenter; \n"
                                                "uniform float valueWindowOffset; \n"
 
+                                               "uniform float valueRangeScale; \n"
+                                               "uniform float valueRangeOffset; \n"
+
                                                "out vec4 FragColor; \n"
 
                                                "{{ applyWindowFunction }} \n"
@@ -85,6 +88,9 @@ static const std::string fragmentBaseRaycasting =
     "uniform float valueWindowCenter; \n"
     "uniform float valueWindowOffset; \n"
 
+    "uniform float valueRangeScale; \n"
+    "uniform float valueRangeOffset; \n"
+
     "out vec4 fragColor; \n"
     "out float gl_FragDepth; \n"
 
@@ -306,10 +312,13 @@ static const std::pair<std::string, std::string> applyWindowFunctionSigmoid =
                    "} \n");
 
 static const std::pair<std::string, std::string> accessVoxelWithoutWindow =
-    std::make_pair("{{ accessVoxel }}", "texture(dataTex, position).r");
+    std::make_pair("{{ accessVoxel }}",
+                   "texture(dataTex, position).r * valueRangeScale + valueRangeOffset");
 
 static const std::pair<std::string, std::string> accessVoxelWithWindow =
-    std::make_pair("{{ accessVoxel }}", "applyWindow(texture(dataTex, position).r)");
+    std::make_pair("{{ accessVoxel }}",
+                   "applyWindow(texture(dataTex, position).r * valueRangeScale + "
+                   "valueRangeOffset)");
 
 static const std::pair<std::string, std::string> getGradientOnTheFly = std::make_pair(
     "{{ getGradient }}", "vec3 getGradient(vec3 position) { \n"
@@ -25,9 +25,17 @@ struct ValueWindowSettings {
     float valueWindowOffset = 0.0f;
 };
 
+// Maps texture values to the normalized value range of the volume:
+// value = texture * scale + offset
+struct ValueRangeMapping {
+    float scale = 1.0f;
+    float offset = 0.0f;
+};
+
 struct RaycastShaderSettings {
     RayCastMethods method = RayCastMethods::MIP;
     ValueWindowSettings windowSettings;
+    ValueRangeMapping valueRangeMapping;
 
     float aspectRationOpenGLWindow = 1.0f;
     std::array<float, 2> viewportSize = {100.0f, 100.0f};
@@ -38,6 +46,7 @@ struct RaycastShaderSettings {
 
 struct Slice2DShaderSettings {
     ValueWindowSettings windowSettings;
+    ValueRangeMapping valueRangeMapping;
     VDTK::VolumeAxis axis = VDTK::VolumeAxis::XYAxis;
     VDTK::VolumeSize size = VDTK::VolumeSize{0, 0, 0};
     VDTK::VolumeSpacing spacing = VDTK::VolumeSpacing{1.0, 1.0, 1.0};
@@ -1,10 +1,13 @@
 
 #include "volume_data_3D_texture.h"
 
+#include <algorithm>
+
 namespace VDS {
 VolumeData3DTexture::VolumeData3DTexture() {
     m_size = {1, 1, 1};
     m_spacing = {1.0f, 1.0f, 1.0f};
+    m_voxelType = VoxelType::UInt16;
     m_texture = 0;
 }
 VolumeData3DTexture::~VolumeData3DTexture() {
@@ -12,18 +15,49 @@ VolumeData3DTexture::~VolumeData3DTexture() {
 }
 void VolumeData3DTexture::setup(const std::array<std::size_t, 3> size,
                                 const std::array<float, 3> spacing) {
-    m_size = size;
-    m_spacing = spacing;
-
     // generate dummy data
-    std::vector<uint16_t> dummyData =
-        std::vector<uint16_t>(getSizeX() * getSizeY() * getSizeZ(), UINT16_MAX / 2);
+    Volume dummyVolume(size, spacing, VoxelType::UInt16);
+    std::fill_n(dummyVolume.getData<uint16_t>(), dummyVolume.getVoxelCount(), UINT16_MAX / 2);
 
     initializeOpenGLFunctions();
 
     glGenTextures(1, &m_texture);
 
-    update(m_size, m_spacing, dummyData);
+    update(dummyVolume);
+}
+VoxelType VolumeData3DTexture::getVoxelType() const {
+    return m_voxelType;
+}
+const ValueRangeMapping& VolumeData3DTexture::getValueRangeMapping() const {
+    return m_valueRangeMapping;
+}
+ValueRangeMapping VolumeData3DTexture::computeValueRangeMapping(const Volume& volume) {
+    return computeValueRangeMapping(volume.getVoxelType(), volume.getValueRange());
+}
+ValueRangeMapping VolumeData3DTexture::computeValueRangeMapping(const VoxelType voxelType,
+                                                                const ValueRange& valueRange) {
+    // texture value of the largest voxel value: unsigned normalized formats return value / max,
+    // GL_R16_SNORM returns value / 32767 and floating point formats the value itself
+    float textureUnit = 1.0f;
+    switch (voxelType) {
+    case VoxelType::UInt8:
+        textureUnit = static_cast<float>(UINT8_MAX);
+        break;
+    case VoxelType::UInt16:
+        textureUnit = static_cast<float>(UINT16_MAX);
+        break;
+    case VoxelType::Int16:
+        textureUnit = static_cast<float>(INT16_MAX);
+        break;
+    case VoxelType::Float32:
+    default:
+        textureUnit = 1.0f;
+        break;
+    }
+
+    const float extent = valueRange.maximum - valueRange.minimum;
+
+    return ValueRangeMapping{textureUnit / extent, -valueRange.minimum / extent};
 }
 std::size_t VolumeData3DTexture::getSizeX() const {
     return m_size[0];
@@ -59,28 +93,100 @@ const std::array<float, 3> VolumeData3DTexture::getExtent() const {
 GLuint VolumeData3DTexture::getTextureHandle() const {
     return m_texture;
 }
-void VolumeData3DTexture::update(const std::array<std::size_t, 3> size,
-                                 const std::array<float, 3> spacing,
-                                 const std::vector<uint16_t>& volumeData) {
+void VolumeData3DTexture::update(const Volume& volume) {
+    allocate(volume.getSize(), volume.getSpacing(), volume.getVoxelType(),
+             volume.getValueRange(), volume.getRawData());
+}
+void VolumeData3DTexture::update(const CompressedVolume& volume) {
+    allocate(volume.getSize(), volume.getSpacing(), volume.getVoxelType(),
+             volume.getValueRange(), nullptr);
+
+    // slabs of 64 MiB keep the driver's staging copies small as well
+    const std::size_t slabSliceCount = volume.getSlabSliceCount(std::size_t{64} << 20);
+    Volume slab;
+    for (std::size_t firstSlice = 0; firstSlice < m_size[2]; firstSlice += slabSliceCount) {
+        const std::size_t sliceCount = std::min(slabSliceCount, m_size[2] - firstSlice);
+        if (!volume.readSlab(firstSlice, sliceCount, slab)) {
+            return;
+        }
+        VolumeRegion region;
+        region.offset = {0, 0, firstSlice};
+        region.size = slab.getSize();
+        updateRegion(slab, region);
+    }
+}
+void VolumeData3DTexture::allocate(const std::array<std::size_t, 3>& size,
+                                   const std::array<float, 3>& spacing, const VoxelType voxelType,
+                                   const ValueRange& valueRange, const void* data) {
     m_size = size;
     m_spacing = spacing;
+    m_voxelType = voxelType;
+    m_valueRangeMapping = computeValueRangeMapping(voxelType, valueRange);
+
+    GLint internalFormat = GL_R16;
+    switch (m_voxelType) {
+    case VoxelType::UInt8:
+        internalFormat = GL_R8;
+        break;
+    case VoxelType::Int16:
+        internalFormat = GL_R16_SNORM;
+        break;
+    case VoxelType::Float32:
+        internalFormat = GL_R32F;
+        break;
+    case VoxelType::UInt16:
+    default:
+        break;
+    }
 
     glBindTexture(GL_TEXTURE_3D, m_texture);
 
-    // set pixel alignment to 2 Byte, so support odd volume data pixel sizes with a bit size of 16
-    // bits. Default is often set to 4 bytes, which can result in memory access violations.
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    // set pixel alignment to the voxel size, so support odd volume data pixel sizes. Default is
+    // often set to 4 bytes, which can result in memory access violations.
+    glPixelStorei(GL_UNPACK_ALIGNMENT, static_cast<GLint>(getBytesPerVoxel(m_voxelType)));
 
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_BORDER);
-    glTexImage3D(GL_TEXTURE_3D, 0, GL_R16, static_cast<GLsizei>(getSizeX()),
+    glTexImage3D(GL_TEXTURE_3D, 0, internalFormat, static_cast<GLsizei>(getSizeX()),
                  static_cast<GLsizei>(getSizeY()), static_cast<GLsizei>(getSizeZ()), 0, GL_RED,
-                 GL_UNSIGNED_SHORT, volumeData.data());
+                 getPixelType(m_voxelType), data);
 
     // unbind
     glBindTexture(GL_TEXTURE_3D, 0);
 }
-} // namespace VDS
\ No newline at end of file
+void VolumeData3DTexture::updateRegion(const Volume& regionData, const VolumeRegion& region) {
+    const VolumeRegion clampedRegion = region.clamped(m_size);
+    if (clampedRegion.isEmpty() || regionData.getVoxelType() != m_voxelType ||
+        regionData.getSize() != region.size || clampedRegion.size != region.size) {
+        return;
+    }
+
+    glBindTexture(GL_TEXTURE_3D, m_texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, static_cast<GLint>(getBytesPerVoxel(m_voxelType)));
+
+    glTexSubImage3D(GL_TEXTURE_3D, 0, static_cast<GLint>(region.offset[0]),
+                    static_cast<GLint>(region.offset[1]), static_cast<GLint>(region.offset[2]),
+                    static_cast<GLsizei>(region.size[0]), static_cast<GLsizei>(region.size[1]),
+                    static_cast<GLsizei>(region.size[2]), GL_RED, getPixelType(m_voxelType),
+                    regionData.getRawData());
+
+    // unbind
+    glBindTexture(GL_TEXTURE_3D, 0);
+}
+GLenum VolumeData3DTexture::getPixelType(const VoxelType voxelType) {
+    switch (voxelType) {
+    case VoxelType::UInt8:
+        return GL_UNSIGNED_BYTE;
+    case VoxelType::Int16:
+        return GL_SHORT;
+    case VoxelType::Float32:
+        return GL_FLOAT;
+    case VoxelType::UInt16:
+    default:
+        return GL_UNSIGNED_SHORT;
+    }
+}
+} // namespace VDS
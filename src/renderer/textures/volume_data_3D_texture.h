@@ -5,6 +5,10 @@
 #include <QOpenGLFunctions_4_3_Core>
 #include <stdint.h>
 
+#include "common/compressed_volume.h"
+#include "common/volume.h"
+#include "renderer/shader/shader_settings.h"
+
 namespace VDS {
 class VolumeData3DTexture : protected QOpenGLFunctions_4_3_Core {
 public:
@@ -13,8 +17,23 @@ public:
 
     void setup(const std::array<std::size_t, 3> size, const std::array<float, 3> spacing);
     // need to call setup at least once before the first call of updateVolumeData
-    void update(const std::array<std::size_t, 3> size, const std::array<float, 3> spacing,
-                const std::vector<uint16_t>& volumeData);
+    // The texture format follows the voxel type of the volume (GL_R8, GL_R16, GL_R16_SNORM or
+    // GL_R32F). No conversion pass is done on the CPU, shaders have to map the texture values
+    // with getValueRangeMapping.
+    void update(const Volume& volume);
+    // Allocates the texture and uploads the volume slab by slab, so only one decompressed slab is
+    // held in memory besides the texture.
+    void update(const CompressedVolume& volume);
+    // Uploads the voxels of regionData to region with glTexSubImage3D. regionData has to have the
+    // size of the region and the voxel type of the texture, see Volume::extractRegion.
+    void updateRegion(const Volume& regionData, const VolumeRegion& region);
+
+    VoxelType getVoxelType() const;
+    const ValueRangeMapping& getValueRangeMapping() const;
+
+    static ValueRangeMapping computeValueRangeMapping(const Volume& volume);
+    static ValueRangeMapping computeValueRangeMapping(const VoxelType voxelType,
+                                                      const ValueRange& valueRange);
 
     std::size_t getSizeX() const;
     std::size_t getSizeY() const;
@@ -29,8 +48,16 @@ public:
     GLuint getTextureHandle() const;
 
 private:
+    // (re)allocates the texture for a volume, data may be null to leave the texture uninitialized
+    void allocate(const std::array<std::size_t, 3>& size, const std::array<float, 3>& spacing,
+                  const VoxelType voxelType, const ValueRange& valueRange, const void* data);
+    // pixel transfer type of the voxel type for glTexImage3D and glTexSubImage3D
+    static GLenum getPixelType(const VoxelType voxelType);
+
     std::array<std::size_t, 3> m_size;
     std::array<float, 3> m_spacing;
+    VoxelType m_voxelType;
+    ValueRangeMapping m_valueRangeMapping;
     GLuint m_texture;
 };
 } // namespace VDS
\ No newline at end of file
@@ -0,0 +1,328 @@
+#include "connected_components.h"
+
+#include <QDebug>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <numeric>
+
+namespace VDS {
+namespace {
+// slabs per thread and round, more slabs balance the load better but add merge work
+constexpr std::size_t slabsPerThread = 4;
+
+std::size_t getThreadCount() {
+    return static_cast<std::size_t>(std::max(QThread::idealThreadCount(), 1));
+}
+
+// voxels begin to end - 1 of a row at or above the isovalue
+struct Run {
+    std::uint32_t begin = 0;
+    std::uint32_t end = 0;
+};
+
+struct Slab {
+    std::size_t firstSlice = 0;
+    std::size_t sliceCount = 0;
+    std::vector<Run> runs;
+    // index of the first run per row of the slab and the run count as last entry, rows are
+    // ordered by slice and then by Y
+    std::vector<std::uint32_t> rowRuns;
+    // union-find parent per run, a root is its own parent
+    std::vector<std::uint32_t> parents;
+};
+
+// Path halving keeps the trees flat. Linking the larger to the smaller root makes the root of
+// every component its first run, which the numbering relies on.
+std::uint32_t findRoot(std::vector<std::uint32_t>& parents, std::uint32_t run) {
+    while (parents[run] != run) {
+        parents[run] = parents[parents[run]];
+        run = parents[run];
+    }
+    return run;
+}
+
+void unite(std::vector<std::uint32_t>& parents, const std::uint32_t first,
+           const std::uint32_t second) {
+    const std::uint32_t firstRoot = findRoot(parents, first);
+    const std::uint32_t secondRoot = findRoot(parents, second);
+    if (firstRoot < secondRoot) {
+        parents[secondRoot] = firstRoot;
+    } else if (secondRoot < firstRoot) {
+        parents[firstRoot] = secondRoot;
+    }
+}
+
+// unites the overlapping runs of two rows, both sorted along X, runs are numbered from firstIndex
+// and secondIndex on in parents
+void uniteOverlappingRuns(const Run* first, const std::size_t firstCount,
+                          const std::uint32_t firstIndex, const Run* second,
+                          const std::size_t secondCount, const std::uint32_t secondIndex,
+                          std::vector<std::uint32_t>& parents) {
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < firstCount && j < secondCount) {
+        if (first[i].begin < second[j].end && second[j].begin < first[i].end) {
+            unite(parents, firstIndex + static_cast<std::uint32_t>(i),
+                  secondIndex + static_cast<std::uint32_t>(j));
+        }
+        if (first[i].end < second[j].end) {
+            i++;
+        } else {
+            j++;
+        }
+    }
+}
+
+template <typename T>
+void labelSlab(const Volume& volume, const float isovalue, Slab& slab) {
+    const std::array<std::size_t, 3>& size = volume.getSize();
+    slab.rowRuns.reserve(slab.sliceCount * size[1] + 1);
+    slab.rowRuns.push_back(0);
+
+    for (std::size_t z = slab.firstSlice; z < slab.firstSlice + slab.sliceCount; z++) {
+        for (std::size_t y = 0; y < size[1]; y++) {
+            const T* row = volume.getRow<T>(y, z);
+            std::size_t x = 0;
+            while (x < size[0]) {
+                while (x < size[0] && static_cast<float>(row[x]) < isovalue) {
+                    x++;
+                }
+                const std::size_t begin = x;
+                while (x < size[0] && static_cast<float>(row[x]) >= isovalue) {
+                    x++;
+                }
+                if (x > begin) {
+                    slab.parents.push_back(static_cast<std::uint32_t>(slab.runs.size()));
+                    slab.runs.push_back(
+                        {static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(x)});
+                }
+            }
+            slab.rowRuns.push_back(static_cast<std::uint32_t>(slab.runs.size()));
+
+            // face neighbours in the previous row and the previous slice of the slab
+            const std::size_t rowIndex = (z - slab.firstSlice) * size[1] + y;
+            const auto uniteWithRow = [&slab, rowIndex](const std::size_t otherRow) {
+                const std::uint32_t first = slab.rowRuns[otherRow];
+                const std::uint32_t second = slab.rowRuns[rowIndex];
+                uniteOverlappingRuns(slab.runs.data() + first, slab.rowRuns[otherRow + 1] - first,
+                                     first, slab.runs.data() + second,
+                                     slab.rowRuns[rowIndex + 1] - second, second, slab.parents);
+            };
+            if (y > 0) {
+                uniteWithRow(rowIndex - 1);
+            }
+            if (z > slab.firstSlice) {
+                uniteWithRow(rowIndex - size[1]);
+            }
+        }
+    }
+}
+
+template <typename L>
+void writeLabels(const Slab& slab, const std::array<std::size_t, 3>& size,
+                 const std::vector<std::uint32_t>& runLabels, const std::size_t firstRun,
+                 L* labels) {
+    for (std::size_t row = 0; row + 1 < slab.rowRuns.size(); row++) {
+        L* labelRow = labels + (slab.firstSlice * size[1] + row) * size[0];
+        for (std::uint32_t run = slab.rowRuns[row]; run < slab.rowRuns[row + 1]; run++) {
+            std::fill(labelRow + slab.runs[run].begin, labelRow + slab.runs[run].end,
+                      static_cast<L>(runLabels[firstRun + run]));
+        }
+    }
+}
+} // namespace
+
+ConnectedComponents labelConnectedComponents(const Volume& volume, const float isovalue,
+                                             const ProgressCallback& progress) {
+    const auto start = std::chrono::steady_clock::now();
+    const std::array<std::size_t, 3>& size = volume.getSize();
+    if (volume.isEmpty()) {
+        return ConnectedComponents();
+    }
+
+    const std::size_t threadCount = getThreadCount();
+    const std::size_t slabSliceCount = std::max<std::size_t>(
+        (size[2] + threadCount * slabsPerThread - 1) / (threadCount * slabsPerThread), 1);
+    std::vector<Slab> slabs;
+    for (std::size_t firstSlice = 0; firstSlice < size[2]; firstSlice += slabSliceCount) {
+        slabs.emplace_back();
+        slabs.back().firstSlice = firstSlice;
+        slabs.back().sliceCount = std::min(slabSliceCount, size[2] - firstSlice);
+    }
+
+    // labelling the slabs takes most of the time, the merge passes get the last tenth
+    const bool finished = dispatchVoxelType(volume.getVoxelType(), [&](auto tag) {
+        using T = decltype(tag);
+        std::vector<std::size_t> batch;
+        for (std::size_t first = 0; first < slabs.size(); first += threadCount) {
+            batch.resize(std::min(threadCount, slabs.size() - first));
+            std::iota(batch.begin(), batch.end(), first);
+            QtConcurrent::blockingMap(batch, [&](const std::size_t slab) {
+                labelSlab<T>(volume, isovalue, slabs[slab]);
+            });
+
+            if (progress && !progress(0.9f * static_cast<float>(first + batch.size()) /
+                                      static_cast<float>(slabs.size()))) {
+                return false;
+            }
+        }
+        return true;
+    });
+    if (!finished) {
+        return ConnectedComponents();
+    }
+
+    // runs of all slabs numbered one after another
+    std::vector<std::size_t> firstRuns(slabs.size() + 1, 0);
+    for (std::size_t slab = 0; slab < slabs.size(); slab++) {
+        firstRuns[slab + 1] = firstRuns[slab] + slabs[slab].runs.size();
+    }
+    const std::size_t runCount = firstRuns.back();
+    if (runCount >= std::numeric_limits<std::uint32_t>::max()) {
+        qWarning("Too many runs of voxels above the isovalue to label: %zu", runCount);
+        return ConnectedComponents();
+    }
+
+    std::vector<std::uint32_t> parents(runCount);
+    for (std::size_t slab = 0; slab < slabs.size(); slab++) {
+        const std::uint32_t offset = static_cast<std::uint32_t>(firstRuns[slab]);
+        std::transform(slabs[slab].parents.begin(), slabs[slab].parents.end(),
+                       parents.begin() + offset,
+                       [offset](const std::uint32_t parent) { return parent + offset; });
+        slabs[slab].parents = std::vector<std::uint32_t>();
+    }
+
+    // the last slice of each slab touches the first slice of the next one
+    for (std::size_t slab = 1; slab < slabs.size(); slab++) {
+        const Slab& previous = slabs[slab - 1];
+        const Slab& current = slabs[slab];
+        const std::size_t lastRow = (previous.sliceCount - 1) * size[1];
+        for (std::size_t y = 0; y < size[1]; y++) {
+            const std::uint32_t first = previous.rowRuns[lastRow + y];
+            const std::uint32_t second = current.rowRuns[y];
+            uniteOverlappingRuns(
+                previous.runs.data() + first, previous.rowRuns[lastRow + y + 1] - first,
+                static_cast<std::uint32_t>(firstRuns[slab - 1]) + first,
+                current.runs.data() + second, current.rowRuns[y + 1] - second,
+                static_cast<std::uint32_t>(firstRuns[slab]) + second, parents);
+        }
+    }
+
+    // Roots are the first run of their component and parents point to smaller runs, so a single
+    // pass in run order numbers the components in scan order. The parents become the labels.
+    std::uint32_t componentCount = 0;
+    for (std::size_t run = 0; run < runCount; run++) {
+        parents[run] = parents[run] == run ? ++componentCount : parents[parents[run]];
+    }
+    const std::vector<std::uint32_t>& runLabels = parents;
+    // float labels beyond 2^24 would round to the labels of neighbouring components
+    if (componentCount > (std::uint32_t{1} << 24)) {
+        qWarning("Too many components to label exactly: %u", componentCount);
+        return ConnectedComponents();
+    }
+
+    ConnectedComponents result;
+    result.components.resize(componentCount);
+    std::vector<std::array<std::size_t, 3>> minimum(
+        componentCount, {std::numeric_limits<std::size_t>::max(),
+                         std::numeric_limits<std::size_t>::max(),
+                         std::numeric_limits<std::size_t>::max()});
+    std::vector<std::array<std::size_t, 3>> maximum(componentCount, {0, 0, 0});
+    for (std::size_t slab = 0; slab < slabs.size(); slab++) {
+        const Slab& current = slabs[slab];
+        for (std::size_t row = 0; row + 1 < current.rowRuns.size(); row++) {
+            const std::size_t y = row % size[1];
+            const std::size_t z = current.firstSlice + row / size[1];
+            for (std::uint32_t run = current.rowRuns[row]; run < current.rowRuns[row + 1]; run++) {
+                const std::size_t component = runLabels[firstRuns[slab] + run] - 1;
+                const Run& voxels = current.runs[run];
+                const std::size_t length = voxels.end - voxels.begin;
+
+                ComponentStatistics& statistics = result.components[component];
+                statistics.voxelCount += length;
+                statistics.centroid[0] +=
+                    0.5 * static_cast<double>(voxels.begin + voxels.end - 1) * length;
+                statistics.centroid[1] += static_cast<double>(y * length);
+                statistics.centroid[2] += static_cast<double>(z * length);
+
+                minimum[component] = {std::min<std::size_t>(minimum[component][0], voxels.begin),
+                                      std::min(minimum[component][1], y),
+                                      std::min(minimum[component][2], z)};
+                maximum[component] = {std::max<std::size_t>(maximum[component][0], voxels.end),
+                                      std::max(maximum[component][1], y + 1),
+                                      std::max(maximum[component][2], z + 1)};
+            }
+        }
+    }
+    for (std::size_t component = 0; component < componentCount; component++) {
+        ComponentStatistics& statistics = result.components[component];
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            statistics.centroid[axis] /= static_cast<double>(statistics.voxelCount);
+            statistics.boundingBox.offset[axis] = minimum[component][axis];
+            statistics.boundingBox.size[axis] =
+                maximum[component][axis] - minimum[component][axis];
+        }
+    }
+
+    const VoxelType labelType = componentCount <= std::numeric_limits<std::uint8_t>::max()
+                                    ? VoxelType::UInt8
+                                : componentCount <= std::numeric_limits<std::uint16_t>::max()
+                                    ? VoxelType::UInt16
+                                    : VoxelType::Float32;
+    // background stays 0, the new volume is zero-initialized and not shared
+    result.labels = Volume(size, volume.getSpacing(), labelType);
+    result.labels.setValueRange({0.0f, static_cast<float>(std::max<std::uint32_t>(componentCount,
+                                                                                  1))});
+    dispatchVoxelType(labelType, [&](auto tag) {
+        using L = decltype(tag);
+        L* labels = result.labels.getData<L>();
+        std::vector<std::size_t> indices(slabs.size());
+        std::iota(indices.begin(), indices.end(), 0);
+        QtConcurrent::blockingMap(indices, [&](const std::size_t slab) {
+            writeLabels<L>(slabs[slab], size, runLabels, firstRuns[slab], labels);
+        });
+    });
+
+    if (progress) {
+        progress(1.0f);
+    }
+
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    qInfo("Labelled %u components of %zu voxel runs in %zu voxels in %.1f ms (%.0f MVoxel/s)",
+          componentCount, runCount, volume.getVoxelCount(), seconds * 1000.0,
+          static_cast<double>(volume.getVoxelCount()) / seconds / 1.0e6);
+    return result;
+}
+
+bool exportComponentStatistics(const std::filesystem::path& filePath,
+                               const ConnectedComponents& components,
+                               const std::array<float, 3>& spacing) {
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file(
+        std::fopen(filePath.string().c_str(), "w"), &std::fclose);
+    if (!file) {
+        return false;
+    }
+
+    const double voxelVolume = static_cast<double>(spacing[0]) * spacing[1] * spacing[2];
+    std::fprintf(file.get(), "label,voxels,volume,offset x,offset y,offset z,size x,size y,"
+                             "size z,centroid x,centroid y,centroid z\n");
+    for (std::size_t component = 0; component < components.components.size(); component++) {
+        const ComponentStatistics& statistics = components.components[component];
+        const VolumeRegion& box = statistics.boundingBox;
+        std::fprintf(file.get(), "%zu,%llu,%g,%zu,%zu,%zu,%zu,%zu,%zu,%.2f,%.2f,%.2f\n",
+                     component + 1, static_cast<unsigned long long>(statistics.voxelCount),
+                     static_cast<double>(statistics.voxelCount) * voxelVolume, box.offset[0],
+                     box.offset[1], box.offset[2], box.size[0], box.size[1], box.size[2],
+                     statistics.centroid[0], statistics.centroid[1], statistics.centroid[2]);
+    }
+
+    return std::ferror(file.get()) == 0;
+}
+} // namespace VDS
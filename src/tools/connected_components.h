@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "common/progress_callback.h"
+#include "common/volume.h"
+
+namespace VDS {
+struct ComponentStatistics {
+    std::uint64_t voxelCount = 0;
+    // smallest region containing all voxels of the component
+    VolumeRegion boundingBox;
+    // mean position of its voxels in voxels
+    std::array<double, 3> centroid = {0.0, 0.0, 0.0};
+};
+
+struct ConnectedComponents {
+    // Label per voxel, 0 below the isovalue, otherwise the number of its component starting at 1.
+    // Components are numbered in the order their first voxel appears with X being the fastest
+    // axis. Labels are stored in the smallest voxel type holding all of them, as floats beyond
+    // 65535 components, which are exact up to the supported maximum of 2^24 components.
+    Volume labels;
+    // statistics of component label - 1
+    std::vector<ComponentStatistics> components;
+};
+
+// Components of the voxels at or above isovalue that are connected through their faces. Nodes of
+// the union-find are the runs of such voxels along X, not the voxels, so a row of foreground
+// voxels costs a single node. The volume is split into slabs of slices, each slab finds its runs
+// and unites overlapping runs of neighbouring rows and slices in parallel. A merge pass then only
+// unites the runs of the slices where two slabs meet, and another pass numbers the components,
+// gathers their statistics and writes the labels run by run. progress is called between batches
+// of slabs, an empty label volume is returned if it returns false, if there are 2^32 runs or
+// more or if there are more than 2^24 components.
+ConnectedComponents labelConnectedComponents(const Volume& volume, const float isovalue,
+                                             const ProgressCallback& progress = ProgressCallback());
+
+// Comma separated table with one line per component: label, voxel count, volume in units of
+// spacing cubed, bounding box and centroid in voxels
+bool exportComponentStatistics(const std::filesystem::path& filePath,
+                               const ConnectedComponents& components,
+                               const std::array<float, 3>& spacing);
+} // namespace VDS
@@ -0,0 +1,501 @@
+#include "isosurface.h"
+
+#include <QDebug>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace VDS {
+namespace {
+// bricks per thread between two progress reports
+constexpr std::size_t bricksPerThread = 16;
+constexpr std::uint32_t noVertex = std::numeric_limits<std::uint32_t>::max();
+
+std::size_t getThreadCount() {
+    return static_cast<std::size_t>(std::max(QThread::idealThreadCount(), 1));
+}
+
+// The corners of a cell are numbered x + 2 * y + 4 * z. Edge axis * 4 + i runs along axis, i
+// holds its offsets along the next two axes in bit 0 and bit 1.
+struct CellEdge {
+    std::size_t axis = 0;
+    // offset of its first corner within the cell
+    std::array<std::size_t, 3> offset = {0, 0, 0};
+    std::array<std::uint8_t, 2> corners = {0, 0};
+};
+
+std::array<CellEdge, 12> createCellEdges() {
+    std::array<CellEdge, 12> edges;
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        for (std::size_t i = 0; i < 4; i++) {
+            CellEdge& edge = edges[axis * 4 + i];
+            edge.axis = axis;
+            edge.offset[(axis + 1) % 3] = i & 1;
+            edge.offset[(axis + 2) % 3] = i >> 1;
+            const std::size_t corner = edge.offset[0] | edge.offset[1] << 1 | edge.offset[2] << 2;
+            edge.corners = {static_cast<std::uint8_t>(corner),
+                            static_cast<std::uint8_t>(corner | std::size_t(1) << axis)};
+        }
+    }
+    return edges;
+}
+
+const std::array<CellEdge, 12>& getCellEdges() {
+    static const std::array<CellEdge, 12> edges = createCellEdges();
+    return edges;
+}
+
+// Triangles of each of the 256 inside/outside combinations of the corners, three cell edges per
+// triangle. Instead of the classic hand made table the polygons are derived from the cell faces:
+// on every face the edges where the surface crosses get connected, so the inside corners are on
+// the left seen from outside. A face with two diagonal inside corners is ambiguous, there the
+// inside corners are always cut off separately. Both cells sharing a face see the same corners
+// and connect the same edges, so the surface has no holes. The segments of all faces form closed
+// loops of edges, which are split into triangle fans.
+std::array<std::vector<std::uint8_t>, 256> createCaseTable() {
+    const std::array<CellEdge, 12>& edges = getCellEdges();
+    const auto getEdge = [&edges](const std::size_t first, const std::size_t second) {
+        for (std::size_t edge = 0; edge < edges.size(); edge++) {
+            if ((edges[edge].corners[0] == first && edges[edge].corners[1] == second) ||
+                (edges[edge].corners[0] == second && edges[edge].corners[1] == first)) {
+                return edge;
+            }
+        }
+        return std::size_t(0);
+    };
+    // every edge lies in the faces of the cell at its offsets along the other two axes
+    const auto sharesFace = [&edges](const std::size_t first, const std::size_t second) {
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            if (axis != edges[first].axis && axis != edges[second].axis &&
+                edges[first].offset[axis] == edges[second].offset[axis]) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::array<std::vector<std::uint8_t>, 256> table;
+    for (std::size_t cellCase = 0; cellCase < table.size(); cellCase++) {
+        const auto isInside = [cellCase](const std::size_t corner) {
+            return (cellCase >> corner & 1) != 0;
+        };
+
+        // the edge a loop continues with, per edge the surface crosses
+        std::array<std::size_t, 12> next;
+        next.fill(edges.size());
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            for (std::size_t side = 0; side < 2; side++) {
+                const std::size_t base = side << axis;
+                const std::size_t u = std::size_t(1) << (axis + 1) % 3;
+                const std::size_t v = std::size_t(1) << (axis + 2) % 3;
+                // counter-clockwise seen from outside of the cell
+                std::array<std::size_t, 4> corners = {base, base | u, base | u | v, base | v};
+                if (side == 0) {
+                    std::reverse(corners.begin(), corners.end());
+                }
+
+                for (std::size_t i = 0; i < 4; i++) {
+                    if (!isInside(corners[i]) || isInside(corners[(i + 1) % 4])) {
+                        continue;
+                    }
+                    // the surface leaves the face behind corner i, it entered before the run of
+                    // inside corners ending at i
+                    std::size_t first = i;
+                    while (isInside(corners[(first + 3) % 4])) {
+                        first = (first + 3) % 4;
+                    }
+                    next[getEdge(corners[i], corners[(i + 1) % 4])] =
+                        getEdge(corners[(first + 3) % 4], corners[first]);
+                }
+            }
+        }
+
+        std::array<bool, 12> visited{};
+        for (std::size_t start = 0; start < edges.size(); start++) {
+            if (next[start] == edges.size() || visited[start]) {
+                continue;
+            }
+            std::vector<std::uint8_t> loop;
+            for (std::size_t edge = start; !visited[edge]; edge = next[edge]) {
+                visited[edge] = true;
+                loop.push_back(static_cast<std::uint8_t>(edge));
+            }
+            // A fan diagonal between two edges of the same face would lie within that face,
+            // where the neighbouring cell may have the same diagonal, so the fan starts at an
+            // edge without such diagonals.
+            const std::size_t count = loop.size();
+            std::size_t fanStart = 0;
+            for (std::size_t candidate = 0; candidate < count; candidate++) {
+                bool inFace = false;
+                for (std::size_t i = 2; i + 1 < count; i++) {
+                    inFace |= sharesFace(loop[candidate], loop[(candidate + i) % count]);
+                }
+                if (!inFace) {
+                    fanStart = candidate;
+                    break;
+                }
+            }
+            // the loops run clockwise seen from outside of the inside corners
+            for (std::size_t i = 1; i + 1 < count; i++) {
+                table[cellCase].insert(table[cellCase].end(),
+                                       {loop[fanStart], loop[(fanStart + i + 1) % count],
+                                        loop[(fanStart + i) % count]});
+            }
+        }
+    }
+    return table;
+}
+
+const std::array<std::vector<std::uint8_t>, 256>& getCaseTable() {
+    static const std::array<std::vector<std::uint8_t>, 256> table = createCaseTable();
+    return table;
+}
+
+// mesh of the cells of a single brick, vertex indices are local to the brick
+struct BrickMesh {
+    std::vector<std::array<float, 3>> positions;
+    std::vector<std::array<float, 3>> normals;
+    std::vector<std::uint32_t> indices;
+    // vertices on the faces of the brick, which neighbouring bricks create as well, with the
+    // global key of their edge
+    std::vector<std::pair<std::uint32_t, std::uint64_t>> sharedVertices;
+};
+
+// cells whose first corner lies in the brick, the cells of the last voxel layer would reach out
+// of the volume
+VolumeRegion getBrickCells(const std::array<std::size_t, 3>& brick,
+                           const std::array<std::size_t, 3>& size) {
+    VolumeRegion cells;
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        cells.offset[axis] = brick[axis] * VolumeBrickRanges::brickSize;
+        const std::size_t end = std::min(cells.offset[axis] + VolumeBrickRanges::brickSize,
+                                         size[axis] > 0 ? size[axis] - 1 : 0);
+        cells.size[axis] = end > cells.offset[axis] ? end - cells.offset[axis] : 0;
+    }
+    return cells;
+}
+
+// The cells of a brick reach into the first voxel layer of the next bricks, so their ranges
+// count as well.
+bool crossesIsovalue(const VolumeBrickRanges& brickRanges, const std::array<std::size_t, 3>& brick,
+                     const float isovalue) {
+    const std::array<std::size_t, 3>& brickCount = brickRanges.getBrickCount();
+    ValueRange range{std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()};
+    for (std::size_t z = brick[2]; z < std::min(brick[2] + 2, brickCount[2]); z++) {
+        for (std::size_t y = brick[1]; y < std::min(brick[1] + 2, brickCount[1]); y++) {
+            for (std::size_t x = brick[0]; x < std::min(brick[0] + 2, brickCount[0]); x++) {
+                const ValueRange& brickRange = brickRanges.getBrickRange(x, y, z);
+                range.minimum = std::min(range.minimum, brickRange.minimum);
+                range.maximum = std::max(range.maximum, brickRange.maximum);
+            }
+        }
+    }
+    return range.minimum < isovalue && range.maximum >= isovalue;
+}
+
+template <typename T>
+class BrickMesher {
+public:
+    BrickMesher(const Volume& volume, const float isovalue)
+        : m_data(volume.getData<T>()), m_size(volume.getSize()), m_spacing(volume.getSpacing()),
+          m_isovalue(isovalue) {}
+
+    BrickMesh extract(const VolumeRegion& cells) const {
+        const std::array<CellEdge, 12>& edges = getCellEdges();
+        const std::array<std::vector<std::uint8_t>, 256>& caseTable = getCaseTable();
+
+        BrickMesh mesh;
+        // Vertices of the edges along X and Y per slice of corners, below and above the current
+        // layer of cells, and of the edges along Z within the layer. Each edge gets its vertex
+        // once, however many cells share it.
+        const std::size_t rowLength = cells.size[0] + 1;
+        const std::size_t sliceLength = rowLength * (cells.size[1] + 1);
+        std::array<std::vector<std::uint32_t>, 2> sliceVertices = {
+            std::vector<std::uint32_t>(sliceLength * 2, noVertex),
+            std::vector<std::uint32_t>(sliceLength * 2, noVertex)};
+        std::vector<std::uint32_t> layerVertices(sliceLength, noVertex);
+
+        for (std::size_t z = 0; z < cells.size[2]; z++) {
+            for (std::size_t y = 0; y < cells.size[1]; y++) {
+                for (std::size_t x = 0; x < cells.size[0]; x++) {
+                    const std::array<std::size_t, 3> cell = {
+                        cells.offset[0] + x, cells.offset[1] + y, cells.offset[2] + z};
+
+                    std::array<float, 8> values;
+                    std::size_t cellCase = 0;
+                    for (std::size_t corner = 0; corner < 8; corner++) {
+                        values[corner] = getValue(cell[0] + (corner & 1),
+                                                  cell[1] + (corner >> 1 & 1),
+                                                  cell[2] + (corner >> 2));
+                        cellCase |= std::size_t(values[corner] >= m_isovalue) << corner;
+                    }
+                    if (cellCase == 0 || cellCase == 255) {
+                        continue;
+                    }
+
+                    for (const std::uint8_t edgeIndex : caseTable[cellCase]) {
+                        const CellEdge& edge = edges[edgeIndex];
+                        const std::size_t column =
+                            (y + edge.offset[1]) * rowLength + x + edge.offset[0];
+                        std::uint32_t& vertex =
+                            edge.axis == 2 ? layerVertices[column]
+                                           : sliceVertices[edge.offset[2]][column * 2 + edge.axis];
+                        if (vertex == noVertex) {
+                            vertex = static_cast<std::uint32_t>(mesh.positions.size());
+                            addVertex(cells, cell, edge, values, mesh);
+                        }
+                        mesh.indices.push_back(vertex);
+                    }
+                }
+            }
+
+            std::swap(sliceVertices[0], sliceVertices[1]);
+            std::fill(sliceVertices[1].begin(), sliceVertices[1].end(), noVertex);
+            std::fill(layerVertices.begin(), layerVertices.end(), noVertex);
+        }
+        return mesh;
+    }
+
+private:
+    float getValue(const std::size_t x, const std::size_t y, const std::size_t z) const {
+        return static_cast<float>(m_data[(z * m_size[1] + y) * m_size[0] + x]);
+    }
+
+    // central differences, one-sided at the border of the volume
+    std::array<float, 3> getGradient(const std::array<std::size_t, 3>& voxel) const {
+        std::array<float, 3> gradient;
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            std::array<std::size_t, 3> previous = voxel;
+            std::array<std::size_t, 3> next = voxel;
+            previous[axis] = voxel[axis] > 0 ? voxel[axis] - 1 : 0;
+            next[axis] = std::min(voxel[axis] + 1, m_size[axis] - 1);
+            const float distance =
+                static_cast<float>(next[axis] - previous[axis]) * m_spacing[axis];
+            gradient[axis] = distance > 0.0f ? (getValue(next[0], next[1], next[2]) -
+                                                getValue(previous[0], previous[1], previous[2])) /
+                                                   distance
+                                             : 0.0f;
+        }
+        return gradient;
+    }
+
+    void addVertex(const VolumeRegion& cells, const std::array<std::size_t, 3>& cell,
+                   const CellEdge& edge, const std::array<float, 8>& values,
+                   BrickMesh& mesh) const {
+        const float first = values[edge.corners[0]];
+        const float second = values[edge.corners[1]];
+        const float t = (m_isovalue - first) / (second - first);
+
+        std::array<std::size_t, 3> voxel;
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            voxel[axis] = cell[axis] + edge.offset[axis];
+        }
+        std::array<std::size_t, 3> nextVoxel = voxel;
+        nextVoxel[edge.axis]++;
+
+        std::array<float, 3> position;
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            position[axis] = static_cast<float>(voxel[axis]) * m_spacing[axis];
+        }
+        position[edge.axis] += t * m_spacing[edge.axis];
+        mesh.positions.push_back(position);
+
+        // the gradient points to higher values, the normal outwards to lower ones
+        const std::array<float, 3> firstGradient = getGradient(voxel);
+        const std::array<float, 3> secondGradient = getGradient(nextVoxel);
+        std::array<float, 3> normal;
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            normal[axis] =
+                -(firstGradient[axis] + t * (secondGradient[axis] - firstGradient[axis]));
+        }
+        const float length =
+            std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (length > 0.0f) {
+            for (float& component : normal) {
+                component /= length;
+            }
+        } else {
+            normal = {0.0f, 0.0f, 0.0f};
+            normal[edge.axis] = first >= m_isovalue ? 1.0f : -1.0f;
+        }
+        mesh.normals.push_back(normal);
+
+        const std::array<std::size_t, 3> end = cells.getEnd();
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            if (axis != edge.axis &&
+                (voxel[axis] == cells.offset[axis] || voxel[axis] == end[axis])) {
+                const std::uint64_t key =
+                    ((static_cast<std::uint64_t>(voxel[2]) * m_size[1] + voxel[1]) * m_size[0] +
+                     voxel[0]) * 3 + edge.axis;
+                mesh.sharedVertices.emplace_back(
+                    static_cast<std::uint32_t>(mesh.positions.size() - 1), key);
+                break;
+            }
+        }
+    }
+
+    const T* m_data;
+    const std::array<std::size_t, 3> m_size;
+    const std::array<float, 3> m_spacing;
+    const float m_isovalue;
+};
+
+// appends the brick meshes, vertices on brick faces are welded by the key of their edge
+TriangleMesh mergeBrickMeshes(const std::vector<BrickMesh>& brickMeshes) {
+    TriangleMesh mesh;
+    std::unordered_map<std::uint64_t, std::uint32_t> sharedVertices;
+    std::vector<std::uint32_t> vertices;
+    for (const BrickMesh& brickMesh : brickMeshes) {
+        vertices.assign(brickMesh.positions.size(), noVertex);
+        for (const auto& [vertex, key] : brickMesh.sharedVertices) {
+            const auto found = sharedVertices.find(key);
+            if (found != sharedVertices.end()) {
+                vertices[vertex] = found->second;
+            }
+        }
+        for (std::size_t vertex = 0; vertex < vertices.size(); vertex++) {
+            if (vertices[vertex] == noVertex) {
+                vertices[vertex] = static_cast<std::uint32_t>(mesh.positions.size());
+                mesh.positions.push_back(brickMesh.positions[vertex]);
+                mesh.normals.push_back(brickMesh.normals[vertex]);
+            }
+        }
+        for (const auto& [vertex, key] : brickMesh.sharedVertices) {
+            sharedVertices.emplace(key, vertices[vertex]);
+        }
+        for (const std::uint32_t index : brickMesh.indices) {
+            mesh.indices.push_back(vertices[index]);
+        }
+    }
+    return mesh;
+}
+} // namespace
+
+TriangleMesh extractIsosurface(const Volume& volume, const VolumeBrickRanges& brickRanges,
+                               const float isovalue, const ProgressCallback& progress) {
+    const auto start = std::chrono::steady_clock::now();
+
+    const std::array<std::size_t, 3>& brickCount = brickRanges.getBrickCount();
+    if (volume.isEmpty() ||
+        brickCount != VolumeBrickRanges::computeBrickCount(volume.getSize())) {
+        return TriangleMesh();
+    }
+
+    // only the bricks the surface may pass through are meshed
+    std::vector<std::size_t> bricks;
+    const std::size_t totalBrickCount = brickCount[0] * brickCount[1] * brickCount[2];
+    for (std::size_t brick = 0; brick < totalBrickCount; brick++) {
+        const std::array<std::size_t, 3> position = {brick % brickCount[0],
+                                                     brick / brickCount[0] % brickCount[1],
+                                                     brick / brickCount[0] / brickCount[1]};
+        if (!getBrickCells(position, volume.getSize()).isEmpty() &&
+            crossesIsovalue(brickRanges, position, isovalue)) {
+            bricks.push_back(brick);
+        }
+    }
+
+    std::vector<BrickMesh> brickMeshes(bricks.size());
+    const bool finished = dispatchVoxelType(volume.getVoxelType(), [&](auto tag) {
+        using T = decltype(tag);
+        const BrickMesher<T> mesher(volume, isovalue);
+
+        const std::size_t batchSize = getThreadCount() * bricksPerThread;
+        std::vector<std::size_t> batch;
+        for (std::size_t first = 0; first < bricks.size(); first += batchSize) {
+            batch.resize(std::min(batchSize, bricks.size() - first));
+            std::iota(batch.begin(), batch.end(), first);
+            QtConcurrent::blockingMap(batch, [&](const std::size_t index) {
+                const std::size_t brick = bricks[index];
+                const std::array<std::size_t, 3> position = {
+                    brick % brickCount[0], brick / brickCount[0] % brickCount[1],
+                    brick / brickCount[0] / brickCount[1]};
+                brickMeshes[index] = mesher.extract(getBrickCells(position, volume.getSize()));
+            });
+
+            if (progress && !progress(static_cast<float>(first + batch.size()) /
+                                      static_cast<float>(bricks.size()))) {
+                return false;
+            }
+        }
+        return true;
+    });
+    if (!finished) {
+        return TriangleMesh();
+    }
+
+    TriangleMesh mesh = mergeBrickMeshes(brickMeshes);
+
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    qInfo("Isosurface at %g: %zu triangles, %zu vertices from %zu of %zu bricks in %.1f ms",
+          static_cast<double>(isovalue), mesh.getTriangleCount(), mesh.positions.size(),
+          bricks.size(), totalBrickCount, seconds * 1000.0);
+    return mesh;
+}
+
+TriangleMesh decimateMesh(const TriangleMesh& mesh, const std::array<float, 3>& cellSize) {
+    // cell coordinates of 21 bits per axis, positions are not negative
+    const auto getCellKey = [&cellSize](const std::array<float, 3>& position) {
+        std::uint64_t key = 0;
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            const std::uint64_t cell = static_cast<std::uint64_t>(
+                std::max(std::floor(position[axis] / cellSize[axis]), 0.0f));
+            key |= std::min<std::uint64_t>(cell, (1 << 21) - 1) << (axis * 21);
+        }
+        return key;
+    };
+
+    TriangleMesh result;
+    std::unordered_map<std::uint64_t, std::uint32_t> clusters;
+    std::vector<std::uint32_t> clusterOfVertex(mesh.positions.size());
+    std::vector<std::uint32_t> clusterSize;
+    for (std::size_t vertex = 0; vertex < mesh.positions.size(); vertex++) {
+        const auto [cluster, inserted] = clusters.emplace(
+            getCellKey(mesh.positions[vertex]), static_cast<std::uint32_t>(clusterSize.size()));
+        if (inserted) {
+            result.positions.push_back({0.0f, 0.0f, 0.0f});
+            result.normals.push_back({0.0f, 0.0f, 0.0f});
+            clusterSize.push_back(0);
+        }
+        const std::uint32_t index = cluster->second;
+        clusterOfVertex[vertex] = index;
+        clusterSize[index]++;
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            result.positions[index][axis] += mesh.positions[vertex][axis];
+            result.normals[index][axis] += mesh.normals[vertex][axis];
+        }
+    }
+
+    for (std::size_t cluster = 0; cluster < clusterSize.size(); cluster++) {
+        std::array<float, 3>& normal = result.normals[cluster];
+        const float length =
+            std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            result.positions[cluster][axis] /= static_cast<float>(clusterSize[cluster]);
+            normal[axis] = length > 0.0f ? normal[axis] / length : 0.0f;
+        }
+    }
+
+    for (std::size_t index = 0; index + 2 < mesh.indices.size(); index += 3) {
+        const std::uint32_t first = clusterOfVertex[mesh.indices[index]];
+        const std::uint32_t second = clusterOfVertex[mesh.indices[index + 1]];
+        const std::uint32_t third = clusterOfVertex[mesh.indices[index + 2]];
+        if (first != second && second != third && third != first) {
+            result.indices.insert(result.indices.end(), {first, second, third});
+        }
+    }
+
+    qInfo("Decimated mesh from %zu to %zu triangles", mesh.getTriangleCount(),
+          result.getTriangleCount());
+    return result;
+}
+} // namespace VDS
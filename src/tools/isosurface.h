@@ -0,0 +1,27 @@
+#pragma once
+
+#include <array>
+
+#include "common/progress_callback.h"
+#include "common/triangle_mesh.h"
+#include "common/volume.h"
+#include "common/volume_brick_ranges.h"
+
+namespace VDS {
+// Isosurface between voxels below isovalue and voxels at or above it, the surface the FirstHit
+// ray casting shows at the same threshold. Marching cubes runs in parallel over the bricks of
+// brickRanges, bricks whose value range, including the first voxel layer of their neighbours,
+// lies completely on one side of isovalue produce no triangles and are skipped without reading
+// their voxels. Vertices on the same voxel edge are welded, within a brick by edge caches of two
+// slices and across bricks by a lookup of the vertices on brick faces only. Normals are the
+// interpolated voxel gradients. progress is called between batches of bricks, an empty mesh is
+// returned if it returns false.
+TriangleMesh extractIsosurface(const Volume& volume, const VolumeBrickRanges& brickRanges,
+                               const float isovalue,
+                               const ProgressCallback& progress = ProgressCallback());
+
+// Vertex clustering, all vertices within a cell of cellSize get merged into their mean and
+// triangles that collapsed are dropped. Cheap and fast, but without any quality guarantees, the
+// result may have edges shared by more than two triangles.
+TriangleMesh decimateMesh(const TriangleMesh& mesh, const std::array<float, 3>& cellSize);
+} // namespace VDS
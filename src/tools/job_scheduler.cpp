@@ -0,0 +1,203 @@
+#include "job_scheduler.h"
+
+#include <QDebug>
+#include <QStringList>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+
+namespace VDS {
+namespace {
+constexpr int statusUpdateIntervalInMilliseconds = 250;
+} // namespace
+
+JobContext::JobContext() : m_canceled{false}, m_progress{-1.0f} {}
+
+bool JobContext::isCanceled() const {
+    return m_canceled;
+}
+
+void JobContext::cancel() {
+    m_canceled = true;
+}
+
+float JobContext::getProgress() const {
+    return m_progress;
+}
+
+void JobContext::setProgress(const float progress) {
+    m_progress = std::clamp(progress, 0.0f, 1.0f);
+}
+
+ProgressCallback JobContext::getProgressCallback() {
+    return [this](const float progress) {
+        setProgress(progress);
+        return !isCanceled();
+    };
+}
+
+JobScheduler::JobScheduler(int workerCount, QObject* parent) : QObject(parent), m_nextId{0} {
+    m_threadPool.setMaxThreadCount(std::max(workerCount, 1));
+
+    m_statusTimer.setInterval(statusUpdateIntervalInMilliseconds);
+    connect(&m_statusTimer, &QTimer::timeout, this, &JobScheduler::updateStatus);
+}
+
+JobScheduler::~JobScheduler() {
+    cancelAll();
+    m_threadPool.waitForDone();
+}
+
+std::uint64_t JobScheduler::submit(const QString& name, const JobPriority priority, Job job,
+                                   const std::string& coalescingKey) {
+    std::uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!coalescingKey.empty()) {
+            m_pendingJobs.erase(std::remove_if(m_pendingJobs.begin(), m_pendingJobs.end(),
+                                               [&](const JobEntry& entry) {
+                                                   return entry.coalescingKey == coalescingKey;
+                                               }),
+                                m_pendingJobs.end());
+            for (const JobEntry& entry : m_runningJobs) {
+                if (entry.coalescingKey == coalescingKey) {
+                    entry.context->cancel();
+                }
+            }
+        }
+
+        id = ++m_nextId;
+        m_pendingJobs.push_back(JobEntry{id, name, priority, coalescingKey, std::move(job),
+                                         std::make_shared<JobContext>()});
+    }
+
+    // workers beyond the maximum thread count wait in the queue of the pool, workers that find no
+    // job to start return right away
+    m_threadPool.start([this]() { runJobs(); });
+
+    // the timer belongs to the UI thread
+    QMetaObject::invokeMethod(
+        this,
+        [this]() {
+            if (!m_statusTimer.isActive()) {
+                m_statusTimer.start();
+            }
+            updateStatus();
+        },
+        Qt::QueuedConnection);
+
+    return id;
+}
+
+void JobScheduler::cancel(const std::uint64_t id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pendingJobs.erase(std::remove_if(m_pendingJobs.begin(), m_pendingJobs.end(),
+                                       [&](const JobEntry& entry) { return entry.id == id; }),
+                        m_pendingJobs.end());
+    for (const JobEntry& entry : m_runningJobs) {
+        if (entry.id == id) {
+            entry.context->cancel();
+        }
+    }
+}
+
+void JobScheduler::cancelAll() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pendingJobs.clear();
+    for (const JobEntry& entry : m_runningJobs) {
+        entry.context->cancel();
+    }
+}
+
+std::size_t JobScheduler::getJobCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pendingJobs.size() + m_runningJobs.size();
+}
+
+void JobScheduler::runJobs() {
+    JobEntry entry;
+    while (takeNextJob(entry)) {
+        // the worker has to survive, e.g. std::bad_alloc while allocating a large result
+        bool failed = true;
+        QString failure;
+        try {
+            entry.job(*entry.context);
+            failed = false;
+        } catch (const std::exception& exception) {
+            failure = QString::fromLocal8Bit(exception.what());
+        } catch (...) {
+            failure = QString("unknown exception");
+        }
+        if (failed) {
+            qWarning("Job \"%s\" failed: %s", qUtf8Printable(entry.name),
+                     qUtf8Printable(failure));
+            emit(jobFailed(entry.name, failure));
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_runningJobs.erase(std::remove_if(m_runningJobs.begin(), m_runningJobs.end(),
+                                           [&](const JobEntry& running) {
+                                               return running.id == entry.id;
+                                           }),
+                            m_runningJobs.end());
+    }
+}
+
+bool JobScheduler::takeNextJob(JobEntry& entry) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // a job waits while the job it superseded is still running
+    const auto isBlocked = [&](const JobEntry& pending) {
+        return !pending.coalescingKey.empty() &&
+               std::any_of(m_runningJobs.begin(), m_runningJobs.end(),
+                           [&](const JobEntry& running) {
+                               return running.coalescingKey == pending.coalescingKey;
+                           });
+    };
+
+    auto next = m_pendingJobs.end();
+    for (auto it = m_pendingJobs.begin(); it != m_pendingJobs.end(); ++it) {
+        // pending jobs are in submission order, so the first one of the highest priority wins
+        if (!isBlocked(*it) && (next == m_pendingJobs.end() || it->priority > next->priority)) {
+            next = it;
+        }
+    }
+    if (next == m_pendingJobs.end()) {
+        return false;
+    }
+
+    entry = std::move(*next);
+    m_pendingJobs.erase(next);
+    m_runningJobs.push_back(JobEntry{entry.id, entry.name, entry.priority, entry.coalescingKey,
+                                     Job(), entry.context});
+    return true;
+}
+
+void JobScheduler::updateStatus() {
+    QStringList jobs;
+    std::size_t pendingCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const JobEntry& entry : m_runningJobs) {
+            const float progress = entry.context->getProgress();
+            jobs.append(progress < 0.0f ? entry.name
+                                        : QString("%1 %2%").arg(entry.name).arg(static_cast<int>(
+                                              std::floor(progress * 100.0f))));
+        }
+        pendingCount = m_pendingJobs.size();
+    }
+    if (pendingCount > 0) {
+        jobs.append(QString("%1 queued").arg(pendingCount));
+    }
+    if (jobs.isEmpty()) {
+        m_statusTimer.stop();
+    }
+
+    const QString status = jobs.join(", ");
+    if (status != m_status) {
+        m_status = status;
+        emit(statusChanged(m_status));
+    }
+}
+} // namespace VDS
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/progress_callback.h"
+
+namespace VDS {
+// Pending jobs of a higher priority are started first
+enum class JobPriority { Export = 0, Import = 1, Interactive = 2 };
+
+// Cancellation flag and progress of a job, shared between the job and the scheduler.
+// Cancellation is cooperative, the job has to poll isCanceled or use the progress callback.
+class JobContext {
+public:
+    JobContext();
+
+    bool isCanceled() const;
+    void cancel();
+
+    // progress in [0, 1], negative while the job does not report any
+    float getProgress() const;
+    void setProgress(const float progress);
+    // for operations taking a ProgressCallback, fails them once the job got canceled
+    ProgressCallback getProgressCallback();
+
+private:
+    std::atomic<bool> m_canceled;
+    std::atomic<float> m_progress;
+};
+
+// Runs background jobs on a bounded number of worker threads. Pending jobs are started by priority
+// and in submission order within the same priority. Jobs with the same coalescing key supersede
+// each other: submitting one drops the pending job with that key and cancels the running one, and
+// it does not start before the canceled job returned, so results arrive in submission order.
+// Running and pending jobs are summarized for the status bar.
+class JobScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    using Job = std::function<void(JobContext& context)>;
+
+    // Jobs use all cores on their own for the heavy lifting, so only a few run side by side
+    static constexpr int defaultWorkerCount = 2;
+
+    explicit JobScheduler(int workerCount = defaultWorkerCount, QObject* parent = nullptr);
+    // cancels all jobs and waits for the running ones to return
+    ~JobScheduler();
+
+    // Queues job and returns its id. Can be called from any thread.
+    std::uint64_t submit(const QString& name, const JobPriority priority, Job job,
+                         const std::string& coalescingKey = std::string());
+    void cancel(const std::uint64_t id);
+    void cancelAll();
+
+    // number of running and pending jobs
+    std::size_t getJobCount() const;
+
+signals:
+    // names and progress of the running jobs, empty once all jobs are done
+    void statusChanged(const QString& status);
+    // a job threw, reason is the message of the exception, emitted from the worker thread
+    void jobFailed(const QString& name, const QString& reason);
+
+private:
+    struct JobEntry {
+        std::uint64_t id = 0;
+        QString name;
+        JobPriority priority = JobPriority::Export;
+        std::string coalescingKey;
+        Job job;
+        std::shared_ptr<JobContext> context;
+    };
+
+    // Runs pending jobs until none of them can be started. A job that throws is reported through
+    // jobFailed and removed like one that returned, so its coalescing key does not stay blocked.
+    void runJobs();
+    bool takeNextJob(JobEntry& entry);
+    void updateStatus();
+
+    mutable std::mutex m_mutex;
+    std::vector<JobEntry> m_pendingJobs;
+    // the job functions of running jobs are owned by the worker running them
+    std::vector<JobEntry> m_runningJobs;
+    std::uint64_t m_nextId;
+
+    QThreadPool m_threadPool;
+    QTimer m_statusTimer;
+    QString m_status;
+};
+} // namespace VDS
@@ -0,0 +1,411 @@
+#include "operation_graph.h"
+
+#include "common/volume_kernels.h"
+
+#include <QDebug>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
+namespace VDS {
+namespace {
+// upper bound of the slabs a stage without a resize hands on at once
+constexpr std::size_t maximumSlabSizeInBytes = std::size_t{64} << 20;
+
+std::string getInterpolationMethodName(const InterpolationMethod method) {
+    switch (method) {
+    case InterpolationMethod::NearestNeighbor:
+        return "Nearest Neighbor";
+    case InterpolationMethod::Cubic:
+        return "Cubic";
+    case InterpolationMethod::Area:
+        return "Area";
+    case InterpolationMethod::Lanczos:
+        return "Lanczos";
+    case InterpolationMethod::Linear:
+    default:
+        return "Linear";
+    }
+}
+
+// A non-pointwise operation, if any, and the pointwise operations following it
+struct Stage {
+    const Operation* producer = nullptr;
+    std::vector<Operation> pointwise;
+};
+
+std::vector<Stage> splitStages(const std::vector<Operation>& operations) {
+    std::vector<Stage> stages(1);
+    for (const Operation& operation : operations) {
+        if (operation.isPointwise()) {
+            stages.back().pointwise.push_back(operation);
+        } else if (stages.back().producer == nullptr && stages.back().pointwise.empty()) {
+            stages.back().producer = &operation;
+        } else {
+            stages.emplace_back();
+            stages.back().producer = &operation;
+        }
+    }
+    return stages;
+}
+
+VolumeFormat applyOperation(VolumeFormat format, const Operation& operation) {
+    switch (operation.type) {
+    case OperationType::Resize:
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            format.spacing[axis] *=
+                static_cast<float>(format.size[axis]) / static_cast<float>(operation.newSize[axis]);
+        }
+        format.size = operation.newSize;
+        break;
+    case OperationType::Reorient:
+        format.size = operation.reorientation.getSize(format.size);
+        format.spacing = operation.reorientation.getSpacing(format.spacing);
+        break;
+    case OperationType::ConvertVoxelType:
+        format.voxelType = operation.voxelType;
+        format.valueRange = dispatchVoxelType(
+            operation.voxelType, [](auto tag) { return getVoxelTypeRange<decltype(tag)>(); });
+        break;
+    case OperationType::ValueWindow:
+    default:
+        break;
+    }
+    return format;
+}
+
+// Voxel values normalized to the value range of the volume run through the pointwise operations
+// in order. A conversion rounds to the values representable by its voxel type, so the fused
+// mapping gives the same result as converting in separate passes.
+float applyPointwise(const std::vector<Operation>& operations, float normalized) {
+    for (const Operation& operation : operations) {
+        if (operation.type == OperationType::ValueWindow) {
+            normalized = Kernels::applyWindow(normalized, operation.window);
+        } else if (operation.type == OperationType::ConvertVoxelType) {
+            normalized = dispatchVoxelType(operation.voxelType, [&](auto tag) {
+                using T = decltype(tag);
+                constexpr ValueRange range = getVoxelTypeRange<T>();
+                return Kernels::normalizeVoxel(Kernels::denormalizeVoxel<T>(normalized, range),
+                                               range);
+            });
+        }
+    }
+    return normalized;
+}
+
+// All pointwise operations of a stage as a single mapping from Source to Destination. Integer
+// sources go through a lookup table with one entry per representable value, so the cost per voxel
+// does not depend on the number of fused operations.
+template <typename Source, typename Destination>
+class FusedPointwise {
+public:
+    FusedPointwise(const std::vector<Operation>& operations, const ValueRange& sourceRange,
+                   const ValueRange& destinationRange)
+        : m_operations{operations}, m_sourceRange{sourceRange},
+          m_destinationRange{destinationRange} {
+        if constexpr (std::is_integral_v<Source>) {
+            m_lookupTable.resize(Kernels::getValueCount<Source>());
+            for (std::size_t index = 0; index < m_lookupTable.size(); index++) {
+                m_lookupTable[index] = mapVoxel(static_cast<Source>(
+                    static_cast<int32_t>(index) + std::numeric_limits<Source>::lowest()));
+            }
+        }
+    }
+
+    void apply(const Source* source, Destination* destination, const std::size_t count) const {
+        if constexpr (std::is_same_v<Source, Destination>) {
+            if (m_operations.empty()) {
+                std::copy(source, source + count, destination);
+                return;
+            }
+        }
+        for (std::size_t index = 0; index < count; index++) {
+            if constexpr (std::is_integral_v<Source>) {
+                destination[index] = m_lookupTable[Kernels::getValueIndex(source[index])];
+            } else {
+                destination[index] = mapVoxel(source[index]);
+            }
+        }
+    }
+
+private:
+    Destination mapVoxel(const Source value) const {
+        const float normalized =
+            applyPointwise(m_operations, Kernels::normalizeVoxel(value, m_sourceRange));
+        return Kernels::denormalizeVoxel<Destination>(normalized, m_destinationRange);
+    }
+
+    const std::vector<Operation>& m_operations;
+    ValueRange m_sourceRange;
+    ValueRange m_destinationRange;
+    std::vector<Destination> m_lookupTable;
+};
+
+// reports the end of stage number finishedStages
+bool stageProgressDone(const ProgressCallback& progress, const std::size_t finishedStages,
+                       const std::size_t stageCount) {
+    return !progress ||
+           progress(static_cast<float>(finishedStages) / static_cast<float>(stageCount));
+}
+
+// Runs a single stage on input, the slabs produced by its non-pointwise operation are mapped by
+// the fused pointwise operations and handed on to sink right away
+template <typename Source, typename Destination>
+bool executeStage(const Volume& input, const Stage& stage, const VolumeFormat& output,
+                  const OperationGraph::SlabSink& sink, const ProgressCallback& progress) {
+    VolumeFormat produced = VolumeFormat::of(input);
+    if (stage.producer != nullptr) {
+        produced = applyOperation(produced, *stage.producer);
+    }
+    const FusedPointwise<Source, Destination> pointwise(stage.pointwise, produced.valueRange,
+                                                        output.valueRange);
+
+    Volume slab;
+    const auto emitSlab = [&](const Source* voxels, const std::size_t firstSlice,
+                              const std::size_t sliceCount) {
+        const std::array<std::size_t, 3> slabSize = {output.size[0], output.size[1], sliceCount};
+        if (slab.getSize() != slabSize) {
+            slab = Volume(slabSize, output.spacing, output.voxelType);
+            slab.setValueRange(output.valueRange);
+        }
+
+        // the slab is only shared while the sink holds on to it, which detaches it here
+        Destination* destination = slab.getData<Destination>();
+        const std::size_t sliceVoxelCount = slabSize[0] * slabSize[1];
+        std::vector<std::size_t> slices(sliceCount);
+        std::iota(slices.begin(), slices.end(), 0);
+        QtConcurrent::blockingMap(slices, [&](const std::size_t slice) {
+            pointwise.apply(voxels + slice * sliceVoxelCount,
+                            destination + slice * sliceVoxelCount, sliceVoxelCount);
+        });
+        return sink(slab, firstSlice) &&
+               (!progress || progress(static_cast<float>(firstSlice + sliceCount) /
+                                      static_cast<float>(output.size[2])));
+    };
+
+    // the resize produces its result slice by slice, nothing else of it is kept
+    if (stage.producer != nullptr && stage.producer->type == OperationType::Resize) {
+        return resampleVolumeSlices(input, stage.producer->newSize,
+                                    stage.producer->interpolationMethod,
+                                    [&](const Volume& slice, const std::size_t z) {
+                                        return emitSlab(slice.getData<Source>(), z, 1);
+                                    });
+    }
+
+    // reorienting writes its result in an order unrelated to the slices, so it is the one
+    // producer that needs its complete result
+    const Volume source = stage.producer != nullptr
+                              ? reorientVolume(input, stage.producer->reorientation)
+                              : input;
+    if (source.isEmpty()) {
+        return false;
+    }
+    const std::size_t sliceBytes =
+        std::max<std::size_t>(output.size[0] * output.size[1] * sizeof(Destination), 1);
+    const std::size_t slabSliceCount =
+        std::max<std::size_t>(maximumSlabSizeInBytes / sliceBytes, 1);
+    for (std::size_t firstSlice = 0; firstSlice < output.size[2]; firstSlice += slabSliceCount) {
+        if (!emitSlab(source.getRow<Source>(0, firstSlice), firstSlice,
+                      std::min(slabSliceCount, output.size[2] - firstSlice))) {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+bool Operation::isPointwise() const {
+    return type == OperationType::ValueWindow || type == OperationType::ConvertVoxelType;
+}
+
+std::string Operation::getDescription() const {
+    switch (type) {
+    case OperationType::Resize:
+        return "Resize to " + std::to_string(newSize[0]) + " x " + std::to_string(newSize[1]) +
+               " x " + std::to_string(newSize[2]) + " (" +
+               getInterpolationMethodName(interpolationMethod) + ")";
+    case OperationType::Reorient: {
+        const char axisNames[3] = {'X', 'Y', 'Z'};
+        std::string description = "Reorient to ";
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            description += reorientation.flipped[axis] ? "-" : "";
+            description += axisNames[reorientation.axes[axis]];
+            description += axis < 2 ? " " : "";
+        }
+        return description;
+    }
+    case OperationType::ConvertVoxelType:
+        return "Convert to " + getVoxelTypeName(voxelType);
+    case OperationType::ValueWindow:
+    default: {
+        // in the 16 bit units of the value window controls
+        char description[64];
+        std::snprintf(description, sizeof(description), "Value Window %d / %d",
+                      static_cast<int>(std::lround(window.valueWindowCenter * UINT16_MAX)),
+                      static_cast<int>(std::lround(window.valueWindowWidth * UINT16_MAX)));
+        return description;
+    }
+    }
+}
+
+Operation Operation::resize(const std::array<std::size_t, 3>& newSize,
+                            const InterpolationMethod method) {
+    Operation operation;
+    operation.type = OperationType::Resize;
+    operation.newSize = newSize;
+    operation.interpolationMethod = method;
+    return operation;
+}
+
+Operation Operation::reorient(const Reorientation& reorientation) {
+    Operation operation;
+    operation.type = OperationType::Reorient;
+    operation.reorientation = reorientation;
+    return operation;
+}
+
+Operation Operation::valueWindow(const ValueWindowSettings& window) {
+    Operation operation;
+    operation.type = OperationType::ValueWindow;
+    operation.window = window;
+    operation.window.enabled = true;
+    return operation;
+}
+
+Operation Operation::convertVoxelType(const VoxelType voxelType) {
+    Operation operation;
+    operation.type = OperationType::ConvertVoxelType;
+    operation.voxelType = voxelType;
+    return operation;
+}
+
+VolumeFormat VolumeFormat::of(const Volume& volume) {
+    return VolumeFormat{volume.getSize(), volume.getSpacing(), volume.getVoxelType(),
+                        volume.getValueRange()};
+}
+
+bool OperationGraph::isEmpty() const {
+    return m_operations.empty();
+}
+
+const std::vector<Operation>& OperationGraph::getOperations() const {
+    return m_operations;
+}
+
+void OperationGraph::append(const Operation& operation) {
+    m_operations.push_back(operation);
+}
+
+void OperationGraph::remove(const std::size_t index) {
+    if (index < m_operations.size()) {
+        m_operations.erase(m_operations.begin() + static_cast<std::ptrdiff_t>(index));
+    }
+}
+
+void OperationGraph::moveUp(const std::size_t index) {
+    if (index > 0 && index < m_operations.size()) {
+        std::swap(m_operations[index - 1], m_operations[index]);
+    }
+}
+
+void OperationGraph::clear() {
+    m_operations.clear();
+}
+
+VolumeFormat OperationGraph::getOutputFormat(const VolumeFormat& input) const {
+    VolumeFormat format = input;
+    for (const Operation& operation : m_operations) {
+        format = applyOperation(format, operation);
+    }
+    return format;
+}
+
+std::size_t OperationGraph::getStageCount() const {
+    return splitStages(m_operations).size();
+}
+
+bool OperationGraph::execute(const Volume& volume, const SlabSink& sink,
+                             const ProgressCallback& progress) const {
+    if (volume.isEmpty()) {
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<Stage> stages = splitStages(m_operations);
+    Volume input = volume;
+    for (std::size_t index = 0; index < stages.size(); index++) {
+        const Stage& stage = stages[index];
+        VolumeFormat output = VolumeFormat::of(input);
+        if (stage.producer != nullptr) {
+            output = applyOperation(output, *stage.producer);
+        }
+        for (const Operation& operation : stage.pointwise) {
+            output = applyOperation(output, operation);
+        }
+
+        // only the input of the next non-pointwise operation gets materialised
+        const bool last = index + 1 == stages.size();
+        if (!last && stage.pointwise.empty() && stage.producer != nullptr &&
+            stage.producer->type == OperationType::Reorient) {
+            // the reoriented volume already is that input
+            input = reorientVolume(input, stage.producer->reorientation);
+            if (!stageProgressDone(progress, index + 1, stages.size())) {
+                return false;
+            }
+            continue;
+        }
+        Volume next;
+        if (!last) {
+            next = Volume(output.size, output.spacing, output.voxelType);
+            next.setValueRange(output.valueRange);
+        }
+        const SlabSink stageSink =
+            last ? sink : [&next](const Volume& slab, const std::size_t firstSlice) {
+                next.insertRegion(slab, VolumeRegion{{0, 0, firstSlice}, slab.getSize()});
+                return true;
+            };
+        const ProgressCallback stageProgress = [&](const float stageFraction) {
+            return !progress || progress((static_cast<float>(index) + stageFraction) /
+                                         static_cast<float>(stages.size()));
+        };
+
+        const bool success = dispatchVoxelType(input.getVoxelType(), [&](auto sourceTag) {
+            return dispatchVoxelType(output.voxelType, [&](auto destinationTag) {
+                return executeStage<decltype(sourceTag), decltype(destinationTag)>(
+                    input, stage, output, stageSink, stageProgress);
+            });
+        });
+        if (!success) {
+            return false;
+        }
+        input = std::move(next);
+    }
+
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    qInfo("Executed %zu operations in %zu passes in %.1f ms", m_operations.size(),
+          stages.size(), seconds * 1e3);
+    return true;
+}
+
+Volume OperationGraph::execute(const Volume& volume, const ProgressCallback& progress) const {
+    const VolumeFormat format = getOutputFormat(VolumeFormat::of(volume));
+    Volume result(format.size, format.spacing, format.voxelType);
+    result.setValueRange(format.valueRange);
+
+    const bool success = execute(
+        volume,
+        [&result](const Volume& slab, const std::size_t firstSlice) {
+            result.insertRegion(slab, VolumeRegion{{0, 0, firstSlice}, slab.getSize()});
+            return true;
+        },
+        progress);
+    return success ? result : Volume();
+}
+} // namespace VDS
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "common/progress_callback.h"
+#include "common/volume.h"
+#include "renderer/shader/shader_settings.h"
+#include "tools/volume_reorientation.h"
+#include "tools/volume_resampler.h"
+
+namespace VDS {
+enum class OperationType { Resize, Reorient, ValueWindow, ConvertVoxelType };
+
+// A single queued transform, only the parameters of its type are used
+struct Operation {
+    OperationType type = OperationType::ValueWindow;
+    // Resize
+    std::array<std::size_t, 3> newSize = {1, 1, 1};
+    InterpolationMethod interpolationMethod = InterpolationMethod::Linear;
+    // Reorient
+    Reorientation reorientation;
+    // ValueWindow, applied to the value range of the volume like the export does
+    ValueWindowSettings window;
+    // ConvertVoxelType, maps the value range of the volume to the full range of the new type
+    VoxelType voxelType = VoxelType::UInt8;
+
+    // pointwise operations map every voxel on its own, without looking at its neighbours
+    bool isPointwise() const;
+    // short text for the Tools menu, e.g. "Resize to 256 x 256 x 128 (Cubic)"
+    std::string getDescription() const;
+
+    static Operation resize(const std::array<std::size_t, 3>& newSize,
+                            const InterpolationMethod method);
+    static Operation reorient(const Reorientation& reorientation);
+    static Operation valueWindow(const ValueWindowSettings& window);
+    static Operation convertVoxelType(const VoxelType voxelType);
+};
+
+// Everything about a volume but its voxels
+struct VolumeFormat {
+    std::array<std::size_t, 3> size = {0, 0, 0};
+    std::array<float, 3> spacing = {1.0f, 1.0f, 1.0f};
+    VoxelType voxelType = VoxelType::UInt16;
+    ValueRange valueRange;
+
+    static VolumeFormat of(const Volume& volume);
+};
+
+// Queue of transforms that only run when the graph gets executed. Execution splits the queue into
+// stages at every operation that is not pointwise. The pointwise operations following it are fused
+// into a single per-voxel mapping, a lookup table for integer voxels, and applied to every slab as
+// soon as the non-pointwise operation produced it. The slabs are handed on to the sink right away,
+// so each stage traverses the voxels once and no intermediate volume is created within a stage.
+// Only consecutive non-pointwise operations need the complete result of the previous one, so the
+// volume between them gets materialised.
+class OperationGraph {
+public:
+    // receives the result slab by slab in increasing slice order, false stops the execution
+    using SlabSink = std::function<bool(const Volume& slab, std::size_t firstSlice)>;
+
+    bool isEmpty() const;
+    const std::vector<Operation>& getOperations() const;
+
+    void append(const Operation& operation);
+    void remove(const std::size_t index);
+    // swaps the operation at index with the one before it
+    void moveUp(const std::size_t index);
+    void clear();
+
+    // format of the result for an input volume of the given format
+    VolumeFormat getOutputFormat(const VolumeFormat& input) const;
+    // number of passes over the voxels, one per stage
+    std::size_t getStageCount() const;
+
+    // Streams the result of all operations applied to volume into sink. progress is called per
+    // slab, the execution stops if it returns false.
+    bool execute(const Volume& volume, const SlabSink& sink,
+                 const ProgressCallback& progress = ProgressCallback()) const;
+    // result of all operations as a new volume
+    Volume execute(const Volume& volume,
+                   const ProgressCallback& progress = ProgressCallback()) const;
+
+private:
+    std::vector<Operation> m_operations;
+};
+} // namespace VDS
@@ -2,7 +2,10 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include "resize_volume_data.h"
+#include "volume_resampler.h"
 
+#include <algorithm>
+#include <array>
 #include <limits>
 #include <string>
 
@@ -11,9 +14,10 @@
 namespace VDS {
 
 DialogResizeVolumeData::DialogResizeVolumeData(const QVector3D& size, const QVector3D& spacing,
-                                               const int textureSizeMax,
-                                               QWidget* parent)
-    : QDialog(parent), m_sizeOriginal(size), m_spacingOriginal(spacing) {
+                                               const std::size_t bytesPerVoxel,
+                                               const int textureSizeMax, QWidget* parent)
+    : QDialog(parent), m_sizeOriginal(size), m_spacingOriginal(spacing),
+      m_bytesPerVoxel(bytesPerVoxel) {
     setWindowTitle(QString("Resize Volume Data"));
 
     // disable the context help button
@@ -66,18 +70,38 @@ void DialogResizeVolumeData::onCancelButtonClicked() {
     this->reject();
 }
 void DialogResizeVolumeData::computeTextureSizeOriginal() {
-    m_textureSizeOriginal = static_cast<float>(sizeof(std::uint16_t)) * m_sizeOriginal.x() *
+    m_textureSizeOriginal = static_cast<float>(m_bytesPerVoxel) * m_sizeOriginal.x() *
                             m_sizeOriginal.y() * m_sizeOriginal.z() /
                             static_cast<float>(std::pow(1024, 2));
 }
 void DialogResizeVolumeData::computeTextureSizeNew() {
     m_textureSizeNew =
-        static_cast<float>(sizeof(std::uint16_t)) * m_lineEditMetaDataNewSizeX->text().toFloat() *
+        static_cast<float>(m_bytesPerVoxel) * m_lineEditMetaDataNewSizeX->text().toFloat() *
         m_lineEditMetaDataNewSizeY->text().toFloat() *
         m_lineEditMetaDataNewSizeZ->text().toFloat() / static_cast<float>(std::pow(1024, 2));
 
     m_labelTextureSizeNew->setText(QString("New: ") + QString::number(m_textureSizeNew) + " MB");
 }
+void DialogResizeVolumeData::computeRunTimeEstimate() {
+    const std::array<std::size_t, 3> size = {static_cast<std::size_t>(m_sizeOriginal.x()),
+                                             static_cast<std::size_t>(m_sizeOriginal.y()),
+                                             static_cast<std::size_t>(m_sizeOriginal.z())};
+    const std::array<std::size_t, 3> newSize = {
+        static_cast<std::size_t>(std::max(m_lineEditMetaDataNewSizeX->text().toInt(), 0)),
+        static_cast<std::size_t>(std::max(m_lineEditMetaDataNewSizeY->text().toInt(), 0)),
+        static_cast<std::size_t>(std::max(m_lineEditMetaDataNewSizeZ->text().toInt(), 0))};
+
+    // the combo box items are in the order of InterpolationMethod
+    const double seconds = estimateResampleDuration(
+        size, newSize,
+        static_cast<InterpolationMethod>(m_comboBoxInterpolationMethod->currentIndex()));
+
+    QString runTime = QString::number(seconds, 'f', 1) + " s";
+    if (seconds >= 60.0) {
+        runTime = QString::number(seconds / 60.0, 'f', 1) + " min";
+    }
+    m_labelRunTimeEstimate->setText(QString("Estimated run time: ~") + runTime);
+}
 void DialogResizeVolumeData::updateSpacingX() {
     const float newSizeX = m_lineEditMetaDataNewSizeX->text().toFloat();
     const float scaleFactor = m_sizeOriginal.x() / newSizeX;
@@ -350,15 +374,33 @@ void DialogResizeVolumeData::setupSectionInterpolationMethod() {
     m_comboBoxInterpolationMethod = new QComboBox;
     m_comboBoxInterpolationMethod->addItems({"Fast & Low Quality [Nearest Neighbour]",
                                              "Slow & Medium Quality [Tri-Linear]",
-                                             "Slowest & Best Quality [Tri-Cubic]"});
+                                             "Slowest & Best Quality [Tri-Cubic]",
+                                             "Smooth Downscaling [Area Average]",
+                                             "Sharp & Best Quality [Lanczos]"});
     m_comboBoxInterpolationMethod->setCurrentIndex(1);
 
     m_hLayoutInterpolationMethod = new QHBoxLayout;
     m_hLayoutInterpolationMethod->addWidget(m_labelInterpolationMethod);
     m_hLayoutInterpolationMethod->addWidget(m_comboBoxInterpolationMethod);
 
+    m_labelRunTimeEstimate = new QLabel;
+
+    m_vLayoutInterpolationMethod = new QVBoxLayout;
+    m_vLayoutInterpolationMethod->addLayout(m_hLayoutInterpolationMethod);
+    m_vLayoutInterpolationMethod->addWidget(m_labelRunTimeEstimate);
+
     m_groupInterpolationMethod = new QGroupBox;
-    m_groupInterpolationMethod->setLayout(m_hLayoutInterpolationMethod);
+    m_groupInterpolationMethod->setLayout(m_vLayoutInterpolationMethod);
+
+    connect(m_comboBoxInterpolationMethod, &QComboBox::currentIndexChanged, this,
+            &DialogResizeVolumeData::computeRunTimeEstimate);
+    connect(m_lineEditMetaDataNewSizeX, &QLineEdit::textChanged, this,
+            &DialogResizeVolumeData::computeRunTimeEstimate);
+    connect(m_lineEditMetaDataNewSizeY, &QLineEdit::textChanged, this,
+            &DialogResizeVolumeData::computeRunTimeEstimate);
+    connect(m_lineEditMetaDataNewSizeZ, &QLineEdit::textChanged, this,
+            &DialogResizeVolumeData::computeRunTimeEstimate);
+    computeRunTimeEstimate();
 }
 
 void DialogResizeVolumeData::setupSectionOKAndCancel() {
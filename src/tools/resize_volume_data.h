@@ -18,7 +18,8 @@ class DialogResizeVolumeData : public QDialog {
 
 public:
     DialogResizeVolumeData(const QVector3D& size, const QVector3D& spacing,
-                           const int textureSizeMax, QWidget* parent = 0);
+                           const std::size_t bytesPerVoxel, const int textureSizeMax,
+                           QWidget* parent = 0);
     
     QVector3D getNewSize() const;
     int getInterploationMethod() const;
@@ -28,6 +29,7 @@ public slots:
     void onCancelButtonClicked();
     void computeTextureSizeOriginal();
     void computeTextureSizeNew();
+    void computeRunTimeEstimate();
     void updateSpacingX();
     void updateSpacingY();
     void updateSpacingZ();
@@ -55,6 +57,7 @@ private:
     // Original Meta Data
     const QVector3D m_sizeOriginal;
     const QVector3D m_spacingOriginal;
+    const std::size_t m_bytesPerVoxel;
     QGroupBox* m_metaDataOriginal;
     QGroupBox* m_metaDataOriginalSize;
     QGroupBox* m_metaDataOriginalSpacing;
@@ -104,9 +107,11 @@ private:
 
     // Interpolation Method
     QGroupBox* m_groupInterpolationMethod;
+    QVBoxLayout* m_vLayoutInterpolationMethod;
     QHBoxLayout* m_hLayoutInterpolationMethod;
     QLabel* m_labelInterpolationMethod;
     QComboBox* m_comboBoxInterpolationMethod;
+    QLabel* m_labelRunTimeEstimate;
 
     // Texture Size
     QGroupBox* m_textureSize;
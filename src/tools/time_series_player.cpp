@@ -0,0 +1,354 @@
+#include "time_series_player.h"
+
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+namespace VDS {
+TimeSeriesPlayer::TimeSeriesPlayer(QObject* parent)
+    : QObject(parent), m_prefetchCount{0}, m_currentTimestep{0}, m_stopLoader{false},
+      m_loadingFailed{false}, m_currentShown{false} {
+    m_playbackTimer.setTimerType(Qt::PreciseTimer);
+    setTimestepsPerSecond(defaultTimestepsPerSecond);
+    connect(&m_playbackTimer, &QTimer::timeout, this, &TimeSeriesPlayer::advance);
+}
+
+TimeSeriesPlayer::~TimeSeriesPlayer() {
+    close();
+}
+
+void TimeSeriesPlayer::open(const TimeSeriesIO::TimeSeries& series, const Volume& firstTimestep,
+                            std::size_t prefetchCount) {
+    close();
+    if (series.getTimestepCount() == 0) {
+        return;
+    }
+
+    m_series = series;
+    m_valueRange = firstTimestep.getValueRange();
+    m_prefetchCount = std::min(prefetchCount, series.getTimestepCount() - 1);
+
+    m_ring.resize(getRingSize());
+    m_ring[0] = RingSlot{0, true, firstTimestep};
+    m_currentTimestep = 0;
+    m_currentShown = false;
+    m_stopLoader = false;
+    m_loadingFailed = false;
+
+    m_textureTimesteps.assign(getRingSize(), 0);
+    m_textureValid.assign(getRingSize(), false);
+    emit(setupTimestepTextures(getRingSize()));
+
+    m_loader = QtConcurrent::run([this]() { loadTimesteps(); });
+
+    uploadDecodedTimesteps();
+}
+
+void TimeSeriesPlayer::close() {
+    m_playbackTimer.stop();
+
+    if (m_loader.isRunning()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopLoader = true;
+        }
+        m_loaderCondition.notify_all();
+        m_loader.waitForFinished();
+    }
+
+    if (!isOpen()) {
+        return;
+    }
+
+    m_series = TimeSeriesIO::TimeSeries{};
+    m_ring.clear();
+    m_textureTimesteps.clear();
+    m_textureValid.clear();
+    m_shownTimePoints.clear();
+    m_prefetchCount = 0;
+    m_currentTimestep = 0;
+
+    emit(setupTimestepTextures(0));
+    emit(playbackStateChanged(false));
+}
+
+bool TimeSeriesPlayer::isOpen() const {
+    return m_series.getTimestepCount() > 0;
+}
+
+bool TimeSeriesPlayer::isPlaying() const {
+    return m_playbackTimer.isActive();
+}
+
+std::size_t TimeSeriesPlayer::getTimestepCount() const {
+    return m_series.getTimestepCount();
+}
+
+std::size_t TimeSeriesPlayer::getCurrentTimestep() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_currentTimestep;
+}
+
+std::size_t TimeSeriesPlayer::getRingSize() const {
+    return isOpen() ? m_prefetchCount + 1 : 0;
+}
+
+bool TimeSeriesPlayer::getCurrentVolume(Volume& volume) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const RingSlot* slot = findRingSlot(m_currentTimestep);
+    if (slot == nullptr) {
+        return false;
+    }
+
+    volume = slot->volume;
+    return true;
+}
+
+void TimeSeriesPlayer::play() {
+    if (!isOpen() || isPlaying()) {
+        return;
+    }
+
+    m_shownTimePoints.clear();
+    m_playbackTimer.start();
+    emit(playbackStateChanged(true));
+}
+
+void TimeSeriesPlayer::pause() {
+    if (!isPlaying()) {
+        return;
+    }
+
+    m_playbackTimer.stop();
+    emit(playbackStateChanged(false));
+}
+
+void TimeSeriesPlayer::togglePlayback() {
+    if (isPlaying()) {
+        pause();
+    } else {
+        play();
+    }
+}
+
+void TimeSeriesPlayer::setTimestepsPerSecond(int timestepsPerSecond) {
+    m_playbackTimer.setInterval(1000 / std::max(timestepsPerSecond, 1));
+}
+
+void TimeSeriesPlayer::stepForward() {
+    advance();
+}
+
+void TimeSeriesPlayer::stepBackward() {
+    if (!isOpen()) {
+        return;
+    }
+
+    const std::size_t timestepCount = getTimestepCount();
+    seek((getCurrentTimestep() + timestepCount - 1) % timestepCount);
+}
+
+void TimeSeriesPlayer::seek(std::size_t timestep) {
+    if (!isOpen() || timestep >= getTimestepCount()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_currentTimestep = timestep;
+    }
+    m_currentShown = false;
+    m_loaderCondition.notify_all();
+
+    // shows the timestep right away if it is already on the GPU
+    uploadDecodedTimesteps();
+}
+
+void TimeSeriesPlayer::loadTimesteps() {
+    QThread::currentThread()->setObjectName("Time Series Loader Thread");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopLoader) {
+        std::size_t timestep = 0;
+        std::size_t slot = 0;
+        if (m_loadingFailed || !findTimestepToLoad(timestep) || !findFreeRingSlot(slot)) {
+            m_loaderCondition.wait(lock);
+            continue;
+        }
+
+        // decode without blocking the playback
+        lock.unlock();
+        Volume volume;
+        const bool success = TimeSeriesIO::loadTimestep(m_series, timestep, volume);
+        lock.lock();
+
+        if (!success) {
+            m_loadingFailed = true;
+            emit(loadingFailed());
+            continue;
+        }
+
+        // the window might have moved on while decoding
+        if (!isInWindow(timestep) || findRingSlot(timestep) != nullptr ||
+            !findFreeRingSlot(slot)) {
+            continue;
+        }
+
+        volume.setValueRange(m_valueRange);
+        m_ring[slot] = RingSlot{timestep, true, std::move(volume)};
+
+        QMetaObject::invokeMethod(
+            this, [this]() { uploadDecodedTimesteps(); }, Qt::QueuedConnection);
+    }
+}
+
+void TimeSeriesPlayer::uploadDecodedTimesteps() {
+    if (!isOpen()) {
+        return;
+    }
+
+    {
+        // the loader only replaces ring slots outside of the window, but the lock keeps the
+        // ring consistent while the uploaded volumes are read
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // upload in playback order, so the next timestep is available first
+        for (std::size_t offset = 0; offset <= m_prefetchCount; offset++) {
+            const std::size_t timestep = (m_currentTimestep + offset) % getTimestepCount();
+            const RingSlot* ringSlot = findRingSlot(timestep);
+            if (ringSlot == nullptr || findTextureSlot(timestep) != getRingSize()) {
+                continue;
+            }
+
+            // reuse a texture of a timestep that fell out of the window
+            for (std::size_t textureSlot = 0; textureSlot < getRingSize(); textureSlot++) {
+                if (!m_textureValid[textureSlot] ||
+                    !isInWindow(m_textureTimesteps[textureSlot])) {
+                    emit(uploadTimestep(ringSlot->volume, textureSlot));
+                    m_textureTimesteps[textureSlot] = timestep;
+                    m_textureValid[textureSlot] = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!m_currentShown) {
+        showCurrentTimestep();
+    }
+    reportStatistics();
+}
+
+void TimeSeriesPlayer::advance() {
+    if (!isOpen()) {
+        return;
+    }
+
+    const std::size_t nextTimestep = (getCurrentTimestep() + 1) % getTimestepCount();
+    if (findTextureSlot(nextTimestep) == getRingSize()) {
+        // the loader could not keep up, try again on the next tick
+        reportStatistics();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_currentTimestep = nextTimestep;
+    }
+    m_loaderCondition.notify_all();
+
+    showCurrentTimestep();
+
+    // the texture of the previous timestep is free for the next one now
+    uploadDecodedTimesteps();
+}
+
+void TimeSeriesPlayer::showCurrentTimestep() {
+    const std::size_t currentTimestep = getCurrentTimestep();
+    const std::size_t textureSlot = findTextureSlot(currentTimestep);
+    if (textureSlot == getRingSize()) {
+        return;
+    }
+
+    emit(showTimestep(textureSlot));
+    emit(timestepChanged(currentTimestep, getTimestepCount()));
+    m_currentShown = true;
+
+    m_shownTimePoints.push_back(std::chrono::steady_clock::now());
+}
+
+void TimeSeriesPlayer::reportStatistics() {
+    // count the timesteps shown within the last second
+    const auto now = std::chrono::steady_clock::now();
+    while (!m_shownTimePoints.empty() &&
+           now - m_shownTimePoints.front() > std::chrono::seconds(1)) {
+        m_shownTimePoints.pop_front();
+    }
+    const float timestepsPerSecond =
+        isPlaying() ? static_cast<float>(m_shownTimePoints.size()) : 0.0f;
+
+    std::size_t decodedCount = 0;
+    std::size_t uploadedCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const RingSlot& slot : m_ring) {
+            if (slot.valid && isInWindow(slot.timestep)) {
+                decodedCount++;
+            }
+        }
+        for (std::size_t textureSlot = 0; textureSlot < getRingSize(); textureSlot++) {
+            if (m_textureValid[textureSlot] && isInWindow(m_textureTimesteps[textureSlot])) {
+                uploadedCount++;
+            }
+        }
+    }
+
+    emit(playbackStatistics(timestepsPerSecond, decodedCount, uploadedCount, getRingSize()));
+}
+
+bool TimeSeriesPlayer::isInWindow(std::size_t timestep) const {
+    const std::size_t timestepCount = getTimestepCount();
+    const std::size_t offset = (timestep + timestepCount - m_currentTimestep) % timestepCount;
+    return offset <= m_prefetchCount;
+}
+
+bool TimeSeriesPlayer::findTimestepToLoad(std::size_t& timestep) const {
+    for (std::size_t offset = 0; offset <= m_prefetchCount; offset++) {
+        const std::size_t candidate = (m_currentTimestep + offset) % getTimestepCount();
+        if (findRingSlot(candidate) == nullptr) {
+            timestep = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TimeSeriesPlayer::findFreeRingSlot(std::size_t& slot) const {
+    for (std::size_t index = 0; index < m_ring.size(); index++) {
+        if (!m_ring[index].valid || !isInWindow(m_ring[index].timestep)) {
+            slot = index;
+            return true;
+        }
+    }
+    return false;
+}
+
+const TimeSeriesPlayer::RingSlot* TimeSeriesPlayer::findRingSlot(std::size_t timestep) const {
+    for (const RingSlot& slot : m_ring) {
+        if (slot.valid && slot.timestep == timestep) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+std::size_t TimeSeriesPlayer::findTextureSlot(std::size_t timestep) const {
+    for (std::size_t textureSlot = 0; textureSlot < m_textureTimesteps.size(); textureSlot++) {
+        if (m_textureValid[textureSlot] && m_textureTimesteps[textureSlot] == timestep) {
+            return textureSlot;
+        }
+    }
+    return getRingSize();
+}
+} // namespace VDS
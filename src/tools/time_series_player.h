@@ -0,0 +1,115 @@
+#pragma once
+
+#include <QFuture>
+#include <QObject>
+#include <QTimer>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "common/volume.h"
+#include "fileio/time_series_io.h"
+
+namespace VDS {
+// Plays back a time series of volumes with the same geometry. A loader thread keeps the current
+// and the next timesteps decoded in a RAM ring buffer. Decoded timesteps are handed to the volume
+// view to be uploaded into a ring of GPU textures, so a timestep switch only swaps the texture
+// handle that gets rendered.
+class TimeSeriesPlayer : public QObject {
+    Q_OBJECT
+
+public:
+    // timesteps decoded and uploaded ahead of the current one
+    static constexpr std::size_t defaultPrefetchCount = 8;
+    static constexpr int defaultTimestepsPerSecond = 10;
+
+    explicit TimeSeriesPlayer(QObject* parent = nullptr);
+    ~TimeSeriesPlayer();
+
+    // Starts the loader and shows the first timestep as soon as it is on the GPU. Float volumes
+    // of all timesteps are mapped with the value range of firstTimestep, so the brightness does
+    // not jump between timesteps.
+    void open(const TimeSeriesIO::TimeSeries& series, const Volume& firstTimestep,
+              std::size_t prefetchCount = defaultPrefetchCount);
+    void close();
+
+    bool isOpen() const;
+    bool isPlaying() const;
+    std::size_t getTimestepCount() const;
+    std::size_t getCurrentTimestep() const;
+    // number of slots of the RAM and the GPU ring buffer
+    std::size_t getRingSize() const;
+
+    // copy of the decoded voxels of the current timestep
+    bool getCurrentVolume(Volume& volume) const;
+
+public slots:
+    void play();
+    void pause();
+    void togglePlayback();
+    void setTimestepsPerSecond(int timestepsPerSecond);
+    void stepForward();
+    void stepBackward();
+    void seek(std::size_t timestep);
+
+signals:
+    // Has to be connected with Qt::DirectConnection, since the texture slot counts as uploaded
+    // as soon as the signal returns.
+    void setupTimestepTextures(std::size_t count);
+    void uploadTimestep(const VDS::Volume& volume, std::size_t textureSlot);
+    void showTimestep(std::size_t textureSlot);
+
+    void timestepChanged(std::size_t timestep, std::size_t timestepCount);
+    void playbackStateChanged(bool playing);
+    // sustained playback rate over the last second and fill level of the ring buffers
+    void playbackStatistics(float timestepsPerSecond, std::size_t decodedCount,
+                            std::size_t uploadedCount, std::size_t ringSize);
+    void loadingFailed();
+
+private:
+    struct RingSlot {
+        std::size_t timestep = 0;
+        bool valid = false;
+        Volume volume;
+    };
+
+    void loadTimesteps();
+    void uploadDecodedTimesteps();
+    void advance();
+    void showCurrentTimestep();
+    void reportStatistics();
+
+    // need to hold m_mutex
+    bool isInWindow(std::size_t timestep) const;
+    bool findTimestepToLoad(std::size_t& timestep) const;
+    bool findFreeRingSlot(std::size_t& slot) const;
+    const RingSlot* findRingSlot(std::size_t timestep) const;
+
+    // texture slot holding timestep or getRingSize() if it is not on the GPU
+    std::size_t findTextureSlot(std::size_t timestep) const;
+
+    TimeSeriesIO::TimeSeries m_series;
+    ValueRange m_valueRange;
+    std::size_t m_prefetchCount;
+
+    // shared with the loader thread
+    mutable std::mutex m_mutex;
+    std::condition_variable m_loaderCondition;
+    std::vector<RingSlot> m_ring;
+    std::size_t m_currentTimestep;
+    bool m_stopLoader;
+    bool m_loadingFailed;
+    QFuture<void> m_loader;
+
+    // timestep held by each GPU texture slot, only used on the main thread
+    std::vector<std::size_t> m_textureTimesteps;
+    std::vector<bool> m_textureValid;
+    bool m_currentShown;
+
+    QTimer m_playbackTimer;
+    std::deque<std::chrono::steady_clock::time_point> m_shownTimePoints;
+};
+} // namespace VDS
@@ -0,0 +1,424 @@
+#include "volume_filter.h"
+
+#include "common/bricked_volume.h"
+#include "common/simd_kernels.h"
+
+#include <QDebug>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace VDS {
+namespace {
+// slabs per thread and round, more slabs balance the load better but filter more halo slices
+constexpr std::size_t slabsPerThread = 2;
+// Upper bound of the ring of filtered slices per slab. Large kernels on wide slices split the
+// slabs into tiles of rows, which filter the halo rows along X once more but keep the memory of
+// all slabs in flight bounded.
+constexpr std::size_t ringBytesPerSlab = std::size_t{32} << 20;
+// bricks per thread between two progress reports of the median
+constexpr std::size_t bricksPerThread = 64;
+
+// The median of 27 values is found by sorting 32 wires, the 5 padding wires hold the lowest value
+// twice and the highest value three times, so the median ends up on wire 15.
+constexpr std::size_t medianValueCount = 27;
+constexpr std::size_t medianWireCount = 32;
+constexpr std::size_t medianLowPaddingCount = 2;
+constexpr std::size_t medianWire = medianLowPaddingCount + medianValueCount / 2;
+
+using Comparator = std::pair<std::uint8_t, std::uint8_t>;
+
+std::size_t getThreadCount() {
+    return static_cast<std::size_t>(std::max(QThread::idealThreadCount(), 1));
+}
+
+std::size_t clampIndex(const std::ptrdiff_t index, const std::size_t count) {
+    return static_cast<std::size_t>(
+        std::clamp<std::ptrdiff_t>(index, 0, static_cast<std::ptrdiff_t>(count) - 1));
+}
+
+void logThroughput(const char* filterName, const Volume& volume,
+                   const std::chrono::steady_clock::time_point start) {
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    qInfo("%s filter of %zu voxels in %.1f ms (%.0f MVoxel/s)", filterName,
+          volume.getVoxelCount(), seconds * 1000.0,
+          static_cast<double>(volume.getVoxelCount()) / seconds / 1.0e6);
+}
+
+// normalized taps of a 1D kernel with 2 * radius + 1 taps
+std::vector<float> getGaussianWeights(const float sigma) {
+    if (sigma <= 0.0f) {
+        return {1.0f};
+    }
+
+    const std::size_t radius = static_cast<std::size_t>(std::ceil(3.0f * sigma));
+    std::vector<float> weights(2 * radius + 1);
+    for (std::size_t tap = 0; tap < weights.size(); tap++) {
+        const float distance = static_cast<float>(tap) - static_cast<float>(radius);
+        weights[tap] = std::exp(-distance * distance / (2.0f * sigma * sigma));
+    }
+    const float sum = std::accumulate(weights.begin(), weights.end(), 0.0f);
+    for (float& weight : weights) {
+        weight /= sum;
+    }
+    return weights;
+}
+
+std::vector<float> getBoxWeights(const std::size_t radius) {
+    return std::vector<float>(2 * radius + 1, 1.0f / static_cast<float>(2 * radius + 1));
+}
+
+// rounds half away from zero like std::lround, which is a call the compiler cannot vectorize
+template <typename T>
+T toVoxel(const float value) {
+    if constexpr (std::is_integral_v<T>) {
+        constexpr ValueRange range = getVoxelTypeRange<T>();
+        const float clamped = std::clamp(value, range.minimum, range.maximum);
+        return static_cast<T>(static_cast<int32_t>(clamped + (clamped < 0.0f ? -0.5f : 0.5f)));
+    } else {
+        return value;
+    }
+}
+
+// The row kernels loop over the voxels of a row per tap, so the inner loops are plain multiply
+// adds over contiguous floats, which the compiler vectorizes.
+
+// result[x] = sum of weights[tap] * source[x + tap], source has weights.size() - 1 more values
+void convolveRow(const float* source, float* result, const std::size_t count,
+                 const std::vector<float>& weights) {
+    std::fill(result, result + count, 0.0f);
+    for (std::size_t tap = 0; tap < weights.size(); tap++) {
+        const float weight = weights[tap];
+        const float* shifted = source + tap;
+        for (std::size_t x = 0; x < count; x++) {
+            result[x] += weight * shifted[x];
+        }
+    }
+}
+
+// result[x] = sum of weights[tap] * rows[tap][x]
+void combineRows(const std::vector<const float*>& rows, float* result, const std::size_t count,
+                 const std::vector<float>& weights) {
+    std::fill(result, result + count, 0.0f);
+    for (std::size_t tap = 0; tap < weights.size(); tap++) {
+        const float weight = weights[tap];
+        const float* row = rows[tap];
+        for (std::size_t x = 0; x < count; x++) {
+            result[x] += weight * row[x];
+        }
+    }
+}
+
+// Filters the rowCount rows starting at firstRow of the sliceCount slices starting at firstSlice
+// with weights along every axis into result. The tiles of the slices filtered along X and Y are
+// kept in a ring of one tile per tap, indexed by slice modulo the tap count. The slices the Z
+// kernel of a voxel reaches are consecutive, so they never share a slot, and every slice of the
+// slab and its halo gets filtered only once.
+template <typename T>
+void filterSlab(const Volume& volume, const std::vector<float>& weights,
+                const std::size_t firstSlice, const std::size_t sliceCount,
+                const std::size_t firstRow, const std::size_t rowCount, T* result) {
+    const std::array<std::size_t, 3>& size = volume.getSize();
+    const std::size_t radius = weights.size() / 2;
+    const std::size_t sliceVoxelCount = size[0] * size[1];
+    const std::size_t tileVoxelCount = size[0] * rowCount;
+    // rows the Y kernel of the tile reaches
+    const std::size_t firstHaloRow = firstRow - std::min(firstRow, radius);
+    const std::size_t endHaloRow = std::min(firstRow + rowCount + radius, size[1]);
+
+    std::vector<float> ring(weights.size() * tileVoxelCount);
+    std::vector<std::size_t> ringSlices(weights.size(), std::numeric_limits<std::size_t>::max());
+    std::vector<float> filteredX((endHaloRow - firstHaloRow) * size[0]);
+    std::vector<float> paddedRow(size[0] + 2 * radius);
+    std::vector<float> resultRow(size[0]);
+    std::vector<const float*> rows(weights.size());
+    std::vector<const float*> slices(weights.size());
+
+    const auto filterSliceXY = [&](const std::size_t slice) {
+        float* filtered = ring.data() + (slice % weights.size()) * tileVoxelCount;
+        if (ringSlices[slice % weights.size()] == slice) {
+            return filtered;
+        }
+
+        for (std::size_t y = firstHaloRow; y < endHaloRow; y++) {
+            const T* row = volume.getRow<T>(y, slice);
+            std::fill(paddedRow.begin(), paddedRow.begin() + radius, static_cast<float>(row[0]));
+            std::copy(row, row + size[0], paddedRow.begin() + radius);
+            std::fill(paddedRow.begin() + radius + size[0], paddedRow.end(),
+                      static_cast<float>(row[size[0] - 1]));
+            convolveRow(paddedRow.data(), filteredX.data() + (y - firstHaloRow) * size[0],
+                        size[0], weights);
+        }
+        for (std::size_t y = firstRow; y < firstRow + rowCount; y++) {
+            for (std::size_t tap = 0; tap < weights.size(); tap++) {
+                const std::ptrdiff_t sourceY = static_cast<std::ptrdiff_t>(y + tap) -
+                                               static_cast<std::ptrdiff_t>(radius);
+                rows[tap] =
+                    filteredX.data() + (clampIndex(sourceY, size[1]) - firstHaloRow) * size[0];
+            }
+            combineRows(rows, filtered + (y - firstRow) * size[0], size[0], weights);
+        }
+
+        ringSlices[slice % weights.size()] = slice;
+        return filtered;
+    };
+
+    for (std::size_t z = firstSlice; z < firstSlice + sliceCount; z++) {
+        for (std::size_t tap = 0; tap < weights.size(); tap++) {
+            const std::ptrdiff_t sourceZ =
+                static_cast<std::ptrdiff_t>(z + tap) - static_cast<std::ptrdiff_t>(radius);
+            slices[tap] = filterSliceXY(clampIndex(sourceZ, size[2]));
+        }
+
+        T* resultSlice = result + z * sliceVoxelCount;
+        for (std::size_t y = firstRow; y < firstRow + rowCount; y++) {
+            for (std::size_t tap = 0; tap < weights.size(); tap++) {
+                rows[tap] = slices[tap] + (y - firstRow) * size[0];
+            }
+            combineRows(rows, resultRow.data(), size[0], weights);
+            std::transform(resultRow.begin(), resultRow.end(), resultSlice + y * size[0],
+                           toVoxel<T>);
+        }
+    }
+}
+
+Volume filterSeparable(const Volume& volume, const std::vector<float>& weights,
+                       const ProgressCallback& progress) {
+    Volume result(volume.getSize(), volume.getSpacing(), volume.getVoxelType());
+    // a kernel with positive weights cannot leave the value range
+    result.setValueRange(volume.getValueRange());
+    if (volume.isEmpty()) {
+        return result;
+    }
+
+    // thin slabs would spend most of their time on the halo
+    const std::array<std::size_t, 3>& size = volume.getSize();
+    const std::size_t sliceCount = size[2];
+    const std::size_t threadCount = getThreadCount();
+    const std::size_t slabSliceCount =
+        std::max((sliceCount + threadCount * slabsPerThread - 1) / (threadCount * slabsPerThread),
+                 2 * weights.size());
+    const std::size_t tileRowCount = std::clamp<std::size_t>(
+        ringBytesPerSlab / (weights.size() * size[0] * sizeof(float)), 1, size[1]);
+
+    const bool finished = dispatchVoxelType(volume.getVoxelType(), [&](auto tag) {
+        using T = decltype(tag);
+        // the new volume is not shared, so the slabs can write their slices in parallel
+        T* data = result.getData<T>();
+
+        // first slice and first row of the tiles of all slabs
+        std::vector<std::pair<std::size_t, std::size_t>> slabs;
+        for (std::size_t first = 0; first < sliceCount; first += slabSliceCount) {
+            for (std::size_t firstRow = 0; firstRow < size[1]; firstRow += tileRowCount) {
+                slabs.emplace_back(first, firstRow);
+            }
+        }
+
+        // a round of slabs per thread count, so progress gets reported in between
+        std::vector<std::pair<std::size_t, std::size_t>> round;
+        for (std::size_t index = 0; index < slabs.size(); index += threadCount) {
+            round.assign(slabs.begin() + index,
+                         slabs.begin() + std::min(index + threadCount, slabs.size()));
+            QtConcurrent::blockingMap(round, [&](const std::pair<std::size_t, std::size_t>& slab) {
+                filterSlab<T>(volume, weights, slab.first,
+                              std::min(slabSliceCount, sliceCount - slab.first), slab.second,
+                              std::min(tileRowCount, size[1] - slab.second), data);
+            });
+
+            if (progress && !progress(static_cast<float>(index + round.size()) /
+                                      static_cast<float>(slabs.size()))) {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    return finished ? result : Volume();
+}
+
+// Comparators of Batcher's odd-even merge sort of all wires, reduced to the ones the median wire
+// depends on. Going backwards from the median wire, a comparator matters if it touches a wire
+// that matters. Returned as pairs of wire indices, see Simd::applySortingNetwork.
+std::vector<std::uint8_t> createMedianNetwork() {
+    std::vector<Comparator> comparators;
+    const std::size_t n = medianWireCount;
+    for (std::size_t p = 1; p < n; p *= 2) {
+        for (std::size_t k = p; k >= 1; k /= 2) {
+            for (std::size_t j = k % p; j + k < n; j += 2 * k) {
+                for (std::size_t i = 0; i < std::min(k, n - j - k); i++) {
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                        comparators.emplace_back(static_cast<std::uint8_t>(i + j),
+                                                 static_cast<std::uint8_t>(i + j + k));
+                    }
+                }
+            }
+        }
+    }
+
+    std::array<bool, medianWireCount> matters{};
+    matters[medianWire] = true;
+    std::vector<Comparator> network;
+    for (auto comparator = comparators.rbegin(); comparator != comparators.rend(); comparator++) {
+        if (matters[comparator->first] || matters[comparator->second]) {
+            matters[comparator->first] = true;
+            matters[comparator->second] = true;
+            network.push_back(*comparator);
+        }
+    }
+    std::reverse(network.begin(), network.end());
+
+    std::vector<std::uint8_t> wires;
+    for (const Comparator& comparator : network) {
+        wires.push_back(comparator.first);
+        wires.push_back(comparator.second);
+    }
+    return wires;
+}
+
+// The sorting network runs on 16 bit integers or floats. Unsigned values get mapped to int16_t
+// preserving their order, uint16_t by flipping the sign bit.
+template <typename T>
+using MedianWire = std::conditional_t<std::is_same_v<T, float>, float, std::int16_t>;
+
+template <typename T>
+MedianWire<T> toMedianWire(const T value) {
+    if constexpr (std::is_same_v<T, std::uint16_t>) {
+        return static_cast<std::int16_t>(value ^ 0x8000u);
+    } else {
+        return static_cast<MedianWire<T>>(value);
+    }
+}
+
+template <typename T>
+T fromMedianWire(const MedianWire<T> value) {
+    if constexpr (std::is_same_v<T, std::uint16_t>) {
+        return static_cast<std::uint16_t>(static_cast<std::uint16_t>(value) ^ 0x8000u);
+    } else {
+        return static_cast<T>(value);
+    }
+}
+
+// Median filters a brick together with its halo of one voxel. Each row of the brick puts the 27
+// neighbours of its voxels on separate wires of brickSize values, so every comparator of the
+// network handles the whole row at once.
+template <typename T>
+void medianFilterBrick(const BrickedVolume& bricked, const std::size_t brick,
+                       const std::vector<std::uint8_t>& network, T* result) {
+    using W = MedianWire<T>;
+    constexpr std::size_t brickSize = BrickedVolume::brickSize;
+    constexpr std::size_t blockSize = brickSize + 2;
+    static_assert(brickSize == Kernels::Simd::sortingNetworkLaneCount);
+
+    const VolumeRegion region = bricked.getBrickRegion(brick);
+    const std::array<std::size_t, 3>& size = bricked.getSize();
+
+    std::vector<T> block(blockSize * blockSize * blockSize);
+    bricked.readBlock<T>({static_cast<std::ptrdiff_t>(region.offset[0]) - 1,
+                          static_cast<std::ptrdiff_t>(region.offset[1]) - 1,
+                          static_cast<std::ptrdiff_t>(region.offset[2]) - 1},
+                         {blockSize, blockSize, blockSize}, block.data());
+
+    alignas(64) W wires[medianWireCount][brickSize];
+    for (std::size_t z = 0; z < region.size[2]; z++) {
+        for (std::size_t y = 0; y < region.size[1]; y++) {
+            // the network sorts in place, so the padding wires need to be restored every row
+            for (std::size_t wire = medianValueCount; wire < medianWireCount; wire++) {
+                const bool low = wire < medianValueCount + medianLowPaddingCount;
+                std::fill(wires[wire], wires[wire] + brickSize,
+                          low ? std::numeric_limits<W>::lowest() : std::numeric_limits<W>::max());
+            }
+            std::size_t wire = 0;
+            for (std::size_t dz = 0; dz < 3; dz++) {
+                for (std::size_t dy = 0; dy < 3; dy++) {
+                    const T* row = block.data() + ((z + dz) * blockSize + y + dy) * blockSize;
+                    for (std::size_t dx = 0; dx < 3; dx++) {
+                        std::transform(row + dx, row + dx + brickSize, wires[wire++],
+                                       toMedianWire<T>);
+                    }
+                }
+            }
+
+            Kernels::Simd::applySortingNetwork(wires[0], network.data(), network.size() / 2);
+
+            const std::size_t offset =
+                ((region.offset[2] + z) * size[1] + region.offset[1] + y) * size[0] +
+                region.offset[0];
+            std::transform(wires[medianWire], wires[medianWire] + region.size[0],
+                           result + offset, fromMedianWire<T>);
+        }
+    }
+}
+} // namespace
+
+Volume gaussianFilterVolume(const Volume& volume, const float sigma,
+                            const ProgressCallback& progress) {
+    const auto start = std::chrono::steady_clock::now();
+    Volume result = filterSeparable(volume, getGaussianWeights(sigma), progress);
+    if (!result.isEmpty()) {
+        logThroughput("Gaussian", volume, start);
+    }
+    return result;
+}
+
+Volume boxFilterVolume(const Volume& volume, const std::size_t radius,
+                       const ProgressCallback& progress) {
+    const auto start = std::chrono::steady_clock::now();
+    Volume result = filterSeparable(volume, getBoxWeights(radius), progress);
+    if (!result.isEmpty()) {
+        logThroughput("Box", volume, start);
+    }
+    return result;
+}
+
+Volume medianFilterVolume(const Volume& volume, const ProgressCallback& progress) {
+    const auto start = std::chrono::steady_clock::now();
+    Volume result(volume.getSize(), volume.getSpacing(), volume.getVoxelType());
+    result.setValueRange(volume.getValueRange());
+    if (volume.isEmpty()) {
+        return result;
+    }
+
+    static const std::vector<std::uint8_t> network = createMedianNetwork();
+    const BrickedVolume bricked(volume);
+
+    const bool finished = dispatchVoxelType(volume.getVoxelType(), [&](auto tag) {
+        using T = decltype(tag);
+        // the new volume is not shared, so the bricks can write their rows in parallel
+        T* data = result.getData<T>();
+
+        const std::size_t brickCount = bricked.getTotalBrickCount();
+        const std::size_t batchSize = getThreadCount() * bricksPerThread;
+        std::vector<std::size_t> bricks;
+        for (std::size_t first = 0; first < brickCount; first += batchSize) {
+            bricks.resize(std::min(batchSize, brickCount - first));
+            std::iota(bricks.begin(), bricks.end(), first);
+            QtConcurrent::blockingMap(bricks, [&](const std::size_t brick) {
+                medianFilterBrick<T>(bricked, brick, network, data);
+            });
+
+            if (progress && !progress(static_cast<float>(first + bricks.size()) /
+                                      static_cast<float>(brickCount))) {
+                return false;
+            }
+        }
+        return true;
+    });
+    if (!finished) {
+        return Volume();
+    }
+
+    logThroughput("Median", volume, start);
+    return result;
+}
+} // namespace VDS
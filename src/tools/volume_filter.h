@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+
+#include "common/progress_callback.h"
+#include "common/volume.h"
+
+namespace VDS {
+enum class FilterType { Gaussian, Box, Median };
+
+// Denoising filters returning a new volume of the same size and voxel type. Voxels outside of the
+// volume repeat the nearest border voxel. progress is called between batches of slabs or bricks,
+// an empty volume is returned if it returns false.
+//
+// The Gaussian and box filters are separable and run as three passes of 1D kernels along X, Y and
+// Z. The volume is split into slabs of slices which are processed in parallel, each slab reads
+// the halo of slices its kernel reaches into from its neighbours and keeps the slices filtered
+// along X and Y in a ring, so every voxel is read from and written to the volume only once. Slabs
+// of large kernels on wide slices are split into tiles of rows to bound the memory of the ring.
+// Intermediate results are floats, integer results get rounded.
+
+// standard deviation sigma in voxels, the kernel reaches to 3 sigma
+Volume gaussianFilterVolume(const Volume& volume, const float sigma,
+                            const ProgressCallback& progress = ProgressCallback());
+// mean of the cube of (2 * radius + 1)^3 voxels
+Volume boxFilterVolume(const Volume& volume, const std::size_t radius,
+                       const ProgressCallback& progress = ProgressCallback());
+// Median of the 3x3x3 neighbourhood. The volume is processed brick by brick in parallel, see
+// BrickedVolume::readBlock, and 16 voxels of a row at once go through a sorting network of SIMD
+// minimum and maximum operations.
+Volume medianFilterVolume(const Volume& volume,
+                          const ProgressCallback& progress = ProgressCallback());
+} // namespace VDS
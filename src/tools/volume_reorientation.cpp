@@ -0,0 +1,207 @@
+#include "volume_reorientation.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace VDS {
+namespace {
+// Tiles span tileWidth voxels along destination X and as many voxels along the source rows as fit
+// into tileSizeInBytes. Long runs along the source rows amortize the cache and TLB misses of
+// jumping between source rows, while the tile buffer stays in the L1 cache.
+constexpr std::size_t tileWidth = 32;
+constexpr std::size_t tileSizeInBytes = std::size_t{16} << 10;
+// Whole volumes are reoriented in slabs of source slices of about this size, so a job can be
+// canceled between them.
+constexpr std::size_t slabSizeInBytes = std::size_t{64} << 20;
+
+template <typename T>
+void reorientSlabTyped(const T* slab, const std::array<std::size_t, 3>& sourceSize,
+                       const std::size_t firstSlice, const std::size_t sliceCount,
+                       const Reorientation& reorientation, Volume& destination) {
+    const std::array<std::ptrdiff_t, 3> sourceStrides = {
+        1, static_cast<std::ptrdiff_t>(sourceSize[0]),
+        static_cast<std::ptrdiff_t>(sourceSize[0] * sourceSize[1])};
+
+    // part of the destination covered by the slab and the step through the slab per destination
+    // axis
+    VolumeRegion region{{0, 0, 0}, destination.getSize()};
+    std::array<std::ptrdiff_t, 3> steps{};
+    std::ptrdiff_t origin = 0;
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        const std::size_t sourceAxis = reorientation.axes[axis];
+        const bool flipped = reorientation.flipped[axis];
+        if (sourceAxis == 2) {
+            region.offset[axis] = flipped ? sourceSize[2] - firstSlice - sliceCount : firstSlice;
+            region.size[axis] = sliceCount;
+        }
+
+        // slab coordinate of the first voxel of the region along this axis
+        std::size_t sourceCoordinate =
+            flipped ? sourceSize[sourceAxis] - 1 - region.offset[axis] : region.offset[axis];
+        if (sourceAxis == 2) {
+            sourceCoordinate -= firstSlice;
+        }
+        origin += static_cast<std::ptrdiff_t>(sourceCoordinate) * sourceStrides[sourceAxis];
+        steps[axis] = flipped ? -sourceStrides[sourceAxis] : sourceStrides[sourceAxis];
+    }
+
+    const auto getSource = [&](std::size_t x, std::size_t y, std::size_t z) {
+        return slab + origin + static_cast<std::ptrdiff_t>(x) * steps[0] +
+               static_cast<std::ptrdiff_t>(y) * steps[1] +
+               static_cast<std::ptrdiff_t>(z) * steps[2];
+    };
+    // a shared destination is detached here once, the tasks only compute row pointers
+    T* const destinationData = destination.getData<T>();
+    const std::array<std::size_t, 3> destinationSize = destination.getSize();
+    const auto getDestination = [&](std::size_t y, std::size_t z) {
+        return destinationData +
+               ((region.offset[2] + z) * destinationSize[1] + region.offset[1] + y) *
+                   destinationSize[0] +
+               region.offset[0];
+    };
+
+    if (reorientation.axes[0] == 0) {
+        // rows stay rows, only their order and direction change
+        std::vector<std::size_t> rows(region.size[1] * region.size[2]);
+        std::iota(rows.begin(), rows.end(), 0);
+        QtConcurrent::blockingMap(rows, [&](const std::size_t row) {
+            const std::size_t y = row % region.size[1];
+            const std::size_t z = row / region.size[1];
+            const T* source = getSource(0, y, z);
+            T* target = getDestination(y, z);
+            if (steps[0] > 0) {
+                std::memcpy(target, source, region.size[0] * sizeof(T));
+            } else {
+                std::reverse_copy(source - (region.size[0] - 1), source + 1, target);
+            }
+        });
+        return;
+    }
+
+    // The source rows end up along destination axis inner, so the copy is tiled in the plane of
+    // destination X and inner. Each tile is gathered with sequential reads of source rows into a
+    // local buffer and scattered from there with sequential writes of destination rows. Going
+    // through the buffer avoids the cache set conflicts of reading a tile column with a power of
+    // two stride. Each task copies a strip of tiles along X.
+    const std::size_t inner = reorientation.axes[1] == 0 ? 1 : 2;
+    const std::size_t outer = 3 - inner;
+    constexpr std::size_t tileDepth = tileSizeInBytes / (tileWidth * sizeof(T));
+    const std::size_t stripCount = (region.size[inner] + tileDepth - 1) / tileDepth;
+    std::vector<std::size_t> strips(region.size[outer] * stripCount);
+    std::iota(strips.begin(), strips.end(), 0);
+    QtConcurrent::blockingMap(strips, [&](const std::size_t strip) {
+        const std::size_t outerIndex = strip / stripCount;
+        const std::size_t innerBegin = (strip % stripCount) * tileDepth;
+        const std::size_t innerEnd = std::min(innerBegin + tileDepth, region.size[inner]);
+
+        const auto getY = [&](std::size_t innerIndex) {
+            return inner == 1 ? innerIndex : outerIndex;
+        };
+        const auto getZ = [&](std::size_t innerIndex) {
+            return inner == 1 ? outerIndex : innerIndex;
+        };
+
+        std::array<T, tileWidth * tileDepth> tile;
+        for (std::size_t xBegin = 0; xBegin < region.size[0]; xBegin += tileWidth) {
+            const std::size_t xEnd = std::min(xBegin + tileWidth, region.size[0]);
+
+            for (std::size_t x = xBegin; x < xEnd; x++) {
+                const T* source = getSource(x, getY(innerBegin), getZ(innerBegin));
+                T* tileRow = tile.data() + (x - xBegin) * tileDepth;
+                if (steps[inner] > 0) {
+                    std::copy(source, source + (innerEnd - innerBegin), tileRow);
+                } else {
+                    std::reverse_copy(source - (innerEnd - innerBegin - 1), source + 1, tileRow);
+                }
+            }
+
+            for (std::size_t innerIndex = innerBegin; innerIndex < innerEnd; innerIndex++) {
+                T* target = getDestination(getY(innerIndex), getZ(innerIndex));
+                const T* tileColumn = tile.data() + (innerIndex - innerBegin);
+                for (std::size_t x = xBegin; x < xEnd; x++) {
+                    target[x] = tileColumn[(x - xBegin) * tileDepth];
+                }
+            }
+        }
+    });
+}
+} // namespace
+
+bool Reorientation::isIdentity() const {
+    return axes == std::array<std::size_t, 3>{0, 1, 2} &&
+           flipped == std::array<bool, 3>{false, false, false};
+}
+
+bool Reorientation::isValid() const {
+    std::array<std::size_t, 3> sortedAxes = axes;
+    std::sort(sortedAxes.begin(), sortedAxes.end());
+    return sortedAxes == std::array<std::size_t, 3>{0, 1, 2};
+}
+
+std::array<std::size_t, 3>
+Reorientation::getSize(const std::array<std::size_t, 3>& sourceSize) const {
+    return {sourceSize[axes[0]], sourceSize[axes[1]], sourceSize[axes[2]]};
+}
+
+std::array<float, 3> Reorientation::getSpacing(const std::array<float, 3>& sourceSpacing) const {
+    return {sourceSpacing[axes[0]], sourceSpacing[axes[1]], sourceSpacing[axes[2]]};
+}
+
+Reorientation Reorientation::flip(const std::size_t axis) {
+    Reorientation reorientation;
+    reorientation.flipped[axis] = true;
+    return reorientation;
+}
+
+Reorientation Reorientation::swap(const std::size_t firstAxis, const std::size_t secondAxis) {
+    Reorientation reorientation;
+    std::swap(reorientation.axes[firstAxis], reorientation.axes[secondAxis]);
+    return reorientation;
+}
+
+Volume reorientVolume(const Volume& volume, const Reorientation& reorientation,
+                      const ProgressCallback& progress) {
+    if (!reorientation.isValid() || reorientation.isIdentity() || volume.isEmpty()) {
+        return volume;
+    }
+
+    Volume reoriented(reorientation.getSize(volume.getSize()),
+                      reorientation.getSpacing(volume.getSpacing()), volume.getVoxelType());
+    reoriented.setValueRange(volume.getValueRange());
+
+    // at least a tile width of slices, source Z may end up along destination X
+    const std::size_t sliceBytes = volume.getSizeX() * volume.getSizeY() *
+                                   getBytesPerVoxel(volume.getVoxelType());
+    const std::size_t slabSliceCount = std::max(slabSizeInBytes / sliceBytes, tileWidth);
+    const auto* const data = static_cast<const std::uint8_t*>(volume.getRawData());
+    for (std::size_t firstSlice = 0; firstSlice < volume.getSizeZ(); firstSlice += slabSliceCount) {
+        const std::size_t sliceCount = std::min(slabSliceCount, volume.getSizeZ() - firstSlice);
+        reorientSlab(data + firstSlice * sliceBytes, volume.getSize(), firstSlice, sliceCount,
+                     reorientation, reoriented);
+        if (progress && !progress(static_cast<float>(firstSlice + sliceCount) /
+                                  static_cast<float>(volume.getSizeZ()))) {
+            return Volume();
+        }
+    }
+    return reoriented;
+}
+
+void reorientSlab(const void* slab, const std::array<std::size_t, 3>& sourceSize,
+                  const std::size_t firstSlice, const std::size_t sliceCount,
+                  const Reorientation& reorientation, Volume& destination) {
+    if (sliceCount == 0) {
+        return;
+    }
+
+    dispatchVoxelType(destination.getVoxelType(), [&](auto tag) {
+        using T = decltype(tag);
+        reorientSlabTyped(reinterpret_cast<const T*>(slab), sourceSize, firstSlice, sliceCount,
+                          reorientation, destination);
+    });
+}
+} // namespace VDS
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "common/progress_callback.h"
+#include "common/volume.h"
+
+namespace VDS {
+// Permutation and flips of the volume axes. Destination axis i shows source axis axes[i], walked
+// backwards if flipped[i] is set.
+struct Reorientation {
+    std::array<std::size_t, 3> axes = {0, 1, 2};
+    std::array<bool, 3> flipped = {false, false, false};
+
+    bool isIdentity() const;
+    bool isValid() const;
+    std::array<std::size_t, 3> getSize(const std::array<std::size_t, 3>& sourceSize) const;
+    std::array<float, 3> getSpacing(const std::array<float, 3>& sourceSpacing) const;
+
+    static Reorientation flip(const std::size_t axis);
+    static Reorientation swap(const std::size_t firstAxis, const std::size_t secondAxis);
+};
+
+// Permutes and flips the axes of the volume. The copy is split into tiles that fit into the
+// cache, so reads and writes both stay sequential within a tile, and tiles are processed on all
+// cores. progress is called per slab of source slices, the result is empty if it returned false.
+Volume reorientVolume(const Volume& volume, const Reorientation& reorientation,
+                      const ProgressCallback& progress = ProgressCallback());
+
+// Reorients the slab of sliceCount XY slices starting at slice firstSlice of a source volume of
+// sourceSize into its place within destination, which has to be of the reoriented size. Allows
+// reorienting a volume that is read slab by slab with a bounded buffer.
+void reorientSlab(const void* slab, const std::array<std::size_t, 3>& sourceSize,
+                  const std::size_t firstSlice, const std::size_t sliceCount,
+                  const Reorientation& reorientation, Volume& destination);
+} // namespace VDS
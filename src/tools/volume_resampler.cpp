@@ -0,0 +1,408 @@
+#include "volume_resampler.h"
+
+#include "fileio/raw_volume_io.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+namespace VDS {
+namespace {
+constexpr float pi = 3.14159265358979f;
+// lobes of the Lanczos kernel
+constexpr float lanczosRadius = 3.0f;
+// size of the volume the resampling throughput is measured on
+constexpr std::size_t calibrationSize = 96;
+
+// Weights of all destination positions along one axis. Destination position i is computed from
+// the source voxels first[i] to first[i] + count[i] - 1 with the weights starting at
+// weights[weightOffset[i]]. Source positions outside of the volume are clamped to the border.
+struct AxisFilter {
+    std::vector<std::size_t> first;
+    std::vector<std::size_t> count;
+    std::vector<std::size_t> weightOffset;
+    std::vector<float> weights;
+};
+
+float cubicWeight(const float distance) {
+    // Catmull-Rom spline
+    const float x = std::abs(distance);
+    if (x < 1.0f) {
+        return 1.5f * x * x * x - 2.5f * x * x + 1.0f;
+    }
+    if (x < 2.0f) {
+        return -0.5f * x * x * x + 2.5f * x * x - 4.0f * x + 2.0f;
+    }
+    return 0.0f;
+}
+
+float lanczosWeight(const float distance) {
+    const float x = std::abs(distance);
+    if (x < 1e-6f) {
+        return 1.0f;
+    }
+    if (x >= lanczosRadius) {
+        return 0.0f;
+    }
+    const float px = pi * x;
+    return lanczosRadius * std::sin(px) * std::sin(px / lanczosRadius) / (px * px);
+}
+
+float getKernelRadius(const InterpolationMethod method) {
+    switch (method) {
+    case InterpolationMethod::Linear:
+        return 1.0f;
+    case InterpolationMethod::Cubic:
+        return 2.0f;
+    case InterpolationMethod::Lanczos:
+        return lanczosRadius;
+    case InterpolationMethod::NearestNeighbor:
+    case InterpolationMethod::Area:
+    default:
+        return 0.5f;
+    }
+}
+
+float getKernelWeight(const InterpolationMethod method, const float distance) {
+    switch (method) {
+    case InterpolationMethod::Linear:
+        return std::max(1.0f - std::abs(distance), 0.0f);
+    case InterpolationMethod::Cubic:
+        return cubicWeight(distance);
+    case InterpolationMethod::Lanczos:
+        return lanczosWeight(distance);
+    case InterpolationMethod::NearestNeighbor:
+    case InterpolationMethod::Area:
+    default:
+        return std::abs(distance) <= 0.5f ? 1.0f : 0.0f;
+    }
+}
+
+AxisFilter computeAxisFilter(const std::size_t sourceSize, const std::size_t newSize,
+                             const InterpolationMethod method) {
+    AxisFilter filter;
+    filter.first.resize(newSize);
+    filter.count.resize(newSize);
+    filter.weightOffset.resize(newSize);
+
+    const float scale = static_cast<float>(sourceSize) / static_cast<float>(newSize);
+    const auto clampIndex = [sourceSize](const long long index) {
+        return static_cast<std::size_t>(
+            std::clamp<long long>(index, 0, static_cast<long long>(sourceSize) - 1));
+    };
+
+    // weights of the source voxels of one destination position, indexed from the first one
+    std::vector<float> weights;
+    for (std::size_t position = 0; position < newSize; position++) {
+        long long begin = 0;
+        long long end = 0;
+        weights.clear();
+
+        if (method == InterpolationMethod::NearestNeighbor) {
+            const float center = (static_cast<float>(position) + 0.5f) * scale - 0.5f;
+            begin = static_cast<long long>(clampIndex(std::lround(center)));
+            end = begin + 1;
+            weights.push_back(1.0f);
+        } else if (method == InterpolationMethod::Area) {
+            // overlap of the source voxels with the interval covered by the destination voxel
+            const float intervalBegin = static_cast<float>(position) * scale;
+            const float intervalEnd = intervalBegin + scale;
+            begin = static_cast<long long>(std::floor(intervalBegin));
+            end = std::max(static_cast<long long>(std::ceil(intervalEnd)), begin + 1);
+            for (long long index = begin; index < end; index++) {
+                const float overlap = std::min(intervalEnd, static_cast<float>(index + 1)) -
+                                      std::max(intervalBegin, static_cast<float>(index));
+                weights.push_back(std::max(overlap, 0.0f));
+            }
+        } else {
+            const float center = (static_cast<float>(position) + 0.5f) * scale - 0.5f;
+            const float filterScale = std::max(scale, 1.0f);
+            const float radius = getKernelRadius(method) * filterScale;
+            begin = static_cast<long long>(std::floor(center - radius)) + 1;
+            end = static_cast<long long>(std::ceil(center + radius));
+            for (long long index = begin; index < end; index++) {
+                weights.push_back(getKernelWeight(
+                    method, (static_cast<float>(index) - center) / filterScale));
+            }
+        }
+
+        // clamp to the border and normalize, so widened kernels keep the brightness
+        const std::size_t first = clampIndex(begin);
+        const std::size_t last = clampIndex(end - 1);
+        const std::size_t offset = filter.weights.size();
+        filter.weights.resize(offset + last - first + 1, 0.0f);
+        float sum = 0.0f;
+        for (long long index = begin; index < end; index++) {
+            const float weight = weights[static_cast<std::size_t>(index - begin)];
+            filter.weights[offset + clampIndex(index) - first] += weight;
+            sum += weight;
+        }
+        if (sum != 0.0f) {
+            for (std::size_t tap = offset; tap < filter.weights.size(); tap++) {
+                filter.weights[tap] /= sum;
+            }
+        }
+
+        filter.first[position] = first;
+        filter.count[position] = last - first + 1;
+        filter.weightOffset[position] = offset;
+    }
+
+    return filter;
+}
+
+// multiply-adds of all three passes, the X and Y passes run once per source slice in use
+double countFilterTaps(const AxisFilter& filterX, const AxisFilter& filterY,
+                       const AxisFilter& filterZ, const std::size_t sourceSizeY) {
+    std::size_t sourceSliceCount = 0;
+    std::size_t nextSourceSlice = 0;
+    for (std::size_t z = 0; z < filterZ.first.size(); z++) {
+        const std::size_t end = filterZ.first[z] + filterZ.count[z];
+        sourceSliceCount += end - std::max(filterZ.first[z], std::min(nextSourceSlice, end));
+        nextSourceSlice = std::max(nextSourceSlice, end);
+    }
+
+    const double sizeX = static_cast<double>(filterX.first.size());
+    const double sizeY = static_cast<double>(filterY.first.size());
+    const double slices = static_cast<double>(sourceSliceCount);
+    return static_cast<double>(filterX.weights.size()) * sourceSizeY * slices +
+           sizeX * static_cast<double>(filterY.weights.size()) * slices +
+           sizeX * sizeY * static_cast<double>(filterZ.weights.size());
+}
+
+// Filters the volume along X, then Y, then Z. Source slices filtered along X and Y are kept as
+// float planes while destination slices still need them, so every source slice is filtered only
+// once and no float copy of the whole volume is needed. Within a pass, rows are processed in
+// parallel, the Y and Z passes scale whole rows and vectorize.
+// getSourceSlice(z) returns the voxels of source slice z, which only need to stay valid until the
+// next call, or nullptr on failure. Slices are requested in increasing order. Destination slice z
+// is written to getDestinationSlice(z), finishDestinationSlice(z) is called once it is complete.
+template <typename T, typename SourceSlices, typename DestinationSlices, typename FinishSlice>
+bool resampleSlices(const std::array<std::size_t, 3>& sourceSize,
+                    const std::array<std::size_t, 3>& newSize, const InterpolationMethod method,
+                    SourceSlices&& getSourceSlice, DestinationSlices&& getDestinationSlice,
+                    FinishSlice&& finishDestinationSlice) {
+    const AxisFilter filterX = computeAxisFilter(sourceSize[0], newSize[0], method);
+    const AxisFilter filterY = computeAxisFilter(sourceSize[1], newSize[1], method);
+    const AxisFilter filterZ = computeAxisFilter(sourceSize[2], newSize[2], method);
+
+    const std::size_t sizeX = newSize[0];
+    const std::size_t sizeY = newSize[1];
+
+    std::vector<std::size_t> sourceRows(sourceSize[1]);
+    std::iota(sourceRows.begin(), sourceRows.end(), 0);
+    std::vector<std::size_t> rows(sizeY);
+    std::iota(rows.begin(), rows.end(), 0);
+
+    // source slice filtered along X and the planes of source slices in use
+    std::vector<float> filteredX(sizeX * sourceSize[1]);
+    std::deque<std::pair<std::size_t, std::vector<float>>> planes;
+
+    const auto filterSlice = [&](const T* sourceSlice) {
+        QtConcurrent::blockingMap(sourceRows, [&](const std::size_t y) {
+            const T* sourceRow = sourceSlice + y * sourceSize[0];
+            float* row = filteredX.data() + y * sizeX;
+            for (std::size_t x = 0; x < sizeX; x++) {
+                const T* taps = sourceRow + filterX.first[x];
+                const float* weights = filterX.weights.data() + filterX.weightOffset[x];
+                float value = 0.0f;
+                for (std::size_t tap = 0; tap < filterX.count[x]; tap++) {
+                    value += weights[tap] * static_cast<float>(taps[tap]);
+                }
+                row[x] = value;
+            }
+        });
+
+        std::vector<float> plane(sizeX * sizeY);
+        QtConcurrent::blockingMap(rows, [&](const std::size_t y) {
+            float* row = plane.data() + y * sizeX;
+            const float* weights = filterY.weights.data() + filterY.weightOffset[y];
+            for (std::size_t tap = 0; tap < filterY.count[y]; tap++) {
+                const float* tapRow = filteredX.data() + (filterY.first[y] + tap) * sizeX;
+                const float weight = weights[tap];
+                for (std::size_t x = 0; x < sizeX; x++) {
+                    row[x] += weight * tapRow[x];
+                }
+            }
+        });
+        return plane;
+    };
+
+    constexpr ValueRange typeRange = getVoxelTypeRange<T>();
+    for (std::size_t z = 0; z < newSize[2]; z++) {
+        const std::size_t first = filterZ.first[z];
+        const std::size_t count = filterZ.count[z];
+
+        // the source slices of consecutive destination slices only move forward
+        while (!planes.empty() && planes.front().first < first) {
+            planes.pop_front();
+        }
+        for (std::size_t sourceZ = planes.empty() ? first : planes.back().first + 1;
+             sourceZ < first + count; sourceZ++) {
+            const T* sourceSlice = getSourceSlice(sourceZ);
+            if (sourceSlice == nullptr) {
+                return false;
+            }
+            planes.emplace_back(sourceZ, filterSlice(sourceSlice));
+        }
+
+        T* destinationSlice = getDestinationSlice(z);
+        const float* weights = filterZ.weights.data() + filterZ.weightOffset[z];
+        QtConcurrent::blockingMap(rows, [&](const std::size_t y) {
+            std::vector<float> values(sizeX, 0.0f);
+            for (std::size_t tap = 0; tap < count; tap++) {
+                const float* tapRow = planes[tap].second.data() + y * sizeX;
+                const float weight = weights[tap];
+                for (std::size_t x = 0; x < sizeX; x++) {
+                    values[x] += weight * tapRow[x];
+                }
+            }
+
+            T* row = destinationSlice + y * sizeX;
+            for (std::size_t x = 0; x < sizeX; x++) {
+                if constexpr (std::is_integral_v<T>) {
+                    // cubic and Lanczos interpolation can over- and undershoot
+                    row[x] = static_cast<T>(std::lround(
+                        std::clamp(values[x], typeRange.minimum, typeRange.maximum)));
+                } else {
+                    row[x] = static_cast<T>(values[x]);
+                }
+            }
+        });
+
+        if (!finishDestinationSlice(z)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double measureSecondsPerTap() {
+    const std::array<std::size_t, 3> size = {calibrationSize, calibrationSize, calibrationSize};
+    const std::array<std::size_t, 3> newSize = {calibrationSize * 3 / 4, calibrationSize * 3 / 4,
+                                                calibrationSize * 3 / 4};
+    const Volume volume(size, {1.0f, 1.0f, 1.0f}, VoxelType::UInt16);
+
+    const auto start = std::chrono::steady_clock::now();
+    resampleVolume(volume, newSize, InterpolationMethod::Cubic);
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const double taps = countFilterTaps(
+        computeAxisFilter(size[0], newSize[0], InterpolationMethod::Cubic),
+        computeAxisFilter(size[1], newSize[1], InterpolationMethod::Cubic),
+        computeAxisFilter(size[2], newSize[2], InterpolationMethod::Cubic), size[1]);
+    return seconds / taps;
+}
+} // namespace
+
+Volume resampleVolume(const Volume& volume, const std::array<std::size_t, 3>& newSize,
+                      const InterpolationMethod method, const ProgressCallback& progress) {
+    const std::array<float, 3> spacing = {
+        volume.getSpacing()[0] * volume.getSizeX() / static_cast<float>(newSize[0]),
+        volume.getSpacing()[1] * volume.getSizeY() / static_cast<float>(newSize[1]),
+        volume.getSpacing()[2] * volume.getSizeZ() / static_cast<float>(newSize[2])};
+
+    Volume resampled(newSize, spacing, volume.getVoxelType());
+    resampled.setValueRange(volume.getValueRange());
+
+    if (volume.isEmpty() || resampled.isEmpty()) {
+        return resampled;
+    }
+
+    const bool success = dispatchVoxelType(volume.getVoxelType(), [&](auto tag) {
+        using T = decltype(tag);
+        return resampleSlices<T>(
+            volume.getSize(), newSize, method,
+            [&](const std::size_t z) { return volume.getRow<T>(0, z); },
+            [&](const std::size_t z) { return resampled.getRow<T>(0, z); },
+            [&](const std::size_t z) {
+                return !progress || progress(static_cast<float>(z + 1) / newSize[2]);
+            });
+    });
+
+    return success ? resampled : Volume();
+}
+
+bool resampleVolumeSlices(const Volume& volume, const std::array<std::size_t, 3>& newSize,
+                          const InterpolationMethod method,
+                          const std::function<bool(const Volume&, std::size_t)>& consumeSlice) {
+    if (volume.isEmpty() || newSize[0] == 0 || newSize[1] == 0 || newSize[2] == 0) {
+        return false;
+    }
+
+    const std::array<float, 3> spacing = {
+        volume.getSpacing()[0] * volume.getSizeX() / static_cast<float>(newSize[0]),
+        volume.getSpacing()[1] * volume.getSizeY() / static_cast<float>(newSize[1]),
+        volume.getSpacing()[2] * volume.getSizeZ() / static_cast<float>(newSize[2])};
+    Volume destinationSlice({newSize[0], newSize[1], 1}, spacing, volume.getVoxelType());
+    destinationSlice.setValueRange(volume.getValueRange());
+
+    return dispatchVoxelType(volume.getVoxelType(), [&](auto tag) {
+        using T = decltype(tag);
+        return resampleSlices<T>(
+            volume.getSize(), newSize, method,
+            [&](const std::size_t z) { return volume.getRow<T>(0, z); },
+            [&](const std::size_t) { return destinationSlice.getData<T>(); },
+            [&](const std::size_t z) { return consumeSlice(destinationSlice, z); });
+    });
+}
+
+bool resampleRawFile(const std::filesystem::path& sourcePath, const VoxelType voxelType,
+                     const bool littleEndian, const std::array<std::size_t, 3>& size,
+                     const std::filesystem::path& destinationPath,
+                     const std::array<std::size_t, 3>& newSize, const InterpolationMethod method,
+                     const ProgressCallback& progress) {
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        if (newSize[axis] == 0) {
+            return false;
+        }
+    }
+
+    RawVolumeIO::RawSliceReader reader(sourcePath, voxelType, littleEndian, size,
+                                       {1.0f, 1.0f, 1.0f});
+    RawVolumeIO::RawSliceWriter writer(destinationPath, voxelType, littleEndian);
+    if (!reader.isOpen() || !writer.isOpen()) {
+        return false;
+    }
+
+    Volume sourceSlice;
+    Volume destinationSlice({newSize[0], newSize[1], 1}, {1.0f, 1.0f, 1.0f}, voxelType);
+    return dispatchVoxelType(voxelType, [&](auto tag) {
+        using T = decltype(tag);
+        return resampleSlices<T>(
+            size, newSize, method,
+            [&](const std::size_t z) -> const T* {
+                return reader.readSlab(z, 1, sourceSlice) ? sourceSlice.getData<T>() : nullptr;
+            },
+            [&](const std::size_t) { return destinationSlice.getData<T>(); },
+            [&](const std::size_t z) {
+                // the voxels keep their values, only the endianness gets converted
+                return writer.writeSlab(destinationSlice, ValueWindowSettings{}) &&
+                       (!progress || progress(static_cast<float>(z + 1) / newSize[2]));
+            });
+    });
+}
+
+double estimateResampleDuration(const std::array<std::size_t, 3>& size,
+                                const std::array<std::size_t, 3>& newSize,
+                                const InterpolationMethod method) {
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        if (size[axis] == 0 || newSize[axis] == 0) {
+            return 0.0;
+        }
+    }
+
+    static const double secondsPerTap = measureSecondsPerTap();
+    const double taps = countFilterTaps(computeAxisFilter(size[0], newSize[0], method),
+                                        computeAxisFilter(size[1], newSize[1], method),
+                                        computeAxisFilter(size[2], newSize[2], method), size[1]);
+    return taps * secondsPerTap;
+}
+} // namespace VDS
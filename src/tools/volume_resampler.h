@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <functional>
+
+#include "common/progress_callback.h"
+#include "common/volume.h"
+
+namespace VDS {
+enum class InterpolationMethod { NearestNeighbor, Linear, Cubic, Area, Lanczos };
+
+// Resamples the volume to newSize in its native voxel type. Voxel centers are aligned, so the
+// physical extent stays the same and the spacing is scaled by oldSize / newSize. The filter is
+// applied separably along X, Y and Z with precomputed weights, rows are filtered in parallel.
+// When downscaling, the kernels of Linear, Cubic and Lanczos are widened by the scale factor, so
+// they low-pass the volume before decimating it. Area averages all source voxels overlapping a
+// destination voxel. progress is called per destination slice, the result is empty if it
+// returned false.
+Volume resampleVolume(const Volume& volume, const std::array<std::size_t, 3>& newSize,
+                      const InterpolationMethod method,
+                      const ProgressCallback& progress = ProgressCallback());
+
+// Streaming variant of resampleVolume. Every destination slice is passed to consumeSlice(slice, z)
+// as soon as it is complete instead of being collected in a volume, slice is reused for the next
+// one. Stops and returns false once consumeSlice returns false.
+bool resampleVolumeSlices(const Volume& volume, const std::array<std::size_t, 3>& newSize,
+                          const InterpolationMethod method,
+                          const std::function<bool(const Volume&, std::size_t)>& consumeSlice);
+
+// Out-of-core variant of resampleVolume for raw files larger than RAM. Source slices are read one
+// at a time, only the filtered planes within the filter support along Z are kept in memory and
+// every destination slice is appended to destinationPath once it is complete. Voxel type and
+// endianness of the source are kept.
+bool resampleRawFile(const std::filesystem::path& sourcePath, const VoxelType voxelType,
+                     const bool littleEndian, const std::array<std::size_t, 3>& size,
+                     const std::filesystem::path& destinationPath,
+                     const std::array<std::size_t, 3>& newSize, const InterpolationMethod method,
+                     const ProgressCallback& progress = ProgressCallback());
+
+// Estimated run time of resampleVolume in seconds. Based on the number of filter taps and the
+// throughput measured once on a small volume.
+double estimateResampleDuration(const std::array<std::size_t, 3>& size,
+                                const std::array<std::size_t, 3>& newSize,
+                                const InterpolationMethod method);
+} // namespace VDS
@@ -0,0 +1,651 @@
+#include "voxel_expression.h"
+
+#include "common/simd_kernels.h"
+#include "common/volume_kernels.h"
+
+#include <QDebug>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <locale>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <type_traits>
+
+namespace VDS {
+namespace {
+// voxels per block, small enough for the registers of a block to stay in the L1 cache
+constexpr std::size_t blockSize = 256;
+// upper bound of the slices processed between two progress reports
+constexpr std::size_t maximumSlabSizeInBytes = std::size_t{64} << 20;
+
+// a and b point to count values each, or to a single value used for all voxels if constant
+template <typename Function>
+void mapBinary(const float* a, const bool aConstant, const float* b, const bool bConstant,
+               float* result, const std::size_t count, Function function) {
+    if (aConstant && bConstant) {
+        std::fill(result, result + count, function(*a, *b));
+    } else if (aConstant) {
+        const float constant = *a;
+        for (std::size_t index = 0; index < count; index++) {
+            result[index] = function(constant, b[index]);
+        }
+    } else if (bConstant) {
+        const float constant = *b;
+        for (std::size_t index = 0; index < count; index++) {
+            result[index] = function(a[index], constant);
+        }
+    } else {
+        for (std::size_t index = 0; index < count; index++) {
+            result[index] = function(a[index], b[index]);
+        }
+    }
+}
+
+// Evaluates every unary instruction, per batch of voxels, and folds unary instructions on a
+// constant into a single value while compiling. The operand is never a constant when evaluating,
+// as those instructions got folded, so unlike mapBinary it needs no broadcasting.
+template <typename Function>
+void mapUnary(const float* a, float* result, const std::size_t count, Function function) {
+    for (std::size_t index = 0; index < count; index++) {
+        result[index] = function(a[index]);
+    }
+}
+
+// integer results get rounded and clamped to their type, results that are not finite become 0
+template <typename T>
+T toVoxel(const float value) {
+    constexpr ValueRange range = getVoxelTypeRange<T>();
+    if (!std::isfinite(value)) {
+        return T{0};
+    }
+    return static_cast<T>(std::lround(std::clamp(value, range.minimum, range.maximum)));
+}
+
+bool isIdentifierCharacter(const char character) {
+    return std::isalnum(static_cast<unsigned char>(character)) || character == '_';
+}
+} // namespace
+
+struct VoxelExpression::Node {
+    enum class Kind { Constant, Value, Operation };
+
+    Kind kind = Kind::Constant;
+    float constant = 0.0f;
+    Opcode opcode = Opcode::Add;
+    std::vector<std::unique_ptr<Node>> arguments;
+
+    static std::unique_ptr<Node> operation(const Opcode opcode,
+                                           std::vector<std::unique_ptr<Node>> arguments) {
+        auto node = std::make_unique<Node>();
+        node->kind = Kind::Operation;
+        node->opcode = opcode;
+        node->arguments = std::move(arguments);
+        return node;
+    }
+
+    static std::unique_ptr<Node> operation(const Opcode opcode, std::unique_ptr<Node> a,
+                                           std::unique_ptr<Node> b = nullptr) {
+        std::vector<std::unique_ptr<Node>> arguments;
+        arguments.push_back(std::move(a));
+        if (b) {
+            arguments.push_back(std::move(b));
+        }
+        return operation(opcode, std::move(arguments));
+    }
+};
+
+// Recursive descent parser, lowest precedence first:
+//   comparison := sum (("<" | "<=" | ">" | ">=" | "==" | "!=") sum)*
+//   sum        := product (("+" | "-") product)*
+//   product    := unary (("*" | "/") unary)*
+//   unary      := ("-" | "+") unary | power
+//   power      := primary ("^" unary)?
+//   primary    := number | "v" | function "(" comparison ("," comparison)* ")" | "(" comparison ")"
+// Every function returns null after an error, the first error is kept.
+class VoxelExpression::Parser {
+public:
+    explicit Parser(const std::string& text) : m_text{text} {}
+
+    std::unique_ptr<Node> parse() {
+        std::unique_ptr<Node> root = parseComparison();
+        skipWhitespace();
+        if (root && m_position < m_text.size()) {
+            return fail(std::string("Unexpected '") + m_text[m_position] + "'");
+        }
+        return root;
+    }
+
+    const std::string& getError() const {
+        return m_error;
+    }
+
+private:
+    std::unique_ptr<Node> parseComparison() {
+        std::unique_ptr<Node> node = parseSum();
+        while (node) {
+            Opcode opcode;
+            if (accept("<=")) {
+                opcode = Opcode::LessEqual;
+            } else if (accept(">=")) {
+                opcode = Opcode::GreaterEqual;
+            } else if (accept("==")) {
+                opcode = Opcode::Equal;
+            } else if (accept("!=")) {
+                opcode = Opcode::NotEqual;
+            } else if (accept("<")) {
+                opcode = Opcode::Less;
+            } else if (accept(">")) {
+                opcode = Opcode::Greater;
+            } else {
+                break;
+            }
+            std::unique_ptr<Node> right = parseSum();
+            node = right ? Node::operation(opcode, std::move(node), std::move(right)) : nullptr;
+        }
+        return node;
+    }
+
+    std::unique_ptr<Node> parseSum() {
+        std::unique_ptr<Node> node = parseProduct();
+        while (node) {
+            Opcode opcode;
+            if (accept("+")) {
+                opcode = Opcode::Add;
+            } else if (accept("-")) {
+                opcode = Opcode::Subtract;
+            } else {
+                break;
+            }
+            std::unique_ptr<Node> right = parseProduct();
+            node = right ? Node::operation(opcode, std::move(node), std::move(right)) : nullptr;
+        }
+        return node;
+    }
+
+    std::unique_ptr<Node> parseProduct() {
+        std::unique_ptr<Node> node = parseUnary();
+        while (node) {
+            Opcode opcode;
+            if (accept("*")) {
+                opcode = Opcode::Multiply;
+            } else if (accept("/")) {
+                opcode = Opcode::Divide;
+            } else {
+                break;
+            }
+            std::unique_ptr<Node> right = parseUnary();
+            node = right ? Node::operation(opcode, std::move(node), std::move(right)) : nullptr;
+        }
+        return node;
+    }
+
+    std::unique_ptr<Node> parseUnary() {
+        if (accept("-")) {
+            std::unique_ptr<Node> operand = parseUnary();
+            return operand ? Node::operation(Opcode::Negate, std::move(operand)) : nullptr;
+        }
+        if (accept("+")) {
+            return parseUnary();
+        }
+        return parsePower();
+    }
+
+    std::unique_ptr<Node> parsePower() {
+        std::unique_ptr<Node> node = parsePrimary();
+        if (node && accept("^")) {
+            // right associative, 2 ^ -1 is allowed
+            std::unique_ptr<Node> exponent = parseUnary();
+            node = exponent ? Node::operation(Opcode::Power, std::move(node), std::move(exponent))
+                            : nullptr;
+        }
+        return node;
+    }
+
+    std::unique_ptr<Node> parsePrimary() {
+        skipWhitespace();
+        if (m_position >= m_text.size()) {
+            return fail("Expression ends unexpectedly");
+        }
+
+        const char character = m_text[m_position];
+        if (std::isdigit(static_cast<unsigned char>(character)) || character == '.') {
+            return parseNumber();
+        }
+        if (accept("(")) {
+            std::unique_ptr<Node> node = parseComparison();
+            if (node && !accept(")")) {
+                return fail("Missing ')'");
+            }
+            return node;
+        }
+        if (isIdentifierCharacter(character)) {
+            return parseIdentifier();
+        }
+        return fail(std::string("Unexpected '") + character + "'");
+    }
+
+    std::unique_ptr<Node> parseNumber() {
+        const std::size_t start = m_position;
+        while (m_position < m_text.size() &&
+               (std::isdigit(static_cast<unsigned char>(m_text[m_position])) ||
+                m_text[m_position] == '.')) {
+            m_position++;
+        }
+        if (m_position < m_text.size() &&
+            (m_text[m_position] == 'e' || m_text[m_position] == 'E')) {
+            m_position++;
+            if (m_position < m_text.size() &&
+                (m_text[m_position] == '+' || m_text[m_position] == '-')) {
+                m_position++;
+            }
+            while (m_position < m_text.size() &&
+                   std::isdigit(static_cast<unsigned char>(m_text[m_position]))) {
+                m_position++;
+            }
+        }
+
+        // the classic locale reads a '.' as decimal point regardless of the system locale
+        std::istringstream stream(m_text.substr(start, m_position - start));
+        stream.imbue(std::locale::classic());
+        auto node = std::make_unique<Node>();
+        if (!(stream >> node->constant) ||
+            stream.peek() != std::istringstream::traits_type::eof()) {
+            m_position = start;
+            return fail("Invalid number");
+        }
+        return node;
+    }
+
+    std::unique_ptr<Node> parseIdentifier() {
+        const std::size_t start = m_position;
+        while (m_position < m_text.size() && isIdentifierCharacter(m_text[m_position])) {
+            m_position++;
+        }
+        const std::string name = m_text.substr(start, m_position - start);
+
+        if (name == "v") {
+            auto node = std::make_unique<Node>();
+            node->kind = Node::Kind::Value;
+            return node;
+        }
+
+        static const std::vector<std::pair<std::string, Opcode>> unaryFunctions = {
+            {"abs", Opcode::Absolute},  {"sqrt", Opcode::SquareRoot}, {"exp", Opcode::Exponential},
+            {"log", Opcode::Logarithm}, {"floor", Opcode::Floor},     {"ceil", Opcode::Ceil},
+            {"round", Opcode::Round}};
+        const auto unaryFunction =
+            std::find_if(unaryFunctions.begin(), unaryFunctions.end(),
+                         [&](const auto& function) { return function.first == name; });
+        const bool isFunction = unaryFunction != unaryFunctions.end() || name == "min" ||
+                                name == "max" || name == "clamp" || name == "select";
+        if (!isFunction) {
+            m_position = start;
+            return fail("Unknown name '" + name + "', the voxel value is called v");
+        }
+
+        if (!accept("(")) {
+            return fail("Missing '(' after " + name);
+        }
+        std::vector<std::unique_ptr<Node>> arguments;
+        do {
+            std::unique_ptr<Node> argument = parseComparison();
+            if (!argument) {
+                return nullptr;
+            }
+            arguments.push_back(std::move(argument));
+        } while (accept(","));
+        if (!accept(")")) {
+            return fail("Missing ')' after the arguments of " + name);
+        }
+
+        if (unaryFunction != unaryFunctions.end()) {
+            if (arguments.size() != 1) {
+                return fail(name + " takes a single argument");
+            }
+            return Node::operation(unaryFunction->second, std::move(arguments));
+        }
+        if (name == "min" || name == "max") {
+            if (arguments.size() < 2) {
+                return fail(name + " takes at least two arguments");
+            }
+            const Opcode opcode = name == "min" ? Opcode::Minimum : Opcode::Maximum;
+            std::unique_ptr<Node> node = std::move(arguments[0]);
+            for (std::size_t index = 1; index < arguments.size(); index++) {
+                node = Node::operation(opcode, std::move(node), std::move(arguments[index]));
+            }
+            return node;
+        }
+        if (arguments.size() != 3) {
+            return fail(name + " takes three arguments");
+        }
+        if (name == "clamp") {
+            // clamp(x, low, high) = max(min(x, high), low)
+            std::unique_ptr<Node> upper =
+                Node::operation(Opcode::Minimum, std::move(arguments[0]), std::move(arguments[2]));
+            return Node::operation(Opcode::Maximum, std::move(upper), std::move(arguments[1]));
+        }
+        return Node::operation(Opcode::Select, std::move(arguments));
+    }
+
+    void skipWhitespace() {
+        while (m_position < m_text.size() &&
+               std::isspace(static_cast<unsigned char>(m_text[m_position]))) {
+            m_position++;
+        }
+    }
+
+    // consumes token if the text continues with it, longer tokens have to be tried first
+    bool accept(const std::string& token) {
+        skipWhitespace();
+        if (m_text.compare(m_position, token.size(), token) != 0) {
+            return false;
+        }
+        m_position += token.size();
+        return true;
+    }
+
+    std::unique_ptr<Node> fail(const std::string& message) {
+        if (m_error.empty()) {
+            m_error = message + " at position " + std::to_string(m_position + 1);
+        }
+        return nullptr;
+    }
+
+    const std::string& m_text;
+    std::size_t m_position = 0;
+    std::string m_error;
+};
+
+bool VoxelExpression::parse(const std::string& text, std::string& errorMessage) {
+    Parser parser(text);
+    const std::unique_ptr<Node> root = parser.parse();
+    if (!root) {
+        errorMessage = parser.getError();
+        return false;
+    }
+
+    VoxelExpression expression;
+    expression.m_text = text;
+    expression.m_result = expression.compile(*root);
+    *this = std::move(expression);
+    return true;
+}
+
+bool VoxelExpression::isEmpty() const {
+    return m_text.empty();
+}
+
+const std::string& VoxelExpression::getText() const {
+    return m_text;
+}
+
+VoxelExpression::Operand VoxelExpression::compile(const Node& node) {
+    Operand operand;
+    if (node.kind == Node::Kind::Constant) {
+        operand.isConstant = true;
+        operand.constant = node.constant;
+        return operand;
+    }
+    if (node.kind == Node::Kind::Value) {
+        return operand;
+    }
+
+    Instruction instruction;
+    instruction.opcode = node.opcode;
+    bool isConstant = true;
+    for (std::size_t index = 0; index < node.arguments.size(); index++) {
+        instruction.operands[index] = compile(*node.arguments[index]);
+        isConstant = isConstant && instruction.operands[index].isConstant;
+    }
+
+    // constant subtrees like "2 * 1024" get evaluated once here instead of per voxel
+    if (isConstant) {
+        const std::array<const float*, 3> operands = {&instruction.operands[0].constant,
+                                                      &instruction.operands[1].constant,
+                                                      &instruction.operands[2].constant};
+        operand.isConstant = true;
+        execute(instruction, operands, &operand.constant, 1);
+        return operand;
+    }
+
+    instruction.result = m_registerCount++;
+    m_program.push_back(instruction);
+    operand.index = instruction.result;
+    return operand;
+}
+
+void VoxelExpression::execute(const Instruction& instruction,
+                              const std::array<const float*, 3>& operands, float* result,
+                              const std::size_t count) {
+    const auto binary = [&](auto function) {
+        mapBinary(operands[0], instruction.operands[0].isConstant, operands[1],
+                  instruction.operands[1].isConstant, result, count, function);
+    };
+    const auto unary = [&](auto function) { mapUnary(operands[0], result, count, function); };
+
+    switch (instruction.opcode) {
+    case Opcode::Add:
+        binary([](const float a, const float b) { return a + b; });
+        break;
+    case Opcode::Subtract:
+        binary([](const float a, const float b) { return a - b; });
+        break;
+    case Opcode::Multiply:
+        binary([](const float a, const float b) { return a * b; });
+        break;
+    case Opcode::Divide:
+        binary([](const float a, const float b) { return a / b; });
+        break;
+    case Opcode::Power:
+        binary([](const float a, const float b) { return std::pow(a, b); });
+        break;
+    case Opcode::Minimum:
+        binary([](const float a, const float b) { return b < a ? b : a; });
+        break;
+    case Opcode::Maximum:
+        binary([](const float a, const float b) { return a < b ? b : a; });
+        break;
+    case Opcode::Less:
+        binary([](const float a, const float b) { return a < b ? 1.0f : 0.0f; });
+        break;
+    case Opcode::LessEqual:
+        binary([](const float a, const float b) { return a <= b ? 1.0f : 0.0f; });
+        break;
+    case Opcode::Greater:
+        binary([](const float a, const float b) { return a > b ? 1.0f : 0.0f; });
+        break;
+    case Opcode::GreaterEqual:
+        binary([](const float a, const float b) { return a >= b ? 1.0f : 0.0f; });
+        break;
+    case Opcode::Equal:
+        binary([](const float a, const float b) { return a == b ? 1.0f : 0.0f; });
+        break;
+    case Opcode::NotEqual:
+        binary([](const float a, const float b) { return a != b ? 1.0f : 0.0f; });
+        break;
+    case Opcode::Select: {
+        // rare enough to not need a loop per combination of constant operands
+        std::array<std::size_t, 3> strides;
+        for (std::size_t index = 0; index < 3; index++) {
+            strides[index] = instruction.operands[index].isConstant ? 0 : 1;
+        }
+        for (std::size_t index = 0; index < count; index++) {
+            result[index] = operands[0][index * strides[0]] != 0.0f
+                                ? operands[1][index * strides[1]]
+                                : operands[2][index * strides[2]];
+        }
+        break;
+    }
+    case Opcode::Negate:
+        unary([](const float a) { return -a; });
+        break;
+    case Opcode::Absolute:
+        unary([](const float a) { return std::abs(a); });
+        break;
+    case Opcode::SquareRoot:
+        unary([](const float a) { return std::sqrt(a); });
+        break;
+    case Opcode::Exponential:
+        unary([](const float a) { return std::exp(a); });
+        break;
+    case Opcode::Logarithm:
+        unary([](const float a) { return std::log(a); });
+        break;
+    case Opcode::Floor:
+        unary([](const float a) { return std::floor(a); });
+        break;
+    case Opcode::Ceil:
+        unary([](const float a) { return std::ceil(a); });
+        break;
+    case Opcode::Round:
+        unary([](const float a) { return std::round(a); });
+        break;
+    }
+}
+
+void VoxelExpression::evaluateBlock(const float* values, float* results, const std::size_t count,
+                                    float* scratch) const {
+    const auto getRegister = [&](const std::uint32_t index) {
+        return scratch + (index - 1) * blockSize;
+    };
+
+    for (std::size_t index = 0; index < m_program.size(); index++) {
+        const Instruction& instruction = m_program[index];
+        std::array<const float*, 3> operands;
+        for (std::size_t argument = 0; argument < 3; argument++) {
+            const Operand& operand = instruction.operands[argument];
+            if (operand.isConstant) {
+                operands[argument] = &operand.constant;
+            } else {
+                operands[argument] = operand.index == 0 ? values : getRegister(operand.index);
+            }
+        }
+        // the last instruction writes the results right away
+        float* result =
+            index + 1 == m_program.size() ? results : getRegister(instruction.result);
+        execute(instruction, operands, result, count);
+    }
+}
+
+void VoxelExpression::evaluate(const float* values, float* results,
+                               const std::size_t count) const {
+    if (m_program.empty()) {
+        if (m_result.isConstant) {
+            std::fill(results, results + count, m_result.constant);
+        } else if (results != values) {
+            std::copy(values, values + count, results);
+        }
+        return;
+    }
+
+    std::vector<float> scratch((m_registerCount - 1) * blockSize);
+    for (std::size_t first = 0; first < count; first += blockSize) {
+        evaluateBlock(values + first, results + first, std::min(blockSize, count - first),
+                      scratch.data());
+    }
+}
+
+float VoxelExpression::evaluate(const float value) const {
+    float result;
+    evaluate(&value, &result, 1);
+    return result;
+}
+
+Volume VoxelExpression::apply(const Volume& volume, const ProgressCallback& progress) const {
+    if (volume.isEmpty()) {
+        return Volume();
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::array<std::size_t, 3>& size = volume.getSize();
+    Volume result(size, volume.getSpacing(), volume.getVoxelType());
+    result.setValueRange(volume.getValueRange());
+
+    // minimum and maximum result per slice of floating point volumes
+    std::vector<ValueRange> sliceRanges(size[2]);
+
+    const bool finished = dispatchVoxelType(volume.getVoxelType(), [&](auto tag) {
+        using T = decltype(tag);
+
+        std::vector<T> lookupTable;
+        if constexpr (std::is_integral_v<T>) {
+            std::vector<float> values(Kernels::getValueCount<T>());
+            for (std::size_t index = 0; index < values.size(); index++) {
+                values[index] = static_cast<float>(static_cast<int32_t>(index) +
+                                                   std::numeric_limits<T>::lowest());
+            }
+            evaluate(values.data(), values.data(), values.size());
+            lookupTable.resize(values.size());
+            std::transform(values.begin(), values.end(), lookupTable.begin(), toVoxel<T>);
+        }
+
+        const std::size_t sliceVoxelCount = size[0] * size[1];
+        const T* source = volume.getData<T>();
+        T* destination = result.getData<T>();
+        const auto mapSlice = [&](const std::size_t slice) {
+            const T* sourceSlice = source + slice * sliceVoxelCount;
+            T* destinationSlice = destination + slice * sliceVoxelCount;
+            if constexpr (std::is_integral_v<T>) {
+                for (std::size_t index = 0; index < sliceVoxelCount; index++) {
+                    destinationSlice[index] =
+                        lookupTable[Kernels::getValueIndex(sourceSlice[index])];
+                }
+            } else {
+                evaluate(sourceSlice, destinationSlice, sliceVoxelCount);
+                // while the slice is still in the cache
+                float minimum;
+                float maximum;
+                Kernels::Simd::replaceNonFinite(destinationSlice, sliceVoxelCount, minimum,
+                                                maximum);
+                sliceRanges[slice] = ValueRange{minimum, maximum};
+            }
+        };
+
+        const std::size_t slabSliceCount =
+            std::max<std::size_t>(1, maximumSlabSizeInBytes / (sliceVoxelCount * sizeof(T)));
+        std::vector<std::size_t> slices;
+        for (std::size_t firstSlice = 0; firstSlice < size[2]; firstSlice += slabSliceCount) {
+            slices.resize(std::min(slabSliceCount, size[2] - firstSlice));
+            std::iota(slices.begin(), slices.end(), firstSlice);
+            QtConcurrent::blockingMap(slices, mapSlice);
+
+            if (progress && !progress(static_cast<float>(firstSlice + slices.size()) /
+                                      static_cast<float>(size[2]))) {
+                return false;
+            }
+        }
+        return true;
+    });
+    if (!finished) {
+        return Volume();
+    }
+
+    if (volume.getVoxelType() == VoxelType::Float32) {
+        ValueRange range{std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()};
+        for (const ValueRange& sliceRange : sliceRanges) {
+            range.minimum = std::min(range.minimum, sliceRange.minimum);
+            range.maximum = std::max(range.maximum, sliceRange.maximum);
+        }
+        // avoid a division by zero for constant results, like computeValueRange does
+        if (range.maximum <= range.minimum) {
+            range.maximum = range.minimum + 1.0f;
+        }
+        result.setValueRange(range);
+    }
+
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    qInfo("Evaluated %s over %zu voxels in %.1f ms (%.0f MVoxel/s, %.1f GB/s)", m_text.c_str(),
+          volume.getVoxelCount(), seconds * 1000.0,
+          static_cast<double>(volume.getVoxelCount()) / seconds / 1.0e6,
+          2.0 * static_cast<double>(volume.getSizeInBytes()) / seconds / 1.0e9);
+
+    return result;
+}
+} // namespace VDS
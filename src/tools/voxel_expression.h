@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/progress_callback.h"
+#include "common/volume.h"
+
+namespace VDS {
+// Per-voxel formula over the voxel value v, e.g. "clamp(v * 1.2 - 100, 0, 4095)" to rescale and
+// clamp or "v > 300" to threshold into a mask. Supports numbers, + - * / ^, comparisons
+// < <= > >= == != which give 1 or 0, parentheses and the functions min, max, clamp, select(c, a,
+// b), abs, sqrt, exp, log, floor, ceil and round.
+//
+// The text gets parsed into an expression tree, constant subtrees are folded and the tree is
+// compiled into a short list of instructions. Instead of walking the tree per voxel, every
+// instruction runs over a whole block of voxels at once in a plain loop the compiler vectorizes,
+// so the interpretation overhead is paid once per block. Integer volumes evaluate the expression
+// only once per representable value into a lookup table, which leaves a single table lookup per
+// voxel.
+class VoxelExpression {
+public:
+    // Replaces the expression by the one parsed from text. On failure errorMessage names the
+    // position of the error and the expression stays unchanged.
+    bool parse(const std::string& text, std::string& errorMessage);
+    bool isEmpty() const;
+    const std::string& getText() const;
+
+    // results of the expression for count voxel values, results may be the same array as values
+    void evaluate(const float* values, float* results, const std::size_t count) const;
+    float evaluate(const float value) const;
+
+    // Result of the expression for every voxel of volume in the same voxel type, integer results
+    // get rounded and clamped to the range of the type. Results that are not finite, like
+    // sqrt(-1) or 1 / 0, become 0. Floating point volumes get the value range of the result.
+    // progress is called per slab of slices, an empty volume is returned if it returns false.
+    Volume apply(const Volume& volume, const ProgressCallback& progress = ProgressCallback()) const;
+
+private:
+    enum class Opcode : std::uint8_t {
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Power,
+        Minimum,
+        Maximum,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual,
+        Equal,
+        NotEqual,
+        Select,
+        Negate,
+        Absolute,
+        SquareRoot,
+        Exponential,
+        Logarithm,
+        Floor,
+        Ceil,
+        Round
+    };
+
+    // a register holding one value per voxel of the block or a value for all voxels
+    struct Operand {
+        bool isConstant = false;
+        float constant = 0.0f;
+        std::uint32_t index = 0;
+    };
+
+    struct Instruction {
+        Opcode opcode = Opcode::Add;
+        std::uint32_t result = 0;
+        std::array<Operand, 3> operands;
+    };
+
+    // expression tree and the recursive descent parser building it, see voxel_expression.cpp
+    struct Node;
+    class Parser;
+
+    // appends the instructions computing node, its result is returned as operand
+    Operand compile(const Node& node);
+    // runs instruction over count voxels, constant operands point to their single value
+    static void execute(const Instruction& instruction,
+                        const std::array<const float*, 3>& operands, float* result,
+                        const std::size_t count);
+    void evaluateBlock(const float* values, float* results, const std::size_t count,
+                       float* scratch) const;
+
+    std::string m_text;
+    // register 0 holds v, the result of the last instruction is the result of the expression
+    std::vector<Instruction> m_program;
+    std::uint32_t m_registerCount = 1;
+    // result of expressions without instructions, v itself or a constant
+    Operand m_result;
+};
+} // namespace VDS
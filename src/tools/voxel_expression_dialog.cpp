@@ -0,0 +1,199 @@
+#include <QMessageBox>
+#include "voxel_expression_dialog.h"
+
+#include <limits>
+#include <string>
+
+namespace VDS {
+
+DialogVoxelExpression::DialogVoxelExpression(const QString& voxelTypeName, QWidget* parent)
+    : QDialog(parent) {
+    setWindowTitle(QString("Voxel Expression"));
+
+    // disable the context help button
+    setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint);
+
+    setupSectionExpression(voxelTypeName);
+    setupSectionRegion();
+    setupSectionOKAndCancel();
+
+    m_vLayoutDialog = new QVBoxLayout(this);
+    m_vLayoutDialog->addWidget(m_groupExpression);
+    m_vLayoutDialog->addWidget(m_groupRegion);
+    m_vLayoutDialog->addWidget(m_groupOKAndCancel);
+
+    setLayout(m_vLayoutDialog);
+
+    // surpress setGeometry warning. Probably related to some weird stylesheet parsing.
+    setMinimumSize(443, 263);
+}
+
+const VoxelExpression& DialogVoxelExpression::getExpression() const {
+    return m_expression;
+}
+
+VolumeRegion DialogVoxelExpression::getRegion(const std::array<std::size_t, 3>& volumeSize) const {
+    const std::array<const QLineEdit*, 3> offsets = {m_textRegionOffsetX, m_textRegionOffsetY,
+                                                     m_textRegionOffsetZ};
+    const std::array<const QLineEdit*, 3> sizes = {m_textRegionSizeX, m_textRegionSizeY,
+                                                   m_textRegionSizeZ};
+
+    // empty fields start at the first voxel and extend up to the end of the volume
+    VolumeRegion region;
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        region.offset[axis] = offsets[axis]->text().toULongLong();
+        region.size[axis] = sizes[axis]->text().isEmpty()
+                                ? volumeSize[axis]
+                                : static_cast<std::size_t>(sizes[axis]->text().toULongLong());
+    }
+    return region.clamped(volumeSize);
+}
+
+void DialogVoxelExpression::parseExpression(const QString& text) {
+    std::string errorMessage;
+    if (m_expression.parse(text.toStdString(), errorMessage)) {
+        m_labelExpressionStatus->setText(QString("Valid expression"));
+        m_labelExpressionStatus->setStyleSheet("QLabel { color : #80E015; }");
+    } else {
+        m_expression = VoxelExpression();
+        m_labelExpressionStatus->setText(QString::fromStdString(errorMessage));
+        m_labelExpressionStatus->setStyleSheet("QLabel { color : #FF483F; }");
+    }
+    m_buttonPreview->setEnabled(!m_expression.isEmpty());
+}
+
+void DialogVoxelExpression::onPreviewButtonClicked() {
+    if (!m_expression.isEmpty()) {
+        emit(requestPreview(m_expression));
+    }
+}
+
+void DialogVoxelExpression::onOKButtonClicked() {
+    if (!m_expression.isEmpty()) {
+        this->accept();
+    } else {
+        QMessageBox msgBox(QMessageBox::Warning, "Voxel Expression not possible!",
+                           m_labelExpressionStatus->text());
+        msgBox.exec();
+    }
+}
+
+void DialogVoxelExpression::onCancelButtonClicked() {
+    this->reject();
+}
+
+void DialogVoxelExpression::setupSectionExpression(const QString& voxelTypeName) {
+    m_labelExpressionInfo = new QLabel;
+    m_labelExpressionInfo->setWordWrap(true);
+    m_labelExpressionInfo->setText(
+        QString("Computes every voxel from its value v, e.g. clamp(v * 1.2 - 100, 0, 4095) or "
+                "v > 300 for a mask. Available: + - * / ^, < <= > >= == !=, min, max, clamp, "
+                "select(condition, a, b), abs, sqrt, exp, log, floor, ceil and round. The result "
+                "is stored as ") +
+        voxelTypeName + QString("."));
+
+    m_lineEditExpression = new QLineEdit;
+    m_lineEditExpression->setMinimumWidth(350);
+    m_lineEditExpression->setPlaceholderText(QString("clamp(v * 1.2 - 100, 0, 4095)"));
+
+    m_buttonPreview = new QPushButton;
+    m_buttonPreview->setText(QString("Preview"));
+    m_buttonPreview->setToolTip(QString("Shows the result on the slices of the slice views"));
+    m_buttonPreview->setEnabled(false);
+    // return previews instead of applying the expression to the whole volume
+    m_buttonPreview->setDefault(true);
+
+    m_hLayoutExpression = new QHBoxLayout;
+    m_hLayoutExpression->addWidget(m_lineEditExpression);
+    m_hLayoutExpression->addWidget(m_buttonPreview);
+
+    m_labelExpressionStatus = new QLabel;
+
+    m_vLayoutExpression = new QVBoxLayout;
+    m_vLayoutExpression->addWidget(m_labelExpressionInfo);
+    m_vLayoutExpression->addLayout(m_hLayoutExpression);
+    m_vLayoutExpression->addWidget(m_labelExpressionStatus);
+
+    m_groupExpression = new QGroupBox;
+    m_groupExpression->setTitle(QString("Expression:"));
+    m_groupExpression->setLayout(m_vLayoutExpression);
+
+    connect(m_lineEditExpression, &QLineEdit::textChanged, this,
+            &DialogVoxelExpression::parseExpression);
+    connect(m_buttonPreview, &QPushButton::clicked, this,
+            &DialogVoxelExpression::onPreviewButtonClicked);
+}
+
+void DialogVoxelExpression::setupSectionRegion() {
+    m_validatorRegion = new QIntValidator(0, std::numeric_limits<int>::max(), this);
+
+    m_labelRegionOffset = new QLabel;
+    m_labelRegionOffset->setText(QString("Region offset in pixel (optional):"));
+
+    m_textRegionOffsetX = new QLineEdit;
+    m_textRegionOffsetX->setPlaceholderText(QString("0"));
+    m_textRegionOffsetX->setValidator(m_validatorRegion);
+
+    m_textRegionOffsetY = new QLineEdit;
+    m_textRegionOffsetY->setPlaceholderText(QString("0"));
+    m_textRegionOffsetY->setValidator(m_validatorRegion);
+
+    m_textRegionOffsetZ = new QLineEdit;
+    m_textRegionOffsetZ->setPlaceholderText(QString("0"));
+    m_textRegionOffsetZ->setValidator(m_validatorRegion);
+
+    m_hLayoutRegionOffset = new QHBoxLayout;
+    m_hLayoutRegionOffset->addWidget(m_textRegionOffsetX);
+    m_hLayoutRegionOffset->addWidget(m_textRegionOffsetY);
+    m_hLayoutRegionOffset->addWidget(m_textRegionOffsetZ);
+
+    m_labelRegionSize = new QLabel;
+    m_labelRegionSize->setText(QString("Region size in pixel (optional):"));
+
+    m_textRegionSizeX = new QLineEdit;
+    m_textRegionSizeX->setPlaceholderText(QString("Up to end"));
+    m_textRegionSizeX->setValidator(m_validatorRegion);
+
+    m_textRegionSizeY = new QLineEdit;
+    m_textRegionSizeY->setPlaceholderText(QString("Up to end"));
+    m_textRegionSizeY->setValidator(m_validatorRegion);
+
+    m_textRegionSizeZ = new QLineEdit;
+    m_textRegionSizeZ->setPlaceholderText(QString("Up to end"));
+    m_textRegionSizeZ->setValidator(m_validatorRegion);
+
+    m_hLayoutRegionSize = new QHBoxLayout;
+    m_hLayoutRegionSize->addWidget(m_textRegionSizeX);
+    m_hLayoutRegionSize->addWidget(m_textRegionSizeY);
+    m_hLayoutRegionSize->addWidget(m_textRegionSizeZ);
+
+    m_vLayoutRegion = new QVBoxLayout;
+    m_vLayoutRegion->addWidget(m_labelRegionOffset);
+    m_vLayoutRegion->addLayout(m_hLayoutRegionOffset);
+    m_vLayoutRegion->addWidget(m_labelRegionSize);
+    m_vLayoutRegion->addLayout(m_hLayoutRegionSize);
+
+    m_groupRegion = new QGroupBox;
+    m_groupRegion->setTitle(QString("Region:"));
+    m_groupRegion->setLayout(m_vLayoutRegion);
+}
+
+void DialogVoxelExpression::setupSectionOKAndCancel() {
+    m_buttonOK = new QPushButton;
+    m_buttonOK->setText(QString("Apply"));
+
+    m_buttonCancel = new QPushButton;
+    m_buttonCancel->setText(QString("Cancel"));
+
+    m_hLayoutOKAndCancel = new QHBoxLayout;
+    m_hLayoutOKAndCancel->addWidget(m_buttonOK);
+    m_hLayoutOKAndCancel->addWidget(m_buttonCancel);
+
+    m_groupOKAndCancel = new QGroupBox;
+    m_groupOKAndCancel->setLayout(m_hLayoutOKAndCancel);
+
+    connect(m_buttonOK, &QPushButton::clicked, this, &DialogVoxelExpression::onOKButtonClicked);
+    connect(m_buttonCancel, &QPushButton::clicked, this,
+            &DialogVoxelExpression::onCancelButtonClicked);
+}
+} // namespace VDS
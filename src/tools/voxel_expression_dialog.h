@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QDialog>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QIntValidator>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+#include <array>
+
+#include "common/volume_region.h"
+#include "voxel_expression.h"
+
+namespace VDS {
+
+class DialogVoxelExpression : public QDialog {
+    Q_OBJECT
+
+public:
+    DialogVoxelExpression(const QString& voxelTypeName, QWidget* parent = 0);
+
+    // the expression as parsed from the current input, empty if the input is invalid
+    const VoxelExpression& getExpression() const;
+    // voxels the expression gets applied to, the whole volume unless a region was entered
+    VolumeRegion getRegion(const std::array<std::size_t, 3>& volumeSize) const;
+
+public slots:
+    void parseExpression(const QString& text);
+    void onPreviewButtonClicked();
+    void onOKButtonClicked();
+    void onCancelButtonClicked();
+
+signals:
+    // asks to show the result of expression on the slices of the slice views
+    void requestPreview(const VDS::VoxelExpression& expression);
+
+private:
+    void setupSectionExpression(const QString& voxelTypeName);
+    void setupSectionRegion();
+    void setupSectionOKAndCancel();
+
+    VoxelExpression m_expression;
+
+    // Dialog Window
+    QVBoxLayout* m_vLayoutDialog;
+
+    // Expression
+    QGroupBox* m_groupExpression;
+    QVBoxLayout* m_vLayoutExpression;
+    QHBoxLayout* m_hLayoutExpression;
+    QLabel* m_labelExpressionInfo;
+    QLineEdit* m_lineEditExpression;
+    QPushButton* m_buttonPreview;
+    QLabel* m_labelExpressionStatus;
+
+    // Region
+    QIntValidator* m_validatorRegion;
+    QGroupBox* m_groupRegion;
+    QVBoxLayout* m_vLayoutRegion;
+    QLabel* m_labelRegionOffset;
+    QHBoxLayout* m_hLayoutRegionOffset;
+    QLineEdit* m_textRegionOffsetX;
+    QLineEdit* m_textRegionOffsetY;
+    QLineEdit* m_textRegionOffsetZ;
+    QLabel* m_labelRegionSize;
+    QHBoxLayout* m_hLayoutRegionSize;
+    QLineEdit* m_textRegionSizeX;
+    QLineEdit* m_textRegionSizeY;
+    QLineEdit* m_textRegionSizeZ;
+
+    // OK and Cancel
+    QGroupBox* m_groupOKAndCancel;
+    QHBoxLayout* m_hLayoutOKAndCancel;
+    QPushButton* m_buttonOK;
+    QPushButton* m_buttonCancel;
+};
+} // namespace VDS
@@ -5,21 +5,18 @@
 #include <QFuture>
 
 HistogramViewGL::HistogramViewGL(QWidget* parent)
-    : QOpenGLWidget(parent), m_histogramData(UINT16_MAX + 1, 0), m_histogramDataScaled(10, 0) {
+    : QOpenGLWidget(parent),
+      m_histogramData(std::make_shared<const std::vector<uint16_t>>(UINT16_MAX + 1, 0)),
+      m_ignoreBorders(false), m_histogramDataScaled(10, 0) {
     m_width = m_height = 1;
     is_opengl_initialized = false;
 
     connect(this, &HistogramViewGL::updateHistogram, this, &HistogramViewGL::updateTexture);
 }
 
-void HistogramViewGL::updateHistogramData(const std::vector<uint16_t>& histo, bool ignoreBorders) {
-    setHistogramData(histo);
-
-    if (ignoreBorders) {
-        QMutexLocker locker(&m_mutexHistogram);
-        m_histogramData[0] = 0;
-        m_histogramData[UINT16_MAX] = 0;
-    }
+void HistogramViewGL::updateHistogramData(const VDS::DisplayHistogram& histo,
+                                          bool ignoreBorders) {
+    setHistogramData(histo, ignoreBorders);
 
     calculateScaledHistogram();
     update();
@@ -83,14 +80,19 @@ void HistogramViewGL::paintGL() {
     glUseProgram(0);
 }
 
-const std::vector<uint16_t> HistogramViewGL::getHistogramData() {
+VDS::DisplayHistogram HistogramViewGL::getHistogramData(bool& ignoreBorders) {
     QMutexLocker locker(&m_mutexHistogram);
+    ignoreBorders = m_ignoreBorders;
     return m_histogramData;
 }
 
-void HistogramViewGL::setHistogramData(const std::vector<uint16_t>& histogram) {
+void HistogramViewGL::setHistogramData(const VDS::DisplayHistogram& histogram,
+                                       bool ignoreBorders) {
     QMutexLocker locker(&m_mutexHistogram);
-    m_histogramData = histogram;
+    if (histogram) {
+        m_histogramData = histogram;
+        m_ignoreBorders = ignoreBorders;
+    }
 }
 
 const std::vector<uint16_t> HistogramViewGL::getScaledHistogramData() {
@@ -139,15 +141,24 @@ void HistogramViewGL::calculateScaledHistogram() {
 
         const int width = getWidth();
         std::vector<uint16_t> histogramScaled(width);
-        const std::vector<uint16_t> histogram = getHistogramData();
+        bool ignoreBorders = false;
+        const VDS::DisplayHistogram histogramData = getHistogramData(ignoreBorders);
+        const std::vector<uint16_t>& histogram = *histogramData;
 
+        // the number of bins depends on the voxel type and can be smaller than the width
         const std::size_t size = histogram.size();
-        const std::size_t sectionSize = size / width;
 
-        for (std::size_t index = 0; index < width; index++) {
-            histogramScaled[index] =
-                *std::max_element(histogram.begin() + index * sectionSize,
-                                  histogram.begin() + (index + 1) * sectionSize - 1);
+        for (std::size_t index = 0; index < width && size > 0; index++) {
+            const std::size_t begin = std::min(index * size / width, size - 1);
+            const std::size_t end = std::max(begin + 1, (index + 1) * size / width);
+            // the shared bins stay untouched, ignored border bins are skipped instead
+            uint16_t maximum = 0;
+            for (std::size_t bin = begin; bin < end; bin++) {
+                if (!ignoreBorders || (bin != 0 && bin != size - 1)) {
+                    maximum = std::max(maximum, histogram[bin]);
+                }
+            }
+            histogramScaled[index] = maximum;
         }
 
         setMax(*std::max_element(histogramScaled.begin(), histogramScaled.end()));
@@ -7,6 +7,8 @@
 
 #include <vector>
 
+#include "common/volume_histogram.h"
+
 class HistogramViewGL : public QOpenGLWidget, protected QOpenGLFunctions_4_3_Core {
     Q_OBJECT
 
@@ -14,9 +16,10 @@ public:
     HistogramViewGL(QWidget* parent);
 
 public slots:
-    // ignoreBorders if active, 0 and Max (UINT16MAX) get ingored, since they are crowed by linear
-    // windowing
-    void updateHistogramData(const std::vector<uint16_t>& histo, bool ignoreBorders);
+    // histo may have any number of bins (256 for 8 bit, 65536 for 16 bit volumes). ignoreBorders if
+    // active, the first and last bin get ingored, since they are crowed by linear windowing. The
+    // bins are shared with the sender and never modified.
+    void updateHistogramData(const VDS::DisplayHistogram& histo, bool ignoreBorders);
     void updateTexture();
 
 protected:
@@ -24,8 +27,8 @@ protected:
     void resizeGL(int w, int h) override;
     void paintGL() override;
 
-    const std::vector<uint16_t> getHistogramData();
-    void setHistogramData(const std::vector<uint16_t>& histogram);
+    VDS::DisplayHistogram getHistogramData(bool& ignoreBorders);
+    void setHistogramData(const VDS::DisplayHistogram& histogram, bool ignoreBorders);
     const std::vector<uint16_t> getScaledHistogramData();
     void setScaledHistogramData(const std::vector<uint16_t>& histogram);
 
@@ -50,7 +53,8 @@ private:
     void setupShaderProgram();
     void setupTexture();
 
-    std::vector<uint16_t> m_histogramData;
+    VDS::DisplayHistogram m_histogramData;
+    bool m_ignoreBorders;
     std::vector<uint16_t> m_histogramDataScaled;
 
     bool is_opengl_initialized;
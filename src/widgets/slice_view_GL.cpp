@@ -104,6 +104,20 @@ void SliceViewGL::updateValueWindowOffset(float windowOffset) {
 
     update();
 }
+void SliceViewGL::updateValueRangeMapping(const VDS::ValueRangeMapping& mapping) {
+    m_settings.valueRangeMapping = mapping;
+
+    glUseProgram(m_shaderProgram);
+
+    const GLuint scalePosition = glGetUniformLocation(m_shaderProgram, "valueRangeScale");
+    glUniform1f(scalePosition, m_settings.valueRangeMapping.scale);
+    const GLuint offsetPosition = glGetUniformLocation(m_shaderProgram, "valueRangeOffset");
+    glUniform1f(offsetPosition, m_settings.valueRangeMapping.offset);
+
+    glUseProgram(0);
+
+    update();
+}
 
 void SliceViewGL::initializeGL() {
     initializeOpenGLFunctions();
@@ -330,6 +344,7 @@ void SliceViewGL::updateShaderUniforms() {
     updateValueWindowWidth(m_settings.windowSettings.valueWindowWidth);
     updateValueWindowCenter(m_settings.windowSettings.valueWindowCenter);
     updateValueWindowOffset(m_settings.windowSettings.valueWindowOffset);
+    updateValueRangeMapping(m_settings.valueRangeMapping);
     update();
 }
 
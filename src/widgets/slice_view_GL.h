@@ -29,6 +29,7 @@ public slots:
     void updateValueWindowWidth(float windowWidth);
     void updateValueWindowCenter(float windowCenter);
     void updateValueWindowOffset(float windowOffset);
+    void updateValueRangeMapping(const VDS::ValueRangeMapping& mapping);
 
 protected:
     void initializeGL() override;
@@ -3,6 +3,7 @@
 #include <QDebug>
 #include <QMetaEnum>
 
+#include <cassert>
 #include <chrono>
 #include <cmath>
 
@@ -38,10 +39,11 @@ VolumeViewGL::VolumeViewGL(QWidget* parent)
             &VolumeViewGL::recieveFragmentShaderFromRenderer);
 }
 
-void VolumeViewGL::updateVolumeData(const std::array<std::size_t, 3> size,
-                                    const std::array<float, 3> spacing,
-                                    const std::vector<uint16_t>& volumeData) {
-    m_rayCastRenderer.updateVolumeData(size, spacing, volumeData);
+void VolumeViewGL::updateVolumeData(const VDS::Volume& volume) {
+    // the texture is uploaded straight from the voxels shared with the main window
+    [[maybe_unused]] const std::size_t deepCopyCount = VDS::Volume::getDeepCopyCount();
+    m_rayCastRenderer.updateVolumeData(volume);
+    assert(VDS::Volume::getDeepCopyCount() == deepCopyCount);
 
     // set sample step length to 1x optimal samples per ray
     setRecommendedSampleStepLength(0);
@@ -52,6 +54,61 @@ void VolumeViewGL::updateVolumeData(const std::array<std::size_t, 3> size,
     this->update();
 }
 
+void VolumeViewGL::updateCompressedVolumeData(
+    const std::shared_ptr<const VDS::CompressedVolume>& volume) {
+    if (!volume) {
+        return;
+    }
+    m_rayCastRenderer.updateVolumeData(*volume);
+
+    setRecommendedSampleStepLength(0);
+
+    resetViewMatrix();
+    m_rayCastRenderer.applyMatrices();
+
+    this->update();
+}
+
+void VolumeViewGL::updateVolumeRegion(const VDS::Volume& regionData,
+                                      const VDS::VolumeRegion& region) {
+    m_rayCastRenderer.updateVolumeRegion(regionData, region);
+
+    this->update();
+}
+
+void VolumeViewGL::setupTimestepTextures(std::size_t count) {
+    makeCurrent();
+    m_rayCastRenderer.setupTimestepTextures(count);
+    doneCurrent();
+
+    this->update();
+}
+
+void VolumeViewGL::uploadTimestep(const VDS::Volume& volume, std::size_t textureSlot) {
+    makeCurrent();
+    m_rayCastRenderer.uploadTimestep(volume, textureSlot);
+    doneCurrent();
+}
+
+void VolumeViewGL::showTimestep(std::size_t textureSlot) {
+    m_rayCastRenderer.showTimestep(textureSlot);
+
+    this->update();
+}
+
+void VolumeViewGL::updateMesh(const std::shared_ptr<const VDS::TriangleMesh>& mesh) {
+    makeCurrent();
+    m_rayCastRenderer.updateMesh(mesh ? *mesh : VDS::TriangleMesh());
+    doneCurrent();
+
+    this->update();
+}
+
+void VolumeViewGL::setMeshRenderStatus(bool active) {
+    m_rayCastRenderer.setMeshRenderStatus(active);
+    update();
+}
+
 int VolumeViewGL::getTextureSizeMaximum() {
     return m_maxiumTextureSize;
 }
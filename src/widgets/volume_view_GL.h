@@ -9,6 +9,8 @@
 #include <QOpenGLWidget>
 #include <QPoint>
 
+#include <memory>
+
 class VolumeViewGL : public QOpenGLWidget, protected QOpenGLFunctions_4_3_Core {
 
     Q_OBJECT
@@ -19,8 +21,15 @@ public:
     GLuint getTextureHandle() const;
 
 public slots:
-    void updateVolumeData(const std::array<std::size_t, 3> size, const std::array<float, 3> spacing,
-                          const std::vector<uint16_t>& volumeData);
+    void updateVolumeData(const VDS::Volume& volume);
+    void updateCompressedVolumeData(const std::shared_ptr<const VDS::CompressedVolume>& volume);
+    void updateVolumeRegion(const VDS::Volume& regionData, const VDS::VolumeRegion& region);
+    void setupTimestepTextures(std::size_t count);
+    void uploadTimestep(const VDS::Volume& volume, std::size_t textureSlot);
+    void showTimestep(std::size_t textureSlot);
+    // an empty pointer removes the mesh
+    void updateMesh(const std::shared_ptr<const VDS::TriangleMesh>& mesh);
+    void setMeshRenderStatus(bool active);
     void setRenderLoop(bool onlyRerenderOnChange);
     void setBoundingBoxRenderStatus(bool active);
     void setRenderSliceBorders(bool active);